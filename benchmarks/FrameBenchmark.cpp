@@ -0,0 +1,31 @@
+#include "BackendScene.h"
+#include "HeadlessBackend.h"
+
+#include <cstdlib>
+#include <string_view>
+
+//FrameBenchmark [numObjects [numFrames]], the same frame as the renderer's --benchmark-frame without SDL or a device
+int main(int argc, char* argv[])
+{
+	using namespace dae;
+
+	uint32_t numObjects{ 10000 };
+	uint32_t numFrames{ 100 };
+	if (argc > 1)
+	{
+		numObjects = static_cast<uint32_t>(std::strtoul(argv[1], nullptr, 10));
+	}
+	if (argc > 2)
+	{
+		numFrames = static_cast<uint32_t>(std::strtoul(argv[2], nullptr, 10));
+	}
+
+	for (const bool isConstantBufferRangeSupported : { true, false })
+	{
+		HeadlessBackend backend{ isConstantBufferRangeSupported };
+		BackendScene::Benchmark(backend, numObjects, numFrames);
+		backend.PrintStatistics();
+	}
+
+	return 0;
+}
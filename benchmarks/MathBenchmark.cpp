@@ -0,0 +1,38 @@
+#include "MathBenchmark.h"
+
+#include <algorithm>
+#include <cstdlib>
+#include <string_view>
+
+//MathBenchmark [--repetitions n] [--milliseconds ms] [--json results.json], the renderer's --benchmark-math without SDL
+int main(int argc, char* argv[])
+{
+	using namespace dae;
+
+	MathBenchmark::Options options{};
+	const char* pJSONPath{ nullptr };
+	for (int i = 1; i + 1 < argc; i += 2)
+	{
+		const std::string_view option{ argv[i] };
+		if (option == "--repetitions")
+		{
+			options.numRepetitions = std::max(std::atoi(argv[i + 1]), 1);
+		}
+		else if (option == "--milliseconds")
+		{
+			options.millisecondsPerRepetition = std::max(static_cast<float>(std::atof(argv[i + 1])), 0.1f);
+		}
+		else if (option == "--json")
+		{
+			pJSONPath = argv[i + 1];
+		}
+	}
+
+	const std::vector<MathBenchmark::Result> results = MathBenchmark::Run(options);
+	MathBenchmark::Print(results);
+
+	if (pJSONPath != nullptr && !MathBenchmark::WriteJSON(pJSONPath, results, options))
+		return 1;
+
+	return 0;
+}
@@ -0,0 +1,174 @@
+#include "AtlasLayout.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <iostream>
+#include <numeric>
+
+namespace dae
+{
+	namespace
+	{
+		constexpr uint32_t bytesPerPixel{ 4 };
+
+		uint32_t AlignUp(uint32_t value, uint32_t alignment)
+		{
+			return (value + alignment - 1) / alignment * alignment;
+		}
+
+		uint32_t NextPowerOfTwo(uint32_t value)
+		{
+			uint32_t result{ 1 };
+			while (result < value)
+			{
+				result *= 2;
+			}
+			return result;
+		}
+
+		//Copies the image into the atlas and replicates its edge texels into the gutter
+		void Blit(const Image& image, Image& atlas, uint32_t x, uint32_t y, uint32_t gutter)
+		{
+			const int32_t width = static_cast<int32_t>(image.width);
+			const int32_t height = static_cast<int32_t>(image.height);
+			const int32_t border = static_cast<int32_t>(gutter);
+
+			for (int32_t dy = -border; dy < height + border; ++dy)
+			{
+				const int32_t srcY = Clamp(dy, 0, height - 1);
+				const uint8_t* pSrcRow = &image.pixels[static_cast<size_t>(srcY) * width * bytesPerPixel];
+				uint8_t* pDstRow = &atlas.pixels[(static_cast<size_t>(y + gutter + dy) * atlas.width + x) * bytesPerPixel];
+
+				for (int32_t dx = -border; dx < 0; ++dx)
+				{
+					memcpy(pDstRow + static_cast<size_t>(dx + border) * bytesPerPixel, pSrcRow, bytesPerPixel);
+				}
+
+				memcpy(pDstRow + static_cast<size_t>(border) * bytesPerPixel, pSrcRow, static_cast<size_t>(width) * bytesPerPixel);
+
+				for (int32_t dx = width; dx < width + border; ++dx)
+				{
+					memcpy(pDstRow + static_cast<size_t>(dx + border) * bytesPerPixel, pSrcRow + static_cast<size_t>(width - 1) * bytesPerPixel, bytesPerPixel);
+				}
+			}
+		}
+	}
+
+	uint32_t AtlasLayout::GetMipCount(uint32_t gutter)
+	{
+		uint32_t mipCount{ 1 };
+		while ((gutter >> mipCount) >= 1)
+		{
+			++mipCount;
+		}
+		return mipCount;
+	}
+
+	bool AtlasLayout::Pack(const std::vector<Int2>& sizes, uint32_t size, uint32_t alignment, std::vector<Int2>& positions)
+	{
+		positions.assign(sizes.size(), Int2{});
+
+		//Tallest first keeps the wasted space on each shelf small
+		std::vector<size_t> order(sizes.size());
+		std::iota(order.begin(), order.end(), size_t{ 0 });
+		std::stable_sort(order.begin(), order.end(), [&sizes](size_t a, size_t b) { return sizes[a].y > sizes[b].y; });
+
+		uint32_t shelfX{ 0 };
+		uint32_t shelfY{ 0 };
+		uint32_t shelfHeight{ 0 };
+
+		for (const size_t index : order)
+		{
+			const uint32_t width = AlignUp(static_cast<uint32_t>(sizes[index].x), alignment);
+			const uint32_t height = AlignUp(static_cast<uint32_t>(sizes[index].y), alignment);
+
+			if (width > size)
+				return false;
+
+			if (shelfX + width > size)
+			{
+				shelfY += shelfHeight;
+				shelfX = 0;
+				shelfHeight = 0;
+			}
+
+			if (shelfY + height > size)
+				return false;
+
+			positions[index] = { static_cast<int>(shelfX), static_cast<int>(shelfY) };
+			shelfX += width;
+			shelfHeight = std::max(shelfHeight, height);
+		}
+
+		return true;
+	}
+
+	bool AtlasLayout::Build(const std::vector<Image>& images, uint32_t gutter, uint32_t maxSize, Image& atlas, std::vector<Region>& regions)
+	{
+		regions.clear();
+		if (images.empty())
+			return false;
+
+		const uint32_t alignment = 1u << (GetMipCount(gutter) - 1);
+
+		std::vector<Int2> sizes;
+		sizes.reserve(images.size());
+
+		uint64_t totalArea{ 0 };
+		for (const Image& image : images)
+		{
+			const Int2 size{
+				static_cast<int>(AlignUp(image.width + 2 * gutter, alignment)),
+				static_cast<int>(AlignUp(image.height + 2 * gutter, alignment))
+			};
+
+			sizes.push_back(size);
+			totalArea += static_cast<uint64_t>(size.x) * size.y;
+		}
+
+		//Grow a power of two square until everything fits
+		std::vector<Int2> positions;
+		uint32_t size = NextPowerOfTwo(static_cast<uint32_t>(std::sqrt(static_cast<double>(totalArea))));
+		while (size <= maxSize && !Pack(sizes, size, alignment, positions))
+		{
+			size *= 2;
+		}
+
+		if (size > maxSize)
+		{
+			std::cout << "TextureAtlas: " << images.size() << " images don't fit in " << maxSize << "x" << maxSize << "!\n";
+			return false;
+		}
+
+		atlas.width = size;
+		atlas.height = size;
+		atlas.pixels.assign(static_cast<size_t>(size) * size * bytesPerPixel, 0);
+
+		const float invSize = 1.0f / static_cast<float>(size);
+
+		regions.reserve(images.size());
+		for (size_t i = 0; i < images.size(); ++i)
+		{
+			const uint32_t x = static_cast<uint32_t>(positions[i].x);
+			const uint32_t y = static_cast<uint32_t>(positions[i].y);
+			Blit(images[i], atlas, x, y, gutter);
+
+			Region region{};
+			region.x = x + gutter;
+			region.y = y + gutter;
+			region.width = images[i].width;
+			region.height = images[i].height;
+			region.uvTransform = {
+				region.width * invSize,
+				region.height * invSize,
+				region.x * invSize,
+				region.y * invSize
+			};
+
+			regions.push_back(region);
+		}
+
+		return true;
+	}
+}
@@ -0,0 +1,38 @@
+#pragma once
+
+#include "Image.h"
+#include "MathHelpers.h"
+#include "Vector4.h"
+
+#include <cstdint>
+#include <vector>
+
+namespace dae
+{
+	// The CPU side of a TextureAtlas: where every image goes and the padded pixels it is uploaded from. Needs no device.
+	namespace AtlasLayout
+	{
+		struct Region
+		{
+			uint32_t x;
+			uint32_t y;
+			uint32_t width;
+			uint32_t height;
+
+			// xy scale, zw offset, see Mesh::SetDiffuseMap
+			Vector4 uvTransform;
+		};
+
+		// Number of mips that stay free of bleeding, a level is clean while the gutter is at least one texel wide in it.
+		// Regions (gutters included) are aligned to 1 << (mipCount - 1) texels so the gutter shrinks evenly.
+		uint32_t GetMipCount(uint32_t gutter);
+
+		// Shelf packing of width x height rectangles (gutters included) into a size x size square.
+		// Every placement is aligned to alignment texels. Returns false when they don't fit.
+		bool Pack(const std::vector<Int2>& sizes, uint32_t size, uint32_t alignment, std::vector<Int2>& positions);
+
+		// Packs the images into the smallest power of two square that fits, replicating the edge texels of every image
+		// into a gutter texels wide border. Returns false when that square would be larger than maxSize.
+		bool Build(const std::vector<Image>& images, uint32_t gutter, uint32_t maxSize, Image& atlas, std::vector<Region>& regions);
+	}
+}
@@ -0,0 +1,538 @@
+#include "BackendScene.h"
+
+#include "ConstantRingAllocator.h"
+
+#include <algorithm>
+#include <cassert>
+#include <chrono>
+#include <cmath>
+#include <cstring>
+#include <iostream>
+
+namespace dae
+{
+	namespace
+	{
+		constexpr uint32_t perFrameSize{ ConstantRingAllocator::GetAllocationSize(sizeof(PerFrameConstants)) };
+		constexpr uint32_t perDrawSize{ ConstantRingAllocator::GetAllocationSize(sizeof(PerDrawConstants)) };
+
+		//Frames the GPU may still be reading while the next ones are written, the ring holds one more
+		constexpr uint32_t numFramesInFlight{ 3 };
+	}
+
+	BackendScene::BackendScene(GraphicsBackend& backend)
+		: m_Backend{ backend }
+	{
+	}
+
+	BackendScene::~BackendScene()
+	{
+		for (const SceneMesh& mesh : m_Meshes)
+		{
+			if (!mesh.isOwned)
+				continue;
+
+			m_Backend.DestroyBuffer(mesh.vertexBuffer);
+			m_Backend.DestroyBuffer(mesh.indexBuffer);
+		}
+
+		m_Backend.DestroyBuffer(m_ConstantBuffer);
+		m_Backend.DestroyBuffer(m_PerFrameBuffer);
+	}
+
+	uint32_t BackendScene::AddMesh(std::span<const Vertex> vertices, std::span<const uint32_t> indices, PipelineHandle pipeline)
+	{
+		if (vertices.empty() || indices.empty())
+			return UINT32_MAX;
+
+		const BufferHandle vertexBuffer = m_Backend.CreateBuffer({ BufferUsage::Vertex, static_cast<uint32_t>(vertices.size_bytes()), false }, vertices.data());
+		const BufferHandle indexBuffer = m_Backend.CreateBuffer({ BufferUsage::Index, static_cast<uint32_t>(indices.size_bytes()), false }, indices.data());
+		if (vertexBuffer == 0 || indexBuffer == 0)
+		{
+			m_Backend.DestroyBuffer(vertexBuffer);
+			m_Backend.DestroyBuffer(indexBuffer);
+			return UINT32_MAX;
+		}
+
+		//Same bounds as Mesh
+		Vector3 min = vertices[0].position;
+		Vector3 max = vertices[0].position;
+		for (const Vertex& vertex : vertices)
+		{
+			min = Vector3::Min(min, vertex.position);
+			max = Vector3::Max(max, vertex.position);
+		}
+
+		BoundingSphere bounds{ (min + max) * 0.5f, 0.0f };
+		for (const Vertex& vertex : vertices)
+		{
+			bounds.radius = std::max(bounds.radius, (vertex.position - bounds.center).Magnitude());
+		}
+
+		const uint32_t mesh = AddMesh(vertexBuffer, indexBuffer, static_cast<uint32_t>(indices.size()), bounds, pipeline);
+		m_Meshes[mesh].isOwned = true;
+		return mesh;
+	}
+
+	uint32_t BackendScene::AddMesh(BufferHandle vertexBuffer, BufferHandle indexBuffer, uint32_t indexCount, const BoundingSphere& bounds, PipelineHandle pipeline)
+	{
+		m_Meshes.push_back({ vertexBuffer, indexBuffer, indexCount, pipeline, bounds, false });
+		return static_cast<uint32_t>(m_Meshes.size() - 1);
+	}
+
+	uint32_t BackendScene::AddMaterial(TextureHandle diffuseMap, TextureHandle normalGlossSpecularMap, const Vector4& diffuseUVTransform)
+	{
+		m_Materials.push_back({ diffuseMap, normalGlossSpecularMap, diffuseUVTransform });
+		return static_cast<uint32_t>(m_Materials.size() - 1);
+	}
+
+	uint32_t BackendScene::AddObject(uint32_t mesh, uint32_t material, const Matrix& world)
+	{
+		assert(mesh < m_Meshes.size() && material < m_Materials.size());
+
+		m_Objects.push_back({ mesh, material, world, 0, 0, 0 });
+		return static_cast<uint32_t>(m_Objects.size() - 1);
+	}
+
+	void BackendScene::SetObjectWorld(uint32_t object, const Matrix& world)
+	{
+		m_Objects[object].world = world;
+	}
+
+	void BackendScene::SetObjectInstances(uint32_t object, BufferHandle instanceBuffer, uint32_t instanceStride, uint32_t numInstances)
+	{
+		SceneObject& sceneObject = m_Objects[object];
+		sceneObject.instanceBuffer = instanceBuffer;
+		sceneObject.instanceStride = instanceStride;
+		sceneObject.numInstances = numInstances;
+	}
+
+	void BackendScene::Prepare(const Camera& camera)
+	{
+		using Clock = std::chrono::high_resolution_clock;
+		const auto toMilliseconds = [](Clock::duration duration)
+			{
+				return std::chrono::duration<float, std::milli>(duration).count();
+			};
+
+		const Clock::time_point start = Clock::now();
+		Cull(camera);
+		const Clock::time_point culled = Clock::now();
+		Sort(camera);
+		CountStateChanges();
+		const Clock::time_point sorted = Clock::now();
+		WriteConstants(camera);
+		const Clock::time_point written = Clock::now();
+
+		m_Statistics.cullMilliseconds = toMilliseconds(culled - start);
+		m_Statistics.sortMilliseconds = toMilliseconds(sorted - culled);
+		m_Statistics.constantsMilliseconds = toMilliseconds(written - sorted);
+	}
+
+	uint32_t BackendScene::GetNumDraws() const
+	{
+		return static_cast<uint32_t>(m_DrawQueue.GetItems().size());
+	}
+
+	void BackendScene::Submit(GraphicsBackend& backend, RecordingRange range) const
+	{
+		assert(m_IsRangeSupported || &backend == &m_Backend);
+
+		const std::span<const DrawQueue::Item> items = m_DrawQueue.GetItems();
+		range.end = std::min(range.end, static_cast<uint32_t>(items.size()));
+		//Nothing to bind when Prepare could not write the constants
+		if (range.begin >= range.end || m_ConstantBuffer == 0 || (m_IsRangeSupported && m_PerDrawAllocations.size() != items.size()))
+			return;
+
+		if (m_IsRangeSupported)
+		{
+			uint32_t firstConstant{};
+			uint32_t numConstants{};
+			ConstantRingAllocator::GetConstantRange(m_PerFrameAllocation, firstConstant, numConstants);
+			backend.SetConstantBuffer(ConstantBuffers::PerFrameSlot, m_ConstantBuffer, firstConstant, numConstants);
+		}
+		else
+		{
+			backend.SetConstantBuffer(ConstantBuffers::PerFrameSlot, m_PerFrameBuffer);
+			backend.SetConstantBuffer(ConstantBuffers::PerDrawSlot, m_ConstantBuffer);
+		}
+
+		//Sorted by pipeline, material and mesh, so only the first draw of a group binds anything
+		uint32_t boundMesh{ UINT32_MAX };
+		BufferHandle boundInstanceBuffer{ 0 };
+		uint32_t boundMaterial{ UINT32_MAX };
+		PipelineHandle boundPipeline{ 0 };
+		for (uint32_t i = range.begin; i < range.end; ++i)
+		{
+			const SceneObject& object = m_Objects[items[i].index];
+			const SceneMesh& mesh = m_Meshes[object.mesh];
+
+			if (mesh.pipeline != boundPipeline)
+			{
+				backend.SetPipeline(mesh.pipeline);
+				boundPipeline = mesh.pipeline;
+			}
+
+			if (object.material != boundMaterial)
+			{
+				const SceneMaterial& material = m_Materials[object.material];
+				backend.SetTexture(0, material.diffuseMap);
+				backend.SetTexture(1, material.normalGlossSpecularMap);
+				boundMaterial = object.material;
+			}
+
+			if (object.mesh != boundMesh || object.instanceBuffer != boundInstanceBuffer)
+			{
+				const BufferHandle vertexBuffers[2]{ mesh.vertexBuffer, object.instanceBuffer };
+				const uint32_t strides[2]{ sizeof(Vertex), object.instanceStride };
+				constexpr uint32_t offsets[2]{ 0, 0 };
+				backend.SetVertexBuffers(0, object.instanceBuffer != 0 ? 2 : 1, vertexBuffers, strides, offsets);
+				backend.SetIndexBuffer(mesh.indexBuffer);
+				boundMesh = object.mesh;
+				boundInstanceBuffer = object.instanceBuffer;
+			}
+
+			const uint8_t* pPerDraw = m_Constants.data() + perFrameSize + i * perDrawSize;
+			if (m_IsRangeSupported)
+			{
+				uint32_t firstConstant{};
+				uint32_t numConstants{};
+				ConstantRingAllocator::GetConstantRange(m_PerDrawAllocations[i], firstConstant, numConstants);
+				backend.SetConstantBuffer(ConstantBuffers::PerDrawSlot, m_ConstantBuffer, firstConstant, numConstants);
+			}
+			else
+			{
+				backend.UpdateBuffer(m_ConstantBuffer, pPerDraw, sizeof(PerDrawConstants));
+			}
+
+			if (object.instanceBuffer != 0)
+			{
+				backend.DrawIndexedInstanced(mesh.indexCount, object.numInstances, 0, 0, 0);
+			}
+			else
+			{
+				backend.DrawIndexed(mesh.indexCount, 0, 0);
+			}
+		}
+	}
+
+	void BackendScene::Render(const Camera& camera)
+	{
+		Prepare(camera);
+
+		const auto start = std::chrono::high_resolution_clock::now();
+		Submit(m_Backend, { 0, GetNumDraws() });
+		m_Statistics.submitMilliseconds = std::chrono::duration<float, std::milli>(std::chrono::high_resolution_clock::now() - start).count();
+	}
+
+	const BackendScene::Statistics& BackendScene::GetStatistics() const
+	{
+		return m_Statistics;
+	}
+
+	void BackendScene::PrintStatistics() const
+	{
+		std::cout << "Scene: " << m_Statistics.numVisible << " of " << m_Statistics.numObjects << " objects visible"
+			<< " (" << m_Statistics.numPipelineChanges << " pipeline, " << m_Statistics.numMaterialChanges << " material, "
+			<< m_Statistics.numMeshChanges << " mesh changes), cull " << m_Statistics.cullMilliseconds << " ms, sort "
+			<< m_Statistics.sortMilliseconds << " ms, constants " << m_Statistics.constantsMilliseconds << " ms, submit "
+			<< m_Statistics.submitMilliseconds << " ms\n";
+		std::cout << "Constants: " << m_Statistics.constantBytes << " bytes per frame, " << m_Statistics.numConstantDiscards << " discards\n";
+	}
+
+	void BackendScene::Cull(const Camera& camera)
+	{
+		m_WorldBounds.resize(m_Objects.size());
+		m_Containment.resize(m_Objects.size());
+
+		for (size_t i = 0; i < m_Objects.size(); ++i)
+		{
+			const SceneObject& object = m_Objects[i];
+			const BoundingSphere& bounds = m_Meshes[object.mesh].bounds;
+
+			//The largest axis scale keeps the sphere conservative under non uniform scaling
+			const float scale = std::sqrt(std::max({ object.world.GetAxisX().SqrMagnitude(), object.world.GetAxisY().SqrMagnitude(), object.world.GetAxisZ().SqrMagnitude() }));
+			m_WorldBounds[i] = { object.world.TransformPoint(bounds.center), bounds.radius * scale };
+		}
+
+		const Frustum frustum{ camera.viewMatrix * camera.projectionMatrix };
+		frustum.Classify(m_WorldBounds, m_Containment);
+
+		//The instances were culled by whoever filled the buffer
+		for (size_t i = 0; i < m_Objects.size(); ++i)
+		{
+			const SceneObject& object = m_Objects[i];
+			if (object.instanceBuffer != 0)
+			{
+				m_Containment[i] = object.numInstances > 0 ? Containment::Intersecting : Containment::Outside;
+			}
+		}
+
+		m_Statistics.numObjects = static_cast<uint32_t>(m_Objects.size());
+	}
+
+	void BackendScene::Sort(const Camera& camera)
+	{
+		m_DrawQueue.Clear();
+
+		//Handles and indices are dense already, they are the ids of the key. Instances spread over the scene, a batch
+		//sorts as if it was at the near plane.
+		const float depthRange = camera.farPlane - camera.nearPlane;
+		for (uint32_t i = 0; i < m_Objects.size(); ++i)
+		{
+			if (m_Containment[i] == Containment::Outside)
+				continue;
+
+			const SceneObject& object = m_Objects[i];
+			const float depth = object.instanceBuffer != 0 ? 0.0f : (Vector3::Dot(m_WorldBounds[i].center - camera.origin, camera.forward) - camera.nearPlane) / depthRange;
+			const uint64_t key = DrawQueue::CreateKey(DrawQueue::Pass::Opaque, m_Meshes[object.mesh].pipeline, object.material, object.mesh, depth);
+			m_DrawQueue.Submit(key, i);
+		}
+
+		m_DrawQueue.Sort();
+		m_Statistics.numVisible = GetNumDraws();
+	}
+
+	void BackendScene::CountStateChanges()
+	{
+		//What Submit binds for the whole list, every further range binds its first draw's state again
+		m_Statistics.numPipelineChanges = 0;
+		m_Statistics.numMaterialChanges = 0;
+		m_Statistics.numMeshChanges = 0;
+
+		uint32_t boundMesh{ UINT32_MAX };
+		BufferHandle boundInstanceBuffer{ 0 };
+		uint32_t boundMaterial{ UINT32_MAX };
+		PipelineHandle boundPipeline{ 0 };
+		for (const DrawQueue::Item& item : m_DrawQueue.GetItems())
+		{
+			const SceneObject& object = m_Objects[item.index];
+			const PipelineHandle pipeline = m_Meshes[object.mesh].pipeline;
+
+			m_Statistics.numPipelineChanges += pipeline != boundPipeline ? 1 : 0;
+			m_Statistics.numMaterialChanges += object.material != boundMaterial ? 1 : 0;
+			m_Statistics.numMeshChanges += object.mesh != boundMesh || object.instanceBuffer != boundInstanceBuffer ? 1 : 0;
+
+			boundPipeline = pipeline;
+			boundMaterial = object.material;
+			boundMesh = object.mesh;
+			boundInstanceBuffer = object.instanceBuffer;
+		}
+	}
+
+	void BackendScene::WriteConstants(const Camera& camera)
+	{
+		const std::span<const DrawQueue::Item> items = m_DrawQueue.GetItems();
+
+		//Laid out as they are uploaded with ranges, per draw buffers are written from here without them
+		const uint32_t numBytes = perFrameSize + static_cast<uint32_t>(items.size()) * perDrawSize;
+		m_Constants.resize(numBytes);
+
+		PerFrameConstants perFrame{};
+		perFrame.viewInverse = camera.invViewMatrix;
+		perFrame.viewProjection = camera.viewMatrix * camera.projectionMatrix;
+		std::memcpy(m_Constants.data(), &perFrame, sizeof(perFrame));
+
+		for (size_t i = 0; i < items.size(); ++i)
+		{
+			const SceneObject& object = m_Objects[items[i].index];
+			PerDrawConstants perDraw{};
+			FillConstants(camera, object, m_Materials[object.material], perDraw);
+			std::memcpy(m_Constants.data() + perFrameSize + i * perDrawSize, &perDraw, sizeof(perDraw));
+		}
+
+		m_IsRangeSupported = m_Backend.IsConstantBufferRangeSupported();
+		m_PerDrawAllocations.clear();
+		m_Statistics.constantBytes = numBytes;
+		if (!m_IsRangeSupported)
+		{
+			if (m_PerFrameBuffer == 0)
+			{
+				m_PerFrameBuffer = m_Backend.CreateBuffer({ BufferUsage::Constant, sizeof(PerFrameConstants), true }, nullptr);
+			}
+			if (!ReserveConstantBuffer(sizeof(PerDrawConstants)) || m_PerFrameBuffer == 0)
+				return;
+
+			m_Backend.UpdateBuffer(m_PerFrameBuffer, &perFrame, sizeof(perFrame));
+			++m_Statistics.numConstantDiscards;
+			return;
+		}
+
+		if (!ReserveConstantRing(numBytes))
+			return;
+
+		//Every frame is discarded when only discard is supported, the ring then always starts at 0
+		if (!m_Backend.IsConstantBufferNoOverwriteSupported())
+		{
+			m_pConstantRing->Reset();
+		}
+
+		ConstantRingAllocator::MapMode mapMode{};
+		if (!m_pConstantRing->BeginFrame(numBytes, mapMode))
+			return;
+
+		m_pConstantRing->Allocate(sizeof(PerFrameConstants), m_PerFrameAllocation);
+		m_PerDrawAllocations.resize(items.size());
+		for (ConstantAllocation& allocation : m_PerDrawAllocations)
+		{
+			m_pConstantRing->Allocate(sizeof(PerDrawConstants), allocation);
+		}
+		m_pConstantRing->EndFrame();
+
+		const bool isDiscarding = mapMode == ConstantRingAllocator::MapMode::Discard;
+		m_Backend.UpdateBuffer(m_ConstantBuffer, m_Constants.data(), numBytes, m_pConstantRing->GetFrameOffset(), isDiscarding);
+		m_Statistics.numConstantDiscards += isDiscarding ? 1 : 0;
+	}
+
+	bool BackendScene::ReserveConstantRing(uint32_t frameSize)
+	{
+		if (m_pConstantRing && frameSize <= m_pConstantRing->GetCapacity() / numFramesInFlight)
+			return true;
+
+		//Frames wrap before they fill the ring, so a frame only has to fit once, room for more saves the discards
+		const uint32_t capacity = std::max(ConstantRingAllocator::GetAllocationSize(frameSize) * (numFramesInFlight + 1), m_ConstantBufferSize * 2);
+		if (!ReserveConstantBuffer(capacity))
+		{
+			m_pConstantRing.reset();
+			return false;
+		}
+
+		//A new buffer holds nothing in flight, the ring starts over
+		m_pConstantRing = std::make_unique<ConstantRingAllocator>(m_ConstantBufferSize);
+		return true;
+	}
+
+	bool BackendScene::ReserveConstantBuffer(uint32_t size)
+	{
+		if (size <= m_ConstantBufferSize)
+			return true;
+
+		//Grows by doubling so a slowly growing scene does not recreate it every frame
+		const uint32_t newSize = std::max(size, m_ConstantBufferSize * 2);
+		m_Backend.DestroyBuffer(m_ConstantBuffer);
+		m_ConstantBuffer = m_Backend.CreateBuffer({ BufferUsage::Constant, newSize, true }, nullptr);
+		if (m_ConstantBuffer == 0)
+		{
+			std::cout << "Failed to create scene constant buffer of " << newSize << " bytes!\n";
+			m_ConstantBufferSize = 0;
+			return false;
+		}
+
+		m_ConstantBufferSize = newSize;
+		return true;
+	}
+
+	void BackendScene::FillConstants(const Camera& camera, const SceneObject& object, const SceneMaterial& material, PerDrawConstants& constants)
+	{
+		//The instanced vertex shader takes the world matrix from the instance buffer, an identity keeps both paths alike
+		const Matrix world = object.instanceBuffer != 0 ? Matrix{} : object.world;
+		constants.worldViewProjection = world * camera.viewMatrix * camera.projectionMatrix;
+		constants.world = world;
+		constants.diffuseUVTransform = material.diffuseUVTransform;
+		constants.useNormalGlossSpecularMap = material.normalGlossSpecularMap != 0;
+	}
+
+	void BackendScene::Benchmark(GraphicsBackend& backend, uint32_t numObjects, uint32_t numFrames)
+	{
+		using Clock = std::chrono::high_resolution_clock;
+
+		constexpr uint32_t numMeshes{ 4 };
+		constexpr uint32_t numMaterials{ 16 };
+
+		BackendScene scene{ backend };
+
+		const PipelineHandle pipeline = backend.CreatePipeline({ L"Resources/PosCol3D.fx", {}, 0 });
+		if (pipeline == 0)
+		{
+			std::cout << "Failed to create benchmark pipeline!\n";
+			return;
+		}
+
+		//Unit cubes of different sizes, one face per 4 vertices so normals and tangents are flat
+		const Vector3 normals[6]{ Vector3::UnitX, -Vector3::UnitX, Vector3::UnitY, -Vector3::UnitY, Vector3::UnitZ, -Vector3::UnitZ };
+		for (uint32_t meshIndex = 0; meshIndex < numMeshes; ++meshIndex)
+		{
+			const float halfSize = 0.25f + 0.25f * static_cast<float>(meshIndex);
+
+			std::vector<Vertex> vertices{};
+			std::vector<uint32_t> indices{};
+			for (const Vector3& normal : normals)
+			{
+				const Vector3 tangent = std::abs(normal.y) > 0.5f ? Vector3::UnitX : Vector3::Cross(Vector3::UnitY, normal);
+				const Vector3 bitangent = Vector3::Cross(normal, tangent);
+
+				const uint32_t first = static_cast<uint32_t>(vertices.size());
+				for (int corner = 0; corner < 4; ++corner)
+				{
+					const float u = (corner == 1 || corner == 2) ? 1.0f : 0.0f;
+					const float v = corner >= 2 ? 1.0f : 0.0f;
+					const Vector3 position = (normal + tangent * (u * 2.0f - 1.0f) + bitangent * (v * 2.0f - 1.0f)) * halfSize;
+					vertices.push_back({ position, { u, v }, normal, tangent });
+				}
+				indices.insert(indices.end(), { first, first + 1, first + 2, first, first + 2, first + 3 });
+			}
+
+			scene.AddMesh(vertices, indices, pipeline);
+		}
+
+		std::vector<TextureHandle> textures{};
+		for (uint32_t materialIndex = 0; materialIndex < numMaterials; ++materialIndex)
+		{
+			const uint32_t pixel = 0xFF000000u | (materialIndex * 0x00102030u);
+			const TextureHandle diffuseMap = backend.CreateTexture({ 1, 1, RenderGraphFormat::RGBA8 }, &pixel);
+			textures.push_back(diffuseMap);
+			scene.AddMaterial(diffuseMap, 0);
+		}
+
+		//A square grid around the camera, a turning camera sees roughly a quarter of it
+		const uint32_t gridSize = static_cast<uint32_t>(std::ceil(std::sqrt(static_cast<float>(numObjects))));
+		constexpr float spacing{ 3.0f };
+		for (uint32_t i = 0; i < numObjects; ++i)
+		{
+			const float x = (static_cast<float>(i % gridSize) - gridSize * 0.5f) * spacing;
+			const float z = (static_cast<float>(i / gridSize) - gridSize * 0.5f) * spacing;
+			scene.AddObject(i % numMeshes, (i / numMeshes) % numMaterials, Matrix::CreateTranslation(x, 0.0f, z));
+		}
+
+		Camera camera{};
+		camera.Initialize(16.0f / 9.0f, 0.1f, gridSize * spacing, 60.0f, { 0.0f, 5.0f, 0.0f });
+
+		//The first frames create the constant buffer and warm the caches
+		constexpr uint32_t numWarmupFrames{ 5 };
+		float totalMilliseconds{ 0.0f };
+		Statistics totals{};
+		for (uint32_t frame = 0; frame < numWarmupFrames + numFrames; ++frame)
+		{
+			camera.SetRotation(-0.2f, static_cast<float>(frame) * 0.05f);
+			camera.CalculateViewMatrix();
+			camera.CalculateProjectionMatrix();
+
+			const Clock::time_point start = Clock::now();
+			backend.BeginFrame();
+			scene.Render(camera);
+			backend.EndFrame();
+			const float milliseconds = std::chrono::duration<float, std::milli>(Clock::now() - start).count();
+
+			if (frame < numWarmupFrames)
+				continue;
+
+			totalMilliseconds += milliseconds;
+			totals.numVisible += scene.m_Statistics.numVisible;
+			totals.cullMilliseconds += scene.m_Statistics.cullMilliseconds;
+			totals.sortMilliseconds += scene.m_Statistics.sortMilliseconds;
+			totals.submitMilliseconds += scene.m_Statistics.submitMilliseconds;
+		}
+
+		const float frames = static_cast<float>(numFrames);
+		std::cout << "Frame submission, " << numObjects << " objects, " << (backend.IsConstantBufferRangeSupported() ? "constant ranges" : "per draw constants") << '\n';
+		std::cout << "  " << totals.numVisible / numFrames << " visible, " << totalMilliseconds / frames << " ms per frame"
+			<< " (cull " << totals.cullMilliseconds / frames << " ms, sort " << totals.sortMilliseconds / frames << " ms, submit " << totals.submitMilliseconds / frames << " ms)\n";
+		scene.PrintStatistics();
+
+		for (const TextureHandle texture : textures)
+		{
+			backend.DestroyTexture(texture);
+		}
+		backend.DestroyPipeline(pipeline);
+	}
+}
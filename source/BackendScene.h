@@ -0,0 +1,150 @@
+#pragma once
+
+#include "Camera.h"
+#include "ConstantBuffers.h"
+#include "ConstantRingAllocator.h"
+#include "DrawQueue.h"
+#include "Frustum.h"
+#include "GraphicsBackend.h"
+#include "RecordingScheduler.h"
+#include "Vertex.h"
+
+#include <memory>
+#include <span>
+#include <vector>
+
+namespace dae
+{
+	// The engine side of a frame on any GraphicsBackend: meshes, materials and objects are plain handles, Prepare culls
+	// the objects, sorts them through a DrawQueue and writes every constant of the frame, Submit binds only the state
+	// that changes between sorted draws. The Renderer draws its frame with it on the D3D11Backend, the HeadlessBackend
+	// runs the same code without a GPU, which is what Benchmark measures.
+	//
+	// With constant buffer ranges the constants of a frame are one allocation of a ring (see ConstantRingAllocator) and
+	// every draw binds its own slice, so ranges of the sorted draws can be submitted concurrently, each to its own
+	// backend. Without them every draw rewrites one small buffer and the whole list goes to the scene's backend.
+	class BackendScene final
+	{
+	public:
+		struct Statistics
+		{
+			uint32_t numObjects{};
+			uint32_t numVisible{};
+			uint32_t numPipelineChanges{};
+			uint32_t numMaterialChanges{};
+			uint32_t numMeshChanges{};
+			// Since the scene was created, frames whose constants wrapped around the ring (all of them without no overwrite)
+			uint32_t numConstantDiscards{};
+			uint32_t constantBytes{};
+			float cullMilliseconds{};
+			float sortMilliseconds{};
+			float constantsMilliseconds{};
+			float submitMilliseconds{};
+		};
+
+	public:
+		explicit BackendScene(GraphicsBackend& backend);
+		~BackendScene();
+
+		BackendScene(const BackendScene&)				= delete;
+		BackendScene& operator=(const BackendScene&)	= delete;
+		BackendScene(BackendScene&&)					= delete;
+		BackendScene& operator=(BackendScene&&)			= delete;
+
+		// Returns the mesh index, UINT32_MAX when a buffer could not be created
+		uint32_t AddMesh(std::span<const Vertex> vertices, std::span<const uint32_t> indices, PipelineHandle pipeline);
+		// Buffers owned by the caller (see Mesh), they must outlive the scene. The same buffers may be added again with
+		// another pipeline, e.g. the instanced one.
+		uint32_t AddMesh(BufferHandle vertexBuffer, BufferHandle indexBuffer, uint32_t indexCount, const BoundingSphere& bounds, PipelineHandle pipeline);
+		// Either texture may be 0, the normal map is then not sampled. diffuseUVTransform maps the mesh UVs into a region
+		// of the diffuse map (xy scale, zw offset), e.g. of a TextureAtlas.
+		uint32_t AddMaterial(TextureHandle diffuseMap, TextureHandle normalGlossSpecularMap, const Vector4& diffuseUVTransform = { 1.0f, 1.0f, 0.0f, 0.0f });
+		uint32_t AddObject(uint32_t mesh, uint32_t material, const Matrix& world);
+		void SetObjectWorld(uint32_t object, const Matrix& world);
+		// Draws the object numInstances times with the per instance data of instanceBuffer in vertex slot 1, the world
+		// matrix of the object is ignored. The scene does not cull instances, whoever fills the buffer does (see
+		// InstanceBatch); 0 instances skips the draw.
+		void SetObjectInstances(uint32_t object, BufferHandle instanceBuffer, uint32_t instanceStride, uint32_t numInstances);
+
+		// Culls, sorts and writes the constants of the frame with one update. Between BeginFrame and EndFrame of the
+		// scene's backend, the camera matrices must be calculated.
+		void Prepare(const Camera& camera);
+		// Draws Prepare sorted, Submit takes ranges of them
+		uint32_t GetNumDraws() const;
+		// Binds and draws [range.begin, range.end) of the sorted draws, starting from no known bound state. With constant
+		// buffer ranges backend may be any backend sharing the scene backend's resources and ranges may be submitted
+		// concurrently (see D3D11RecordingTarget); without them it must be the scene's backend.
+		void Submit(GraphicsBackend& backend, RecordingRange range) const;
+		// Prepare and Submit of every draw to the scene's backend
+		void Render(const Camera& camera);
+
+		const Statistics& GetStatistics() const;
+		void PrintStatistics() const;
+
+		// Renders numFrames of numObjects cubes with a turning camera and prints the CPU time per frame
+		static void Benchmark(GraphicsBackend& backend, uint32_t numObjects = 10000, uint32_t numFrames = 100);
+
+	private:
+		struct SceneMesh
+		{
+			BufferHandle vertexBuffer;
+			BufferHandle indexBuffer;
+			uint32_t indexCount;
+			PipelineHandle pipeline;
+			BoundingSphere bounds;
+			bool isOwned;
+		};
+
+		struct SceneMaterial
+		{
+			TextureHandle diffuseMap;
+			TextureHandle normalGlossSpecularMap;
+			Vector4 diffuseUVTransform;
+		};
+
+		struct SceneObject
+		{
+			uint32_t mesh;
+			uint32_t material;
+			Matrix world;
+			// 0 for a single draw
+			BufferHandle instanceBuffer;
+			uint32_t instanceStride;
+			uint32_t numInstances;
+		};
+
+		GraphicsBackend& m_Backend;
+
+		std::vector<SceneMesh> m_Meshes{};
+		std::vector<SceneMaterial> m_Materials{};
+		std::vector<SceneObject> m_Objects{};
+
+		// Per frame, kept to avoid reallocating
+		std::vector<BoundingSphere> m_WorldBounds{};
+		std::vector<Containment> m_Containment{};
+		DrawQueue m_DrawQueue{};
+		// The constants of the frame as they are uploaded, the per frame block first
+		std::vector<uint8_t> m_Constants{};
+		bool m_IsRangeSupported{ false };
+
+		// With ranges the ring buffer and the allocation of every sorted draw, otherwise a single PerDrawConstants
+		BufferHandle m_ConstantBuffer{ 0 };
+		uint32_t m_ConstantBufferSize{ 0 };
+		std::unique_ptr<ConstantRingAllocator> m_pConstantRing{};
+		ConstantAllocation m_PerFrameAllocation{};
+		std::vector<ConstantAllocation> m_PerDrawAllocations{};
+		BufferHandle m_PerFrameBuffer{ 0 };
+
+		Statistics m_Statistics{};
+
+	private:
+		void Cull(const Camera& camera);
+		void Sort(const Camera& camera);
+		void CountStateChanges();
+		void WriteConstants(const Camera& camera);
+		// Grows the ring to hold frameSize at least numFramesInFlight times, false when the buffer could not be created
+		bool ReserveConstantRing(uint32_t frameSize);
+		bool ReserveConstantBuffer(uint32_t size);
+		static void FillConstants(const Camera& camera, const SceneObject& object, const SceneMaterial& material, PerDrawConstants& constants);
+	};
+}
@@ -0,0 +1,60 @@
+#include "pch.h"
+#include "Camera.h"
+
+namespace dae
+{
+	void Camera::Update(const Timer* pTimer)
+	{
+		const float deltaTime = pTimer->GetElapsed();
+
+		HandleKeyboardInput(deltaTime);
+		HandleMouseInput(deltaTime);
+
+		//Update Matrices
+		CalculateViewMatrix();
+		CalculateProjectionMatrix();
+	}
+
+	void Camera::HandleKeyboardInput(float dt)
+	{
+		const uint8_t* pKeyboardState = SDL_GetKeyboardState(nullptr);
+
+		const int8_t xDir = pKeyboardState[SDL_SCANCODE_D] - pKeyboardState[SDL_SCANCODE_A];
+		const int8_t zDir = pKeyboardState[SDL_SCANCODE_W] - pKeyboardState[SDL_SCANCODE_S];
+
+		origin += zDir * walkSpeed * forward * dt;
+		origin += xDir * walkSpeed * right * dt;
+	}
+
+	void Camera::HandleMouseInput(float dt)
+	{
+		int mouseX, mouseY;
+		const uint32_t mouseState = SDL_GetRelativeMouseState(&mouseX, &mouseY);
+
+		const bool isLeftMouseDown = static_cast<bool>(mouseState & SDL_BUTTON(1));
+		const bool isRightMouseDown = static_cast<bool>(mouseState & SDL_BUTTON(3));
+		const bool areBothMouseDown = isLeftMouseDown && isRightMouseDown;
+
+		SDL_SetRelativeMouseMode(static_cast<SDL_bool>(isLeftMouseDown || isRightMouseDown));
+
+		if (areBothMouseDown)
+		{
+			origin -= mouseY * dragSpeed * Vector3::UnitY * dt;
+		}
+		else if (isRightMouseDown)
+		{
+			if (mouseX != 0 || mouseY != 0)
+			{
+				SetRotation(totalPitch - mouseY * rotationSpeed, totalYaw + mouseX * rotationSpeed);
+			}
+		}
+		else if (isLeftMouseDown)
+		{
+			origin -= mouseY * dragSpeed * forward * dt;
+			if (mouseX != 0)
+			{
+				SetRotation(totalPitch, totalYaw + mouseX * rotationSpeed);
+			}
+		}
+	}
+}
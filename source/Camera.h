@@ -1,13 +1,14 @@
 #pragma once
 #include <cassert>
-#include <SDL_keyboard.h>
-#include <SDL_mouse.h>
 
-#include "Math.h"
-#include "Timer.h"
+#include "MathHelpers.h"
+#include "Matrix.h"
+#include "Transform.h"
 
 namespace dae
 {
+	class Timer;
+
 	struct Camera
 	{
 		Camera() = default;
@@ -38,6 +39,11 @@ namespace dae
 		float walkSpeed			= 5.0f;
 		float dragSpeed			= 5.0f;
 
+		//Origin and rotation, caches the view matrix until one of them changes
+		Transform transform{};
+		//Set after changing fov, aspectRatio or the planes
+		bool isProjectionDirty{ true };
+
 		Matrix invViewMatrix{};
 		Matrix viewMatrix{};
 		Matrix projectionMatrix{};
@@ -52,72 +58,41 @@ namespace dae
 			fov = tanf((fovAngle * TO_RADIANS) / 2.f);
 
 			origin = _origin;
+			isProjectionDirty = true;
 		}
 
 		void CalculateViewMatrix()
 		{
-			Matrix rotation = Matrix::CreateRotationX(totalPitch) * Matrix::CreateRotationY(totalYaw);
-			forward = rotation.GetAxisZ();
-			right = rotation.GetAxisX();
-			up = rotation.GetAxisY();
-
-			invViewMatrix = Matrix::CreateLookAtLH(origin, forward, Vector3::UnitY);
-			viewMatrix = invViewMatrix.Inverse();
+			//No roll, so the rotation keeps the x axis horizontal like CreateLookAtLH with UnitY as up
+			transform.SetPosition(origin);
+			invViewMatrix = transform.GetWorldMatrix();
+			viewMatrix = transform.GetInverseWorldMatrix();
 		}
 
 		void CalculateProjectionMatrix()
 		{
-			projectionMatrix = Matrix::CreatePerspectiveFovLH(fov, aspectRatio, nearPlane, farPlane);
-		}
-
-		void Update(const Timer* pTimer)
-		{
-			const float deltaTime = pTimer->GetElapsed();
-
-			HandleKeyboardInput(deltaTime);
-			HandleMouseInput(deltaTime);
+			if (!isProjectionDirty)
+				return;
 
-			//Update Matrices
-			CalculateViewMatrix();
-			CalculateProjectionMatrix();
+			projectionMatrix = Matrix::CreatePerspectiveFovLH(fov, aspectRatio, nearPlane, farPlane);
+			isProjectionDirty = false;
 		}
 
-		void HandleKeyboardInput(float dt)
+		void SetRotation(float pitch, float yaw)
 		{
-			const uint8_t* pKeyboardState = SDL_GetKeyboardState(nullptr);
+			totalPitch = pitch;
+			totalYaw = yaw;
 
-			const int8_t xDir = pKeyboardState[SDL_SCANCODE_D] - pKeyboardState[SDL_SCANCODE_A];
-			const int8_t zDir = pKeyboardState[SDL_SCANCODE_W] - pKeyboardState[SDL_SCANCODE_S];
-
-			origin += zDir * walkSpeed * forward * dt;
-			origin += xDir * walkSpeed * right * dt;
+			transform.SetRotation(Quaternion::CreateRotation(totalPitch, totalYaw, 0.0f));
+			forward = transform.GetForward();
+			right = transform.GetRight();
+			up = transform.GetUp();
 		}
 
-		void HandleMouseInput(float dt)
-		{
-			int mouseX, mouseY;
-			const uint32_t mouseState = SDL_GetRelativeMouseState(&mouseX, &mouseY);
-
-			const bool isLeftMouseDown = static_cast<bool>(mouseState & SDL_BUTTON(1));
-			const bool isRightMouseDown = static_cast<bool>(mouseState & SDL_BUTTON(3));
-			const bool areBothMouseDown = isLeftMouseDown && isRightMouseDown;
-
-			SDL_SetRelativeMouseMode(static_cast<SDL_bool>(isLeftMouseDown || isRightMouseDown));
-
-			if (areBothMouseDown)
-			{
-				origin -= mouseY * dragSpeed * Vector3::UnitY * dt;
-			}
-			else if (isRightMouseDown)
-			{
-				totalYaw += mouseX * rotationSpeed;
-				totalPitch -= mouseY * rotationSpeed;
-			}
-			else if (isLeftMouseDown)
-			{
-				origin -= mouseY * dragSpeed * forward * dt;
-				totalYaw += mouseX * rotationSpeed;
-			}
-		}
+		// Moves and turns with the keyboard and mouse, then updates the matrices. The input handling lives in Camera.cpp,
+		// which is the only part of the camera that needs SDL.
+		void Update(const Timer* pTimer);
+		void HandleKeyboardInput(float dt);
+		void HandleMouseInput(float dt);
 	};
 }
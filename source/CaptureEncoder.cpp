@@ -0,0 +1,151 @@
+#include "CaptureEncoder.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <fstream>
+#include <iostream>
+
+namespace dae
+{
+	CaptureEncoder::CaptureEncoder(std::string pathPrefix, Format format, PNGWriter writePNG, uint32_t maxQueuedFrames)
+		: m_PathPrefix{ std::move(pathPrefix) }
+		, m_Format{ format }
+		, m_WritePNG{ std::move(writePNG) }
+		, m_MaxQueuedFrames{ std::max(maxQueuedFrames, 1u) }
+		, m_Thread{ &CaptureEncoder::EncoderLoop, this }
+	{
+	}
+
+	CaptureEncoder::~CaptureEncoder()
+	{
+		//Frames still queued are written before the thread stops
+		{
+			const std::lock_guard lock{ m_Mutex };
+			m_IsStopping = true;
+		}
+		m_WorkCondition.notify_one();
+		m_Thread.join();
+	}
+
+	void CaptureEncoder::Encode(CapturedFrame&& frame)
+	{
+		std::unique_lock lock{ m_Mutex };
+		if (m_Queue.size() >= m_MaxQueuedFrames)
+		{
+			++m_Statistics.numBlocked;
+			m_DoneCondition.wait(lock, [this] { return m_Queue.size() < m_MaxQueuedFrames; });
+		}
+
+		m_Queue.push_back(std::move(frame));
+		lock.unlock();
+		m_WorkCondition.notify_one();
+	}
+
+	void CaptureEncoder::Finish()
+	{
+		std::unique_lock lock{ m_Mutex };
+		m_DoneCondition.wait(lock, [this] { return m_Queue.empty() && !m_IsEncoding; });
+	}
+
+	std::string CaptureEncoder::GetFilepath(const CapturedFrame& frame) const
+	{
+		char index[32]{};
+		std::snprintf(index, sizeof(index), "%06llu", static_cast<unsigned long long>(frame.frameIndex));
+
+		if (m_Format == Format::PNG)
+			return m_PathPrefix + index + ".png";
+
+		return m_PathPrefix + index + "_" + std::to_string(frame.width) + "x" + std::to_string(frame.height) + ".raw";
+	}
+
+	CaptureEncoder::Statistics CaptureEncoder::GetStatistics() const
+	{
+		const std::lock_guard lock{ m_Mutex };
+		return m_Statistics;
+	}
+
+	void CaptureEncoder::PrintStatistics() const
+	{
+		const Statistics statistics = GetStatistics();
+		std::cout << "Capture: " << statistics.numWritten << " frames written (" << statistics.bytesWritten / 1024 << " KiB of pixels)";
+		if (statistics.numFailed > 0)
+		{
+			std::cout << ", " << statistics.numFailed << " failed";
+		}
+		std::cout << ", encode " << (statistics.numWritten > 0 ? statistics.encodeMilliseconds / statistics.numWritten : 0.0f) << " ms per frame"
+			<< ", " << statistics.numBlocked << " times blocked\n";
+	}
+
+	bool CaptureEncoder::WriteRaw(const std::string& filepath, const CapturedFrame& frame)
+	{
+		std::ofstream file{ filepath, std::ios::binary };
+		if (!file)
+		{
+			std::cout << "Failed to open \"" << filepath << "\"!\n";
+			return false;
+		}
+
+		file.write(reinterpret_cast<const char*>(frame.pixels.data()), static_cast<std::streamsize>(frame.pixels.size()));
+		if (!file)
+		{
+			std::cout << "Failed to write \"" << filepath << "\"!\n";
+			return false;
+		}
+		return true;
+	}
+
+	void CaptureEncoder::EncoderLoop()
+	{
+		std::unique_lock lock{ m_Mutex };
+		while (true)
+		{
+			m_WorkCondition.wait(lock, [this] { return m_IsStopping || !m_Queue.empty(); });
+			if (m_Queue.empty())
+				return;
+
+			CapturedFrame frame = std::move(m_Queue.front());
+			m_Queue.pop_front();
+			m_IsEncoding = true;
+			lock.unlock();
+
+			//A slot in the queue is free again
+			m_DoneCondition.notify_all();
+
+			const auto start = std::chrono::steady_clock::now();
+			const size_t numBytes = frame.pixels.size();
+			const bool isWritten = Write(std::move(frame));
+			const float milliseconds = std::chrono::duration<float, std::milli>(std::chrono::steady_clock::now() - start).count();
+
+			lock.lock();
+			m_IsEncoding = false;
+			if (isWritten)
+			{
+				++m_Statistics.numWritten;
+				m_Statistics.bytesWritten += numBytes;
+				m_Statistics.encodeMilliseconds += milliseconds;
+			}
+			else
+			{
+				++m_Statistics.numFailed;
+			}
+			m_DoneCondition.notify_all();
+		}
+	}
+
+	bool CaptureEncoder::Write(CapturedFrame&& frame) const
+	{
+		const std::string filepath = GetFilepath(frame);
+		if (m_Format == Format::Raw)
+			return WriteRaw(filepath, frame);
+
+		if (!m_WritePNG)
+		{
+			std::cout << "Failed to write \"" << filepath << "\", no PNG writer!\n";
+			return false;
+		}
+
+		const Image image{ frame.width, frame.height, std::move(frame.pixels) };
+		return m_WritePNG(filepath, image);
+	}
+}
@@ -0,0 +1,85 @@
+#pragma once
+
+#include "Image.h"
+#include "ReadbackQueue.h"
+
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <string>
+#include <thread>
+
+namespace dae
+{
+	// Writes captured frames to disk on its own thread, so encoding a PNG never holds up rendering. Files are named
+	// <pathPrefix><frame index, 6 digits>.png, raw files carry their size: <pathPrefix><frame index>_<width>x<height>.raw
+	// and hold the RGBA8 rows top to bottom without a header.
+	class CaptureEncoder final
+	{
+	public:
+		enum class Format : uint8_t
+		{
+			PNG,
+			Raw
+		};
+
+		// Writes a PNG file and returns false on failure, Texture::SavePNG in the renderer
+		using PNGWriter = std::function<bool(const std::string& filepath, const Image& image)>;
+
+		struct Statistics
+		{
+			uint32_t numWritten{};
+			uint32_t numFailed{};
+			// Encodes that had to wait because maxQueuedFrames were already waiting
+			uint32_t numBlocked{};
+			// Uncompressed RGBA8
+			size_t bytesWritten{};
+			// Time spent encoding and writing, on the encoder thread
+			float encodeMilliseconds{};
+		};
+
+	public:
+		// At most maxQueuedFrames frames wait for the encoder, beyond that Encode blocks instead of piling up memory.
+		// writePNG runs on the encoder thread and is only needed for Format::PNG.
+		CaptureEncoder(std::string pathPrefix, Format format, PNGWriter writePNG, uint32_t maxQueuedFrames = 8);
+		~CaptureEncoder();
+
+		CaptureEncoder(const CaptureEncoder&)				= delete;
+		CaptureEncoder& operator=(const CaptureEncoder&)	= delete;
+		CaptureEncoder(CaptureEncoder&&)					= delete;
+		CaptureEncoder& operator=(CaptureEncoder&&)			= delete;
+
+		void Encode(CapturedFrame&& frame);
+		// Blocks until every queued frame is written
+		void Finish();
+
+		std::string GetFilepath(const CapturedFrame& frame) const;
+		// Copied under the lock, the encoder thread keeps counting
+		Statistics GetStatistics() const;
+		void PrintStatistics() const;
+
+		static bool WriteRaw(const std::string& filepath, const CapturedFrame& frame);
+
+	private:
+		const std::string m_PathPrefix;
+		const Format m_Format;
+		const PNGWriter m_WritePNG;
+		const uint32_t m_MaxQueuedFrames;
+
+		mutable std::mutex m_Mutex;
+		std::condition_variable m_WorkCondition;
+		std::condition_variable m_DoneCondition;
+		std::deque<CapturedFrame> m_Queue{};
+		bool m_IsEncoding{ false };
+		bool m_IsStopping{ false };
+
+		Statistics m_Statistics{};
+
+		std::thread m_Thread;
+
+	private:
+		void EncoderLoop();
+		bool Write(CapturedFrame&& frame) const;
+	};
+}
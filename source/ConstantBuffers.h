@@ -0,0 +1,56 @@
+#pragma once
+
+#include "Matrix.h"
+#include "Vector4.h"
+
+#include <cstddef>
+#include <cstdint>
+
+namespace dae
+{
+	// C++ side of the cbuffers in PosCol3D.fx. The matrices are declared row_major there, so they are copied as they are.
+	// HLSL packs constants in 16 byte registers and no member may straddle one, the asserts below pin every offset.
+
+	// cbPerFrame, register b0
+	struct PerFrameConstants
+	{
+		Matrix viewInverse;
+		Matrix viewProjection;
+	};
+
+	// cbPerDraw, register b1
+	struct PerDrawConstants
+	{
+		Matrix worldViewProjection;
+		Matrix world;
+		// xy scale, zw offset
+		Vector4 diffuseUVTransform;
+		// HLSL bool is 4 bytes
+		uint32_t useNormalGlossSpecularMap;
+		uint32_t padding[3];
+	};
+
+	namespace ConstantBuffers
+	{
+		static constexpr uint32_t PerFrameSlot{ 0 };
+		static constexpr uint32_t PerDrawSlot{ 1 };
+
+		template<typename T>
+		constexpr bool IsRegisterPacked()
+		{
+			return sizeof(T) % 16 == 0 && alignof(T) <= 16;
+		}
+	}
+
+	static_assert(ConstantBuffers::IsRegisterPacked<PerFrameConstants>(), "cbPerFrame must cover whole registers");
+	static_assert(offsetof(PerFrameConstants, viewInverse) == 0, "cbPerFrame layout");
+	static_assert(offsetof(PerFrameConstants, viewProjection) == 64, "cbPerFrame layout");
+	static_assert(sizeof(PerFrameConstants) == 128, "cbPerFrame layout");
+
+	static_assert(ConstantBuffers::IsRegisterPacked<PerDrawConstants>(), "cbPerDraw must cover whole registers");
+	static_assert(offsetof(PerDrawConstants, worldViewProjection) == 0, "cbPerDraw layout");
+	static_assert(offsetof(PerDrawConstants, world) == 64, "cbPerDraw layout");
+	static_assert(offsetof(PerDrawConstants, diffuseUVTransform) == 128, "cbPerDraw layout");
+	static_assert(offsetof(PerDrawConstants, useNormalGlossSpecularMap) == 144, "cbPerDraw layout");
+	static_assert(sizeof(PerDrawConstants) == 160, "cbPerDraw layout");
+}
@@ -0,0 +1,91 @@
+#include "ConstantRingAllocator.h"
+
+#include <cassert>
+
+namespace dae
+{
+	ConstantRingAllocator::ConstantRingAllocator(uint32_t capacity)
+		: m_Capacity{ capacity / Alignment * Alignment }
+	{
+	}
+
+	bool ConstantRingAllocator::BeginFrame(uint32_t numBytes, MapMode& mapMode)
+	{
+		assert(!m_IsInFrame);
+
+		const uint32_t frameSize = AlignUp(numBytes, Alignment);
+		if (frameSize > m_Capacity)
+			return false;
+
+		//The first frame and every wrap start at 0, nothing says the GPU is done with the old contents there
+		if (m_Head == 0 || m_Head + frameSize > m_Capacity)
+		{
+			m_FrameOffset = 0;
+			mapMode = MapMode::Discard;
+		}
+		else
+		{
+			m_FrameOffset = m_Head;
+			mapMode = MapMode::NoOverwrite;
+		}
+
+		m_FrameSize = frameSize;
+		m_FrameUsed = 0;
+		m_IsInFrame = true;
+		return true;
+	}
+
+	bool ConstantRingAllocator::Allocate(uint32_t size, ConstantAllocation& allocation)
+	{
+		const uint32_t allocationSize = GetAllocationSize(size);
+		if (!m_IsInFrame || size == 0 || m_FrameUsed + allocationSize > m_FrameSize)
+			return false;
+
+		allocation.offset = m_FrameOffset + m_FrameUsed;
+		allocation.size = allocationSize;
+		m_FrameUsed += allocationSize;
+		return true;
+	}
+
+	void ConstantRingAllocator::EndFrame()
+	{
+		assert(m_IsInFrame);
+
+		//Only the used part is in flight, the next frame may start right after it
+		m_Head = m_FrameOffset + m_FrameUsed;
+		if (m_Head >= m_Capacity)
+		{
+			m_Head = 0;
+		}
+		m_IsInFrame = false;
+	}
+
+	void ConstantRingAllocator::Reset()
+	{
+		m_Head = 0;
+		m_IsInFrame = false;
+	}
+
+	uint32_t ConstantRingAllocator::GetCapacity() const
+	{
+		return m_Capacity;
+	}
+
+	uint32_t ConstantRingAllocator::GetFrameOffset() const
+	{
+		return m_FrameOffset;
+	}
+
+	uint32_t ConstantRingAllocator::GetFrameSize() const
+	{
+		return m_FrameSize;
+	}
+
+	void ConstantRingAllocator::GetConstantRange(const ConstantAllocation& allocation, uint32_t& firstConstant, uint32_t& numConstants)
+	{
+		assert(allocation.offset % Alignment == 0 && allocation.size % Alignment == 0);
+
+		firstConstant = allocation.offset / ConstantSize;
+		numConstants = allocation.size / ConstantSize;
+	}
+}
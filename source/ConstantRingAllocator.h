@@ -0,0 +1,77 @@
+#pragma once
+
+#include <cstdint>
+
+namespace dae
+{
+	// Byte range of one allocation inside the ring
+	struct ConstantAllocation
+	{
+		uint32_t offset{};
+		uint32_t size{};
+	};
+
+	// Offsets and alignment of a per frame constant buffer ring, no D3D types in here so it behaves the same on every platform.
+	// Every frame takes one contiguous range after the previous frame. A frame that does not fit in the space left wraps
+	// to the start, which must be mapped with discard; every other frame can be mapped without overwriting frames in flight.
+	class ConstantRingAllocator final
+	{
+	public:
+		// *SetConstantBuffers1 offsets and sizes are counted in 16 byte constants and must be multiples of 16 constants
+		static constexpr uint32_t ConstantSize{ 16 };
+		static constexpr uint32_t Alignment{ 256 };
+
+		enum class MapMode
+		{
+			NoOverwrite,
+			Discard
+		};
+
+	public:
+		// capacity is rounded down to the alignment
+		explicit ConstantRingAllocator(uint32_t capacity);
+		~ConstantRingAllocator() = default;
+
+		ConstantRingAllocator(const ConstantRingAllocator&)				= delete;
+		ConstantRingAllocator& operator=(const ConstantRingAllocator&)	= delete;
+		ConstantRingAllocator(ConstantRingAllocator&&)					= delete;
+		ConstantRingAllocator& operator=(ConstantRingAllocator&&)		= delete;
+
+		// Reserves numBytes (sum of GetAllocationSize of the frame) for a new frame. False when it exceeds the capacity.
+		bool BeginFrame(uint32_t numBytes, MapMode& mapMode);
+		// False when the frame is full or no frame was begun
+		bool Allocate(uint32_t size, ConstantAllocation& allocation);
+		void EndFrame();
+		// The next frame starts at 0 and is mapped with discard
+		void Reset();
+
+		uint32_t GetCapacity() const;
+		uint32_t GetFrameOffset() const;
+		uint32_t GetFrameSize() const;
+
+		static constexpr uint32_t AlignUp(uint32_t value, uint32_t alignment);
+		// Bytes a single allocation of size takes from the ring
+		static constexpr uint32_t GetAllocationSize(uint32_t size);
+		// First constant and number of constants for *SetConstantBuffers1
+		static void GetConstantRange(const ConstantAllocation& allocation, uint32_t& firstConstant, uint32_t& numConstants);
+
+	private:
+		uint32_t m_Capacity;
+		// End of the last frame
+		uint32_t m_Head{ 0 };
+		uint32_t m_FrameOffset{ 0 };
+		uint32_t m_FrameSize{ 0 };
+		uint32_t m_FrameUsed{ 0 };
+		bool m_IsInFrame{ false };
+	};
+
+	constexpr uint32_t ConstantRingAllocator::AlignUp(uint32_t value, uint32_t alignment)
+	{
+		return (value + alignment - 1) / alignment * alignment;
+	}
+
+	constexpr uint32_t ConstantRingAllocator::GetAllocationSize(uint32_t size)
+	{
+		return AlignUp(size, Alignment);
+	}
+}
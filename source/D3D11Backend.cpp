@@ -0,0 +1,335 @@
+#include "pch.h"
+#include "D3D11Backend.h"
+#include "Texture.h"
+
+namespace dae
+{
+	D3D11Backend::Resources::~Resources()
+	{
+		for (ID3D11Buffer* pBuffer : buffers)
+		{
+			if (pBuffer) pBuffer->Release();
+		}
+
+		for (Texture& texture : textures)
+		{
+			if (texture.pShaderResourceView) texture.pShaderResourceView->Release();
+			if (texture.pTexture) texture.pTexture->Release();
+		}
+	}
+
+	D3D11Backend::D3D11Backend(ID3D11Device* pDevice, D3D11StateFilter& stateFilter, EffectCache& effectCache)
+		: m_pResources{ std::make_shared<Resources>(pDevice, effectCache, false) }
+		, m_StateFilter{ stateFilter }
+	{
+		D3D11_FEATURE_DATA_D3D11_OPTIONS options{};
+		if (SUCCEEDED(pDevice->CheckFeatureSupport(D3D11_FEATURE_D3D11_OPTIONS, &options, sizeof(options))))
+		{
+			m_pResources->isNoOverwriteSupported = options.MapNoOverwriteOnDynamicConstantBuffer;
+		}
+	}
+
+	D3D11Backend::D3D11Backend(D3D11StateFilter& stateFilter, const D3D11Backend& sharedBackend)
+		: m_pResources{ sharedBackend.m_pResources }
+		, m_StateFilter{ stateFilter }
+	{
+	}
+
+	BufferHandle D3D11Backend::CreateBuffer(const BufferDesc& desc, const void* pInitialData)
+	{
+		D3D11_BUFFER_DESC bufferDesc{};
+		bufferDesc.Usage			= desc.isDynamic ? D3D11_USAGE_DYNAMIC : D3D11_USAGE_IMMUTABLE;
+		bufferDesc.ByteWidth		= desc.size;
+		bufferDesc.CPUAccessFlags	= desc.isDynamic ? D3D11_CPU_ACCESS_WRITE : 0;
+		bufferDesc.MiscFlags		= 0;
+
+		switch (desc.usage)
+		{
+		case BufferUsage::Vertex:
+			bufferDesc.BindFlags = D3D11_BIND_VERTEX_BUFFER;
+			break;
+		case BufferUsage::Index:
+			bufferDesc.BindFlags = D3D11_BIND_INDEX_BUFFER;
+			break;
+		case BufferUsage::Constant:
+			//Constant buffers are sized in whole registers
+			bufferDesc.BindFlags = D3D11_BIND_CONSTANT_BUFFER;
+			bufferDesc.ByteWidth = (desc.size + 15) / 16 * 16;
+			break;
+		}
+
+		D3D11_SUBRESOURCE_DATA initData{};
+		initData.pSysMem = pInitialData;
+
+		ID3D11Buffer* pBuffer{ nullptr };
+		const HRESULT result = m_pResources->pDevice->CreateBuffer(&bufferDesc, pInitialData != nullptr ? &initData : nullptr, &pBuffer);
+		if (FAILED(result))
+		{
+			std::cout << "Failed to create backend buffer!\n";
+			return 0;
+		}
+
+		m_pResources->buffers.push_back(pBuffer);
+		return static_cast<BufferHandle>(m_pResources->buffers.size());
+	}
+
+	bool D3D11Backend::UpdateBuffer(BufferHandle buffer, const void* pData, uint32_t size, uint32_t offset, bool isDiscarding)
+	{
+		ID3D11Buffer* pBuffer = GetBuffer(buffer);
+		if (pBuffer == nullptr)
+			return false;
+
+		ID3D11DeviceContext* pDeviceContext = m_StateFilter.GetTarget().pDeviceContext;
+
+		//No overwrite promises not to touch what the GPU may still read, so the mapped pointer keeps the old contents
+		D3D11_MAPPED_SUBRESOURCE mappedResource{};
+		if (FAILED(pDeviceContext->Map(pBuffer, 0, isDiscarding ? D3D11_MAP_WRITE_DISCARD : D3D11_MAP_WRITE_NO_OVERWRITE, 0, &mappedResource)))
+		{
+			std::cout << "Failed to map backend buffer!\n";
+			return false;
+		}
+
+		std::memcpy(static_cast<uint8_t*>(mappedResource.pData) + offset, pData, size);
+		pDeviceContext->Unmap(pBuffer, 0);
+		return true;
+	}
+
+	void D3D11Backend::DestroyBuffer(BufferHandle buffer)
+	{
+		ID3D11Buffer* pBuffer = GetBuffer(buffer);
+		if (pBuffer == nullptr)
+			return;
+
+		pBuffer->Release();
+		m_pResources->buffers[buffer - 1] = nullptr;
+	}
+
+	TextureHandle D3D11Backend::CreateTexture(const TextureDesc& desc, const void* pPixels)
+	{
+		//Sampled textures only, render targets belong to the RenderGraph
+		DXGI_FORMAT format{ DXGI_FORMAT_R8G8B8A8_UNORM };
+		uint32_t bytesPerPixel{ 4 };
+		switch (desc.format)
+		{
+		case RenderGraphFormat::RGBA8:
+			format = DXGI_FORMAT_R8G8B8A8_UNORM;
+			break;
+		case RenderGraphFormat::RGBA16Float:
+			format = DXGI_FORMAT_R16G16B16A16_FLOAT;
+			bytesPerPixel = 8;
+			break;
+		case RenderGraphFormat::R32Float:
+			format = DXGI_FORMAT_R32_FLOAT;
+			break;
+		case RenderGraphFormat::Depth24Stencil8:
+			std::cout << "Failed to create backend texture, depth textures cannot be sampled from memory!\n";
+			return 0;
+		}
+
+		D3D11_TEXTURE2D_DESC textureDesc{};
+		textureDesc.Width				= desc.width;
+		textureDesc.Height				= desc.height;
+		textureDesc.MipLevels			= 1;
+		textureDesc.ArraySize			= 1;
+		textureDesc.Format				= format;
+		textureDesc.SampleDesc.Count	= 1;
+		textureDesc.SampleDesc.Quality	= 0;
+		textureDesc.Usage				= D3D11_USAGE_DEFAULT;
+		textureDesc.BindFlags			= D3D11_BIND_SHADER_RESOURCE;
+		textureDesc.CPUAccessFlags		= 0;
+		textureDesc.MiscFlags			= 0;
+
+		D3D11_SUBRESOURCE_DATA initData{};
+		initData.pSysMem			= pPixels;
+		initData.SysMemPitch		= desc.width * bytesPerPixel;
+		initData.SysMemSlicePitch	= desc.width * desc.height * bytesPerPixel;
+
+		Texture texture{};
+		HRESULT result = m_pResources->pDevice->CreateTexture2D(&textureDesc, pPixels != nullptr ? &initData : nullptr, &texture.pTexture);
+		if (FAILED(result))
+		{
+			std::cout << "Failed to create backend texture!\n";
+			return 0;
+		}
+
+		result = m_pResources->pDevice->CreateShaderResourceView(texture.pTexture, nullptr, &texture.pShaderResourceView);
+		if (FAILED(result))
+		{
+			std::cout << "Failed to create backend shader resource view!\n";
+			texture.pTexture->Release();
+			return 0;
+		}
+
+		m_pResources->textures.push_back(texture);
+		return static_cast<TextureHandle>(m_pResources->textures.size());
+	}
+
+	TextureHandle D3D11Backend::ImportTexture(const dae::Texture* pTexture)
+	{
+		if (pTexture == nullptr)
+			return 0;
+
+		m_pResources->textures.push_back({ nullptr, nullptr, pTexture });
+		return static_cast<TextureHandle>(m_pResources->textures.size());
+	}
+
+	void D3D11Backend::DestroyTexture(TextureHandle texture)
+	{
+		if (texture == 0 || texture > m_pResources->textures.size())
+			return;
+
+		Texture& destroyedTexture = m_pResources->textures[texture - 1];
+		if (destroyedTexture.pShaderResourceView) destroyedTexture.pShaderResourceView->Release();
+		if (destroyedTexture.pTexture) destroyedTexture.pTexture->Release();
+		destroyedTexture = {};
+	}
+
+	PipelineHandle D3D11Backend::CreatePipeline(const PipelineDesc& desc)
+	{
+		std::shared_ptr<Effect> pEffect = m_pResources->effectCache.Get(desc.effectFile, desc.defines);
+		if (!pEffect)
+			return 0;
+
+		m_pResources->pipelines.push_back({ std::move(pEffect), desc.passIndex });
+		return static_cast<PipelineHandle>(m_pResources->pipelines.size());
+	}
+
+	void D3D11Backend::DestroyPipeline(PipelineHandle pipeline)
+	{
+		if (pipeline != 0 && pipeline <= m_pResources->pipelines.size())
+		{
+			m_pResources->pipelines[pipeline - 1] = {};
+		}
+	}
+
+	bool D3D11Backend::IsConstantBufferRangeSupported() const
+	{
+		return m_StateFilter.GetTarget().pDeviceContext1 != nullptr;
+	}
+
+	bool D3D11Backend::IsConstantBufferNoOverwriteSupported() const
+	{
+		return m_pResources->isNoOverwriteSupported;
+	}
+
+	void D3D11Backend::BeginFrame()
+	{
+	}
+
+	void D3D11Backend::EndFrame()
+	{
+	}
+
+	void D3D11Backend::SetPipeline(PipelineHandle pipeline)
+	{
+		m_Pipeline = pipeline;
+	}
+
+	void D3D11Backend::SetVertexBuffers(uint32_t startSlot, uint32_t numBuffers, const BufferHandle* pBuffers, const uint32_t* pStrides, const uint32_t* pOffsets)
+	{
+		std::array<ID3D11Buffer*, D3D11StateFilter::MaxVertexBuffers> pD3DBuffers{};
+		numBuffers = std::min(numBuffers, static_cast<uint32_t>(pD3DBuffers.size()));
+		for (uint32_t i = 0; i < numBuffers; ++i)
+		{
+			pD3DBuffers[i] = GetBuffer(pBuffers[i]);
+		}
+
+		//Effect passes leave the input assembler alone, so this can go straight to the filter
+		m_StateFilter.IASetVertexBuffers(startSlot, numBuffers, pD3DBuffers.data(), pStrides, pOffsets);
+	}
+
+	void D3D11Backend::SetIndexBuffer(BufferHandle buffer)
+	{
+		m_StateFilter.IASetIndexBuffer(GetBuffer(buffer), DXGI_FORMAT_R32_UINT, 0);
+	}
+
+	void D3D11Backend::SetConstantBuffer(uint32_t slot, BufferHandle buffer, uint32_t firstConstant, uint32_t numConstants)
+	{
+		if (slot >= m_ConstantBindings.size())
+			return;
+
+		m_ConstantBindings[slot] = { GetBuffer(buffer), firstConstant, numConstants };
+		m_NumConstantBindings = std::max(m_NumConstantBindings, slot + 1);
+	}
+
+	void D3D11Backend::SetTexture(uint32_t slot, TextureHandle texture)
+	{
+		if (slot >= m_TextureBindings.size())
+			return;
+
+		m_TextureBindings[slot] = GetShaderResourceView(texture);
+		m_NumTextureBindings = std::max(m_NumTextureBindings, slot + 1);
+	}
+
+	void D3D11Backend::DrawIndexed(uint32_t indexCount, uint32_t startIndex, int32_t baseVertex)
+	{
+		if (PrepareDraw())
+		{
+			m_StateFilter.DrawIndexed(indexCount, startIndex, baseVertex);
+		}
+	}
+
+	void D3D11Backend::DrawIndexedInstanced(uint32_t indexCount, uint32_t instanceCount, uint32_t startIndex, int32_t baseVertex, uint32_t startInstance)
+	{
+		if (PrepareDraw())
+		{
+			m_StateFilter.DrawIndexedInstanced(indexCount, instanceCount, startIndex, baseVertex, startInstance);
+		}
+	}
+
+	D3D11StateFilter& D3D11Backend::GetStateFilter() const
+	{
+		return m_StateFilter;
+	}
+
+	ID3D11Buffer* D3D11Backend::GetBuffer(BufferHandle buffer) const
+	{
+		const std::vector<ID3D11Buffer*>& buffers = m_pResources->buffers;
+		return buffer != 0 && buffer <= buffers.size() ? buffers[buffer - 1] : nullptr;
+	}
+
+	ID3D11ShaderResourceView* D3D11Backend::GetShaderResourceView(TextureHandle texture) const
+	{
+		if (texture == 0 || texture > m_pResources->textures.size())
+			return nullptr;
+
+		const Texture& backendTexture = m_pResources->textures[texture - 1];
+		return backendTexture.pImported != nullptr ? backendTexture.pImported->GetShaderResourceView() : backendTexture.pShaderResourceView;
+	}
+
+	bool D3D11Backend::PrepareDraw()
+	{
+		const std::vector<Pipeline>& pipelines = m_pResources->pipelines;
+		if (m_Pipeline == 0 || m_Pipeline > pipelines.size() || !pipelines[m_Pipeline - 1].pEffect)
+			return false;
+
+		const Pipeline& pipeline = pipelines[m_Pipeline - 1];
+		Effect* pEffect = pipeline.pEffect.get();
+
+		m_StateFilter.IASetPrimitiveTopology(D3D11_PRIMITIVE_TOPOLOGY_TRIANGLELIST);
+		m_StateFilter.IASetInputLayout(pEffect->GetInputLayout());
+
+		{
+			const std::lock_guard lock{ pEffect->GetMutex() };
+			m_StateFilter.ApplyPass(pEffect->GetTechnique()->GetPassByIndex(pipeline.passIndex), pEffect->GetVariablesVersion());
+		}
+
+		const bool isRangeSupported = IsConstantBufferRangeSupported();
+		for (uint32_t slot = 0; slot < m_NumConstantBindings; ++slot)
+		{
+			const ConstantBinding& binding = m_ConstantBindings[slot];
+			if (binding.pBuffer == nullptr)
+				continue;
+
+			const bool isRange = isRangeSupported && binding.numConstants != 0;
+			m_StateFilter.VSSetConstantBuffers(slot, 1, &binding.pBuffer, isRange ? &binding.firstConstant : nullptr, isRange ? &binding.numConstants : nullptr);
+			m_StateFilter.PSSetConstantBuffers(slot, 1, &binding.pBuffer, isRange ? &binding.firstConstant : nullptr, isRange ? &binding.numConstants : nullptr);
+		}
+
+		if (m_NumTextureBindings > 0)
+		{
+			m_StateFilter.PSSetShaderResources(0, m_NumTextureBindings, m_TextureBindings.data());
+		}
+		return true;
+	}
+}
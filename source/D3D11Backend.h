@@ -0,0 +1,117 @@
+#pragma once
+
+#include "D3D11StateFilter.h"
+#include "EffectCache.h"
+#include "GraphicsBackend.h"
+
+#include <array>
+
+namespace dae
+{
+	class Texture;
+
+	// GraphicsBackend on a D3D11 immediate or deferred context. Pipelines are effect passes from an EffectCache, binding
+	// goes through a StateFilter. Applying a pass binds the effect's own constant buffers and textures, so the backend's
+	// bindings are bound again on top right before each draw; the filter drops the ones that did not change.
+	//
+	// A backend for a deferred context is created from the immediate one and shares its buffers, textures and pipelines,
+	// handles are valid on both. Resources are created and destroyed on the immediate backend only, never while ranges
+	// are recorded (see D3D11RecordingTarget).
+	class D3D11Backend final : public GraphicsBackend
+	{
+	public:
+		D3D11Backend(ID3D11Device* pDevice, D3D11StateFilter& stateFilter, EffectCache& effectCache);
+		// Draws through stateFilter with the resources of sharedBackend
+		D3D11Backend(D3D11StateFilter& stateFilter, const D3D11Backend& sharedBackend);
+		~D3D11Backend() override = default;
+
+		D3D11Backend(const D3D11Backend&)				= delete;
+		D3D11Backend& operator=(const D3D11Backend&)	= delete;
+		D3D11Backend(D3D11Backend&&)					= delete;
+		D3D11Backend& operator=(D3D11Backend&&)			= delete;
+
+		BufferHandle CreateBuffer(const BufferDesc& desc, const void* pInitialData) override;
+		bool UpdateBuffer(BufferHandle buffer, const void* pData, uint32_t size, uint32_t offset, bool isDiscarding) override;
+		void DestroyBuffer(BufferHandle buffer) override;
+
+		TextureHandle CreateTexture(const TextureDesc& desc, const void* pPixels) override;
+		// A texture owned by the caller, which must outlive the handle. Its view is looked up on every bind, so mips that
+		// TextureResidency evicts or restores are picked up; DestroyTexture only forgets it.
+		TextureHandle ImportTexture(const dae::Texture* pTexture);
+		void DestroyTexture(TextureHandle texture) override;
+
+		PipelineHandle CreatePipeline(const PipelineDesc& desc) override;
+		void DestroyPipeline(PipelineHandle pipeline) override;
+
+		bool IsConstantBufferRangeSupported() const override;
+		bool IsConstantBufferNoOverwriteSupported() const override;
+
+		// Nothing to do, the swap chain is presented by the Renderer
+		void BeginFrame() override;
+		void EndFrame() override;
+
+		void SetPipeline(PipelineHandle pipeline) override;
+		void SetVertexBuffers(uint32_t startSlot, uint32_t numBuffers, const BufferHandle* pBuffers, const uint32_t* pStrides, const uint32_t* pOffsets) override;
+		void SetIndexBuffer(BufferHandle buffer) override;
+		void SetConstantBuffer(uint32_t slot, BufferHandle buffer, uint32_t firstConstant, uint32_t numConstants) override;
+		void SetTexture(uint32_t slot, TextureHandle texture) override;
+
+		void DrawIndexed(uint32_t indexCount, uint32_t startIndex, int32_t baseVertex) override;
+		void DrawIndexedInstanced(uint32_t indexCount, uint32_t instanceCount, uint32_t startIndex, int32_t baseVertex, uint32_t startInstance) override;
+
+		D3D11StateFilter& GetStateFilter() const;
+
+	private:
+		struct Texture
+		{
+			ID3D11Texture2D* pTexture;
+			ID3D11ShaderResourceView* pShaderResourceView;
+			// Set instead of the two above for imported textures
+			const dae::Texture* pImported;
+		};
+
+		struct Pipeline
+		{
+			std::shared_ptr<Effect> pEffect;
+			uint32_t passIndex;
+		};
+
+		// Shared by the immediate backend and the ones of its deferred contexts
+		struct Resources
+		{
+			ID3D11Device* pDevice;
+			EffectCache& effectCache;
+			// D3D 11.1 allows mapping dynamic constant buffers with no overwrite
+			bool isNoOverwriteSupported;
+
+			// Index is handle - 1, destroyed entries stay empty
+			std::vector<ID3D11Buffer*> buffers{};
+			std::vector<Texture> textures{};
+			std::vector<Pipeline> pipelines{};
+
+			~Resources();
+		};
+
+		struct ConstantBinding
+		{
+			ID3D11Buffer* pBuffer;
+			uint32_t firstConstant;
+			uint32_t numConstants;
+		};
+
+		std::shared_ptr<Resources> m_pResources;
+		D3D11StateFilter& m_StateFilter;
+
+		PipelineHandle m_Pipeline{ 0 };
+		std::array<ConstantBinding, D3D11StateFilter::MaxConstantBuffers> m_ConstantBindings{};
+		uint32_t m_NumConstantBindings{ 0 };
+		std::array<ID3D11ShaderResourceView*, D3D11StateFilter::MaxShaderResources> m_TextureBindings{};
+		uint32_t m_NumTextureBindings{ 0 };
+
+	private:
+		ID3D11Buffer* GetBuffer(BufferHandle buffer) const;
+		ID3D11ShaderResourceView* GetShaderResourceView(TextureHandle texture) const;
+		// Applies the pipeline and binds constant buffers and textures on top, false without a pipeline
+		bool PrepareDraw();
+	};
+}
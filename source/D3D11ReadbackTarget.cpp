@@ -0,0 +1,103 @@
+#include "pch.h"
+#include "D3D11ReadbackTarget.h"
+
+#include <cassert>
+
+namespace dae
+{
+	D3D11ReadbackTarget::D3D11ReadbackTarget(ID3D11Device* pDevice, ID3D11DeviceContext* pDeviceContext, ID3D11Texture2D* pSource, uint32_t numSlots)
+		: m_pDeviceContext{ pDeviceContext }
+		, m_pSource{ pSource }
+	{
+		D3D11_TEXTURE2D_DESC sourceDesc{};
+		pSource->GetDesc(&sourceDesc);
+		if (sourceDesc.Format != DXGI_FORMAT_R8G8B8A8_UNORM || sourceDesc.SampleDesc.Count != 1)
+		{
+			std::cout << "Failed to create readback target, the source must be single sampled RGBA8!\n";
+			return;
+		}
+
+		m_Width = sourceDesc.Width;
+		m_Height = sourceDesc.Height;
+
+		D3D11_TEXTURE2D_DESC stagingDesc{};
+		stagingDesc.Width				= sourceDesc.Width;
+		stagingDesc.Height				= sourceDesc.Height;
+		stagingDesc.MipLevels			= 1;
+		stagingDesc.ArraySize			= 1;
+		stagingDesc.Format				= sourceDesc.Format;
+		stagingDesc.SampleDesc.Count	= 1;
+		stagingDesc.SampleDesc.Quality	= 0;
+		stagingDesc.Usage				= D3D11_USAGE_STAGING;
+		stagingDesc.BindFlags			= 0;
+		stagingDesc.CPUAccessFlags		= D3D11_CPU_ACCESS_READ;
+		stagingDesc.MiscFlags			= 0;
+
+		m_StagingTextures.reserve(numSlots);
+		for (uint32_t i = 0; i < numSlots; ++i)
+		{
+			ID3D11Texture2D* pStagingTexture{ nullptr };
+			if (FAILED(pDevice->CreateTexture2D(&stagingDesc, nullptr, &pStagingTexture)))
+			{
+				std::cout << "Failed to create staging texture!\n";
+				break;
+			}
+			m_StagingTextures.push_back(pStagingTexture);
+		}
+	}
+
+	D3D11ReadbackTarget::~D3D11ReadbackTarget()
+	{
+		for (ID3D11Texture2D* pStagingTexture : m_StagingTextures)
+		{
+			pStagingTexture->Release();
+		}
+	}
+
+	uint32_t D3D11ReadbackTarget::GetNumSlots() const
+	{
+		return static_cast<uint32_t>(m_StagingTextures.size());
+	}
+
+	uint32_t D3D11ReadbackTarget::GetWidth() const
+	{
+		return m_Width;
+	}
+
+	uint32_t D3D11ReadbackTarget::GetHeight() const
+	{
+		return m_Height;
+	}
+
+	void D3D11ReadbackTarget::Copy(uint32_t slot)
+	{
+		assert(slot < m_StagingTextures.size());
+
+		m_pDeviceContext->CopyResource(m_StagingTextures[slot], m_pSource);
+	}
+
+	ReadbackStatus D3D11ReadbackTarget::Map(uint32_t slot, bool isWaiting, const uint8_t*& pData, uint32_t& rowPitch)
+	{
+		assert(slot < m_StagingTextures.size());
+
+		D3D11_MAPPED_SUBRESOURCE mappedResource{};
+		const HRESULT result = m_pDeviceContext->Map(m_StagingTextures[slot], 0, D3D11_MAP_READ, isWaiting ? 0 : D3D11_MAP_FLAG_DO_NOT_WAIT, &mappedResource);
+		if (result == DXGI_ERROR_WAS_STILL_DRAWING)
+			return ReadbackStatus::Pending;
+
+		if (FAILED(result))
+		{
+			std::cout << "Failed to map staging texture!\n";
+			return ReadbackStatus::Failed;
+		}
+
+		pData = static_cast<const uint8_t*>(mappedResource.pData);
+		rowPitch = mappedResource.RowPitch;
+		return ReadbackStatus::Ready;
+	}
+
+	void D3D11ReadbackTarget::Unmap(uint32_t slot)
+	{
+		m_pDeviceContext->Unmap(m_StagingTextures[slot], 0);
+	}
+}
@@ -0,0 +1,42 @@
+#pragma once
+
+#include "ReadbackQueue.h"
+
+#include <vector>
+
+namespace dae
+{
+	// Staging textures for a ReadbackQueue. Copy queues a CopyResource from the source texture, Map polls with
+	// DO_NOT_WAIT so a copy the GPU has not reached yet reports Pending instead of blocking the render thread.
+	class D3D11ReadbackTarget final
+	{
+	public:
+		// pSource is an RGBA8 texture without multisampling, the slots are created to match it
+		D3D11ReadbackTarget(ID3D11Device* pDevice, ID3D11DeviceContext* pDeviceContext, ID3D11Texture2D* pSource, uint32_t numSlots = 3);
+		~D3D11ReadbackTarget();
+
+		D3D11ReadbackTarget(const D3D11ReadbackTarget&)				= delete;
+		D3D11ReadbackTarget& operator=(const D3D11ReadbackTarget&)	= delete;
+		D3D11ReadbackTarget(D3D11ReadbackTarget&&)					= delete;
+		D3D11ReadbackTarget& operator=(D3D11ReadbackTarget&&)		= delete;
+
+		// 0 when the staging textures could not be created
+		uint32_t GetNumSlots() const;
+		uint32_t GetWidth() const;
+		uint32_t GetHeight() const;
+
+		void Copy(uint32_t slot);
+		ReadbackStatus Map(uint32_t slot, bool isWaiting, const uint8_t*& pData, uint32_t& rowPitch);
+		void Unmap(uint32_t slot);
+
+	private:
+		ID3D11DeviceContext* m_pDeviceContext;
+		ID3D11Texture2D* m_pSource;
+		std::vector<ID3D11Texture2D*> m_StagingTextures{};
+
+		uint32_t m_Width{};
+		uint32_t m_Height{};
+	};
+
+	using D3D11ReadbackQueue = ReadbackQueue<D3D11ReadbackTarget>;
+}
@@ -0,0 +1,97 @@
+#include "pch.h"
+#include "D3D11RecordingTarget.h"
+
+#include <cassert>
+
+namespace dae
+{
+	D3D11DeferredContexts::D3D11DeferredContexts(ID3D11Device* pDevice, D3D11Backend* pImmediateBackend, uint32_t numContexts)
+		: m_pImmediateBackend{ pImmediateBackend }
+	{
+		if (numContexts == 0)
+		{
+			numContexts = static_cast<uint32_t>(std::max(SDL_GetCPUCount(), 1));
+		}
+
+		//Without driver command lists the runtime emulates them, recording still runs in parallel but executing costs more
+		D3D11_FEATURE_DATA_THREADING threading{};
+		const HRESULT result = pDevice->CheckFeatureSupport(D3D11_FEATURE_THREADING, &threading, sizeof(threading));
+		if (FAILED(result) || !threading.DriverCommandLists)
+		{
+			std::cout << "Driver command lists are not supported, deferred contexts are emulated\n";
+		}
+
+		m_DeferredContexts.reserve(numContexts);
+		for (uint32_t i = 0; i < numContexts; ++i)
+		{
+			ID3D11DeviceContext* pDeviceContext{ nullptr };
+			if (FAILED(pDevice->CreateDeferredContext(0, &pDeviceContext)))
+			{
+				std::cout << "Failed to create deferred context!\n";
+				break;
+			}
+
+			//Only needed for constant buffer ranges
+			ID3D11DeviceContext1* pDeviceContext1{ nullptr };
+			if (FAILED(pDeviceContext->QueryInterface(IID_PPV_ARGS(&pDeviceContext1))))
+			{
+				pDeviceContext1 = nullptr;
+			}
+
+			auto pStateFilter = std::make_unique<D3D11StateFilter>(D3D11StateTarget{ pDeviceContext, pDeviceContext1 });
+			auto pBackend = std::make_unique<D3D11Backend>(*pStateFilter, *m_pImmediateBackend);
+			m_DeferredContexts.push_back({ pDeviceContext, pDeviceContext1, std::move(pStateFilter), std::move(pBackend) });
+		}
+	}
+
+	D3D11DeferredContexts::~D3D11DeferredContexts()
+	{
+		for (DeferredContext& deferredContext : m_DeferredContexts)
+		{
+			if (deferredContext.pDeviceContext1) deferredContext.pDeviceContext1->Release();
+			deferredContext.pDeviceContext->Release();
+		}
+	}
+
+	uint32_t D3D11DeferredContexts::GetNumDeferredContexts() const
+	{
+		return static_cast<uint32_t>(m_DeferredContexts.size());
+	}
+
+	D3D11Backend& D3D11DeferredContexts::GetImmediateBackend() const
+	{
+		return *m_pImmediateBackend;
+	}
+
+	D3D11Backend& D3D11DeferredContexts::GetDeferredBackend(uint32_t index) const
+	{
+		assert(index < m_DeferredContexts.size());
+		return *m_DeferredContexts[index].pBackend;
+	}
+
+	ID3D11CommandList* D3D11DeferredContexts::FinishCommandList(uint32_t index)
+	{
+		assert(index < m_DeferredContexts.size());
+
+		ID3D11CommandList* pCommandList{ nullptr };
+		if (FAILED(m_DeferredContexts[index].pDeviceContext->FinishCommandList(FALSE, &pCommandList)))
+		{
+			std::cout << "Failed to finish command list!\n";
+			return nullptr;
+		}
+		return pCommandList;
+	}
+
+	void D3D11DeferredContexts::ExecuteCommandList(ID3D11CommandList* pCommandList)
+	{
+		m_pImmediateBackend->GetStateFilter().GetTarget().pDeviceContext->ExecuteCommandList(pCommandList, FALSE);
+		pCommandList->Release();
+	}
+
+	void D3D11DeferredContexts::BindOutput(D3D11Backend& backend, const Output& output) const
+	{
+		D3D11StateFilter& stateFilter = backend.GetStateFilter();
+		stateFilter.OMSetRenderTargets(1, &output.pRenderTargetView, output.pDepthStencilView);
+		stateFilter.GetTarget().pDeviceContext->RSSetViewports(1, &output.viewport);
+	}
+}
@@ -0,0 +1,61 @@
+#pragma once
+
+#include "D3D11Backend.h"
+#include "D3D11StateFilter.h"
+#include "DeferredRecordingTarget.h"
+#include "RecordingScheduler.h"
+
+#include <memory>
+#include <vector>
+
+namespace dae
+{
+	// D3D11 deferred contexts for a DeferredRecordingTarget, each behind its own StateFilter and a D3D11Backend sharing
+	// the resources of the immediate one, so the same handles draw on every context.
+	class D3D11DeferredContexts final
+	{
+	public:
+		using Backend = D3D11Backend;
+		using StateFilter = D3D11StateFilter;
+		using CommandList = ID3D11CommandList*;
+
+		struct Output
+		{
+			ID3D11RenderTargetView* pRenderTargetView;
+			ID3D11DepthStencilView* pDepthStencilView;
+			D3D11_VIEWPORT viewport;
+		};
+
+	public:
+		// pImmediateBackend records when the list is too short to split, numContexts 0 uses one per logical core
+		D3D11DeferredContexts(ID3D11Device* pDevice, D3D11Backend* pImmediateBackend, uint32_t numContexts = 0);
+		~D3D11DeferredContexts();
+
+		D3D11DeferredContexts(const D3D11DeferredContexts&)				= delete;
+		D3D11DeferredContexts& operator=(const D3D11DeferredContexts&)	= delete;
+		D3D11DeferredContexts(D3D11DeferredContexts&&)					= delete;
+		D3D11DeferredContexts& operator=(D3D11DeferredContexts&&)		= delete;
+
+		uint32_t GetNumDeferredContexts() const;
+		D3D11Backend& GetImmediateBackend() const;
+		D3D11Backend& GetDeferredBackend(uint32_t index) const;
+		CommandList FinishCommandList(uint32_t index);
+		void ExecuteCommandList(CommandList commandList);
+		void BindOutput(D3D11Backend& backend, const Output& output) const;
+
+	private:
+		struct DeferredContext
+		{
+			ID3D11DeviceContext* pDeviceContext;
+			ID3D11DeviceContext1* pDeviceContext1;
+			std::unique_ptr<D3D11StateFilter> pStateFilter;
+			std::unique_ptr<D3D11Backend> pBackend;
+		};
+
+		D3D11Backend* m_pImmediateBackend;
+		std::vector<DeferredContext> m_DeferredContexts{};
+	};
+
+	using D3D11RecordingTarget = DeferredRecordingTarget<D3D11DeferredContexts>;
+	using D3D11RecordingScheduler = RecordingScheduler<D3D11RecordingTarget>;
+}
@@ -0,0 +1,76 @@
+#pragma once
+
+#include "StateFilter.h"
+
+namespace dae
+{
+	// Forwards the calls a StateFilter lets through to a D3D11 device context
+	struct D3D11StateTarget
+	{
+		using Topology = D3D11_PRIMITIVE_TOPOLOGY;
+		using Format = DXGI_FORMAT;
+		using Buffer = ID3D11Buffer;
+		using InputLayout = ID3D11InputLayout;
+		using VertexShader = ID3D11VertexShader;
+		using PixelShader = ID3D11PixelShader;
+		using ShaderResourceView = ID3D11ShaderResourceView;
+		using SamplerState = ID3D11SamplerState;
+		using RenderTargetView = ID3D11RenderTargetView;
+		using DepthStencilView = ID3D11DepthStencilView;
+		using BlendState = ID3D11BlendState;
+		using DepthStencilState = ID3D11DepthStencilState;
+		using RasterizerState = ID3D11RasterizerState;
+		using Pass = ID3DX11EffectPass;
+
+		ID3D11DeviceContext* pDeviceContext;
+		// Only needed for constant buffer ranges, may be nullptr
+		ID3D11DeviceContext1* pDeviceContext1;
+
+		void IASetPrimitiveTopology(Topology topology) { pDeviceContext->IASetPrimitiveTopology(topology); }
+		void IASetInputLayout(InputLayout* pInputLayout) { pDeviceContext->IASetInputLayout(pInputLayout); }
+		void IASetVertexBuffers(uint32_t startSlot, uint32_t numBuffers, Buffer* const* ppBuffers, const uint32_t* pStrides, const uint32_t* pOffsets) { pDeviceContext->IASetVertexBuffers(startSlot, numBuffers, ppBuffers, pStrides, pOffsets); }
+		void IASetIndexBuffer(Buffer* pBuffer, Format format, uint32_t offset) { pDeviceContext->IASetIndexBuffer(pBuffer, format, offset); }
+
+		void VSSetShader(VertexShader* pShader) { pDeviceContext->VSSetShader(pShader, nullptr, 0); }
+		void PSSetShader(PixelShader* pShader) { pDeviceContext->PSSetShader(pShader, nullptr, 0); }
+
+		void VSSetConstantBuffers(uint32_t startSlot, uint32_t numBuffers, Buffer* const* ppBuffers, const uint32_t* pFirstConstants, const uint32_t* pNumConstants)
+		{
+			if (pFirstConstants != nullptr && pDeviceContext1 != nullptr)
+			{
+				pDeviceContext1->VSSetConstantBuffers1(startSlot, numBuffers, ppBuffers, pFirstConstants, pNumConstants);
+			}
+			else
+			{
+				pDeviceContext->VSSetConstantBuffers(startSlot, numBuffers, ppBuffers);
+			}
+		}
+
+		void PSSetConstantBuffers(uint32_t startSlot, uint32_t numBuffers, Buffer* const* ppBuffers, const uint32_t* pFirstConstants, const uint32_t* pNumConstants)
+		{
+			if (pFirstConstants != nullptr && pDeviceContext1 != nullptr)
+			{
+				pDeviceContext1->PSSetConstantBuffers1(startSlot, numBuffers, ppBuffers, pFirstConstants, pNumConstants);
+			}
+			else
+			{
+				pDeviceContext->PSSetConstantBuffers(startSlot, numBuffers, ppBuffers);
+			}
+		}
+
+		void PSSetShaderResources(uint32_t startSlot, uint32_t numViews, ShaderResourceView* const* ppViews) { pDeviceContext->PSSetShaderResources(startSlot, numViews, ppViews); }
+		void PSSetSamplers(uint32_t startSlot, uint32_t numSamplers, SamplerState* const* ppSamplers) { pDeviceContext->PSSetSamplers(startSlot, numSamplers, ppSamplers); }
+
+		void OMSetRenderTargets(uint32_t numViews, RenderTargetView* const* ppViews, DepthStencilView* pDepthStencilView) { pDeviceContext->OMSetRenderTargets(numViews, ppViews, pDepthStencilView); }
+		void OMSetBlendState(BlendState* pState, const float blendFactor[4], uint32_t sampleMask) { pDeviceContext->OMSetBlendState(pState, blendFactor, sampleMask); }
+		void OMSetDepthStencilState(DepthStencilState* pState, uint32_t stencilRef) { pDeviceContext->OMSetDepthStencilState(pState, stencilRef); }
+		void RSSetState(RasterizerState* pState) { pDeviceContext->RSSetState(pState); }
+
+		void ApplyPass(Pass* pPass) { pPass->Apply(0, pDeviceContext); }
+
+		void DrawIndexed(uint32_t indexCount, uint32_t startIndex, int32_t baseVertex) { pDeviceContext->DrawIndexed(indexCount, startIndex, baseVertex); }
+		void DrawIndexedInstanced(uint32_t indexCount, uint32_t instanceCount, uint32_t startIndex, int32_t baseVertex, uint32_t startInstance) { pDeviceContext->DrawIndexedInstanced(indexCount, instanceCount, startIndex, baseVertex, startInstance); }
+	};
+
+	using D3D11StateFilter = StateFilter<D3D11StateTarget>;
+}
@@ -0,0 +1,146 @@
+#pragma once
+
+#include <cassert>
+#include <cstdint>
+#include <utility>
+
+namespace dae
+{
+	// The Target of a RecordingScheduler on deferred contexts. Every context records through a backend behind its own
+	// StateFilter. A deferred context starts every command list with cleared state, so BeginDeferred forgets what the
+	// filter knows and binds the output again. Command lists are executed without restoring the immediate context's
+	// state, Execute forgets the immediate state and binds the output there afterwards instead.
+	//
+	// Contexts owns the contexts and talks to the API: D3D11DeferredContexts uses D3D11, tests use a fake that logs
+	// what was executed and bound. No D3D types in here, the bookkeeping behaves the same on every platform. It provides
+	//		using Backend;										// Backend::GetStateFilter() returns a StateFilter&
+	//		using StateFilter;
+	//		using CommandList;									// CommandList{} is no list
+	//		using Output;										// what every context draws into
+	//		uint32_t GetNumDeferredContexts() const;
+	//		Backend& GetImmediateBackend() const;
+	//		Backend& GetDeferredBackend(uint32_t index) const;
+	//		CommandList FinishCommandList(uint32_t index);		// on the worker thread that recorded into index
+	//		void ExecuteCommandList(CommandList commandList);	// on the immediate context, releases the list
+	//		void BindOutput(Backend& backend, const Output& output) const;
+	template<typename Contexts>
+	class DeferredRecordingTarget final
+	{
+	public:
+		using Context = typename Contexts::Backend;
+		using CommandList = typename Contexts::CommandList;
+		using Output = typename Contexts::Output;
+		using StateStatistics = typename Contexts::StateFilter::Statistics;
+
+	public:
+		// Arguments go to the constructor of Contexts
+		template<typename... Args>
+		explicit DeferredRecordingTarget(Args&&... args);
+		~DeferredRecordingTarget() = default;
+
+		DeferredRecordingTarget(const DeferredRecordingTarget&)				= delete;
+		DeferredRecordingTarget& operator=(const DeferredRecordingTarget&)	= delete;
+		DeferredRecordingTarget(DeferredRecordingTarget&&)					= delete;
+		DeferredRecordingTarget& operator=(DeferredRecordingTarget&&)		= delete;
+
+		// What every context draws into, bound on the immediate context right away
+		void SetOutput(const Output& output);
+
+		uint32_t GetNumDeferredContexts() const;
+		Context& GetImmediateContext();
+		Context& BeginDeferred(uint32_t index);
+		CommandList FinishDeferred(uint32_t index);
+		void Execute(CommandList commandList);
+
+		// Starts a new frame on every state filter
+		void BeginFrame();
+		// Summed over the immediate and all deferred contexts, for the frame before BeginFrame
+		StateStatistics GetStateStatistics() const;
+
+	private:
+		Contexts m_Contexts;
+		Output m_Output{};
+	};
+
+	template<typename Contexts>
+	template<typename... Args>
+	DeferredRecordingTarget<Contexts>::DeferredRecordingTarget(Args&&... args)
+		: m_Contexts{ std::forward<Args>(args)... }
+	{
+	}
+
+	template<typename Contexts>
+	void DeferredRecordingTarget<Contexts>::SetOutput(const Output& output)
+	{
+		m_Output = output;
+		m_Contexts.BindOutput(m_Contexts.GetImmediateBackend(), m_Output);
+	}
+
+	template<typename Contexts>
+	uint32_t DeferredRecordingTarget<Contexts>::GetNumDeferredContexts() const
+	{
+		return m_Contexts.GetNumDeferredContexts();
+	}
+
+	template<typename Contexts>
+	typename DeferredRecordingTarget<Contexts>::Context& DeferredRecordingTarget<Contexts>::GetImmediateContext()
+	{
+		return m_Contexts.GetImmediateBackend();
+	}
+
+	template<typename Contexts>
+	typename DeferredRecordingTarget<Contexts>::Context& DeferredRecordingTarget<Contexts>::BeginDeferred(uint32_t index)
+	{
+		assert(index < m_Contexts.GetNumDeferredContexts());
+
+		//Finishing the last command list cleared the context, whatever the filter remembers is gone
+		Context& backend = m_Contexts.GetDeferredBackend(index);
+		backend.GetStateFilter().Invalidate();
+		m_Contexts.BindOutput(backend, m_Output);
+		return backend;
+	}
+
+	template<typename Contexts>
+	typename DeferredRecordingTarget<Contexts>::CommandList DeferredRecordingTarget<Contexts>::FinishDeferred(uint32_t index)
+	{
+		assert(index < m_Contexts.GetNumDeferredContexts());
+		return m_Contexts.FinishCommandList(index);
+	}
+
+	template<typename Contexts>
+	void DeferredRecordingTarget<Contexts>::Execute(CommandList commandList)
+	{
+		if (commandList == CommandList{})
+			return;
+
+		//Not restoring the immediate state is cheaper, the next list does not depend on it and the output is bound again
+		m_Contexts.ExecuteCommandList(commandList);
+
+		Context& backend = m_Contexts.GetImmediateBackend();
+		backend.GetStateFilter().Invalidate();
+		m_Contexts.BindOutput(backend, m_Output);
+	}
+
+	template<typename Contexts>
+	void DeferredRecordingTarget<Contexts>::BeginFrame()
+	{
+		m_Contexts.GetImmediateBackend().GetStateFilter().BeginFrame();
+		for (uint32_t i = 0; i < m_Contexts.GetNumDeferredContexts(); ++i)
+		{
+			m_Contexts.GetDeferredBackend(i).GetStateFilter().BeginFrame();
+		}
+	}
+
+	template<typename Contexts>
+	typename DeferredRecordingTarget<Contexts>::StateStatistics DeferredRecordingTarget<Contexts>::GetStateStatistics() const
+	{
+		StateStatistics statistics = m_Contexts.GetImmediateBackend().GetStateFilter().GetStatistics();
+		for (uint32_t i = 0; i < m_Contexts.GetNumDeferredContexts(); ++i)
+		{
+			const StateStatistics& deferredStatistics = m_Contexts.GetDeferredBackend(i).GetStateFilter().GetStatistics();
+			statistics.numSubmitted += deferredStatistics.numSubmitted;
+			statistics.numFiltered += deferredStatistics.numFiltered;
+		}
+		return statistics;
+	}
+}
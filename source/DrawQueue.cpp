@@ -0,0 +1,272 @@
+#include "DrawQueue.h"
+
+#include <algorithm>
+#include <array>
+#include <cassert>
+#include <chrono>
+#include <iostream>
+#include <random>
+
+namespace dae
+{
+	namespace
+	{
+		constexpr uint32_t passShift{ 62 };
+		constexpr uint64_t techniqueMask{ (1ull << DrawQueue::TechniqueBits) - 1 };
+		constexpr uint64_t resourceMask{ (1ull << DrawQueue::ResourceBits) - 1 };
+		constexpr uint64_t depthMask{ (1ull << DrawQueue::DepthBits) - 1 };
+		//Technique, texture and buffer
+		constexpr uint32_t stateBits{ DrawQueue::TechniqueBits + 2 * DrawQueue::ResourceBits };
+		constexpr uint64_t stateMask{ (1ull << stateBits) - 1 };
+
+		static_assert(2 + stateBits + DrawQueue::DepthBits == 64, "The key fields must fill 64 bits");
+	}
+
+	uint64_t DrawQueue::CreateKey(Pass pass, uint32_t technique, uint32_t texture, uint32_t buffer, float depth)
+	{
+		const uint64_t state = (technique & techniqueMask) << (2 * ResourceBits) | (texture & resourceMask) << ResourceBits | (buffer & resourceMask);
+
+		//NaN ends up at the near plane
+		const float clampedDepth = depth > 0.0f ? std::min(depth, 1.0f) : 0.0f;
+		//In double, depthMask is not representable as a float and 1.0f would round up into the state bits
+		const uint64_t quantizedDepth = static_cast<uint64_t>(static_cast<double>(clampedDepth) * static_cast<double>(depthMask));
+
+		const uint64_t key = static_cast<uint64_t>(pass) << passShift;
+		if (pass == Pass::Opaque)
+			return key | state << DepthBits | quantizedDepth;
+
+		return key | (depthMask - quantizedDepth) << stateBits | state;
+	}
+
+	DrawQueue::Pass DrawQueue::GetPass(uint64_t key)
+	{
+		return static_cast<Pass>(key >> passShift);
+	}
+
+	uint64_t DrawQueue::GetState(uint64_t key)
+	{
+		return GetPass(key) == Pass::Opaque ? (key >> DepthBits) & stateMask : key & stateMask;
+	}
+
+	uint32_t DrawQueue::GetId(const void* pObject)
+	{
+		if (pObject == nullptr)
+			return 0;
+
+		return m_Ids.try_emplace(pObject, static_cast<uint32_t>(m_Ids.size() + 1)).first->second;
+	}
+
+	void DrawQueue::Clear()
+	{
+		m_Items.clear();
+	}
+
+	void DrawQueue::Submit(uint64_t key, uint32_t index)
+	{
+		m_Items.push_back({ key, index });
+	}
+
+	void DrawQueue::Sort()
+	{
+		const uint32_t numUnsortedStateChanges = CountStateChanges(m_Items);
+
+		const auto start = std::chrono::high_resolution_clock::now();
+		RadixSort(m_Items, m_Scratch);
+		m_Statistics.sortMilliseconds = std::chrono::duration<float, std::milli>(std::chrono::high_resolution_clock::now() - start).count();
+
+		m_Statistics.numDraws = static_cast<uint32_t>(m_Items.size());
+		m_Statistics.numStateChanges = CountStateChanges(m_Items);
+		m_Statistics.numStateChangesAvoided = numUnsortedStateChanges - std::min(numUnsortedStateChanges, m_Statistics.numStateChanges);
+	}
+
+	std::span<const DrawQueue::Item> DrawQueue::GetItems() const
+	{
+		return m_Items;
+	}
+
+	const DrawQueue::Statistics& DrawQueue::GetStatistics() const
+	{
+		return m_Statistics;
+	}
+
+	void DrawQueue::PrintStatistics() const
+	{
+		std::cout << "Draws: " << m_Statistics.numDraws << ", " << m_Statistics.numStateChanges << " state changes"
+			<< " (" << m_Statistics.numStateChangesAvoided << " avoided, sort " << m_Statistics.sortMilliseconds << " ms)\n";
+	}
+
+	void DrawQueue::RadixSort(std::vector<Item>& items, std::vector<Item>& scratch)
+	{
+		constexpr int numPasses{ 8 };
+		const size_t count = items.size();
+		if (count < 2)
+			return;
+
+		scratch.resize(count);
+
+		//All 8 histograms in one read of the keys
+		std::array<std::array<uint32_t, 256>, numPasses> histograms{};
+		for (const Item& item : items)
+		{
+			for (int pass = 0; pass < numPasses; ++pass)
+			{
+				++histograms[pass][(item.key >> (pass * 8)) & 0xFF];
+			}
+		}
+
+		Item* pSource = items.data();
+		Item* pDestination = scratch.data();
+		for (int pass = 0; pass < numPasses; ++pass)
+		{
+			std::array<uint32_t, 256>& histogram = histograms[pass];
+
+			//Every key has the same byte, the pass would only copy
+			const uint32_t shift = pass * 8;
+			if (histogram[(pSource[0].key >> shift) & 0xFF] == count)
+				continue;
+
+			//Counts to start offsets
+			uint32_t offset{ 0 };
+			for (uint32_t& bucket : histogram)
+			{
+				const uint32_t bucketCount = bucket;
+				bucket = offset;
+				offset += bucketCount;
+			}
+
+			for (size_t i = 0; i < count; ++i)
+			{
+				pDestination[histogram[(pSource[i].key >> shift) & 0xFF]++] = pSource[i];
+			}
+
+			std::swap(pSource, pDestination);
+		}
+
+		//An odd number of passes left the result in scratch
+		if (pSource != items.data())
+		{
+			items.swap(scratch);
+		}
+	}
+
+	uint32_t DrawQueue::CountStateChanges(std::span<const Item> items)
+	{
+		uint32_t numStateChanges{ 0 };
+		for (size_t i = 1; i < items.size(); ++i)
+		{
+			if (GetState(items[i].key) != GetState(items[i - 1].key))
+			{
+				++numStateChanges;
+			}
+		}
+		return numStateChanges;
+	}
+
+	void DrawQueue::Benchmark()
+	{
+		using Clock = std::chrono::high_resolution_clock;
+
+		constexpr int numRepetitions{ 20 };
+
+		//A scene like mix: 256 objects (technique, texture, buffer) drawn many times each, one draw in 8 transparent
+		constexpr uint32_t numObjects{ 256 };
+
+		std::mt19937 random{ 1337 };
+		std::uniform_int_distribution<uint32_t> techniqueDistribution{ 0, 7 };
+		std::uniform_int_distribution<uint32_t> textureDistribution{ 0, 99 };
+		std::uniform_int_distribution<uint32_t> objectDistribution{ 0, numObjects - 1 };
+		std::uniform_real_distribution<float> depthDistribution{ 0.0f, 1.0f };
+		std::uniform_int_distribution<uint32_t> passDistribution{ 0, 7 };
+
+		std::array<std::array<uint32_t, 2>, numObjects> objects{};
+		for (std::array<uint32_t, 2>& object : objects)
+		{
+			object = { techniqueDistribution(random), textureDistribution(random) };
+		}
+
+		const auto milliseconds = [](const Clock::time_point& start)
+		{
+			return std::chrono::duration<float, std::milli>(Clock::now() - start).count() / numRepetitions;
+		};
+
+		std::cout << "Sorting draws, milliseconds per sort\n";
+
+		for (uint32_t numDraws : { 10'000u, 25'000u, 50'000u, 100'000u })
+		{
+			std::vector<Item> submitted(numDraws);
+			for (uint32_t i = 0; i < numDraws; ++i)
+			{
+				const Pass pass = passDistribution(random) == 0 ? Pass::Transparent : Pass::Opaque;
+				const uint32_t object = objectDistribution(random);
+				submitted[i] = { CreateKey(pass, objects[object][0], objects[object][1], object, depthDistribution(random)), i };
+			}
+
+			const auto isKeyLess = [](const Item& a, const Item& b) { return a.key < b.key; };
+
+			std::vector<Item> expected{ submitted };
+			std::stable_sort(expected.begin(), expected.end(), isKeyLess);
+
+			std::vector<Item> items;
+			std::vector<Item> scratch;
+
+			Clock::time_point start = Clock::now();
+			for (int repetition = 0; repetition < numRepetitions; ++repetition)
+			{
+				items = submitted;
+				std::stable_sort(items.begin(), items.end(), isKeyLess);
+			}
+			const float stableSortMilliseconds = milliseconds(start);
+
+			start = Clock::now();
+			for (int repetition = 0; repetition < numRepetitions; ++repetition)
+			{
+				items = submitted;
+				std::sort(items.begin(), items.end(), isKeyLess);
+			}
+			const float sortMilliseconds = milliseconds(start);
+
+			start = Clock::now();
+			for (int repetition = 0; repetition < numRepetitions; ++repetition)
+			{
+				items = submitted;
+				RadixSort(items, scratch);
+			}
+			const float radixSortMilliseconds = milliseconds(start);
+
+			bool isEqual = true;
+			for (uint32_t i = 0; i < numDraws; ++i)
+			{
+				isEqual &= items[i].key == expected[i].key && items[i].index == expected[i].index;
+			}
+
+			//Order checks: opaque before transparent, opaque front to back per state, transparent back to front
+			bool isOrdered = true;
+			for (uint32_t i = 1; i < numDraws; ++i)
+			{
+				const uint64_t previous = items[i - 1].key;
+				const uint64_t current = items[i].key;
+				if (GetPass(previous) != GetPass(current))
+				{
+					isOrdered &= GetPass(previous) == Pass::Opaque;
+				}
+				else if (GetPass(current) == Pass::Opaque && GetState(previous) == GetState(current))
+				{
+					isOrdered &= (previous & depthMask) <= (current & depthMask);
+				}
+				else if (GetPass(current) == Pass::Transparent)
+				{
+					isOrdered &= (previous >> stateBits & depthMask) <= (current >> stateBits & depthMask);
+				}
+			}
+
+			const uint32_t numStateChanges = CountStateChanges(items);
+			const uint32_t numUnsortedStateChanges = CountStateChanges(submitted);
+
+			std::cout << "  " << numDraws << " draws: radix " << radixSortMilliseconds
+				<< ", std::sort " << sortMilliseconds
+				<< ", std::stable_sort " << stableSortMilliseconds
+				<< ", state changes " << numUnsortedStateChanges << " -> " << numStateChanges
+				<< (isEqual ? "" : " MISMATCH") << (isOrdered ? "" : " UNORDERED") << "\n";
+		}
+	}
+}
@@ -0,0 +1,89 @@
+#pragma once
+
+#include <cstdint>
+#include <span>
+#include <unordered_map>
+#include <vector>
+
+namespace dae
+{
+	// Draws of one frame, submitted in any order and sorted by a 64 bit key before they are executed.
+	// Opaque key, most significant first:		pass (2) | technique (6) | texture (14) | buffer (14) | depth (28)
+	// Transparent key:							pass (2) | inverted depth (28) | technique (6) | texture (14) | buffer (14)
+	// Opaque draws are grouped by state and go front to back inside a group, transparent draws go strictly back to front.
+	class DrawQueue final
+	{
+	public:
+		enum class Pass : uint8_t
+		{
+			Opaque,
+			Transparent
+		};
+
+		struct Item
+		{
+			uint64_t key;
+			// Caller defined, usually an index into the list of drawables
+			uint32_t index;
+		};
+
+		struct Statistics
+		{
+			uint32_t numDraws{};
+			// Technique, texture or buffer differing from the previous draw, after sorting
+			uint32_t numStateChanges{};
+			// The same count in submission order minus numStateChanges
+			uint32_t numStateChangesAvoided{};
+			float sortMilliseconds{};
+		};
+
+		static constexpr uint32_t TechniqueBits{ 6 };
+		static constexpr uint32_t ResourceBits{ 14 };
+		static constexpr uint32_t DepthBits{ 28 };
+
+	public:
+		DrawQueue() = default;
+		~DrawQueue() = default;
+
+		DrawQueue(const DrawQueue&)				= delete;
+		DrawQueue& operator=(const DrawQueue&)	= delete;
+		DrawQueue(DrawQueue&&)					= delete;
+		DrawQueue& operator=(DrawQueue&&)		= delete;
+
+		// depth is 0 at the near plane and 1 at the far plane, values outside are clamped.
+		// Ids wrap at their bit count, which only costs grouping, never correctness.
+		static uint64_t CreateKey(Pass pass, uint32_t technique, uint32_t texture, uint32_t buffer, float depth);
+		static Pass GetPass(uint64_t key);
+		// Technique, texture and buffer together, equal for draws that need no state change in between
+		static uint64_t GetState(uint64_t key);
+
+		// Dense id per object (technique, texture, buffer), stable for the lifetime of the queue. nullptr is 0.
+		uint32_t GetId(const void* pObject);
+
+		void Clear();
+		void Submit(uint64_t key, uint32_t index);
+		// Stable, draws with equal keys keep their submission order
+		void Sort();
+		std::span<const Item> GetItems() const;
+
+		const Statistics& GetStatistics() const;
+		void PrintStatistics() const;
+
+		// LSD radix sort on the key, 8 bits per pass. Passes where every key has the same byte are skipped.
+		// scratch is resized to items and holds garbage afterwards.
+		static void RadixSort(std::vector<Item>& items, std::vector<Item>& scratch);
+
+		// Verifies against std::stable_sort and prints the sort time for 10k to 100k draws
+		static void Benchmark();
+
+	private:
+		std::vector<Item> m_Items;
+		std::vector<Item> m_Scratch;
+		std::unordered_map<const void*, uint32_t> m_Ids;
+
+		Statistics m_Statistics{};
+
+	private:
+		static uint32_t CountStateChanges(std::span<const Item> items);
+	};
+}
@@ -1,6 +1,5 @@
 #include "pch.h"
 #include "Effect.h"
-#include "Texture.h"
 
 #include <cassert>
 
@@ -8,15 +7,21 @@ namespace dae
 {
 	/* static */ Effect::Technique Effect::m_Technique{ Technique::TexturePoint };
 
-	Effect::Effect(ID3D11Device* pDevice, const std::wstring& assetFile)
-		: m_pEffect{ LoadEffect(pDevice, assetFile) }
+	Effect::Effect(ID3D11Device* pDevice, const std::wstring& assetFile, const std::vector<Define>& defines, ShaderCache* pShaderCache)
+		: m_pEffect{ LoadEffect(pDevice, assetFile, defines, pShaderCache) }
 	{
+		if (m_pEffect == nullptr)
+			return;
+
 		m_pTexturePointTechnique = FindTechnique("TexturePointTechnique");
 		m_pTextureLinearTechnique = FindTechnique("TextureLinearTechnique");
 		m_pTextureAnisotropicTechnique = FindTechnique("TextureAnisotropicTechnique");
 
-		static constexpr uint32_t numElements{ 4 };
-		D3D11_INPUT_ELEMENT_DESC vertexDesc[numElements]{};
+		m_IsInstanced = std::any_of(defines.begin(), defines.end(), [](const Define& define) { return define.name == InstancedDefine; });
+
+		static constexpr uint32_t numVertexElements{ 4 };
+		static constexpr uint32_t numInstanceElements{ 5 };
+		D3D11_INPUT_ELEMENT_DESC vertexDesc[numVertexElements + numInstanceElements]{};
 
 		vertexDesc[0].SemanticName		= "POSITION";
 		vertexDesc[0].Format			= DXGI_FORMAT_R32G32B32_FLOAT;
@@ -38,6 +43,21 @@ namespace dae
 		vertexDesc[3].AlignedByteOffset	= 32;
 		vertexDesc[3].InputSlotClass	= D3D11_INPUT_PER_VERTEX_DATA;
 
+		//InstanceData: the world matrix rows, then the material index
+		for (uint32_t i = 0; i < numInstanceElements; ++i)
+		{
+			D3D11_INPUT_ELEMENT_DESC& desc = vertexDesc[numVertexElements + i];
+			desc.SemanticName			= i < 4 ? "INSTANCE_WORLD" : "INSTANCE_MATERIAL";
+			desc.SemanticIndex			= i < 4 ? i : 0;
+			desc.Format					= i < 4 ? DXGI_FORMAT_R32G32B32A32_FLOAT : DXGI_FORMAT_R32_UINT;
+			desc.InputSlot				= 1;
+			desc.AlignedByteOffset		= i * 16;
+			desc.InputSlotClass			= D3D11_INPUT_PER_INSTANCE_DATA;
+			desc.InstanceDataStepRate	= 1;
+		}
+
+		const uint32_t numElements = m_IsInstanced ? numVertexElements + numInstanceElements : numVertexElements;
+
 		D3DX11_PASS_DESC passDesc{};
 		m_pTexturePointTechnique->GetPassByIndex(0)->GetDesc(&passDesc);
 
@@ -55,8 +75,7 @@ namespace dae
 			assert(false);
 		}
 
-		m_pMatWorldViewProjVariable = FindVariable("gWorldViewProj")->AsMatrix();
-		m_pDiffuseMapVariable = FindVariable("gDiffuseMap")->AsShaderResource();
+		m_pInstanceUVTransformsVariable = FindVariable("gInstanceUVTransforms")->AsVector();
 	}
 	 
 	Effect::~Effect()
@@ -65,6 +84,11 @@ namespace dae
 		if (m_pEffect) m_pEffect->Release();
 	}
 
+	bool Effect::IsValid() const
+	{
+		return m_pEffect != nullptr;
+	}
+
 	ID3DX11Effect* Effect::GetEffect() const
 	{
 		return m_pEffect;
@@ -87,17 +111,26 @@ namespace dae
 		return m_pInputLayout;
 	}
 
-	void Effect::SetWorldViewProjMatrix(const Matrix& matrix)
+	bool Effect::IsInstanced() const
 	{
-		m_pMatWorldViewProjVariable->SetMatrix(matrix.GetData());
+		return m_IsInstanced;
 	}
 
-	void Effect::SetDiffuseMap(const Texture* pTexture)
+	uint64_t Effect::GetVariablesVersion() const
 	{
-		if (pTexture != nullptr)
-		{
-			m_pDiffuseMapVariable->SetResource(pTexture->GetShaderResourceView());
-		}
+		return m_VariablesVersion;
+	}
+
+	std::mutex& Effect::GetMutex() const
+	{
+		return m_Mutex;
+	}
+
+	void Effect::SetInstanceUVTransforms(std::span<const Vector4> uvTransforms)
+	{
+		assert(uvTransforms.size() <= MaxInstanceMaterials);
+		m_pInstanceUVTransformsVariable->SetFloatVectorArray(&uvTransforms.data()->x, 0, static_cast<uint32_t>(std::min<size_t>(uvTransforms.size(), MaxInstanceMaterials)));
+		++m_VariablesVersion;
 	}
 
 	void Effect::CycleTechnique()
@@ -140,7 +173,7 @@ namespace dae
 		return pVariable;
 	}
 
-	ID3DX11Effect* Effect::LoadEffect(ID3D11Device* pDevice, const std::wstring& assetFile)
+	ID3DX11Effect* Effect::LoadEffect(ID3D11Device* pDevice, const std::wstring& assetFile, const std::vector<Define>& defines, ShaderCache* pShaderCache)
 	{
 		HRESULT result;
 		ID3D10Blob* pErrorBlob{ nullptr };
@@ -152,16 +185,47 @@ namespace dae
 		shaderFlags |= D3DCOMPILE_SKIP_OPTIMIZATION;
 	#endif
 
-		result = D3DX11CompileEffectFromFile(
+		//Warm start, the stored binary goes straight into the effect. A binary the runtime rejects is compiled again below.
+		const uint64_t cacheKey = pShaderCache != nullptr ? ShaderCache::CalculateKey(assetFile, defines, shaderFlags, D3D_COMPILER_VERSION) : 0;
+		std::vector<uint8_t> binary;
+		if (cacheKey != 0 && pShaderCache->Load(cacheKey, binary))
+		{
+			result = D3DX11CreateEffectFromMemory(binary.data(), binary.size(), 0, pDevice, &pEffect);
+			if (SUCCEEDED(result))
+				return pEffect;
+		}
+
+		//The compiler takes a null terminated array
+		std::vector<D3D_SHADER_MACRO> macros;
+		for (const Define& define : defines)
+		{
+			macros.push_back({ define.name.c_str(), define.value.c_str() });
+		}
+		macros.push_back({ nullptr, nullptr });
+
+		//What D3DX11CompileEffectFromFile does, split in two so the compiled binary can be stored
+		ID3D10Blob* pBinaryBlob{ nullptr };
+		result = D3DCompileFromFile(
 			assetFile.c_str(),
+			macros.data(),
+			D3D_COMPILE_STANDARD_FILE_INCLUDE,
 			nullptr,
-			nullptr,
+			"fx_5_0",
 			shaderFlags,
 			0,
-			pDevice,
-			&pEffect,
+			&pBinaryBlob,
 			&pErrorBlob);
 
+		if (SUCCEEDED(result))
+		{
+			result = D3DX11CreateEffectFromMemory(pBinaryBlob->GetBufferPointer(), pBinaryBlob->GetBufferSize(), 0, pDevice, &pEffect);
+			if (SUCCEEDED(result) && cacheKey != 0)
+			{
+				pShaderCache->Store(cacheKey, pBinaryBlob->GetBufferPointer(), pBinaryBlob->GetBufferSize());
+			}
+			pBinaryBlob->Release();
+		}
+
 		if (FAILED(result))
 		{
 			if (pErrorBlob != nullptr)
@@ -191,6 +255,9 @@ namespace dae
 			return nullptr;
 		}
 
+		//Warnings only
+		if (pErrorBlob != nullptr) pErrorBlob->Release();
+
 		return pEffect;
 	}
-}
+}
\ No newline at end of file
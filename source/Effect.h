@@ -1,13 +1,19 @@
 #pragma once
 
 #include "Matrix.h"
+#include "ShaderCache.h"
 
+#include <mutex>
+#include <span>
+#include <string>
 #include <string_view>
+#include <vector>
 
 namespace dae
 {
-	class Texture;
-
+	// Compiled effect, technique lookups and input layout. One instance is shared by every pipeline created with the
+	// same file and defines (see EffectCache). The constants and textures are bound by the D3D11Backend on top of a
+	// pass, the only variables set through the effect are the instance UV transforms.
 	class Effect final
 	{
 	public:
@@ -18,8 +24,16 @@ namespace dae
 			TextureAnisotropic
 		};
 
+		using Define = ShaderDefine;
+
+		// Defining this adds the per instance elements of InstanceData to the input layout, in slot 1
+		static constexpr const char* InstancedDefine{ "INSTANCED" };
+		// Length of gInstanceUVTransforms in the shader
+		static constexpr uint32_t MaxInstanceMaterials{ 16 };
+
 	public:
-		Effect(ID3D11Device* pDevice, const std::wstring& assetFile);
+		// With a shader cache a warm start creates the effect from the stored binary and never runs the compiler
+		Effect(ID3D11Device* pDevice, const std::wstring& assetFile, const std::vector<Define>& defines = {}, ShaderCache* pShaderCache = nullptr);
 		~Effect();
 
 		Effect(const Effect&)				= delete;
@@ -27,12 +41,21 @@ namespace dae
 		Effect(Effect&&)					= delete;
 		Effect& operator=(Effect&&)			= delete;
 
+		// False when the file did not compile, nothing else may be called then
+		bool IsValid() const;
+
 		ID3DX11Effect* GetEffect() const;
 		ID3DX11EffectTechnique* GetTechnique() const;
 		ID3D11InputLayout* GetInputLayout() const;
+		bool IsInstanced() const;
+		// Changes whenever a variable is set, an unchanged version means applying the pass again binds nothing new
+		uint64_t GetVariablesVersion() const;
+		// Held while setting variables and applying a pass, draws sharing the effect may be recorded on several threads
+		// (see RecordingScheduler)
+		std::mutex& GetMutex() const;
 
-		void SetWorldViewProjMatrix(const Matrix& matrix);
-		void SetDiffuseMap(const Texture* pTexture);
+		// Instanced effects only. Indexed by the instance material index, at most MaxInstanceMaterials.
+		void SetInstanceUVTransforms(std::span<const Vector4> uvTransforms);
 
 		static void CycleTechnique();
 
@@ -42,9 +65,11 @@ namespace dae
 		ID3DX11EffectTechnique* m_pTextureLinearTechnique{ nullptr };
 		ID3DX11EffectTechnique* m_pTextureAnisotropicTechnique{ nullptr };
 		ID3D11InputLayout* m_pInputLayout{ nullptr };
+		bool m_IsInstanced{ false };
+		uint64_t m_VariablesVersion{ 0 };
+		mutable std::mutex m_Mutex;
 
-		ID3DX11EffectMatrixVariable* m_pMatWorldViewProjVariable{ nullptr };
-		ID3DX11EffectShaderResourceVariable* m_pDiffuseMapVariable{ nullptr };
+		ID3DX11EffectVectorVariable* m_pInstanceUVTransformsVariable{ nullptr };
 
 		static Technique m_Technique;
 
@@ -52,6 +77,6 @@ namespace dae
 		ID3DX11EffectTechnique* FindTechnique(const std::string_view& name) const;
 		ID3DX11EffectVariable* FindVariable(const std::string_view& name) const;
 
-		static ID3DX11Effect* LoadEffect(ID3D11Device* pDevice, const std::wstring& assetFile);
+		static ID3DX11Effect* LoadEffect(ID3D11Device* pDevice, const std::wstring& assetFile, const std::vector<Define>& defines, ShaderCache* pShaderCache);
 	};
 }
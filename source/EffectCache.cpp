@@ -0,0 +1,89 @@
+#include "pch.h"
+#include "EffectCache.h"
+
+#include <chrono>
+
+namespace dae
+{
+	EffectCache::EffectCache(ID3D11Device* pDevice, const std::filesystem::path& shaderCacheDirectory)
+		: m_pDevice{ pDevice }
+		, m_ShaderCache{ shaderCacheDirectory }
+	{
+	}
+
+	std::shared_ptr<Effect> EffectCache::Get(const std::wstring& assetFile, const std::vector<Effect::Define>& defines)
+	{
+		++m_Statistics.numRequests;
+
+		const std::wstring key = CreateKey(assetFile, defines);
+		if (const auto it = m_Entries.find(key); it != m_Entries.end())
+		{
+			m_Statistics.savedMilliseconds += it->second.createMilliseconds;
+			return it->second.pEffect;
+		}
+
+		const auto start = std::chrono::high_resolution_clock::now();
+		std::shared_ptr<Effect> pEffect = std::make_shared<Effect>(m_pDevice, assetFile, defines, &m_ShaderCache);
+		const float milliseconds = std::chrono::duration<float, std::milli>(std::chrono::high_resolution_clock::now() - start).count();
+
+		++m_Statistics.numCreated;
+		m_Statistics.createMilliseconds += milliseconds;
+
+		//Failures are not cached, a fixed file compiles on the next request
+		if (!pEffect->IsValid())
+		{
+			std::wcout << L"Failed to compile " << assetFile << L"\n";
+			return nullptr;
+		}
+
+		m_Entries.emplace(key, Entry{ pEffect, milliseconds });
+		return pEffect;
+	}
+
+	void EffectCache::ReleaseUnused()
+	{
+		std::erase_if(m_Entries, [](const auto& entry) { return entry.second.pEffect.use_count() == 1; });
+	}
+
+	const EffectCache::Statistics& EffectCache::GetStatistics() const
+	{
+		return m_Statistics;
+	}
+
+	const ShaderCache& EffectCache::GetShaderCache() const
+	{
+		return m_ShaderCache;
+	}
+
+	void EffectCache::PrintStatistics() const
+	{
+		const ShaderCache::Statistics& shaderStatistics = m_ShaderCache.GetStatistics();
+		std::cout << "Effects: " << m_Entries.size() << " cached, " << m_Statistics.numCreated << " created for " << m_Statistics.numRequests << " requests"
+			<< " (create " << m_Statistics.createMilliseconds << " ms, saved " << m_Statistics.savedMilliseconds << " ms)"
+			<< " shader cache hits: " << shaderStatistics.numHits
+			<< " misses: " << shaderStatistics.numMisses
+			<< " rejected: " << shaderStatistics.numRejected
+			<< " stored: " << shaderStatistics.numStores << "\n";
+	}
+
+	std::wstring EffectCache::CreateKey(const std::wstring& assetFile, const std::vector<Effect::Define>& defines)
+	{
+		std::vector<const Effect::Define*> sortedDefines;
+		for (const Effect::Define& define : defines)
+		{
+			sortedDefines.push_back(&define);
+		}
+		std::sort(sortedDefines.begin(), sortedDefines.end(), [](const Effect::Define* pA, const Effect::Define* pB) { return pA->name < pB->name; });
+
+		//Defines are plain ASCII identifiers and values
+		std::wstring key{ assetFile };
+		for (const Effect::Define* pDefine : sortedDefines)
+		{
+			key += L'|';
+			key.append(pDefine->name.begin(), pDefine->name.end());
+			key += L'=';
+			key.append(pDefine->value.begin(), pDefine->value.end());
+		}
+		return key;
+	}
+}
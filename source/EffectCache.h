@@ -0,0 +1,62 @@
+#pragma once
+
+#include "Effect.h"
+
+#include <unordered_map>
+
+namespace dae
+{
+	// Creates every effect file once per set of defines and hands out the same Effect, input layout included,
+	// to every mesh that asks for it. Per mesh parameters stay on the mesh and are set again before every draw.
+	// Compiled binaries also go to an on-disk ShaderCache, so a warm start does not compile at all.
+	class EffectCache final
+	{
+	public:
+		struct Statistics
+		{
+			uint32_t numRequests{};
+			// Effects created, from the shader cache or the compiler
+			uint32_t numCreated{};
+			float createMilliseconds{};
+			// Creation time of every request that was served from memory
+			float savedMilliseconds{};
+		};
+
+	public:
+		explicit EffectCache(ID3D11Device* pDevice, const std::filesystem::path& shaderCacheDirectory = "Resources/ShaderCache");
+		~EffectCache() = default;
+
+		EffectCache(const EffectCache&)				= delete;
+		EffectCache& operator=(const EffectCache&)	= delete;
+		EffectCache(EffectCache&&)					= delete;
+		EffectCache& operator=(EffectCache&&)		= delete;
+
+		// The order of the defines does not matter, returns nullptr when the effect does not compile
+		std::shared_ptr<Effect> Get(const std::wstring& assetFile, const std::vector<Effect::Define>& defines = {});
+
+		// Drops the effects no mesh holds anymore
+		void ReleaseUnused();
+
+		const Statistics& GetStatistics() const;
+		const ShaderCache& GetShaderCache() const;
+		void PrintStatistics() const;
+
+	private:
+		struct Entry
+		{
+			std::shared_ptr<Effect> pEffect;
+			float createMilliseconds;
+		};
+
+		ID3D11Device* m_pDevice;
+		ShaderCache m_ShaderCache;
+
+		// Keyed by file and sorted defines
+		std::unordered_map<std::wstring, Entry> m_Entries;
+
+		Statistics m_Statistics{};
+
+	private:
+		static std::wstring CreateKey(const std::wstring& assetFile, const std::vector<Effect::Define>& defines);
+	};
+}
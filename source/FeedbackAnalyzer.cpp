@@ -0,0 +1,53 @@
+#include "FeedbackAnalyzer.h"
+
+#include <algorithm>
+
+namespace dae
+{
+	const std::vector<FeedbackAnalyzer::PageRequest>& FeedbackAnalyzer::Reduce(const uint32_t* pFeedback, size_t numTexels)
+	{
+		m_Runs.clear();
+		m_Requests.clear();
+
+		//Neighbouring texels mostly hit the same page, collapse those runs before sorting.
+		//The run length lives in the low bits so the sort still groups by page.
+		for (size_t i = 0; i < numTexels; )
+		{
+			const uint32_t key = pFeedback[i];
+			const size_t first = i;
+			while (i < numTexels && pFeedback[i] == key)
+			{
+				++i;
+			}
+
+			if (key != InvalidPage)
+			{
+				m_Runs.push_back((static_cast<uint64_t>(key) << 32) | static_cast<uint64_t>(i - first));
+			}
+		}
+
+		std::sort(m_Runs.begin(), m_Runs.end());
+
+		for (const uint64_t run : m_Runs)
+		{
+			const uint32_t key = static_cast<uint32_t>(run >> 32);
+			const uint32_t count = static_cast<uint32_t>(run);
+
+			if (!m_Requests.empty() && m_Requests.back().pageKey == key)
+			{
+				m_Requests.back().count += count;
+			}
+			else
+			{
+				m_Requests.push_back({ PageId::Unpack(key), key, count });
+			}
+		}
+
+		return m_Requests;
+	}
+
+	const std::vector<FeedbackAnalyzer::PageRequest>& FeedbackAnalyzer::GetRequests() const
+	{
+		return m_Requests;
+	}
+}
@@ -0,0 +1,40 @@
+#pragma once
+
+#include "PageTable.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace dae
+{
+	// Turns the feedback buffer (one packed PageId per texel) into a deduplicated list of requested pages
+	class FeedbackAnalyzer final
+	{
+	public:
+		struct PageRequest
+		{
+			PageId page;
+			uint32_t pageKey;
+			// Number of feedback texels that asked for this page
+			uint32_t count;
+		};
+
+	public:
+		FeedbackAnalyzer() = default;
+		~FeedbackAnalyzer() = default;
+
+		FeedbackAnalyzer(const FeedbackAnalyzer&)				= delete;
+		FeedbackAnalyzer& operator=(const FeedbackAnalyzer&)	= delete;
+		FeedbackAnalyzer(FeedbackAnalyzer&&)					= delete;
+		FeedbackAnalyzer& operator=(FeedbackAnalyzer&&)			= delete;
+
+		// Texels equal to InvalidPage are empty (cleared or not covered by a virtual textured mesh)
+		const std::vector<PageRequest>& Reduce(const uint32_t* pFeedback, size_t numTexels);
+		const std::vector<PageRequest>& GetRequests() const;
+
+	private:
+		std::vector<uint64_t> m_Runs;
+		std::vector<PageRequest> m_Requests;
+	};
+}
@@ -0,0 +1,553 @@
+#include "Frustum.h"
+#include "MathHelpers.h"
+
+#include <cassert>
+#include <chrono>
+#include <cstring>
+#include <iostream>
+#include <random>
+
+#if defined(DAE_MATH_SSE2)
+#include <immintrin.h>
+#endif
+
+#if defined(__GNUC__) || defined(__clang__)
+#define TARGET_AVX __attribute__((target("avx")))
+#else
+#define TARGET_AVX
+#endif
+
+namespace dae
+{
+	using MatrixSIMD::InstructionSet;
+
+	namespace
+	{
+		//Same evaluation order as the SIMD kernels, lane by lane
+		float SignedDistance(const Plane& plane, const Vector3& point)
+		{
+			return plane.normal.x * point.x + plane.normal.y * point.y + plane.normal.z * point.z + plane.distance;
+		}
+
+		Containment ToContainment(int outsideMask, int intersectingMask, int lane)
+		{
+			if (outsideMask & (1 << lane))
+				return Containment::Outside;
+			if (intersectingMask & (1 << lane))
+				return Containment::Intersecting;
+			return Containment::Inside;
+		}
+
+		void ExtractPlanesScalar(const Matrix& viewProjection, Plane* pPlanes)
+		{
+			//Plane i of the clip volume is a combination of the columns of the matrix
+			const Matrix columns = Matrix::Transpose(viewProjection);
+			const Vector4 planes[Frustum::NumPlanes]
+			{
+				columns[3] + columns[0],
+				columns[3] - columns[0],
+				columns[3] + columns[1],
+				columns[3] - columns[1],
+				columns[2],
+				columns[3] - columns[2]
+			};
+
+			for (int i = 0; i < Frustum::NumPlanes; ++i)
+			{
+				const float length = sqrtf(planes[i].x * planes[i].x + planes[i].y * planes[i].y + planes[i].z * planes[i].z);
+				pPlanes[i] = { { planes[i].x / length, planes[i].y / length, planes[i].z / length }, planes[i].w / length };
+			}
+		}
+
+#if defined(DAE_MATH_SSE2)
+#pragma region SSE2
+		void ExtractPlanesSSE2(const Matrix& viewProjection, Plane* pPlanes)
+		{
+			const float* pM = viewProjection.GetData();
+			__m128 c0 = _mm_load_ps(pM + 0);
+			__m128 c1 = _mm_load_ps(pM + 4);
+			__m128 c2 = _mm_load_ps(pM + 8);
+			__m128 c3 = _mm_load_ps(pM + 12);
+			_MM_TRANSPOSE4_PS(c0, c1, c2, c3);
+
+			const __m128 planes[Frustum::NumPlanes]
+			{
+				_mm_add_ps(c3, c0),
+				_mm_sub_ps(c3, c0),
+				_mm_add_ps(c3, c1),
+				_mm_sub_ps(c3, c1),
+				c2,
+				_mm_sub_ps(c3, c2)
+			};
+
+			for (int i = 0; i < Frustum::NumPlanes; ++i)
+			{
+				//x*x + y*y + z*z in the scalar order, so both paths give the same planes
+				const __m128 squared = _mm_mul_ps(planes[i], planes[i]);
+				__m128 lengthSquared = _mm_add_ss(squared, _mm_shuffle_ps(squared, squared, _MM_SHUFFLE(1, 1, 1, 1)));
+				lengthSquared = _mm_add_ss(lengthSquared, _mm_shuffle_ps(squared, squared, _MM_SHUFFLE(2, 2, 2, 2)));
+				const __m128 length = _mm_sqrt_ss(lengthSquared);
+
+				_mm_storeu_ps(&pPlanes[i].normal.x, _mm_div_ps(planes[i], _mm_shuffle_ps(length, length, _MM_SHUFFLE(0, 0, 0, 0))));
+			}
+		}
+
+		struct PlanesSSE2
+		{
+			__m128 nx[Frustum::NumPlanes];
+			__m128 ny[Frustum::NumPlanes];
+			__m128 nz[Frustum::NumPlanes];
+			__m128 d[Frustum::NumPlanes];
+			__m128 ax[Frustum::NumPlanes];
+			__m128 ay[Frustum::NumPlanes];
+			__m128 az[Frustum::NumPlanes];
+		};
+
+		PlanesSSE2 BroadcastSSE2(const Plane* pPlanes, const Vector3* pAbsNormals)
+		{
+			PlanesSSE2 planes{};
+			for (int i = 0; i < Frustum::NumPlanes; ++i)
+			{
+				planes.nx[i] = _mm_set1_ps(pPlanes[i].normal.x);
+				planes.ny[i] = _mm_set1_ps(pPlanes[i].normal.y);
+				planes.nz[i] = _mm_set1_ps(pPlanes[i].normal.z);
+				planes.d[i] = _mm_set1_ps(pPlanes[i].distance);
+				planes.ax[i] = _mm_set1_ps(pAbsNormals[i].x);
+				planes.ay[i] = _mm_set1_ps(pAbsNormals[i].y);
+				planes.az[i] = _mm_set1_ps(pAbsNormals[i].z);
+			}
+			return planes;
+		}
+
+		//Spheres: 4 x 16 bytes, one transpose gives center x/y/z and radius
+		inline void TransposeSpheresSSE2(const BoundingSphere* pSpheres, __m128& cx, __m128& cy, __m128& cz, __m128& r)
+		{
+			const float* pSrc = &pSpheres->center.x;
+			cx = _mm_loadu_ps(pSrc + 0);
+			cy = _mm_loadu_ps(pSrc + 4);
+			cz = _mm_loadu_ps(pSrc + 8);
+			r = _mm_loadu_ps(pSrc + 12);
+			_MM_TRANSPOSE4_PS(cx, cy, cz, r);
+		}
+
+		//Boxes: 4 x 24 bytes, loads at +0 give cx/cy/cz and loads at +2 give ex/ey/ez without reading past the last box
+		inline void TransposeBoxesSSE2(const BoundingBox* pBoxes, __m128& cx, __m128& cy, __m128& cz, __m128& ex, __m128& ey, __m128& ez)
+		{
+			const float* pSrc = &pBoxes->center.x;
+			cx = _mm_loadu_ps(pSrc + 0);
+			cy = _mm_loadu_ps(pSrc + 6);
+			cz = _mm_loadu_ps(pSrc + 12);
+			__m128 unused = _mm_loadu_ps(pSrc + 18);
+			_MM_TRANSPOSE4_PS(cx, cy, cz, unused);
+
+			unused = _mm_loadu_ps(pSrc + 2);
+			ex = _mm_loadu_ps(pSrc + 8);
+			ey = _mm_loadu_ps(pSrc + 14);
+			ez = _mm_loadu_ps(pSrc + 20);
+			_MM_TRANSPOSE4_PS(unused, ex, ey, ez);
+		}
+
+		inline __m128 SignedDistanceSSE2(const PlanesSSE2& planes, int p, __m128 cx, __m128 cy, __m128 cz)
+		{
+			return _mm_add_ps(_mm_add_ps(_mm_add_ps(_mm_mul_ps(planes.nx[p], cx), _mm_mul_ps(planes.ny[p], cy)), _mm_mul_ps(planes.nz[p], cz)), planes.d[p]);
+		}
+
+		void StoreSSE2(__m128 outside, __m128 intersecting, Containment* pResult)
+		{
+			const int outsideMask = _mm_movemask_ps(outside);
+			const int intersectingMask = _mm_movemask_ps(intersecting);
+			for (int lane = 0; lane < 4; ++lane)
+			{
+				pResult[lane] = ToContainment(outsideMask, intersectingMask, lane);
+			}
+		}
+
+		size_t ClassifySpheresSSE2(const PlanesSSE2& planes, std::span<const BoundingSphere> spheres, std::span<Containment> result)
+		{
+			const __m128 signMask = _mm_set1_ps(-0.0f);
+
+			size_t i{ 0 };
+			for (; i + 4 <= spheres.size(); i += 4)
+			{
+				__m128 cx, cy, cz, r;
+				TransposeSpheresSSE2(&spheres[i], cx, cy, cz, r);
+				const __m128 negativeR = _mm_xor_ps(r, signMask);
+
+				__m128 outside = _mm_setzero_ps();
+				__m128 intersecting = _mm_setzero_ps();
+				for (int p = 0; p < Frustum::NumPlanes; ++p)
+				{
+					const __m128 distance = SignedDistanceSSE2(planes, p, cx, cy, cz);
+					outside = _mm_or_ps(outside, _mm_cmplt_ps(distance, negativeR));
+					intersecting = _mm_or_ps(intersecting, _mm_cmplt_ps(distance, r));
+				}
+
+				StoreSSE2(outside, intersecting, &result[i]);
+			}
+			return i;
+		}
+
+		size_t ClassifyBoxesSSE2(const PlanesSSE2& planes, std::span<const BoundingBox> boxes, std::span<Containment> result)
+		{
+			const __m128 signMask = _mm_set1_ps(-0.0f);
+
+			size_t i{ 0 };
+			for (; i + 4 <= boxes.size(); i += 4)
+			{
+				__m128 cx, cy, cz, ex, ey, ez;
+				TransposeBoxesSSE2(&boxes[i], cx, cy, cz, ex, ey, ez);
+
+				__m128 outside = _mm_setzero_ps();
+				__m128 intersecting = _mm_setzero_ps();
+				for (int p = 0; p < Frustum::NumPlanes; ++p)
+				{
+					const __m128 distance = SignedDistanceSSE2(planes, p, cx, cy, cz);
+					const __m128 r = _mm_add_ps(_mm_add_ps(_mm_mul_ps(planes.ax[p], ex), _mm_mul_ps(planes.ay[p], ey)), _mm_mul_ps(planes.az[p], ez));
+					outside = _mm_or_ps(outside, _mm_cmplt_ps(distance, _mm_xor_ps(r, signMask)));
+					intersecting = _mm_or_ps(intersecting, _mm_cmplt_ps(distance, r));
+				}
+
+				StoreSSE2(outside, intersecting, &result[i]);
+			}
+			return i;
+		}
+#pragma endregion
+
+#pragma region AVX
+		//Two groups of 4 are transposed with SSE and joined, AVX has no cheaper 8 wide deinterleave for these strides
+		TARGET_AVX inline __m256 Join(__m128 low, __m128 high)
+		{
+			return _mm256_insertf128_ps(_mm256_castps128_ps256(low), high, 1);
+		}
+
+		TARGET_AVX void StoreAVX(__m256 outside, __m256 intersecting, Containment* pResult)
+		{
+			const int outsideMask = _mm256_movemask_ps(outside);
+			const int intersectingMask = _mm256_movemask_ps(intersecting);
+			for (int lane = 0; lane < 8; ++lane)
+			{
+				pResult[lane] = ToContainment(outsideMask, intersectingMask, lane);
+			}
+		}
+
+		TARGET_AVX size_t ClassifySpheresAVX(const Plane* pPlanes, std::span<const BoundingSphere> spheres, std::span<Containment> result)
+		{
+			__m256 nx[Frustum::NumPlanes], ny[Frustum::NumPlanes], nz[Frustum::NumPlanes], d[Frustum::NumPlanes];
+			for (int p = 0; p < Frustum::NumPlanes; ++p)
+			{
+				nx[p] = _mm256_set1_ps(pPlanes[p].normal.x);
+				ny[p] = _mm256_set1_ps(pPlanes[p].normal.y);
+				nz[p] = _mm256_set1_ps(pPlanes[p].normal.z);
+				d[p] = _mm256_set1_ps(pPlanes[p].distance);
+			}
+			const __m256 signMask = _mm256_set1_ps(-0.0f);
+
+			size_t i{ 0 };
+			for (; i + 8 <= spheres.size(); i += 8)
+			{
+				__m128 cx0, cy0, cz0, r0, cx1, cy1, cz1, r1;
+				TransposeSpheresSSE2(&spheres[i], cx0, cy0, cz0, r0);
+				TransposeSpheresSSE2(&spheres[i + 4], cx1, cy1, cz1, r1);
+				const __m256 cx = Join(cx0, cx1);
+				const __m256 cy = Join(cy0, cy1);
+				const __m256 cz = Join(cz0, cz1);
+				const __m256 r = Join(r0, r1);
+				const __m256 negativeR = _mm256_xor_ps(r, signMask);
+
+				__m256 outside = _mm256_setzero_ps();
+				__m256 intersecting = _mm256_setzero_ps();
+				for (int p = 0; p < Frustum::NumPlanes; ++p)
+				{
+					const __m256 distance = _mm256_add_ps(_mm256_add_ps(_mm256_add_ps(_mm256_mul_ps(nx[p], cx), _mm256_mul_ps(ny[p], cy)), _mm256_mul_ps(nz[p], cz)), d[p]);
+					outside = _mm256_or_ps(outside, _mm256_cmp_ps(distance, negativeR, _CMP_LT_OQ));
+					intersecting = _mm256_or_ps(intersecting, _mm256_cmp_ps(distance, r, _CMP_LT_OQ));
+				}
+
+				StoreAVX(outside, intersecting, &result[i]);
+			}
+			return i;
+		}
+
+		TARGET_AVX size_t ClassifyBoxesAVX(const Plane* pPlanes, const Vector3* pAbsNormals, std::span<const BoundingBox> boxes, std::span<Containment> result)
+		{
+			__m256 nx[Frustum::NumPlanes], ny[Frustum::NumPlanes], nz[Frustum::NumPlanes], d[Frustum::NumPlanes];
+			__m256 ax[Frustum::NumPlanes], ay[Frustum::NumPlanes], az[Frustum::NumPlanes];
+			for (int p = 0; p < Frustum::NumPlanes; ++p)
+			{
+				nx[p] = _mm256_set1_ps(pPlanes[p].normal.x);
+				ny[p] = _mm256_set1_ps(pPlanes[p].normal.y);
+				nz[p] = _mm256_set1_ps(pPlanes[p].normal.z);
+				d[p] = _mm256_set1_ps(pPlanes[p].distance);
+				ax[p] = _mm256_set1_ps(pAbsNormals[p].x);
+				ay[p] = _mm256_set1_ps(pAbsNormals[p].y);
+				az[p] = _mm256_set1_ps(pAbsNormals[p].z);
+			}
+			const __m256 signMask = _mm256_set1_ps(-0.0f);
+
+			size_t i{ 0 };
+			for (; i + 8 <= boxes.size(); i += 8)
+			{
+				__m128 cx0, cy0, cz0, ex0, ey0, ez0, cx1, cy1, cz1, ex1, ey1, ez1;
+				TransposeBoxesSSE2(&boxes[i], cx0, cy0, cz0, ex0, ey0, ez0);
+				TransposeBoxesSSE2(&boxes[i + 4], cx1, cy1, cz1, ex1, ey1, ez1);
+				const __m256 cx = Join(cx0, cx1);
+				const __m256 cy = Join(cy0, cy1);
+				const __m256 cz = Join(cz0, cz1);
+				const __m256 ex = Join(ex0, ex1);
+				const __m256 ey = Join(ey0, ey1);
+				const __m256 ez = Join(ez0, ez1);
+
+				__m256 outside = _mm256_setzero_ps();
+				__m256 intersecting = _mm256_setzero_ps();
+				for (int p = 0; p < Frustum::NumPlanes; ++p)
+				{
+					const __m256 distance = _mm256_add_ps(_mm256_add_ps(_mm256_add_ps(_mm256_mul_ps(nx[p], cx), _mm256_mul_ps(ny[p], cy)), _mm256_mul_ps(nz[p], cz)), d[p]);
+					const __m256 r = _mm256_add_ps(_mm256_add_ps(_mm256_mul_ps(ax[p], ex), _mm256_mul_ps(ay[p], ey)), _mm256_mul_ps(az[p], ez));
+					outside = _mm256_or_ps(outside, _mm256_cmp_ps(distance, _mm256_xor_ps(r, signMask), _CMP_LT_OQ));
+					intersecting = _mm256_or_ps(intersecting, _mm256_cmp_ps(distance, r, _CMP_LT_OQ));
+				}
+
+				StoreAVX(outside, intersecting, &result[i]);
+			}
+			return i;
+		}
+#pragma endregion
+#endif
+	}
+
+	Frustum::Frustum(const Matrix& viewProjection, InstructionSet instructionSet)
+	{
+		Update(viewProjection, instructionSet);
+	}
+
+	void Frustum::Update(const Matrix& viewProjection, InstructionSet instructionSet)
+	{
+#if defined(DAE_MATH_SSE2)
+		if (instructionSet != InstructionSet::Scalar)
+		{
+			ExtractPlanesSSE2(viewProjection, m_Planes);
+		}
+		else
+#endif
+		{
+			ExtractPlanesScalar(viewProjection, m_Planes);
+		}
+		(void)instructionSet;
+
+		for (int i = 0; i < NumPlanes; ++i)
+		{
+			const Vector3& normal = m_Planes[i].normal;
+			m_AbsNormals[i] = { std::abs(normal.x), std::abs(normal.y), std::abs(normal.z) };
+		}
+	}
+
+	const Plane& Frustum::GetPlane(int index) const
+	{
+		assert(index >= 0 && index < NumPlanes);
+		return m_Planes[index];
+	}
+
+	Containment Frustum::Classify(const BoundingSphere& sphere) const
+	{
+		Containment result{ Containment::Inside };
+		for (const Plane& plane : m_Planes)
+		{
+			const float distance = SignedDistance(plane, sphere.center);
+			if (distance < -sphere.radius)
+				return Containment::Outside;
+			if (distance < sphere.radius)
+				result = Containment::Intersecting;
+		}
+		return result;
+	}
+
+	Containment Frustum::Classify(const BoundingBox& box) const
+	{
+		Containment result{ Containment::Inside };
+		for (int i = 0; i < NumPlanes; ++i)
+		{
+			const float distance = SignedDistance(m_Planes[i], box.center);
+			const float radius = m_AbsNormals[i].x * box.extents.x + m_AbsNormals[i].y * box.extents.y + m_AbsNormals[i].z * box.extents.z;
+			if (distance < -radius)
+				return Containment::Outside;
+			if (distance < radius)
+				result = Containment::Intersecting;
+		}
+		return result;
+	}
+
+	void Frustum::Classify(std::span<const BoundingSphere> spheres, std::span<Containment> result, InstructionSet instructionSet) const
+	{
+		assert(result.size() >= spheres.size());
+
+		size_t i{ 0 };
+		switch (instructionSet)
+		{
+#if defined(DAE_MATH_SSE2)
+			case InstructionSet::SSE2:	i = ClassifySpheresSSE2(BroadcastSSE2(m_Planes, m_AbsNormals), spheres, result); break;
+			case InstructionSet::AVX:	i = ClassifySpheresAVX(m_Planes, spheres, result); break;
+#endif
+			default:					break;
+		}
+
+		for (; i < spheres.size(); ++i)
+		{
+			result[i] = Classify(spheres[i]);
+		}
+	}
+
+	void Frustum::Classify(std::span<const BoundingBox> boxes, std::span<Containment> result, InstructionSet instructionSet) const
+	{
+		assert(result.size() >= boxes.size());
+
+		size_t i{ 0 };
+		switch (instructionSet)
+		{
+#if defined(DAE_MATH_SSE2)
+			case InstructionSet::SSE2:	i = ClassifyBoxesSSE2(BroadcastSSE2(m_Planes, m_AbsNormals), boxes, result); break;
+			case InstructionSet::AVX:	i = ClassifyBoxesAVX(m_Planes, m_AbsNormals, boxes, result); break;
+#endif
+			default:					break;
+		}
+
+		for (; i < boxes.size(); ++i)
+		{
+			result[i] = Classify(boxes[i]);
+		}
+	}
+
+	void Frustum::Benchmark()
+	{
+		using Clock = std::chrono::high_resolution_clock;
+
+		//Enough repetitions to classify 10 million bounds per measurement
+		constexpr size_t numTestsPerMeasurement{ 10'000'000 };
+
+		const Matrix view = Matrix::InverseAffine(Matrix::CreateLookAtLH({ 3.0f, 5.0f, -60.0f }, { 0.1f, -0.05f, 1.0f }, Vector3::UnitY));
+		const Matrix viewProjection = view * Matrix::CreatePerspectiveFovLH(tanf(45.0f * TO_RADIANS / 2.0f), 16.0f / 9.0f, 1.0f, 100.0f);
+
+		std::vector<InstructionSet> instructionSets;
+		for (InstructionSet instructionSet : { InstructionSet::Scalar, InstructionSet::SSE2, InstructionSet::AVX })
+		{
+			if (MatrixSIMD::IsSupported(instructionSet))
+			{
+				instructionSets.push_back(instructionSet);
+			}
+		}
+
+		//Both plane extraction paths have to agree exactly
+		const Frustum frustum{ viewProjection, InstructionSet::Scalar };
+		bool arePlanesEqual{ true };
+		for (InstructionSet instructionSet : instructionSets)
+		{
+			const Frustum other{ viewProjection, instructionSet };
+			for (int i = 0; i < NumPlanes; ++i)
+			{
+				arePlanesEqual = arePlanesEqual && memcmp(&frustum.GetPlane(i), &other.GetPlane(i), sizeof(Plane)) == 0;
+			}
+		}
+		std::cout << "Frustum: plane extraction " << (arePlanesEqual ? "consistent" : "MISMATCH") << "\n";
+
+		//Clip space distances in plane order, the tolerance absorbs the rounding of the normalized planes
+		const auto getClipDistances = [&viewProjection](const Vector3& point, float* pDistances, float& tolerance)
+		{
+			const Vector4 clip = viewProjection.TransformPoint(point.ToPoint4());
+			const float distances[NumPlanes]{ clip.w + clip.x, clip.w - clip.x, clip.w + clip.y, clip.w - clip.y, clip.z, clip.w - clip.z };
+			std::copy(std::begin(distances), std::end(distances), pDistances);
+			tolerance = 1e-4f * (std::abs(clip.w) + 1.0f);
+		};
+
+		//Inside: every sample point is inside all planes. Outside: every sample point is outside one shared plane.
+		const auto isPlausible = [&getClipDistances](const Vector3* pPoints, int numPoints, Containment containment)
+		{
+			if (containment == Containment::Intersecting)
+				return true;
+
+			int numOutside[NumPlanes]{};
+			for (int i = 0; i < numPoints; ++i)
+			{
+				float distances[NumPlanes];
+				float tolerance{};
+				getClipDistances(pPoints[i], distances, tolerance);
+				for (int p = 0; p < NumPlanes; ++p)
+				{
+					if (containment == Containment::Inside && distances[p] < -tolerance)
+						return false;
+					if (distances[p] < tolerance)
+						++numOutside[p];
+				}
+			}
+
+			return containment == Containment::Inside || std::any_of(std::begin(numOutside), std::end(numOutside), [numPoints](int n) { return n == numPoints; });
+		};
+
+		std::mt19937 random{ 1337 };
+		std::uniform_real_distribution<float> positionDistribution{ -80.0f, 80.0f };
+		std::uniform_real_distribution<float> sizeDistribution{ 0.1f, 8.0f };
+
+		for (size_t numBounds : { 10'000u, 100'000u, 1'000'000u })
+		{
+			std::vector<BoundingSphere> spheres(numBounds);
+			std::vector<BoundingBox> boxes(numBounds);
+			for (size_t i = 0; i < numBounds; ++i)
+			{
+				const Vector3 center{ positionDistribution(random), positionDistribution(random), positionDistribution(random) * 0.5f + 40.0f };
+				spheres[i] = { center, sizeDistribution(random) };
+				boxes[i] = { center, { sizeDistribution(random), sizeDistribution(random), sizeDistribution(random) } };
+			}
+
+			std::vector<Containment> expectedSpheres(numBounds);
+			std::vector<Containment> expectedBoxes(numBounds);
+			bool isPlausibleResult{ true };
+			int counts[3]{};
+			for (size_t i = 0; i < numBounds; ++i)
+			{
+				expectedSpheres[i] = frustum.Classify(spheres[i]);
+				expectedBoxes[i] = frustum.Classify(boxes[i]);
+				++counts[static_cast<int>(expectedBoxes[i])];
+
+				const Vector3 c = spheres[i].center;
+				const float r = spheres[i].radius;
+				const Vector3 spherePoints[7]{ c, c + Vector3::UnitX * r, c - Vector3::UnitX * r, c + Vector3::UnitY * r, c - Vector3::UnitY * r, c + Vector3::UnitZ * r, c - Vector3::UnitZ * r };
+				//Only the Inside claim can be checked on the axis points, an Outside sphere can reach past them diagonally
+				isPlausibleResult = isPlausibleResult && (expectedSpheres[i] != Containment::Inside || isPlausible(spherePoints, 7, Containment::Inside));
+
+				Vector3 corners[8];
+				for (int corner = 0; corner < 8; ++corner)
+				{
+					const Vector3& e = boxes[i].extents;
+					corners[corner] = boxes[i].center + Vector3{ corner & 1 ? e.x : -e.x, corner & 2 ? e.y : -e.y, corner & 4 ? e.z : -e.z };
+				}
+				isPlausibleResult = isPlausibleResult && isPlausible(corners, 8, expectedBoxes[i]);
+			}
+
+			std::cout << "  " << numBounds << " bounds (boxes: " << counts[0] << " outside, " << counts[1] << " intersecting, " << counts[2] << " inside)"
+				<< ", clip space check " << (isPlausibleResult ? "passed" : "FAILED") << ", million bounds per second:\n";
+
+			const size_t numRepetitions = std::max(numTestsPerMeasurement / numBounds, size_t{ 1 });
+			std::vector<Containment> result(numBounds);
+			for (InstructionSet instructionSet : instructionSets)
+			{
+				Clock::time_point start = Clock::now();
+				for (size_t repetition = 0; repetition < numRepetitions; ++repetition)
+				{
+					frustum.Classify(spheres, result, instructionSet);
+				}
+				const float sphereSeconds = std::chrono::duration<float>(Clock::now() - start).count();
+				const bool areSpheresEqual = result == expectedSpheres;
+
+				start = Clock::now();
+				for (size_t repetition = 0; repetition < numRepetitions; ++repetition)
+				{
+					frustum.Classify(boxes, result, instructionSet);
+				}
+				const float boxSeconds = std::chrono::duration<float>(Clock::now() - start).count();
+				const bool areBoxesEqual = result == expectedBoxes;
+
+				const float numMillions = static_cast<float>(numBounds * numRepetitions) / 1'000'000.0f;
+				std::cout << "    " << MatrixSIMD::GetName(instructionSet) << ": spheres " << numMillions / sphereSeconds << (areSpheresEqual ? "" : " MISMATCH")
+					<< ", boxes " << numMillions / boxSeconds << (areBoxesEqual ? "" : " MISMATCH") << "\n";
+			}
+		}
+	}
+}
@@ -0,0 +1,79 @@
+#pragma once
+
+#include "Matrix.h"
+#include "MatrixSIMD.h"
+
+#include <cstdint>
+#include <span>
+
+namespace dae
+{
+	enum class Containment : uint8_t
+	{
+		Outside,
+		Intersecting,
+		Inside
+	};
+
+	// Points with Dot(normal, p) + distance >= 0 are on the inner side
+	struct Plane
+	{
+		Vector3 normal{};
+		float distance{};
+	};
+
+	struct BoundingSphere
+	{
+		Vector3 center{};
+		float radius{};
+	};
+
+	// Center and half size, cheaper to test than min/max
+	struct BoundingBox
+	{
+		Vector3 center{};
+		Vector3 extents{};
+	};
+
+	// View volume of a D3D style projection (0 <= z <= w), the planes are normalized so sphere tests work in world units.
+	// The batched tests classify 4 (SSE2) or 8 (AVX) bounds per iteration. Like every plane test they are conservative:
+	// bounds near a frustum corner can be reported as Intersecting while lying outside, never the other way around.
+	class Frustum final
+	{
+	public:
+		static constexpr int NumPlanes{ 6 };
+
+		enum PlaneIndex
+		{
+			Left,
+			Right,
+			Bottom,
+			Top,
+			Near,
+			Far
+		};
+
+		Frustum() = default;
+		explicit Frustum(const Matrix& viewProjection, MatrixSIMD::InstructionSet instructionSet = MatrixSIMD::CompiledInstructionSet);
+
+		// Rebuilds the planes, pass world * view * projection to get the planes in object space
+		void Update(const Matrix& viewProjection, MatrixSIMD::InstructionSet instructionSet = MatrixSIMD::CompiledInstructionSet);
+
+		const Plane& GetPlane(int index) const;
+
+		Containment Classify(const BoundingSphere& sphere) const;
+		Containment Classify(const BoundingBox& box) const;
+
+		// result must be at least as long as the input
+		void Classify(std::span<const BoundingSphere> spheres, std::span<Containment> result, MatrixSIMD::InstructionSet instructionSet = MatrixSIMD::CompiledInstructionSet) const;
+		void Classify(std::span<const BoundingBox> boxes, std::span<Containment> result, MatrixSIMD::InstructionSet instructionSet = MatrixSIMD::CompiledInstructionSet) const;
+
+		// Checks every set against the scalar path and the results against the clip space corners, then prints million bounds per second
+		static void Benchmark();
+
+	private:
+		Plane m_Planes[NumPlanes]{};
+		// |normal| per plane, the projected box radius is Dot(m_AbsNormals[i], extents)
+		Vector3 m_AbsNormals[NumPlanes]{};
+	};
+}
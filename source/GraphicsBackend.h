@@ -0,0 +1,96 @@
+#pragma once
+
+#include "RenderGraph.h"
+#include "ShaderCache.h"
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace dae
+{
+	// Handles are dense per backend, 0 is no resource
+	using BufferHandle = uint32_t;
+	using TextureHandle = uint32_t;
+	using PipelineHandle = uint32_t;
+
+	enum class BufferUsage
+	{
+		Vertex,
+		Index,
+		Constant
+	};
+
+	struct BufferDesc
+	{
+		BufferUsage usage;
+		uint32_t size;
+		// Rewritten with UpdateBuffer, otherwise the initial data is all it ever holds
+		bool isDynamic;
+	};
+
+	struct TextureDesc
+	{
+		uint32_t width;
+		uint32_t height;
+		RenderGraphFormat format;
+	};
+
+	// An effect pass with its input layout and fixed function state
+	struct PipelineDesc
+	{
+		std::wstring effectFile;
+		std::vector<ShaderDefine> defines;
+		uint32_t passIndex;
+	};
+
+	// Buffers, textures, pipelines and draws, everything the engine side of a frame needs from the GPU. D3D11Backend
+	// draws, HeadlessBackend records and counts so culling, sorting and submission run and can be measured without a GPU.
+	//
+	// Bindings stay until they are replaced, switching pipelines keeps them. Constant buffer ranges are given in 16 byte
+	// constants, first and count multiples of 16, a count of 0 binds the whole buffer.
+	class GraphicsBackend
+	{
+	public:
+		GraphicsBackend() = default;
+		virtual ~GraphicsBackend() = default;
+
+		GraphicsBackend(const GraphicsBackend&)				= delete;
+		GraphicsBackend& operator=(const GraphicsBackend&)	= delete;
+		GraphicsBackend(GraphicsBackend&&)					= delete;
+		GraphicsBackend& operator=(GraphicsBackend&&)		= delete;
+
+		// pInitialData may be nullptr for dynamic buffers, 0 when creation failed
+		virtual BufferHandle CreateBuffer(const BufferDesc& desc, const void* pInitialData) = 0;
+		// Dynamic buffers only, writes size bytes at offset. Discarding leaves the rest of the buffer undefined; without it
+		// the GPU may still be reading the rest, which the caller must not have written since it was last drawn with.
+		virtual bool UpdateBuffer(BufferHandle buffer, const void* pData, uint32_t size, uint32_t offset = 0, bool isDiscarding = true) = 0;
+		virtual void DestroyBuffer(BufferHandle buffer) = 0;
+
+		// pPixels holds width * height tightly packed pixels, nullptr leaves the content undefined
+		virtual TextureHandle CreateTexture(const TextureDesc& desc, const void* pPixels) = 0;
+		virtual void DestroyTexture(TextureHandle texture) = 0;
+
+		virtual PipelineHandle CreatePipeline(const PipelineDesc& desc) = 0;
+		virtual void DestroyPipeline(PipelineHandle pipeline) = 0;
+
+		// False without D3D 11.1 constant buffer offsetting, ranges must not be bound then
+		virtual bool IsConstantBufferRangeSupported() const = 0;
+		// False when constant buffers can only be updated with discard
+		virtual bool IsConstantBufferNoOverwriteSupported() const = 0;
+
+		virtual void BeginFrame() = 0;
+		virtual void EndFrame() = 0;
+
+		virtual void SetPipeline(PipelineHandle pipeline) = 0;
+		virtual void SetVertexBuffers(uint32_t startSlot, uint32_t numBuffers, const BufferHandle* pBuffers, const uint32_t* pStrides, const uint32_t* pOffsets) = 0;
+		// 32 bit indices
+		virtual void SetIndexBuffer(BufferHandle buffer) = 0;
+		virtual void SetConstantBuffer(uint32_t slot, BufferHandle buffer, uint32_t firstConstant = 0, uint32_t numConstants = 0) = 0;
+		// Pixel shader texture register
+		virtual void SetTexture(uint32_t slot, TextureHandle texture) = 0;
+
+		virtual void DrawIndexed(uint32_t indexCount, uint32_t startIndex, int32_t baseVertex) = 0;
+		virtual void DrawIndexedInstanced(uint32_t indexCount, uint32_t instanceCount, uint32_t startIndex, int32_t baseVertex, uint32_t startInstance) = 0;
+	};
+}
@@ -0,0 +1,238 @@
+#include "HeadlessBackend.h"
+
+#include <cstring>
+#include <iostream>
+
+namespace dae
+{
+	HeadlessBackend::HeadlessBackend(bool isConstantBufferRangeSupported)
+		: m_IsConstantBufferRangeSupported{ isConstantBufferRangeSupported }
+	{
+	}
+
+	BufferHandle HeadlessBackend::CreateBuffer(const BufferDesc& desc, const void* pInitialData)
+	{
+		Buffer buffer{ desc, std::vector<uint8_t>(desc.size), true };
+		if (pInitialData != nullptr)
+		{
+			std::memcpy(buffer.data.data(), pInitialData, desc.size);
+		}
+
+		m_Buffers.push_back(std::move(buffer));
+		m_Statistics.bufferBytes += desc.size;
+		return static_cast<BufferHandle>(m_Buffers.size());
+	}
+
+	bool HeadlessBackend::UpdateBuffer(BufferHandle buffer, const void* pData, uint32_t size, uint32_t offset, bool)
+	{
+		if (!IsBufferAlive(buffer))
+			return false;
+
+		//Discarding keeps the old contents here, what a GPU leaves undefined may as well stay
+		Buffer& updatedBuffer = m_Buffers[buffer - 1];
+		if (!updatedBuffer.desc.isDynamic || offset > updatedBuffer.desc.size || size > updatedBuffer.desc.size - offset)
+		{
+			std::cout << "Failed to update buffer " << buffer << ", it is static or too small!\n";
+			return false;
+		}
+
+		std::memcpy(updatedBuffer.data.data() + offset, pData, size);
+		m_Statistics.uploadedBytes += size;
+		Record(CommandType::UpdateBuffer, 0, buffer, size, offset);
+		return true;
+	}
+
+	void HeadlessBackend::DestroyBuffer(BufferHandle buffer)
+	{
+		if (!IsBufferAlive(buffer))
+			return;
+
+		Buffer& destroyedBuffer = m_Buffers[buffer - 1];
+		m_Statistics.bufferBytes -= destroyedBuffer.desc.size;
+		destroyedBuffer.data = {};
+		destroyedBuffer.isAlive = false;
+	}
+
+	TextureHandle HeadlessBackend::CreateTexture(const TextureDesc& desc, const void*)
+	{
+		m_Textures.push_back({ desc, true });
+		m_Statistics.textureBytes += RenderGraphTextureDesc{ desc.width, desc.height, desc.format }.GetSize();
+		return static_cast<TextureHandle>(m_Textures.size());
+	}
+
+	void HeadlessBackend::DestroyTexture(TextureHandle texture)
+	{
+		if (texture == 0 || texture > m_Textures.size() || !m_Textures[texture - 1].isAlive)
+			return;
+
+		const TextureDesc& desc = m_Textures[texture - 1].desc;
+		m_Statistics.textureBytes -= RenderGraphTextureDesc{ desc.width, desc.height, desc.format }.GetSize();
+		m_Textures[texture - 1].isAlive = false;
+	}
+
+	PipelineHandle HeadlessBackend::CreatePipeline(const PipelineDesc&)
+	{
+		m_Pipelines.push_back(true);
+		return static_cast<PipelineHandle>(m_Pipelines.size());
+	}
+
+	void HeadlessBackend::DestroyPipeline(PipelineHandle pipeline)
+	{
+		if (pipeline != 0 && pipeline <= m_Pipelines.size())
+		{
+			m_Pipelines[pipeline - 1] = false;
+		}
+	}
+
+	bool HeadlessBackend::IsConstantBufferRangeSupported() const
+	{
+		return m_IsConstantBufferRangeSupported;
+	}
+
+	bool HeadlessBackend::IsConstantBufferNoOverwriteSupported() const
+	{
+		return m_IsConstantBufferRangeSupported;
+	}
+
+	void HeadlessBackend::BeginFrame()
+	{
+		m_Statistics.numCommands = {};
+		m_Statistics.numInvalidDraws = 0;
+		m_Statistics.numTriangles = 0;
+		m_Statistics.uploadedBytes = 0;
+		m_Commands.clear();
+
+		m_FrameStart = std::chrono::steady_clock::now();
+	}
+
+	void HeadlessBackend::EndFrame()
+	{
+		m_Statistics.frameMilliseconds = std::chrono::duration<float, std::milli>(std::chrono::steady_clock::now() - m_FrameStart).count();
+		m_FrameStatistics = m_Statistics;
+	}
+
+	void HeadlessBackend::SetPipeline(PipelineHandle pipeline)
+	{
+		m_Pipeline = pipeline;
+		Record(CommandType::SetPipeline, 0, pipeline, 0);
+	}
+
+	void HeadlessBackend::SetVertexBuffers(uint32_t startSlot, uint32_t numBuffers, const BufferHandle* pBuffers, const uint32_t*, const uint32_t* pOffsets)
+	{
+		for (uint32_t i = 0; i < numBuffers; ++i)
+		{
+			if (startSlot + i == 0)
+			{
+				m_VertexBuffer = pBuffers[i];
+			}
+		}
+		Record(CommandType::SetVertexBuffers, startSlot, numBuffers > 0 ? pBuffers[0] : 0, numBuffers > 0 ? pOffsets[0] : 0);
+	}
+
+	void HeadlessBackend::SetIndexBuffer(BufferHandle buffer)
+	{
+		m_IndexBuffer = buffer;
+		Record(CommandType::SetIndexBuffer, 0, buffer, 0);
+	}
+
+	void HeadlessBackend::SetConstantBuffer(uint32_t slot, BufferHandle buffer, uint32_t firstConstant, uint32_t numConstants)
+	{
+		if (numConstants != 0 && (!m_IsConstantBufferRangeSupported || firstConstant % 16 != 0 || numConstants % 16 != 0))
+		{
+			std::cout << "Failed to bind constant range " << firstConstant << ", " << numConstants << "!\n";
+		}
+		Record(CommandType::SetConstantBuffer, slot, buffer, firstConstant);
+	}
+
+	void HeadlessBackend::SetTexture(uint32_t slot, TextureHandle texture)
+	{
+		Record(CommandType::SetTexture, slot, texture, 0);
+	}
+
+	void HeadlessBackend::DrawIndexed(uint32_t indexCount, uint32_t, int32_t)
+	{
+		if (!CanDraw())
+		{
+			++m_Statistics.numInvalidDraws;
+			return;
+		}
+
+		m_Statistics.numTriangles += indexCount / 3;
+		Record(CommandType::DrawIndexed, 0, indexCount, 1);
+	}
+
+	void HeadlessBackend::DrawIndexedInstanced(uint32_t indexCount, uint32_t instanceCount, uint32_t, int32_t, uint32_t)
+	{
+		if (!CanDraw())
+		{
+			++m_Statistics.numInvalidDraws;
+			return;
+		}
+
+		m_Statistics.numTriangles += static_cast<uint64_t>(indexCount / 3) * instanceCount;
+		Record(CommandType::DrawIndexedInstanced, 0, indexCount, instanceCount);
+	}
+
+	void HeadlessBackend::SetRecording(bool isRecording)
+	{
+		m_IsRecording = isRecording;
+	}
+
+	std::span<const HeadlessBackend::Command> HeadlessBackend::GetCommands() const
+	{
+		return m_Commands;
+	}
+
+	std::span<const uint8_t> HeadlessBackend::GetBufferData(BufferHandle buffer) const
+	{
+		if (!IsBufferAlive(buffer))
+			return {};
+
+		return m_Buffers[buffer - 1].data;
+	}
+
+	const HeadlessBackend::Statistics& HeadlessBackend::GetStatistics() const
+	{
+		return m_FrameStatistics;
+	}
+
+	uint32_t HeadlessBackend::GetNumCommands(CommandType type) const
+	{
+		return m_FrameStatistics.numCommands[static_cast<size_t>(type)];
+	}
+
+	void HeadlessBackend::PrintStatistics() const
+	{
+		const uint32_t numDraws = GetNumCommands(CommandType::DrawIndexed) + GetNumCommands(CommandType::DrawIndexedInstanced);
+		std::cout << "Headless: " << numDraws << " draws, " << m_FrameStatistics.numTriangles << " triangles"
+			<< " (" << GetNumCommands(CommandType::SetPipeline) << " pipelines, " << GetNumCommands(CommandType::SetVertexBuffers) << " vertex buffers, "
+			<< GetNumCommands(CommandType::SetTexture) << " textures, " << GetNumCommands(CommandType::SetConstantBuffer) << " constant buffers, "
+			<< GetNumCommands(CommandType::UpdateBuffer) << " updates of " << m_FrameStatistics.uploadedBytes << " bytes)";
+
+		if (m_FrameStatistics.numInvalidDraws > 0)
+		{
+			std::cout << " " << m_FrameStatistics.numInvalidDraws << " invalid draws!";
+		}
+		std::cout << " in " << m_FrameStatistics.frameMilliseconds << " ms\n";
+	}
+
+	void HeadlessBackend::Record(CommandType type, uint32_t slot, uint32_t handle, uint32_t argument, uint32_t offset)
+	{
+		++m_Statistics.numCommands[static_cast<size_t>(type)];
+		if (m_IsRecording)
+		{
+			m_Commands.push_back({ type, slot, handle, argument, offset });
+		}
+	}
+
+	bool HeadlessBackend::IsBufferAlive(BufferHandle buffer) const
+	{
+		return buffer != 0 && buffer <= m_Buffers.size() && m_Buffers[buffer - 1].isAlive;
+	}
+
+	bool HeadlessBackend::CanDraw() const
+	{
+		const bool isPipelineAlive = m_Pipeline != 0 && m_Pipeline <= m_Pipelines.size() && m_Pipelines[m_Pipeline - 1];
+		return isPipelineAlive && IsBufferAlive(m_IndexBuffer) && IsBufferAlive(m_VertexBuffer);
+	}
+}
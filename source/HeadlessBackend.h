@@ -0,0 +1,134 @@
+#pragma once
+
+#include "GraphicsBackend.h"
+
+#include <array>
+#include <chrono>
+#include <span>
+
+namespace dae
+{
+	// A GraphicsBackend without a GPU. Buffers are kept in memory so updates cost the copy a mapped buffer would, every
+	// command is counted per frame and optionally recorded. Draws with nothing to draw (no pipeline, index or vertex
+	// buffer, or a destroyed handle) are counted as invalid instead of failing.
+	class HeadlessBackend final : public GraphicsBackend
+	{
+	public:
+		enum class CommandType : uint8_t
+		{
+			SetPipeline,
+			SetVertexBuffers,
+			SetIndexBuffer,
+			SetConstantBuffer,
+			SetTexture,
+			UpdateBuffer,
+			DrawIndexed,
+			DrawIndexedInstanced,
+			Count
+		};
+
+		struct Command
+		{
+			CommandType type;
+			// Slot for bindings, 0 otherwise
+			uint32_t slot;
+			// Bound or updated handle, index count for draws
+			uint32_t handle;
+			// First constant, bytes updated or instance count
+			uint32_t argument;
+			// Offset of an update, 0 otherwise
+			uint32_t offset;
+		};
+
+		struct Statistics
+		{
+			std::array<uint32_t, static_cast<size_t>(CommandType::Count)> numCommands{};
+			uint32_t numInvalidDraws{};
+			uint64_t numTriangles{};
+			size_t uploadedBytes{};
+			size_t bufferBytes{};
+			size_t textureBytes{};
+			// CPU time between BeginFrame and EndFrame
+			float frameMilliseconds{};
+		};
+
+	public:
+		explicit HeadlessBackend(bool isConstantBufferRangeSupported = true);
+		~HeadlessBackend() override = default;
+
+		BufferHandle CreateBuffer(const BufferDesc& desc, const void* pInitialData) override;
+		bool UpdateBuffer(BufferHandle buffer, const void* pData, uint32_t size, uint32_t offset, bool isDiscarding) override;
+		void DestroyBuffer(BufferHandle buffer) override;
+
+		TextureHandle CreateTexture(const TextureDesc& desc, const void* pPixels) override;
+		void DestroyTexture(TextureHandle texture) override;
+
+		PipelineHandle CreatePipeline(const PipelineDesc& desc) override;
+		void DestroyPipeline(PipelineHandle pipeline) override;
+
+		bool IsConstantBufferRangeSupported() const override;
+		// Same as range support, both came with D3D 11.1
+		bool IsConstantBufferNoOverwriteSupported() const override;
+
+		void BeginFrame() override;
+		void EndFrame() override;
+
+		void SetPipeline(PipelineHandle pipeline) override;
+		void SetVertexBuffers(uint32_t startSlot, uint32_t numBuffers, const BufferHandle* pBuffers, const uint32_t* pStrides, const uint32_t* pOffsets) override;
+		void SetIndexBuffer(BufferHandle buffer) override;
+		void SetConstantBuffer(uint32_t slot, BufferHandle buffer, uint32_t firstConstant, uint32_t numConstants) override;
+		void SetTexture(uint32_t slot, TextureHandle texture) override;
+
+		void DrawIndexed(uint32_t indexCount, uint32_t startIndex, int32_t baseVertex) override;
+		void DrawIndexedInstanced(uint32_t indexCount, uint32_t instanceCount, uint32_t startIndex, int32_t baseVertex, uint32_t startInstance) override;
+
+		// Off by default, the counts are always kept
+		void SetRecording(bool isRecording);
+		// Commands of the current frame, or of the last one after EndFrame
+		std::span<const Command> GetCommands() const;
+		// Content of a buffer as last written
+		std::span<const uint8_t> GetBufferData(BufferHandle buffer) const;
+
+		// Of the last finished frame
+		const Statistics& GetStatistics() const;
+		uint32_t GetNumCommands(CommandType type) const;
+		void PrintStatistics() const;
+
+	private:
+		struct Buffer
+		{
+			BufferDesc desc;
+			std::vector<uint8_t> data;
+			bool isAlive;
+		};
+
+		struct Texture
+		{
+			TextureDesc desc;
+			bool isAlive;
+		};
+
+		const bool m_IsConstantBufferRangeSupported;
+
+		// Index is handle - 1
+		std::vector<Buffer> m_Buffers{};
+		std::vector<Texture> m_Textures{};
+		std::vector<bool> m_Pipelines{};
+
+		PipelineHandle m_Pipeline{ 0 };
+		BufferHandle m_IndexBuffer{ 0 };
+		BufferHandle m_VertexBuffer{ 0 };
+
+		bool m_IsRecording{ false };
+		std::vector<Command> m_Commands{};
+
+		Statistics m_Statistics{};
+		Statistics m_FrameStatistics{};
+		std::chrono::steady_clock::time_point m_FrameStart{};
+
+	private:
+		void Record(CommandType type, uint32_t slot, uint32_t handle, uint32_t argument, uint32_t offset = 0);
+		bool IsBufferAlive(BufferHandle buffer) const;
+		bool CanDraw() const;
+	};
+}
@@ -0,0 +1,15 @@
+#pragma once
+
+#include <cstdint>
+#include <vector>
+
+namespace dae
+{
+	// Decoded RGBA8 pixels, rows are tightly packed
+	struct Image
+	{
+		uint32_t width{};
+		uint32_t height{};
+		std::vector<uint8_t> pixels;
+	};
+}
@@ -0,0 +1,195 @@
+#include "pch.h"
+#include "InstanceBatch.h"
+
+#include <cassert>
+#include <chrono>
+#include <limits>
+
+namespace dae
+{
+	InstanceBatch::InstanceBatch(GraphicsBackend& backend, const Mesh* pMesh, std::shared_ptr<Effect> pEffect)
+		: m_Backend{ backend }
+		, m_pMesh{ pMesh }
+		, m_pEffect{ std::move(pEffect) }
+	{
+		assert(m_pMesh != nullptr);
+		assert(m_pEffect == nullptr || m_pEffect->IsInstanced());
+	}
+
+	InstanceBatch::~InstanceBatch()
+	{
+		m_Backend.DestroyBuffer(m_InstanceBuffer);
+	}
+
+	uint32_t InstanceBatch::Add(const Matrix& worldMatrix, uint32_t materialIndex)
+	{
+		m_WorldMatrices.push_back(worldMatrix);
+		m_MaterialIndices.push_back(materialIndex);
+		m_Bounds.push_back(CalculateBounds(worldMatrix));
+		return static_cast<uint32_t>(m_WorldMatrices.size() - 1);
+	}
+
+	void InstanceBatch::SetWorldMatrix(uint32_t index, const Matrix& worldMatrix)
+	{
+		assert(index < m_WorldMatrices.size());
+		m_WorldMatrices[index] = worldMatrix;
+		m_Bounds[index] = CalculateBounds(worldMatrix);
+	}
+
+	void InstanceBatch::SetMaterialIndex(uint32_t index, uint32_t materialIndex)
+	{
+		assert(index < m_MaterialIndices.size());
+		m_MaterialIndices[index] = materialIndex;
+	}
+
+	void InstanceBatch::Clear()
+	{
+		m_WorldMatrices.clear();
+		m_MaterialIndices.clear();
+		m_Bounds.clear();
+		m_NumVisible = 0;
+	}
+
+	uint32_t InstanceBatch::GetNumInstances() const
+	{
+		return static_cast<uint32_t>(m_WorldMatrices.size());
+	}
+
+	const Mesh* InstanceBatch::GetMesh() const
+	{
+		return m_pMesh;
+	}
+
+	const Effect* InstanceBatch::GetEffect() const
+	{
+		return m_pEffect.get();
+	}
+
+	void InstanceBatch::SetMaterialUVTransforms(std::vector<Vector4> uvTransforms)
+	{
+		if (uvTransforms.size() > Effect::MaxInstanceMaterials)
+		{
+			std::cout << "Too many instance materials, only the first " << Effect::MaxInstanceMaterials << " are used!\n";
+			uvTransforms.resize(Effect::MaxInstanceMaterials);
+		}
+		m_MaterialUVTransforms = std::move(uvTransforms);
+	}
+
+	void InstanceBatch::Update(const Camera& camera, float screenHeight)
+	{
+		const auto cullStart = std::chrono::high_resolution_clock::now();
+
+		//The batched sphere test, then the survivors are packed in instance order
+		const Frustum frustum{ camera.viewMatrix * camera.projectionMatrix };
+		m_Containments.resize(m_Bounds.size());
+		frustum.Classify(m_Bounds, m_Containments);
+
+		m_VisibleInstances.clear();
+		size_t nearestIndex{ m_Containments.size() };
+		float nearestDistance{ std::numeric_limits<float>::max() };
+		for (size_t i = 0; i < m_Containments.size(); ++i)
+		{
+			if (m_Containments[i] == Containment::Outside)
+				continue;
+
+			InstanceData& instance = m_VisibleInstances.emplace_back();
+			std::copy_n(m_WorldMatrices[i].GetData(), 16, instance.world);
+			instance.materialIndex = m_MaterialIndices[i];
+
+			const float distance = (m_Bounds[i].center - camera.origin).Magnitude() - m_Bounds[i].radius;
+			if (distance < nearestDistance)
+			{
+				nearestDistance = distance;
+				nearestIndex = i;
+			}
+		}
+
+		//The nearest instance needs the finest mips, the textures are shared by all of them
+		if (nearestIndex < m_Containments.size())
+		{
+			m_pMesh->RequestTextureMips(camera, screenHeight, m_WorldMatrices[nearestIndex]);
+		}
+
+		const auto uploadStart = std::chrono::high_resolution_clock::now();
+
+		m_NumVisible = 0;
+		const uint32_t numVisible = static_cast<uint32_t>(m_VisibleInstances.size());
+		if (numVisible > 0 && Reserve(numVisible) && m_Backend.UpdateBuffer(m_InstanceBuffer, m_VisibleInstances.data(), numVisible * sizeof(InstanceData)))
+		{
+			m_NumVisible = numVisible;
+		}
+
+		//Set here, on the main thread, so the pass applied while recording only reads them
+		if (m_pEffect)
+		{
+			const Material& material = m_pMesh->GetMaterial();
+			const std::lock_guard lock{ m_pEffect->GetMutex() };
+			if (m_MaterialUVTransforms.empty())
+			{
+				m_pEffect->SetInstanceUVTransforms({ &material.diffuseUVTransform, 1 });
+			}
+			else
+			{
+				m_pEffect->SetInstanceUVTransforms(m_MaterialUVTransforms);
+			}
+		}
+
+		const auto end = std::chrono::high_resolution_clock::now();
+
+		m_Statistics.numInstances = GetNumInstances();
+		m_Statistics.numVisible = m_NumVisible;
+		m_Statistics.cullMilliseconds = std::chrono::duration<float, std::milli>(uploadStart - cullStart).count();
+		m_Statistics.uploadMilliseconds = std::chrono::duration<float, std::milli>(end - uploadStart).count();
+	}
+
+	BufferHandle InstanceBatch::GetInstanceBuffer() const
+	{
+		return m_InstanceBuffer;
+	}
+
+	uint32_t InstanceBatch::GetNumVisible() const
+	{
+		return m_NumVisible;
+	}
+
+	const InstanceBatch::Statistics& InstanceBatch::GetStatistics() const
+	{
+		return m_Statistics;
+	}
+
+	void InstanceBatch::PrintStatistics() const
+	{
+		std::cout << "Instances: " << m_Statistics.numVisible << " of " << m_Statistics.numInstances << " visible"
+			<< " (cull " << m_Statistics.cullMilliseconds << " ms, upload " << m_Statistics.uploadMilliseconds << " ms)\n";
+	}
+
+	BoundingSphere InstanceBatch::CalculateBounds(const Matrix& worldMatrix) const
+	{
+		//The largest axis scale keeps the sphere conservative under non uniform scale
+		const BoundingSphere bounds = m_pMesh->GetBounds();
+		const float scale = std::sqrt(std::max({ worldMatrix.GetAxisX().SqrMagnitude(), worldMatrix.GetAxisY().SqrMagnitude(), worldMatrix.GetAxisZ().SqrMagnitude() }));
+		return { worldMatrix.TransformPoint(bounds.center), bounds.radius * scale };
+	}
+
+	bool InstanceBatch::Reserve(uint32_t numInstances)
+	{
+		if (numInstances <= m_Capacity)
+			return true;
+
+		m_Backend.DestroyBuffer(m_InstanceBuffer);
+
+		//Doubling keeps the number of reallocations low while the visible count grows
+		const uint32_t capacity = std::max(numInstances, m_Capacity * 2);
+
+		m_InstanceBuffer = m_Backend.CreateBuffer({ BufferUsage::Vertex, static_cast<uint32_t>(sizeof(InstanceData)) * capacity, true }, nullptr);
+		if (m_InstanceBuffer == 0)
+		{
+			std::cout << "Failed to create instance buffer!\n";
+			m_Capacity = 0;
+			return false;
+		}
+
+		m_Capacity = capacity;
+		return true;
+	}
+}
@@ -0,0 +1,91 @@
+#pragma once
+
+#include "Effect.h"
+#include "Mesh.h"
+
+namespace dae
+{
+	// Per instance vertex data (slot 1), matches the INSTANCE_* elements of an instanced Effect
+	struct InstanceData
+	{
+		float world[16];
+		uint32_t materialIndex;
+	};
+
+	static_assert(sizeof(InstanceData) == 68, "Effect builds the instance input layout with these offsets");
+
+	// Draws many copies of one Mesh with a single DrawIndexedInstanced. The mesh keeps its vertex and index buffers and
+	// its material textures, the batch adds a buffer of world matrices and material indices. Update culls the instances
+	// against the camera every frame and uploads only the visible ones, packed at the front of the buffer; a BackendScene
+	// object draws them (see BackendScene::SetObjectInstances).
+	class InstanceBatch final
+	{
+	public:
+		struct Statistics
+		{
+			uint32_t numInstances{};
+			uint32_t numVisible{};
+			float cullMilliseconds{};
+			float uploadMilliseconds{};
+		};
+
+	public:
+		// pMesh and backend must outlive the batch. pEffect must be created with Effect::InstancedDefine, it is the effect
+		// of the pipeline the batch is drawn with and gets the material UV transforms.
+		InstanceBatch(GraphicsBackend& backend, const Mesh* pMesh, std::shared_ptr<Effect> pEffect);
+		~InstanceBatch();
+
+		InstanceBatch(const InstanceBatch&)				= delete;
+		InstanceBatch& operator=(const InstanceBatch&)	= delete;
+		InstanceBatch(InstanceBatch&&)					= delete;
+		InstanceBatch& operator=(InstanceBatch&&)		= delete;
+
+		// Returns the index of the new instance
+		uint32_t Add(const Matrix& worldMatrix, uint32_t materialIndex = 0);
+		void SetWorldMatrix(uint32_t index, const Matrix& worldMatrix);
+		void SetMaterialIndex(uint32_t index, uint32_t materialIndex);
+		void Clear();
+		uint32_t GetNumInstances() const;
+
+		const Mesh* GetMesh() const;
+		const Effect* GetEffect() const;
+
+		// Diffuse UV transform (xy scale, zw offset) per material index, e.g. the regions of a TextureAtlas.
+		// Empty uses the transform of the mesh material for every instance.
+		void SetMaterialUVTransforms(std::vector<Vector4> uvTransforms);
+
+		// Culls and uploads the visible instances and requests the mips the nearest visible instance needs from texture
+		// streaming. Call once per frame before TextureResidency::Update and before the batch is drawn.
+		void Update(const Camera& camera, float screenHeight);
+		// The visible instances of the last Update, packed at the front
+		BufferHandle GetInstanceBuffer() const;
+		uint32_t GetNumVisible() const;
+
+		const Statistics& GetStatistics() const;
+		void PrintStatistics() const;
+
+	private:
+		GraphicsBackend& m_Backend;
+		const Mesh* m_pMesh;
+		std::shared_ptr<Effect> m_pEffect;
+
+		std::vector<Matrix> m_WorldMatrices;
+		std::vector<uint32_t> m_MaterialIndices;
+		// World space, kept up to date by Add and SetWorldMatrix
+		std::vector<BoundingSphere> m_Bounds;
+		std::vector<Containment> m_Containments;
+		std::vector<InstanceData> m_VisibleInstances;
+		std::vector<Vector4> m_MaterialUVTransforms;
+
+		BufferHandle m_InstanceBuffer{ 0 };
+		uint32_t m_Capacity{};
+		uint32_t m_NumVisible{};
+
+		Statistics m_Statistics{};
+
+	private:
+		BoundingSphere CalculateBounds(const Matrix& worldMatrix) const;
+		// Grows the buffer to at least numInstances, false when it could not be created
+		bool Reserve(uint32_t numInstances);
+	};
+}
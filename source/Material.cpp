@@ -0,0 +1,255 @@
+#include "pch.h"
+#include "Material.h"
+#include "Texture.h"
+#include "TextureAtlas.h"
+#include "TextureLoader.h"
+
+#include <filesystem>
+#include <fstream>
+
+namespace dae
+{
+	namespace
+	{
+		constexpr uint32_t bytesPerPixel{ 4 };
+
+		//A missing file counts as infinitely old
+		std::filesystem::file_time_type GetWriteTime(const std::string& filepath)
+		{
+			std::error_code error{};
+			const std::filesystem::file_time_type time = std::filesystem::last_write_time(filepath, error);
+			return error ? std::filesystem::file_time_type::min() : time;
+		}
+
+		bool IsUpToDate(const std::string& packedPath, const MaterialImport::Sources& sources)
+		{
+			const std::filesystem::file_time_type packedTime = GetWriteTime(packedPath);
+			if (packedTime == std::filesystem::file_time_type::min())
+				return false;
+
+			for (const std::string* pSource : { &sources.normalMap, &sources.glossMap, &sources.specularMap })
+			{
+				if (GetWriteTime(*pSource) > packedTime)
+					return false;
+			}
+			return true;
+		}
+
+		//The packed map and the manifest live in a cache directory that may not exist yet
+		void CreateParentDirectory(const std::string& filepath)
+		{
+			const std::filesystem::path directory = std::filesystem::path{ filepath }.parent_path();
+			if (directory.empty())
+				return;
+
+			std::error_code error{};
+			std::filesystem::create_directories(directory, error);
+		}
+
+		Material LoadAtlas(ID3D11Device* pDevice, const MaterialImport::Manifest& manifest, TextureLoader& textureLoader)
+		{
+			const bool hasPackedMap = !manifest.normalGlossSpecularMap.empty();
+
+			//The diffuse map and its variants first, the packed map last, all decoded in one go
+			std::vector<std::string> filepaths{ manifest.diffuseMap };
+			filepaths.insert(filepaths.end(), manifest.diffuseVariants.begin(), manifest.diffuseVariants.end());
+			const size_t numDiffuseMaps = filepaths.size();
+			if (hasPackedMap)
+			{
+				filepaths.push_back(manifest.normalGlossSpecularMap);
+			}
+
+			std::vector<uint8_t> isDecoded;
+			std::vector<Image> images = textureLoader.DecodeImages(filepaths, isDecoded);
+
+			Material material{};
+			if (hasPackedMap && isDecoded.back())
+			{
+				material.pNormalGlossSpecularMap = std::make_shared<Texture>(pDevice, manifest.normalGlossSpecularMap, images.back());
+				images.pop_back();
+			}
+
+			//Every variant or none, the material indices of the instances refer to the variant order
+			const bool isEveryDiffuseMapDecoded = std::all_of(isDecoded.begin(), isDecoded.begin() + numDiffuseMaps, [](uint8_t isImageDecoded) { return isImageDecoded; });
+			if (isEveryDiffuseMapDecoded)
+			{
+				images.resize(numDiffuseMaps);
+
+				const TextureAtlas atlas{ pDevice, images };
+				if (atlas.IsValid())
+				{
+					material.pDiffuseMap = atlas.GetTexture();
+					for (uint32_t i = 0; i < atlas.GetNumRegions(); ++i)
+					{
+						material.diffuseUVTransforms.push_back(atlas.GetRegion(i).uvTransform);
+					}
+					material.diffuseUVTransform = material.diffuseUVTransforms.front();
+					return material;
+				}
+			}
+
+			std::cout << "Failed to build the diffuse atlas of \"" << manifest.diffuseMap << "\", using it without its variants!\n";
+			if (isDecoded.front())
+			{
+				material.pDiffuseMap = std::make_shared<Texture>(pDevice, manifest.diffuseMap, images.front());
+			}
+			return material;
+		}
+	}
+
+	bool MaterialImport::Import(const std::string& manifestPath, const std::string& packedPath, const Sources& sources, Manifest& manifest, TextureLoader& textureLoader)
+	{
+		manifest.diffuseMap = sources.diffuseMap;
+		manifest.normalGlossSpecularMap = packedPath;
+		manifest.diffuseVariants = sources.diffuseVariants;
+
+		const bool isPackedUpToDate = IsUpToDate(packedPath, sources);
+		if (isPackedUpToDate && GetWriteTime(manifestPath) != std::filesystem::file_time_type::min())
+		{
+			Manifest cachedManifest = manifest;
+			if (!ReadManifest(manifestPath, cachedManifest))
+				return false;
+
+			if (cachedManifest.diffuseVariants == sources.diffuseVariants)
+			{
+				manifest = std::move(cachedManifest);
+				return true;
+			}
+		}
+
+		CreateParentDirectory(manifestPath);
+		if (isPackedUpToDate)
+			return WriteManifest(manifestPath, manifest);
+
+		std::vector<uint8_t> isDecoded;
+		const std::vector<Image> images = textureLoader.DecodeImages({ sources.normalMap, sources.glossMap, sources.specularMap }, isDecoded);
+		if (std::find(isDecoded.begin(), isDecoded.end(), uint8_t{ false }) != isDecoded.end())
+		{
+			std::cout << "Failed to import material \"" << manifestPath << "\", a source map could not be decoded!\n";
+			return false;
+		}
+
+		Image packed{};
+		if (!Pack(images[0], images[1], images[2], packed))
+		{
+			std::cout << "Failed to import material \"" << manifestPath << "\", the source maps differ in size!\n";
+			return false;
+		}
+
+		CreateParentDirectory(packedPath);
+		if (!Texture::SavePNG(packedPath, packed))
+			return false;
+
+		std::cout << "Packed \"" << sources.normalMap << "\", \"" << sources.glossMap << "\" and \"" << sources.specularMap << "\" into \"" << packedPath << "\"\n";
+		return WriteManifest(manifestPath, manifest);
+	}
+
+	bool MaterialImport::ReadManifest(const std::string& manifestPath, Manifest& manifest)
+	{
+		std::ifstream file(manifestPath);
+		if (!file)
+		{
+			std::cout << "Failed to open material manifest \"" << manifestPath << "\"!\n";
+			return false;
+		}
+
+		//The variants of the file replace the ones already in manifest, none at all included
+		std::vector<std::string> diffuseVariants;
+
+		std::string line;
+		while (std::getline(file, line))
+		{
+			const size_t separator = line.find('=');
+			if (separator == std::string::npos)
+				continue;
+
+			const std::string key = line.substr(0, separator);
+			const std::string value = line.substr(separator + 1);
+
+			if (key == "diffuse")
+			{
+				manifest.diffuseMap = value;
+			}
+			else if (key == "normalGlossSpecular")
+			{
+				manifest.normalGlossSpecularMap = value;
+			}
+			else if (key == "diffuseVariant")
+			{
+				diffuseVariants.push_back(value);
+			}
+		}
+
+		manifest.diffuseVariants = std::move(diffuseVariants);
+		return true;
+	}
+
+	bool MaterialImport::WriteManifest(const std::string& manifestPath, const Manifest& manifest)
+	{
+		std::ofstream file(manifestPath);
+		if (!file)
+		{
+			std::cout << "Failed to write material manifest \"" << manifestPath << "\"!\n";
+			return false;
+		}
+
+		file << "diffuse=" << manifest.diffuseMap << "\n";
+		file << "normalGlossSpecular=" << manifest.normalGlossSpecularMap << "\n";
+		for (const std::string& diffuseVariant : manifest.diffuseVariants)
+		{
+			file << "diffuseVariant=" << diffuseVariant << "\n";
+		}
+		return true;
+	}
+
+	bool MaterialImport::Pack(const Image& normalMap, const Image& glossMap, const Image& specularMap, Image& packed)
+	{
+		const bool isSameSize =
+			normalMap.width == glossMap.width && normalMap.width == specularMap.width &&
+			normalMap.height == glossMap.height && normalMap.height == specularMap.height;
+
+		if (!isSameSize)
+			return false;
+
+		packed.width = normalMap.width;
+		packed.height = normalMap.height;
+		packed.pixels.resize(normalMap.pixels.size());
+
+		//The normal z is reconstructed in the shader, gloss and specular are grayscale so one channel each is enough
+		const size_t numPixels = static_cast<size_t>(packed.width) * packed.height;
+		for (size_t i = 0; i < numPixels; ++i)
+		{
+			const size_t offset = i * bytesPerPixel;
+			packed.pixels[offset + 0] = normalMap.pixels[offset + 0];
+			packed.pixels[offset + 1] = normalMap.pixels[offset + 1];
+			packed.pixels[offset + 2] = glossMap.pixels[offset + 0];
+			packed.pixels[offset + 3] = specularMap.pixels[offset + 0];
+		}
+
+		return true;
+	}
+
+	Material MaterialImport::Load(ID3D11Device* pDevice, const Manifest& manifest, TextureLoader& textureLoader)
+	{
+		if (!manifest.diffuseVariants.empty())
+			return LoadAtlas(pDevice, manifest, textureLoader);
+
+		const bool hasPackedMap = !manifest.normalGlossSpecularMap.empty();
+
+		std::vector<std::string> filepaths{ manifest.diffuseMap };
+		if (hasPackedMap)
+		{
+			filepaths.push_back(manifest.normalGlossSpecularMap);
+		}
+
+		std::vector<std::unique_ptr<Texture>> textures = textureLoader.LoadTextures(pDevice, filepaths);
+
+		Material material{};
+		material.pDiffuseMap = std::move(textures[0]);
+		if (hasPackedMap)
+		{
+			material.pNormalGlossSpecularMap = std::move(textures[1]);
+		}
+		return material;
+	}
+}
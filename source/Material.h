@@ -0,0 +1,59 @@
+#pragma once
+
+#include <string>
+#include <vector>
+
+namespace dae
+{
+	class Texture;
+	class TextureLoader;
+	struct Image;
+
+	// Textures a mesh is shaded with, the Effect binds all of them in one call
+	struct Material
+	{
+		std::shared_ptr<Texture> pDiffuseMap;
+		// rg: tangent space normal xy, b: gloss, a: specular
+		std::shared_ptr<Texture> pNormalGlossSpecularMap;
+		Vector4 diffuseUVTransform{ 1.0f, 1.0f, 0.0f, 0.0f };
+		// When the diffuse map is a TextureAtlas of variants: the region of every variant, the first is diffuseUVTransform.
+		// Indexed by the material index of an InstanceBatch instance (see InstanceBatch::SetMaterialUVTransforms).
+		std::vector<Vector4> diffuseUVTransforms;
+	};
+
+	// Packs the separate normal, gloss and specular maps into a single RGBA texture and keeps a manifest of the result
+	namespace MaterialImport
+	{
+		struct Sources
+		{
+			std::string diffuseMap;
+			std::string normalMap;
+			std::string glossMap;
+			std::string specularMap;
+			// Further diffuse maps laid out for the same UVs, Load packs them into one atlas with diffuseMap
+			std::vector<std::string> diffuseVariants;
+		};
+
+		// Plain text, one "key=filepath" pair per line, a diffuseVariant line per variant
+		struct Manifest
+		{
+			std::string diffuseMap;
+			std::string normalGlossSpecularMap;
+			std::vector<std::string> diffuseVariants;
+		};
+
+		// Repacks only when the packed map is missing or older than one of its sources, rewrites the manifest when it
+		// lists other diffuse variants than sources
+		bool Import(const std::string& manifestPath, const std::string& packedPath, const Sources& sources, Manifest& manifest, TextureLoader& textureLoader);
+
+		bool ReadManifest(const std::string& manifestPath, Manifest& manifest);
+		bool WriteManifest(const std::string& manifestPath, const Manifest& manifest);
+
+		// Normal xy, gloss and specular are read from the red channel (and green for the normal), all sizes must match
+		bool Pack(const Image& normalMap, const Image& glossMap, const Image& specularMap, Image& packed);
+
+		// Decodes the textures of the manifest in parallel, missing entries stay nullptr. With diffuse variants the diffuse
+		// map is a TextureAtlas of all of them; when one fails to decode only the plain diffuse map is used.
+		Material Load(ID3D11Device* pDevice, const Manifest& manifest, TextureLoader& textureLoader);
+	}
+}
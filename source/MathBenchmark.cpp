@@ -0,0 +1,204 @@
+#include "MathBenchmark.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <random>
+
+#include "MatrixSIMD.h"
+#include "Quaternion.h"
+
+namespace dae
+{
+	namespace MathBenchmark
+	{
+		namespace
+		{
+			using Clock = std::chrono::high_resolution_clock;
+
+			//Power of two and small enough to stay in L1, so the loads do not dominate
+			constexpr size_t numInputs{ 1024 };
+
+			//Read back after every batch, keeps the compiler from dropping the measured work
+			volatile float g_Sink{};
+
+			struct Data
+			{
+				std::vector<float> scalars;
+				std::vector<Vector3> vectors;
+				std::vector<Vector3> otherVectors;
+				std::vector<Vector4> vectors4;
+				std::vector<Matrix> matrices;
+				std::vector<Matrix> otherMatrices;
+				std::vector<Matrix> projections;
+				std::vector<Quaternion> quaternions;
+
+				std::vector<float> scalarOutput;
+				std::vector<Vector3> vectorOutput;
+				std::vector<Vector4> vector4Output;
+				std::vector<Matrix> matrixOutput;
+				std::vector<Quaternion> quaternionOutput;
+			};
+
+			Data CreateData()
+			{
+				std::mt19937 random{ 1337 };
+				std::uniform_real_distribution<float> distribution{ -1.0f, 1.0f };
+				const auto randomVector = [&]() { return Vector3{ distribution(random), distribution(random), distribution(random) } * 10.0f + Vector3{ 0.1f, 0.2f, 0.3f }; };
+				const auto randomAffine = [&]()
+				{
+					return Matrix::CreateScale(1.5f + distribution(random), 1.5f + distribution(random), 1.5f + distribution(random))
+						* Matrix::CreateRotation(randomVector())
+						* Matrix::CreateTranslation(randomVector());
+				};
+
+				Data data{};
+				for (size_t i = 0; i < numInputs; ++i)
+				{
+					data.scalars.push_back(1.0f + std::abs(distribution(random)));
+					data.vectors.push_back(randomVector());
+					data.otherVectors.push_back(randomVector());
+					data.vectors4.push_back({ randomVector(), distribution(random) });
+					data.matrices.push_back(randomAffine());
+					data.otherMatrices.push_back(randomAffine());
+					data.projections.push_back(randomAffine() * Matrix::CreatePerspectiveFovLH(0.5f + data.scalars.back() * 0.2f, 16.0f / 9.0f, 0.1f, 100.0f));
+					data.quaternions.push_back(Quaternion::CreateRotation(randomVector()));
+				}
+
+				data.scalarOutput.resize(numInputs);
+				data.vectorOutput.resize(numInputs);
+				data.vector4Output.resize(numInputs);
+				data.matrixOutput.resize(numInputs);
+				data.quaternionOutput.resize(numInputs);
+				return data;
+			}
+
+			//Runs operation(i) numOps times over the inputs and returns the elapsed nanoseconds
+			template<typename Operation>
+			double RunBatch(Operation& operation, size_t numOps)
+			{
+				const Clock::time_point start = Clock::now();
+				for (size_t i = 0; i < numOps; ++i)
+				{
+					operation(i & (numInputs - 1));
+				}
+				return std::chrono::duration<double, std::nano>(Clock::now() - start).count();
+			}
+
+			template<typename Operation>
+			Result Measure(const char* pName, const Options& options, Data& data, Operation operation)
+			{
+				//Grow the batch until one repetition takes the requested time, this doubles as warm up
+				const double targetNanoseconds = options.millisecondsPerRepetition * 1'000'000.0;
+				size_t numOps{ numInputs };
+				for (double elapsed = RunBatch(operation, numOps); elapsed < targetNanoseconds; elapsed = RunBatch(operation, numOps))
+				{
+					const double scale = elapsed > 0.0 ? targetNanoseconds / elapsed : 16.0;
+					numOps = static_cast<size_t>(static_cast<double>(numOps) * std::clamp(scale * 1.1, 1.1, 16.0));
+				}
+
+				std::vector<double> nanosecondsPerOp;
+				for (int repetition = 0; repetition < std::max(options.numRepetitions, 1); ++repetition)
+				{
+					nanosecondsPerOp.push_back(RunBatch(operation, numOps) / static_cast<double>(numOps));
+				}
+				g_Sink = data.scalarOutput[0] + data.vectorOutput[0].x + data.vector4Output[0].x + data.matrixOutput[0][3].x + data.quaternionOutput[0].w;
+
+				std::sort(nanosecondsPerOp.begin(), nanosecondsPerOp.end());
+				const size_t count = nanosecondsPerOp.size();
+
+				Result result{};
+				result.name = pName;
+				result.medianNanoseconds = count % 2 == 1 ? nanosecondsPerOp[count / 2] : (nanosecondsPerOp[count / 2 - 1] + nanosecondsPerOp[count / 2]) * 0.5;
+				result.minNanoseconds = nanosecondsPerOp.front();
+				for (double value : nanosecondsPerOp)
+				{
+					result.meanNanoseconds += value / static_cast<double>(count);
+				}
+				for (double value : nanosecondsPerOp)
+				{
+					result.stddevNanoseconds += (value - result.meanNanoseconds) * (value - result.meanNanoseconds) / static_cast<double>(count);
+				}
+				result.stddevNanoseconds = std::sqrt(result.stddevNanoseconds);
+				result.opsPerSecond = 1'000'000'000.0 / result.medianNanoseconds;
+				result.opsPerRepetition = numOps;
+				return result;
+			}
+		}
+
+		std::vector<Result> Run(const Options& options)
+		{
+			Data d = CreateData();
+
+			std::vector<Result> results;
+			results.push_back(Measure("Vector3::Dot", options, d, [&d](size_t i) { d.scalarOutput[i] = Vector3::Dot(d.vectors[i], d.otherVectors[i]); }));
+			results.push_back(Measure("Vector3::Cross", options, d, [&d](size_t i) { d.vectorOutput[i] = Vector3::Cross(d.vectors[i], d.otherVectors[i]); }));
+			results.push_back(Measure("Vector3::Normalize", options, d, [&d](size_t i) { d.vectorOutput[i] = d.vectors[i]; d.vectorOutput[i].Normalize(); }));
+			results.push_back(Measure("Vector3::Normalized", options, d, [&d](size_t i) { d.vectorOutput[i] = d.vectors[i].Normalized(); }));
+			results.push_back(Measure("Vector3::Reject", options, d, [&d](size_t i) { d.vectorOutput[i] = Vector3::Reject(d.vectors[i], d.otherVectors[i]); }));
+			results.push_back(Measure("Vector4::Dot", options, d, [&d](size_t i) { d.scalarOutput[i] = Vector4::Dot(d.vectors4[i], d.vectors4[(i + 1) & (numInputs - 1)]); }));
+			results.push_back(Measure("Matrix::operator*", options, d, [&d](size_t i) { d.matrixOutput[i] = d.matrices[i] * d.otherMatrices[i]; }));
+			results.push_back(Measure("Matrix::Transpose", options, d, [&d](size_t i) { d.matrixOutput[i] = Matrix::Transpose(d.matrices[i]); }));
+			results.push_back(Measure("Matrix::Inverse", options, d, [&d](size_t i) { d.matrixOutput[i] = Matrix::Inverse(d.projections[i]); }));
+			results.push_back(Measure("Matrix::InverseAffine", options, d, [&d](size_t i) { d.matrixOutput[i] = Matrix::InverseAffine(d.matrices[i]); }));
+			results.push_back(Measure("Matrix::TransformPoint(Vector3)", options, d, [&d](size_t i) { d.vectorOutput[i] = d.matrices[i].TransformPoint(d.vectors[i]); }));
+			results.push_back(Measure("Matrix::TransformVector", options, d, [&d](size_t i) { d.vectorOutput[i] = d.matrices[i].TransformVector(d.vectors[i]); }));
+			results.push_back(Measure("Matrix::TransformPoint(Vector4)", options, d, [&d](size_t i) { d.vector4Output[i] = d.projections[i].TransformPoint(d.vectors4[i]); }));
+			results.push_back(Measure("Matrix::CreateRotation", options, d, [&d](size_t i) { d.matrixOutput[i] = Matrix::CreateRotation(d.vectors[i]); }));
+			results.push_back(Measure("Matrix::CreateLookAtLH", options, d, [&d](size_t i) { d.matrixOutput[i] = Matrix::CreateLookAtLH(d.vectors[i], d.otherVectors[i], Vector3::UnitY); }));
+			results.push_back(Measure("Matrix::CreatePerspectiveFovLH", options, d, [&d](size_t i) { d.matrixOutput[i] = Matrix::CreatePerspectiveFovLH(d.scalars[i], 16.0f / 9.0f, 0.1f, d.scalars[i] * 100.0f); }));
+			results.push_back(Measure("Quaternion::operator*", options, d, [&d](size_t i) { d.quaternionOutput[i] = d.quaternions[i] * d.quaternions[(i + 1) & (numInputs - 1)]; }));
+			results.push_back(Measure("Quaternion::ToMatrix", options, d, [&d](size_t i) { d.matrixOutput[i] = d.quaternions[i].ToMatrix(); }));
+			return results;
+		}
+
+		void Print(const std::vector<Result>& results)
+		{
+			std::cout << "Math benchmark (" << MatrixSIMD::GetName(MatrixSIMD::CompiledInstructionSet) << "), ns/op median, min and stddev, million ops/s\n";
+			for (const Result& result : results)
+			{
+				std::cout << "  " << std::left << std::setw(34) << result.name << std::right << std::fixed << std::setprecision(2)
+					<< std::setw(9) << result.medianNanoseconds
+					<< std::setw(9) << result.minNanoseconds
+					<< std::setw(8) << result.stddevNanoseconds
+					<< std::setw(10) << result.opsPerSecond / 1'000'000.0 << "\n";
+			}
+			std::cout << std::defaultfloat;
+		}
+
+		bool WriteJSON(const std::string& filepath, const std::vector<Result>& results, const Options& options)
+		{
+			std::ofstream file{ filepath };
+			if (!file)
+			{
+				std::cout << "Failed to open " << filepath << " for writing!\n";
+				return false;
+			}
+
+			file << std::fixed << std::setprecision(3);
+			file << "{\n";
+			file << "\t\"instructionSet\": \"" << MatrixSIMD::GetName(MatrixSIMD::CompiledInstructionSet) << "\",\n";
+			file << "\t\"repetitions\": " << options.numRepetitions << ",\n";
+			file << "\t\"results\": [\n";
+			for (size_t i = 0; i < results.size(); ++i)
+			{
+				const Result& result = results[i];
+				file << "\t\t{ \"name\": \"" << result.name << "\""
+					<< ", \"nsPerOp\": " << result.medianNanoseconds
+					<< ", \"minNsPerOp\": " << result.minNanoseconds
+					<< ", \"meanNsPerOp\": " << result.meanNanoseconds
+					<< ", \"stddevNsPerOp\": " << result.stddevNanoseconds
+					<< ", \"opsPerSecond\": " << std::setprecision(0) << result.opsPerSecond << std::setprecision(3)
+					<< ", \"opsPerRepetition\": " << result.opsPerRepetition << " }"
+					<< (i + 1 < results.size() ? ",\n" : "\n");
+			}
+			file << "\t]\n";
+			file << "}\n";
+
+			return static_cast<bool>(file);
+		}
+	}
+}
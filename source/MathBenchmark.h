@@ -0,0 +1,36 @@
+#pragma once
+
+#include <string>
+#include <vector>
+
+namespace dae
+{
+	// Microbenchmarks of the Vector and Matrix operations the engine leans on. Only depends on the math sources.
+	namespace MathBenchmark
+	{
+		struct Options
+		{
+			// Every operation is timed this many times, the statistics are taken over the repetitions
+			int numRepetitions{ 15 };
+			// Length of one repetition, the number of operations per repetition is calibrated to reach it
+			float millisecondsPerRepetition{ 20.0f };
+		};
+
+		struct Result
+		{
+			std::string name;
+			double medianNanoseconds{};
+			double minNanoseconds{};
+			double meanNanoseconds{};
+			double stddevNanoseconds{};
+			double opsPerSecond{};
+			size_t opsPerRepetition{};
+		};
+
+		std::vector<Result> Run(const Options& options = {});
+
+		void Print(const std::vector<Result>& results);
+		// One result per line in a fixed order, so two runs can be diffed directly
+		bool WriteJSON(const std::string& filepath, const std::vector<Result>& results, const Options& options);
+	}
+}
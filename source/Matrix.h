@@ -1,63 +1,73 @@
 #pragma once
+#include <cassert>
+#include <type_traits>
+
+#include "MatrixSIMD.h"
 #include "Vector3.h"
 #include "Vector4.h"
 
 namespace dae {
+	// Everything without sqrt/sin/cos is constexpr. At compile time the products run the scalar kernel inline,
+	// at runtime they go through MatrixSIMD; both use the same evaluation order, so the results are identical.
 	struct Matrix
 	{
-		Matrix() = default;
-		Matrix(
+		constexpr Matrix() = default;
+		constexpr Matrix(
 			const Vector3& xAxis,
 			const Vector3& yAxis,
 			const Vector3& zAxis,
 			const Vector3& t);
 
-		Matrix(
+		constexpr Matrix(
 			const Vector4& xAxis,
 			const Vector4& yAxis,
 			const Vector4& zAxis,
 			const Vector4& t);
 
-		Matrix(const Matrix& m);
+		constexpr Matrix(const Matrix& m);
 
-		Vector3 TransformVector(const Vector3& v) const;
-		Vector3 TransformVector(float x, float y, float z) const;
-		Vector3 TransformPoint(const Vector3& p) const;
-		Vector3 TransformPoint(float x, float y, float z) const;
+		constexpr Vector3 TransformVector(const Vector3& v) const;
+		constexpr Vector3 TransformVector(float x, float y, float z) const;
+		constexpr Vector3 TransformPoint(const Vector3& p) const;
+		constexpr Vector3 TransformPoint(float x, float y, float z) const;
 
-		Vector4 TransformPoint(const Vector4& p) const;
-		Vector4 TransformPoint(float x, float y, float z, float w) const;
+		constexpr Vector4 TransformPoint(const Vector4& p) const;
+		constexpr Vector4 TransformPoint(float x, float y, float z, float w) const;
 
-		const Matrix& Transpose();
+		constexpr const Matrix& Transpose();
+		// Asserts on a singular matrix (see MatrixSIMD::Inverse), release builds leave it unchanged
 		const Matrix& Inverse();
+		// Only for matrices without projection (last column 0, 0, 0, 1), faster than the full Inverse
+		const Matrix& InverseAffine();
 
-		Vector3 GetAxisX() const;
-		Vector3 GetAxisY() const;
-		Vector3 GetAxisZ() const;
-		Vector3 GetTranslation() const;
+		constexpr Vector3 GetAxisX() const;
+		constexpr Vector3 GetAxisY() const;
+		constexpr Vector3 GetAxisZ() const;
+		constexpr Vector3 GetTranslation() const;
 
-		static Matrix CreateTranslation(float x, float y, float z);
-		static Matrix CreateTranslation(const Vector3& t);
+		static constexpr Matrix CreateTranslation(float x, float y, float z);
+		static constexpr Matrix CreateTranslation(const Vector3& t);
 		static Matrix CreateRotationX(float pitch);
 		static Matrix CreateRotationY(float yaw);
 		static Matrix CreateRotationZ(float roll);
 		static Matrix CreateRotation(float pitch, float yaw, float roll);
 		static Matrix CreateRotation(const Vector3& r);
-		static Matrix CreateScale(float sx, float sy, float sz);
-		static Matrix CreateScale(const Vector3& s);
-		static Matrix Transpose(const Matrix& m);
+		static constexpr Matrix CreateScale(float sx, float sy, float sz);
+		static constexpr Matrix CreateScale(const Vector3& s);
+		static constexpr Matrix Transpose(const Matrix& m);
 		static Matrix Inverse(const Matrix& m);
+		static Matrix InverseAffine(const Matrix& m);
 
 		static Matrix CreateLookAtLH(const Vector3& origin, const Vector3& forward, const Vector3& up);
-		static Matrix CreatePerspectiveFovLH(float fovy, float aspect, float zn, float zf);
+		static constexpr Matrix CreatePerspectiveFovLH(float fovy, float aspect, float zn, float zf);
 
-		float* GetData();
-		const float* GetData() const;
+		constexpr float* GetData();
+		constexpr const float* GetData() const;
 
-		Vector4& operator[](int index);
-		Vector4 operator[](int index) const;
-		Matrix operator*(const Matrix& m) const;
-		const Matrix& operator*=(const Matrix& m);
+		constexpr Vector4& operator[](int index);
+		constexpr Vector4 operator[](int index) const;
+		constexpr Matrix operator*(const Matrix& m) const;
+		constexpr const Matrix& operator*=(const Matrix& m);
 
 	private:
 
@@ -75,4 +85,234 @@ namespace dae {
 		// v2x v2y v2z v2w
 		// v3x v3y v3z v3w
 	};
-}
\ No newline at end of file
+
+	static_assert(alignof(Matrix) == 16 && sizeof(Matrix) == 64, "MatrixSIMD uses aligned loads on Matrix::GetData");
+
+	constexpr Matrix::Matrix(const Vector3& xAxis, const Vector3& yAxis, const Vector3& zAxis, const Vector3& t) :
+		Matrix({ xAxis, 0 }, { yAxis, 0 }, { zAxis, 0 }, { t, 1 })
+	{
+	}
+
+	constexpr Matrix::Matrix(const Vector4& xAxis, const Vector4& yAxis, const Vector4& zAxis, const Vector4& t)
+	{
+		data[0] = xAxis;
+		data[1] = yAxis;
+		data[2] = zAxis;
+		data[3] = t;
+	}
+
+	constexpr Matrix::Matrix(const Matrix& m)
+	{
+		data[0] = m[0];
+		data[1] = m[1];
+		data[2] = m[2];
+		data[3] = m[3];
+	}
+
+	constexpr Vector3 Matrix::TransformVector(const Vector3& v) const
+	{
+		return TransformVector(v.x, v.y, v.z);
+	}
+
+	constexpr Vector3 Matrix::TransformVector(float x, float y, float z) const
+	{
+		return TransformPoint(x, y, z, 0.0f).GetXYZ();
+	}
+
+	constexpr Vector3 Matrix::TransformPoint(const Vector3& p) const
+	{
+		return TransformPoint(p.x, p.y, p.z);
+	}
+
+	constexpr Vector3 Matrix::TransformPoint(float x, float y, float z) const
+	{
+		return TransformPoint(x, y, z, 1.0f).GetXYZ();
+	}
+
+	constexpr Vector4 Matrix::TransformPoint(const Vector4& p) const
+	{
+		return TransformPoint(p.x, p.y, p.z, p.w);
+	}
+
+	constexpr Vector4 Matrix::TransformPoint(float x, float y, float z, float w) const
+	{
+		Vector4 result;
+		if (std::is_constant_evaluated())
+		{
+			for (int c{ 0 }; c < 4; ++c)
+			{
+				result[c] = data[0][c] * x + data[1][c] * y + data[2][c] * z + data[3][c] * w;
+			}
+		}
+		else
+		{
+			MatrixSIMD::Transform(GetData(), x, y, z, w, &result.x);
+		}
+		return result;
+	}
+
+	constexpr const Matrix& Matrix::Transpose()
+	{
+		if (std::is_constant_evaluated())
+		{
+			Matrix result{};
+			for (int r{ 0 }; r < 4; ++r)
+			{
+				for (int c{ 0 }; c < 4; ++c)
+				{
+					result[r][c] = data[c][r];
+				}
+			}
+
+			data[0] = result[0];
+			data[1] = result[1];
+			data[2] = result[2];
+			data[3] = result[3];
+		}
+		else
+		{
+			MatrixSIMD::Transpose(GetData(), GetData());
+		}
+		return *this;
+	}
+
+	constexpr Matrix Matrix::Transpose(const Matrix& m)
+	{
+		Matrix out{ m };
+		out.Transpose();
+
+		return out;
+	}
+
+	constexpr Matrix Matrix::CreatePerspectiveFovLH(float fov, float aspect, float zn, float zf)
+	{
+		return {
+			{ 1.0f / (aspect * fov), 0.0f, 0.0f, 0.0f },
+			{ 0.0f, 1.0f / fov, 0.0f, 0.0f },
+			{ 0.0f, 0.0f, zf / (zf - zn), 1.0f },
+			{ 0.0f, 0.0f, -(zf * zn) / (zf - zn), 0.0f }
+		};
+	}
+
+	constexpr Vector3 Matrix::GetAxisX() const
+	{
+		return data[0];
+	}
+
+	constexpr Vector3 Matrix::GetAxisY() const
+	{
+		return data[1];
+	}
+
+	constexpr Vector3 Matrix::GetAxisZ() const
+	{
+		return data[2];
+	}
+
+	constexpr Vector3 Matrix::GetTranslation() const
+	{
+		return data[3];
+	}
+
+	constexpr Matrix Matrix::CreateTranslation(float x, float y, float z)
+	{
+		return CreateTranslation({ x, y, z });
+	}
+
+	constexpr Matrix Matrix::CreateTranslation(const Vector3& t)
+	{
+		return { Vector3::UnitX, Vector3::UnitY, Vector3::UnitZ, t };
+	}
+
+	constexpr Matrix Matrix::CreateScale(float sx, float sy, float sz)
+	{
+		return { {sx, 0, 0}, {0, sy, 0}, {0, 0, sz}, Vector3::Zero };
+	}
+
+	constexpr Matrix Matrix::CreateScale(const Vector3& s)
+	{
+		return CreateScale(s[0], s[1], s[2]);
+	}
+
+	constexpr float* Matrix::GetData()
+	{
+		return &data[0].x;
+	}
+
+	constexpr const float* Matrix::GetData() const
+	{
+		return &data[0].x;
+	}
+
+#pragma region Operator Overloads
+
+	constexpr Vector4& Matrix::operator[](int index)
+	{
+		assert(index <= 3 && index >= 0);
+		return data[index];
+	}
+
+	constexpr Vector4 Matrix::operator[](int index) const
+	{
+		assert(index <= 3 && index >= 0);
+		return data[index];
+	}
+
+	constexpr Matrix Matrix::operator*(const Matrix& m) const
+	{
+		Matrix result;
+		if (std::is_constant_evaluated())
+		{
+			for (int r{ 0 }; r < 4; ++r)
+			{
+				for (int c{ 0 }; c < 4; ++c)
+				{
+					result[r][c] = data[r].x * m[0][c] + data[r].y * m[1][c] + data[r].z * m[2][c] + data[r].w * m[3][c];
+				}
+			}
+		}
+		else
+		{
+			MatrixSIMD::Multiply(GetData(), m.GetData(), result.GetData());
+		}
+
+		return result;
+	}
+
+	constexpr const Matrix& Matrix::operator*=(const Matrix& m)
+	{
+		if (std::is_constant_evaluated())
+		{
+			*this = *this * m;
+		}
+		else
+		{
+			MatrixSIMD::Multiply(GetData(), m.GetData(), GetData());
+		}
+
+		return *this;
+	}
+#pragma endregion
+
+	// The header comment promises these fold at compile time, a call into MatrixSIMD on the way would fail here
+	static_assert([]
+	{
+		const Vector3 t = (Matrix::CreateTranslation(1.0f, 2.0f, 3.0f) * Matrix::CreateScale(2.0f, 2.0f, 2.0f)).GetTranslation();
+		return t.x == 2.0f && t.y == 4.0f && t.z == 6.0f;
+	}());
+
+	static_assert([]
+	{
+		Matrix m = Matrix::CreateScale(2.0f, 2.0f, 2.0f);
+		m *= Matrix::CreateTranslation(1.0f, 2.0f, 3.0f);
+		const Vector3 p = m.TransformPoint(Vector3{ 1.0f, 1.0f, 1.0f });
+		const Vector3 v = m.TransformVector(1.0f, 1.0f, 1.0f);
+		return p.x == 3.0f && p.y == 4.0f && p.z == 5.0f && v.x == 2.0f && v.y == 2.0f && v.z == 2.0f;
+	}());
+
+	static_assert([]
+	{
+		const Matrix m = Matrix::Transpose(Matrix::CreateTranslation(1.0f, 2.0f, 3.0f));
+		return m[0].w == 1.0f && m[1].w == 2.0f && m[2].w == 3.0f && m[3].x == 0.0f && m[3].w == 1.0f;
+	}());
+}
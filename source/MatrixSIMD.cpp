@@ -0,0 +1,637 @@
+#include "MatrixSIMD.h"
+#include "Matrix.h"
+
+#include <cfloat>
+#include <cassert>
+#include <chrono>
+#include <cstring>
+#include <iostream>
+#include <random>
+
+#if defined(DAE_MATH_SSE2)
+#include <immintrin.h>
+#endif
+
+#if defined(_MSC_VER)
+#include <intrin.h>
+#endif
+
+#if defined(__GNUC__) || defined(__clang__)
+#define TARGET_AVX __attribute__((target("avx")))
+#else
+#define TARGET_AVX
+#endif
+
+namespace dae
+{
+	namespace MatrixSIMD
+	{
+		namespace
+		{
+			constexpr double singularEpsilon{ FLT_EPSILON };
+
+			//Only called by asserts
+			[[maybe_unused]] bool IsAligned(const float* pData)
+			{
+				return reinterpret_cast<uintptr_t>(pData) % 16 == 0;
+			}
+
+			//|det| is at most the product of the row lengths (Hadamard), below FLT_EPSILON of that it is rounding noise.
+			//Relative, so a uniformly scaled matrix is as invertible at scale 0.001 as at scale 1. Squared in double,
+			//so neither the lengths nor their product over- or underflow.
+			bool IsSingular(const float* pM, int size, float det)
+			{
+				double bound{ 1.0 };
+				for (int r{ 0 }; r < size; ++r)
+				{
+					double lengthSquared{ 0.0 };
+					for (int c{ 0 }; c < size; ++c)
+					{
+						lengthSquared += static_cast<double>(pM[r * 4 + c]) * pM[r * 4 + c];
+					}
+					bound *= lengthSquared;
+				}
+
+				return static_cast<double>(det) * det <= singularEpsilon * singularEpsilon * bound;
+			}
+
+#if defined(DAE_MATH_SSE2)
+			//CPUID reports AVX, XGETBV whether the OS saves the ymm registers
+			bool HasAVX()
+			{
+#if defined(_MSC_VER)
+				int registers[4]{};
+				__cpuid(registers, 1);
+				const bool hasAVX = (registers[2] & (1 << 28)) != 0;
+				const bool hasOSXSAVE = (registers[2] & (1 << 27)) != 0;
+				return hasAVX && hasOSXSAVE && (_xgetbv(0) & 0x6) == 0x6;
+#else
+				__builtin_cpu_init();
+				return __builtin_cpu_supports("avx");
+#endif
+			}
+#endif
+
+#pragma region Scalar
+			void MultiplyScalar(const float* pA, const float* pB, float* pResult)
+			{
+				float result[16];
+				for (int r{ 0 }; r < 4; ++r)
+				{
+					for (int c{ 0 }; c < 4; ++c)
+					{
+						result[r * 4 + c] = pA[r * 4 + 0] * pB[0 + c] + pA[r * 4 + 1] * pB[4 + c] + pA[r * 4 + 2] * pB[8 + c] + pA[r * 4 + 3] * pB[12 + c];
+					}
+				}
+				memcpy(pResult, result, sizeof(result));
+			}
+
+			void TransformScalar(const float* pM, float x, float y, float z, float w, float* pResult)
+			{
+				for (int c{ 0 }; c < 4; ++c)
+				{
+					pResult[c] = pM[0 + c] * x + pM[4 + c] * y + pM[8 + c] * z + pM[12 + c] * w;
+				}
+			}
+
+			void TransposeScalar(const float* pM, float* pResult)
+			{
+				float result[16];
+				for (int r{ 0 }; r < 4; ++r)
+				{
+					for (int c{ 0 }; c < 4; ++c)
+					{
+						result[r * 4 + c] = pM[c * 4 + r];
+					}
+				}
+				memcpy(pResult, result, sizeof(result));
+			}
+
+			struct Float3
+			{
+				float x, y, z;
+			};
+
+			Float3 Cross(const Float3& a, const Float3& b)
+			{
+				return { a.y * b.z - a.z * b.y, a.z * b.x - a.x * b.z, a.x * b.y - a.y * b.x };
+			}
+
+			float Dot(const Float3& a, const Float3& b)
+			{
+				return a.x * b.x + a.y * b.y + a.z * b.z;
+			}
+
+			Float3 Scale(const Float3& a, float scale)
+			{
+				return { a.x * scale, a.y * scale, a.z * scale };
+			}
+
+			Float3 Combine(const Float3& a, float sa, const Float3& b, float sb)
+			{
+				return { a.x * sa + b.x * sb, a.y * sa + b.y * sb, a.z * sa + b.z * sb };
+			}
+
+			bool InverseScalar(const float* pM, float* pResult)
+			{
+				//FGED1 cross product method, rows of the matrix are the columns in the book
+				const Float3 a{ pM[0], pM[1], pM[2] };
+				const Float3 b{ pM[4], pM[5], pM[6] };
+				const Float3 c{ pM[8], pM[9], pM[10] };
+				const Float3 d{ pM[12], pM[13], pM[14] };
+
+				const float x = pM[3];
+				const float y = pM[7];
+				const float z = pM[11];
+				const float w = pM[15];
+
+				Float3 s = Cross(a, b);
+				Float3 t = Cross(c, d);
+				Float3 u = Combine(a, y, b, -x);
+				Float3 v = Combine(c, w, d, -z);
+
+				const float det = Dot(s, v) + Dot(t, u);
+				if (IsSingular(pM, 4, det))
+					return false;
+
+				const float invDet = 1.0f / det;
+				s = Scale(s, invDet);
+				t = Scale(t, invDet);
+				u = Scale(u, invDet);
+				v = Scale(v, invDet);
+
+				const Float3 r0 = Combine(Cross(b, v), 1.0f, t, y);
+				const Float3 r1 = Combine(Cross(v, a), 1.0f, t, -x);
+				const Float3 r2 = Combine(Cross(d, u), 1.0f, s, w);
+				const Float3 r3 = Combine(Cross(u, c), 1.0f, s, -z);
+
+				const float result[16]
+				{
+					r0.x, r1.x, r2.x, r3.x,
+					r0.y, r1.y, r2.y, r3.y,
+					r0.z, r1.z, r2.z, r3.z,
+					-Dot(b, t), Dot(a, t), -Dot(d, s), Dot(c, s)
+				};
+				memcpy(pResult, result, sizeof(result));
+				return true;
+			}
+
+			bool InverseAffineScalar(const float* pM, float* pResult)
+			{
+				const Float3 a{ pM[0], pM[1], pM[2] };
+				const Float3 b{ pM[4], pM[5], pM[6] };
+				const Float3 c{ pM[8], pM[9], pM[10] };
+				const Float3 t{ pM[12], pM[13], pM[14] };
+
+				const Float3 bc = Cross(b, c);
+				const float det = Dot(a, bc);
+				if (IsSingular(pM, 3, det))
+					return false;
+
+				//The inverse rotation/scale has the cross products as columns
+				const float invDet = 1.0f / det;
+				const Float3 r0 = Scale(bc, invDet);
+				const Float3 r1 = Scale(Cross(c, a), invDet);
+				const Float3 r2 = Scale(Cross(a, b), invDet);
+
+				const float result[16]
+				{
+					r0.x, r1.x, r2.x, 0.0f,
+					r0.y, r1.y, r2.y, 0.0f,
+					r0.z, r1.z, r2.z, 0.0f,
+					-Dot(t, r0), -Dot(t, r1), -Dot(t, r2), 1.0f
+				};
+				memcpy(pResult, result, sizeof(result));
+				return true;
+			}
+#pragma endregion
+
+#if defined(DAE_MATH_SSE2)
+#pragma region SSE2
+			//Broadcasts one lane to all four
+			template<int lane>
+			__m128 Splat(__m128 v)
+			{
+				return _mm_shuffle_ps(v, v, _MM_SHUFFLE(lane, lane, lane, lane));
+			}
+
+			void MultiplySSE2(const float* pA, const float* pB, float* pResult)
+			{
+				const __m128 b0 = _mm_load_ps(pB + 0);
+				const __m128 b1 = _mm_load_ps(pB + 4);
+				const __m128 b2 = _mm_load_ps(pB + 8);
+				const __m128 b3 = _mm_load_ps(pB + 12);
+
+				//Row r of the result is a linear combination of the rows of B, every row of A is read before it is overwritten
+				for (int r{ 0 }; r < 4; ++r)
+				{
+					const __m128 a = _mm_load_ps(pA + r * 4);
+
+					__m128 result = _mm_mul_ps(Splat<0>(a), b0);
+					result = _mm_add_ps(result, _mm_mul_ps(Splat<1>(a), b1));
+					result = _mm_add_ps(result, _mm_mul_ps(Splat<2>(a), b2));
+					result = _mm_add_ps(result, _mm_mul_ps(Splat<3>(a), b3));
+
+					_mm_store_ps(pResult + r * 4, result);
+				}
+			}
+
+			void TransformSSE2(const float* pM, float x, float y, float z, float w, float* pResult)
+			{
+				__m128 result = _mm_mul_ps(_mm_load_ps(pM + 0), _mm_set1_ps(x));
+				result = _mm_add_ps(result, _mm_mul_ps(_mm_load_ps(pM + 4), _mm_set1_ps(y)));
+				result = _mm_add_ps(result, _mm_mul_ps(_mm_load_ps(pM + 8), _mm_set1_ps(z)));
+				result = _mm_add_ps(result, _mm_mul_ps(_mm_load_ps(pM + 12), _mm_set1_ps(w)));
+				_mm_store_ps(pResult, result);
+			}
+
+			void TransposeSSE2(const float* pM, float* pResult)
+			{
+				__m128 row0 = _mm_load_ps(pM + 0);
+				__m128 row1 = _mm_load_ps(pM + 4);
+				__m128 row2 = _mm_load_ps(pM + 8);
+				__m128 row3 = _mm_load_ps(pM + 12);
+				_MM_TRANSPOSE4_PS(row0, row1, row2, row3);
+				_mm_store_ps(pResult + 0, row0);
+				_mm_store_ps(pResult + 4, row1);
+				_mm_store_ps(pResult + 8, row2);
+				_mm_store_ps(pResult + 12, row3);
+			}
+
+			//xyz lanes only, w of the result is 0
+			__m128 CrossSSE2(__m128 a, __m128 b)
+			{
+				const __m128 aYZX = _mm_shuffle_ps(a, a, _MM_SHUFFLE(3, 0, 2, 1));
+				const __m128 bYZX = _mm_shuffle_ps(b, b, _MM_SHUFFLE(3, 0, 2, 1));
+				const __m128 c = _mm_sub_ps(_mm_mul_ps(a, bYZX), _mm_mul_ps(aYZX, b));
+				return _mm_shuffle_ps(c, c, _MM_SHUFFLE(3, 0, 2, 1));
+			}
+
+			//Dot of the xyz lanes broadcast to all four
+			__m128 Dot3SSE2(__m128 a, __m128 b)
+			{
+				const __m128 product = _mm_mul_ps(a, b);
+				const __m128 sum = _mm_add_ss(_mm_add_ss(product, Splat<1>(product)), Splat<2>(product));
+				return Splat<0>(sum);
+			}
+
+			//2x2 blocks are stored row major in one register: (m00, m01, m10, m11)
+			//A * B
+			__m128 Multiply2x2(__m128 a, __m128 b)
+			{
+				return _mm_add_ps(_mm_mul_ps(a, _mm_shuffle_ps(b, b, _MM_SHUFFLE(3, 0, 3, 0))),
+					_mm_mul_ps(_mm_shuffle_ps(a, a, _MM_SHUFFLE(2, 3, 0, 1)), _mm_shuffle_ps(b, b, _MM_SHUFFLE(1, 2, 1, 2))));
+			}
+
+			//adj(A) * B
+			__m128 AdjugateMultiply2x2(__m128 a, __m128 b)
+			{
+				return _mm_sub_ps(_mm_mul_ps(_mm_shuffle_ps(a, a, _MM_SHUFFLE(0, 0, 3, 3)), b),
+					_mm_mul_ps(_mm_shuffle_ps(a, a, _MM_SHUFFLE(2, 2, 1, 1)), _mm_shuffle_ps(b, b, _MM_SHUFFLE(1, 0, 3, 2))));
+			}
+
+			//A * adj(B)
+			__m128 MultiplyAdjugate2x2(__m128 a, __m128 b)
+			{
+				return _mm_sub_ps(_mm_mul_ps(a, _mm_shuffle_ps(b, b, _MM_SHUFFLE(0, 3, 0, 3))),
+					_mm_mul_ps(_mm_shuffle_ps(a, a, _MM_SHUFFLE(2, 3, 0, 1)), _mm_shuffle_ps(b, b, _MM_SHUFFLE(1, 2, 1, 2))));
+			}
+
+			bool InverseSSE2(const float* pM, float* pResult)
+			{
+				//Block inverse on the 2x2 sub matrices | A B |
+				//                                      | C D |, only 2x2 products, no 3x3 cofactors
+				const __m128 row0 = _mm_load_ps(pM + 0);
+				const __m128 row1 = _mm_load_ps(pM + 4);
+				const __m128 row2 = _mm_load_ps(pM + 8);
+				const __m128 row3 = _mm_load_ps(pM + 12);
+
+				const __m128 a = _mm_movelh_ps(row0, row1);
+				const __m128 b = _mm_movehl_ps(row1, row0);
+				const __m128 c = _mm_movelh_ps(row2, row3);
+				const __m128 d = _mm_movehl_ps(row3, row2);
+
+				//(|A|, |B|, |C|, |D|)
+				const __m128 determinants = _mm_sub_ps(
+					_mm_mul_ps(_mm_shuffle_ps(row0, row2, _MM_SHUFFLE(2, 0, 2, 0)), _mm_shuffle_ps(row1, row3, _MM_SHUFFLE(3, 1, 3, 1))),
+					_mm_mul_ps(_mm_shuffle_ps(row0, row2, _MM_SHUFFLE(3, 1, 3, 1)), _mm_shuffle_ps(row1, row3, _MM_SHUFFLE(2, 0, 2, 0))));
+				const __m128 detA = Splat<0>(determinants);
+				const __m128 detB = Splat<1>(determinants);
+				const __m128 detC = Splat<2>(determinants);
+				const __m128 detD = Splat<3>(determinants);
+
+				const __m128 adjDC = AdjugateMultiply2x2(d, c);
+				const __m128 adjAB = AdjugateMultiply2x2(a, b);
+
+				//Adjugates of the blocks of the inverse, still to be scaled by 1/|M|
+				__m128 x = _mm_sub_ps(_mm_mul_ps(detD, a), Multiply2x2(b, adjDC));
+				__m128 w = _mm_sub_ps(_mm_mul_ps(detA, d), Multiply2x2(c, adjAB));
+				__m128 y = _mm_sub_ps(_mm_mul_ps(detB, c), MultiplyAdjugate2x2(d, adjAB));
+				__m128 z = _mm_sub_ps(_mm_mul_ps(detC, b), MultiplyAdjugate2x2(a, adjDC));
+
+				//|M| = |A||D| + |B||C| - tr(adj(A)B adj(D)C)
+				__m128 trace = _mm_mul_ps(adjAB, _mm_shuffle_ps(adjDC, adjDC, _MM_SHUFFLE(3, 1, 2, 0)));
+				trace = _mm_add_ps(trace, _mm_shuffle_ps(trace, trace, _MM_SHUFFLE(2, 3, 0, 1)));
+				trace = _mm_add_ps(trace, _mm_shuffle_ps(trace, trace, _MM_SHUFFLE(1, 0, 3, 2)));
+				const __m128 det = _mm_sub_ps(_mm_add_ps(_mm_mul_ps(detA, detD), _mm_mul_ps(detB, detC)), trace);
+				if (IsSingular(pM, 4, _mm_cvtss_f32(det)))
+					return false;
+
+				//Taking the adjugate of a 2x2 block swaps the diagonal and negates the rest, the signs go in with 1/|M|
+				const __m128 invDet = _mm_div_ps(_mm_setr_ps(1.0f, -1.0f, -1.0f, 1.0f), det);
+				x = _mm_mul_ps(x, invDet);
+				y = _mm_mul_ps(y, invDet);
+				z = _mm_mul_ps(z, invDet);
+				w = _mm_mul_ps(w, invDet);
+
+				_mm_store_ps(pResult + 0, _mm_shuffle_ps(x, y, _MM_SHUFFLE(1, 3, 1, 3)));
+				_mm_store_ps(pResult + 4, _mm_shuffle_ps(x, y, _MM_SHUFFLE(0, 2, 0, 2)));
+				_mm_store_ps(pResult + 8, _mm_shuffle_ps(z, w, _MM_SHUFFLE(1, 3, 1, 3)));
+				_mm_store_ps(pResult + 12, _mm_shuffle_ps(z, w, _MM_SHUFFLE(0, 2, 0, 2)));
+				return true;
+			}
+
+			bool InverseAffineSSE2(const float* pM, float* pResult)
+			{
+				const __m128 xyzMask = _mm_castsi128_ps(_mm_set_epi32(0, -1, -1, -1));
+
+				const __m128 a = _mm_and_ps(_mm_load_ps(pM + 0), xyzMask);
+				const __m128 b = _mm_and_ps(_mm_load_ps(pM + 4), xyzMask);
+				const __m128 c = _mm_and_ps(_mm_load_ps(pM + 8), xyzMask);
+				const __m128 t = _mm_and_ps(_mm_load_ps(pM + 12), xyzMask);
+
+				const __m128 bc = CrossSSE2(b, c);
+				const __m128 det = Dot3SSE2(a, bc);
+				if (IsSingular(pM, 3, _mm_cvtss_f32(det)))
+					return false;
+
+				const __m128 invDet = _mm_div_ps(_mm_set1_ps(1.0f), det);
+				__m128 r0 = _mm_mul_ps(bc, invDet);
+				__m128 r1 = _mm_mul_ps(CrossSSE2(c, a), invDet);
+				__m128 r2 = _mm_mul_ps(CrossSSE2(a, b), invDet);
+
+				//Translation row -(t.r0, t.r1, t.r2, -1) goes into the w lanes before the transpose
+				const __m128 negate = _mm_set1_ps(-0.0f);
+				r0 = _mm_or_ps(r0, _mm_andnot_ps(xyzMask, _mm_xor_ps(Dot3SSE2(t, r0), negate)));
+				r1 = _mm_or_ps(r1, _mm_andnot_ps(xyzMask, _mm_xor_ps(Dot3SSE2(t, r1), negate)));
+				r2 = _mm_or_ps(r2, _mm_andnot_ps(xyzMask, _mm_xor_ps(Dot3SSE2(t, r2), negate)));
+				__m128 r3 = _mm_andnot_ps(xyzMask, _mm_set1_ps(1.0f));
+
+				_MM_TRANSPOSE4_PS(r0, r1, r2, r3);
+
+				_mm_store_ps(pResult + 0, r0);
+				_mm_store_ps(pResult + 4, r1);
+				_mm_store_ps(pResult + 8, r2);
+				_mm_store_ps(pResult + 12, r3);
+				return true;
+			}
+#pragma endregion
+
+#pragma region AVX
+			//Two rows of A per iteration, the rows of B are duplicated into both 128 bit lanes
+			TARGET_AVX void MultiplyAVX(const float* pA, const float* pB, float* pResult)
+			{
+				const __m256 b0 = _mm256_broadcast_ps(reinterpret_cast<const __m128*>(pB + 0));
+				const __m256 b1 = _mm256_broadcast_ps(reinterpret_cast<const __m128*>(pB + 4));
+				const __m256 b2 = _mm256_broadcast_ps(reinterpret_cast<const __m128*>(pB + 8));
+				const __m256 b3 = _mm256_broadcast_ps(reinterpret_cast<const __m128*>(pB + 12));
+
+				const __m256 a01 = _mm256_loadu_ps(pA + 0);
+				const __m256 a23 = _mm256_loadu_ps(pA + 8);
+
+				__m256 result01 = _mm256_mul_ps(_mm256_shuffle_ps(a01, a01, _MM_SHUFFLE(0, 0, 0, 0)), b0);
+				__m256 result23 = _mm256_mul_ps(_mm256_shuffle_ps(a23, a23, _MM_SHUFFLE(0, 0, 0, 0)), b0);
+				result01 = _mm256_add_ps(result01, _mm256_mul_ps(_mm256_shuffle_ps(a01, a01, _MM_SHUFFLE(1, 1, 1, 1)), b1));
+				result23 = _mm256_add_ps(result23, _mm256_mul_ps(_mm256_shuffle_ps(a23, a23, _MM_SHUFFLE(1, 1, 1, 1)), b1));
+				result01 = _mm256_add_ps(result01, _mm256_mul_ps(_mm256_shuffle_ps(a01, a01, _MM_SHUFFLE(2, 2, 2, 2)), b2));
+				result23 = _mm256_add_ps(result23, _mm256_mul_ps(_mm256_shuffle_ps(a23, a23, _MM_SHUFFLE(2, 2, 2, 2)), b2));
+				result01 = _mm256_add_ps(result01, _mm256_mul_ps(_mm256_shuffle_ps(a01, a01, _MM_SHUFFLE(3, 3, 3, 3)), b3));
+				result23 = _mm256_add_ps(result23, _mm256_mul_ps(_mm256_shuffle_ps(a23, a23, _MM_SHUFFLE(3, 3, 3, 3)), b3));
+
+				_mm256_storeu_ps(pResult + 0, result01);
+				_mm256_storeu_ps(pResult + 8, result23);
+			}
+#pragma endregion
+#endif
+		}
+
+		const char* GetName(InstructionSet instructionSet)
+		{
+			switch (instructionSet)
+			{
+				case InstructionSet::Scalar:	return "Scalar";
+				case InstructionSet::SSE2:		return "SSE2";
+				case InstructionSet::AVX:		return "AVX";
+			}
+			return "Unknown";
+		}
+
+		bool IsSupported(InstructionSet instructionSet)
+		{
+			switch (instructionSet)
+			{
+				case InstructionSet::Scalar:	return true;
+#if defined(DAE_MATH_SSE2)
+				case InstructionSet::SSE2:		return true;
+				case InstructionSet::AVX:		return HasAVX();
+#endif
+				default:						return false;
+			}
+		}
+
+		void Multiply(const float* pA, const float* pB, float* pResult, InstructionSet instructionSet)
+		{
+			assert(IsAligned(pA));
+			assert(IsAligned(pB));
+			assert(IsAligned(pResult));
+
+			switch (instructionSet)
+			{
+#if defined(DAE_MATH_SSE2)
+				case InstructionSet::SSE2:		MultiplySSE2(pA, pB, pResult); return;
+				case InstructionSet::AVX:		MultiplyAVX(pA, pB, pResult); return;
+#endif
+				default:						MultiplyScalar(pA, pB, pResult); return;
+			}
+		}
+
+		void Transform(const float* pM, float x, float y, float z, float w, float* pResult, InstructionSet instructionSet)
+		{
+			assert(IsAligned(pM));
+			assert(IsAligned(pResult));
+
+			switch (instructionSet)
+			{
+#if defined(DAE_MATH_SSE2)
+				//A single vector does not fill 8 lanes, AVX uses the SSE2 kernel
+				case InstructionSet::SSE2:
+				case InstructionSet::AVX:		TransformSSE2(pM, x, y, z, w, pResult); return;
+#endif
+				default:						TransformScalar(pM, x, y, z, w, pResult); return;
+			}
+		}
+
+		void Transpose(const float* pM, float* pResult, InstructionSet instructionSet)
+		{
+			assert(IsAligned(pM));
+			assert(IsAligned(pResult));
+
+			switch (instructionSet)
+			{
+#if defined(DAE_MATH_SSE2)
+				case InstructionSet::SSE2:
+				case InstructionSet::AVX:		TransposeSSE2(pM, pResult); return;
+#endif
+				default:						TransposeScalar(pM, pResult); return;
+			}
+		}
+
+		bool Inverse(const float* pM, float* pResult, InstructionSet instructionSet)
+		{
+			assert(IsAligned(pM));
+			assert(IsAligned(pResult));
+
+			switch (instructionSet)
+			{
+#if defined(DAE_MATH_SSE2)
+				case InstructionSet::SSE2:
+				case InstructionSet::AVX:		return InverseSSE2(pM, pResult);
+#endif
+				default:						return InverseScalar(pM, pResult);
+			}
+		}
+
+		bool InverseAffine(const float* pM, float* pResult, InstructionSet instructionSet)
+		{
+			assert(IsAligned(pM));
+			assert(IsAligned(pResult));
+
+			switch (instructionSet)
+			{
+#if defined(DAE_MATH_SSE2)
+				case InstructionSet::SSE2:
+				case InstructionSet::AVX:		return InverseAffineSSE2(pM, pResult);
+#endif
+				default:						return InverseAffineScalar(pM, pResult);
+			}
+		}
+
+		void Benchmark()
+		{
+			using Clock = std::chrono::high_resolution_clock;
+
+			constexpr int numMatrices{ 1024 };
+			constexpr int numRepetitions{ 2000 };
+			constexpr float tolerance{ 1e-4f };
+
+			std::mt19937 random{ 1337 };
+			std::uniform_real_distribution<float> valueDistribution{ -2.0f, 2.0f };
+
+			//Affine matrices with a well conditioned 3x3 part, half of them get a projective last column
+			std::vector<Matrix> matrices(numMatrices);
+			for (int i = 0; i < numMatrices; ++i)
+			{
+				float* pM = matrices[i].GetData();
+				for (int j = 0; j < 16; ++j)
+				{
+					pM[j] = valueDistribution(random);
+				}
+				pM[0] += 4.0f; pM[5] += 4.0f; pM[10] += 4.0f;
+				pM[3] = pM[7] = pM[11] = 0.0f;
+				pM[15] = 1.0f;
+
+				if (i % 2 == 1)
+				{
+					pM[11] = 1.0f;
+					pM[15] = valueDistribution(random);
+				}
+			}
+
+			std::vector<Matrix> results(numMatrices);
+			std::vector<Matrix> expected(numMatrices);
+
+			std::vector<InstructionSet> instructionSets;
+			for (InstructionSet instructionSet : { InstructionSet::Scalar, InstructionSet::SSE2, InstructionSet::AVX })
+			{
+				if (IsSupported(instructionSet))
+				{
+					instructionSets.push_back(instructionSet);
+				}
+			}
+
+			std::cout << "Matrix kernels, compiled for " << GetName(CompiledInstructionSet) << "\n";
+
+			const auto measure = [&](const char* pName, bool isExact, bool isAffineOnly, const auto& kernel)
+			{
+				for (InstructionSet instructionSet : instructionSets)
+				{
+					//Correctness against the scalar kernel
+					bool isValid{ true };
+					for (int i = 0; i < numMatrices; ++i)
+					{
+						if (isAffineOnly && i % 2 == 1)
+							continue;
+
+						kernel(matrices[i].GetData(), expected[i].GetData(), InstructionSet::Scalar);
+						kernel(matrices[i].GetData(), results[i].GetData(), instructionSet);
+
+						for (int j = 0; j < 16; ++j)
+						{
+							const float a = expected[i].GetData()[j];
+							const float b = results[i].GetData()[j];
+							const bool isEqual = isExact ? memcmp(&a, &b, sizeof(float)) == 0 : std::abs(a - b) <= tolerance * std::max(1.0f, std::abs(a));
+							isValid = isValid && isEqual;
+						}
+					}
+
+					const Clock::time_point start = Clock::now();
+					for (int repetition = 0; repetition < numRepetitions; ++repetition)
+					{
+						for (int i = 0; i < numMatrices; ++i)
+						{
+							kernel(matrices[i].GetData(), results[i].GetData(), instructionSet);
+						}
+					}
+					const float nanoseconds = std::chrono::duration<float, std::nano>(Clock::now() - start).count() / (numMatrices * numRepetitions);
+
+					std::cout << "  " << pName << " " << GetName(instructionSet) << ": " << nanoseconds << " ns"
+						<< (isValid ? "" : " MISMATCH") << "\n";
+				}
+			};
+
+			measure("Multiply", true, false, [&matrices](const float* pM, float* pResult, InstructionSet instructionSet)
+			{
+				Multiply(pM, matrices[0].GetData(), pResult, instructionSet);
+			});
+
+			measure("Multiply in place", true, false, [](const float* pM, float* pResult, InstructionSet instructionSet)
+			{
+				memcpy(pResult, pM, 16 * sizeof(float));
+				Multiply(pResult, pM, pResult, instructionSet);
+			});
+
+			measure("Transform x4", true, false, [](const float* pM, float* pResult, InstructionSet instructionSet)
+			{
+				Transform(pM, 1.0f, 2.0f, 3.0f, 1.0f, pResult + 0, instructionSet);
+				Transform(pM, -1.0f, 0.5f, 2.0f, 1.0f, pResult + 4, instructionSet);
+				Transform(pM, 0.0f, -3.0f, 1.0f, 0.0f, pResult + 8, instructionSet);
+				Transform(pM, 4.0f, 1.0f, -2.0f, 0.0f, pResult + 12, instructionSet);
+			});
+
+			measure("Transpose", true, false, [](const float* pM, float* pResult, InstructionSet instructionSet)
+			{
+				Transpose(pM, pResult, instructionSet);
+			});
+
+			measure("Inverse", false, false, [](const float* pM, float* pResult, InstructionSet instructionSet)
+			{
+				Inverse(pM, pResult, instructionSet);
+			});
+
+			measure("InverseAffine", false, true, [](const float* pM, float* pResult, InstructionSet instructionSet)
+			{
+				InverseAffine(pM, pResult, instructionSet);
+			});
+		}
+	}
+}
@@ -0,0 +1,57 @@
+#pragma once
+
+//Matrix picks its kernels at compile time, /arch:AVX (MSVC) or -mavx (GCC/Clang) enables the AVX path
+#if defined(__AVX__)
+#define DAE_MATH_AVX 1
+#endif
+
+#if defined(__AVX__) || defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define DAE_MATH_SSE2 1
+#endif
+
+namespace dae
+{
+	// Kernels behind Matrix, all matrices are 16 floats row after row (row vectors, v * M).
+	// Every matrix and result pointer must be 16 byte aligned, Matrix::GetData and &Vector4::x always are.
+	namespace MatrixSIMD
+	{
+		enum class InstructionSet
+		{
+			Scalar,
+			SSE2,
+			AVX
+		};
+
+#if defined(DAE_MATH_AVX)
+		constexpr InstructionSet CompiledInstructionSet{ InstructionSet::AVX };
+#elif defined(DAE_MATH_SSE2)
+		constexpr InstructionSet CompiledInstructionSet{ InstructionSet::SSE2 };
+#else
+		constexpr InstructionSet CompiledInstructionSet{ InstructionSet::Scalar };
+#endif
+
+		const char* GetName(InstructionSet instructionSet);
+		// Whether the kernels of this set were compiled in and the CPU runs them
+		bool IsSupported(InstructionSet instructionSet);
+
+		// pResult may alias pA and/or pB. Same evaluation order as the scalar path, so results are bit identical.
+		void Multiply(const float* pA, const float* pB, float* pResult, InstructionSet instructionSet = CompiledInstructionSet);
+
+		// pResult = (x, y, z, w) * M, bit identical to the scalar path
+		void Transform(const float* pM, float x, float y, float z, float w, float* pResult, InstructionSet instructionSet = CompiledInstructionSet);
+
+		// pResult may alias pM
+		void Transpose(const float* pM, float* pResult, InstructionSet instructionSet = CompiledInstructionSet);
+
+		// Full 4x4 inverse, returns false (and leaves pResult untouched) when the matrix is singular: |det| at most
+		// FLT_EPSILON times the product of the row lengths, so the cutoff scales with the matrix.
+		// The scalar path uses the FGED cross product method, the SIMD path the 2x2 block method (Schur complement);
+		// they agree to a few ulp, not bit for bit.
+		bool Inverse(const float* pM, float* pResult, InstructionSet instructionSet = CompiledInstructionSet);
+		// Only valid when the last column is (0, 0, 0, 1), cheaper than the full inverse
+		bool InverseAffine(const float* pM, float* pResult, InstructionSet instructionSet = CompiledInstructionSet);
+
+		// Verifies every kernel against the scalar path and prints ns per call for every supported set
+		void Benchmark();
+	}
+}
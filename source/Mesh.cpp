@@ -5,76 +5,177 @@
 
 namespace dae
 {
-	Mesh::Mesh(ID3D11Device* pDevice, const std::vector<Vertex>& vertices, const std::vector<uint32_t>& indices)
+	namespace
+	{
+		//sqrt of the UV area over the object space area, ratio of the lengths instead of the areas
+		float CalculateUVDensity(const std::vector<Vertex>& vertices, const std::vector<uint32_t>& indices)
+		{
+			double objectArea{ 0.0 };
+			double uvArea{ 0.0 };
+			for (size_t i = 0; i + 2 < indices.size(); i += 3)
+			{
+				const Vertex& v0 = vertices[indices[i]];
+				const Vertex& v1 = vertices[indices[i + 1]];
+				const Vertex& v2 = vertices[indices[i + 2]];
+
+				const float triangleArea = Vector3::Cross(v1.position - v0.position, v2.position - v0.position).Magnitude() * 0.5f;
+
+				const Vector2 uvEdge0 = v1.texCoord - v0.texCoord;
+				const Vector2 uvEdge1 = v2.texCoord - v0.texCoord;
+				const float triangleUVArea = std::abs(uvEdge0.x * uvEdge1.y - uvEdge0.y * uvEdge1.x) * 0.5f;
+
+				//Degenerate or unmapped triangles say nothing about the density
+				if (triangleArea <= FLT_EPSILON || triangleUVArea <= FLT_EPSILON)
+					continue;
+
+				objectArea += triangleArea;
+				uvArea += triangleUVArea;
+			}
+
+			if (objectArea == 0.0)
+				return 0.0f;
+
+			return static_cast<float>(std::sqrt(uvArea / objectArea));
+		}
+	}
+
+	Mesh::Mesh(GraphicsBackend& backend, const std::vector<Vertex>& vertices, const std::vector<uint32_t>& indices)
 		: m_Vertices{ vertices }
 		, m_Indices{ indices }
 		, m_NumIndices{ static_cast<uint32_t>(indices.size()) }
-		, m_pEffect{ std::make_unique<Effect>(pDevice, L"Resources/PosCol3D.fx")}
-		, m_pDevice{ pDevice }
+		, m_Backend{ backend }
+		, m_VertexBuffer{ backend.CreateBuffer({ BufferUsage::Vertex, static_cast<uint32_t>(sizeof(Vertex) * m_Vertices.size()), false }, m_Vertices.data()) }
+		, m_IndexBuffer{ backend.CreateBuffer({ BufferUsage::Index, static_cast<uint32_t>(sizeof(uint32_t) * m_Indices.size()), false }, m_Indices.data()) }
 	{
-		D3D11_BUFFER_DESC bufferDesc{};
-		bufferDesc.Usage			= D3D11_USAGE_IMMUTABLE;
-		bufferDesc.ByteWidth		= sizeof(Vertex) * static_cast<uint32_t>(m_Vertices.size());
-		bufferDesc.BindFlags		= D3D11_BIND_VERTEX_BUFFER;
-		bufferDesc.CPUAccessFlags	= 0;
-		bufferDesc.MiscFlags		= 0;
-
-		D3D11_SUBRESOURCE_DATA initData{};
-		initData.pSysMem = m_Vertices.data();
-
-		HRESULT result = m_pDevice->CreateBuffer(&bufferDesc, &initData, &m_pVertexBuffer);
-		if (FAILED(result))
+		if (m_VertexBuffer == 0 || m_IndexBuffer == 0)
 		{
-			std::wcout << L"Failed to create vertex buffer\n";
+			std::cout << "Failed to create mesh buffers!\n";
 			assert(false);
 		}
-		
-		bufferDesc.Usage			= D3D11_USAGE_IMMUTABLE;
-		bufferDesc.ByteWidth		= sizeof(uint32_t) * m_NumIndices;
-		bufferDesc.BindFlags		= D3D11_BIND_INDEX_BUFFER;
-		bufferDesc.CPUAccessFlags	= 0;
-		bufferDesc.MiscFlags		= 0;
 
-		initData.pSysMem = m_Indices.data();
+		m_UVDensity = CalculateUVDensity(m_Vertices, m_Indices);
 
-		result = m_pDevice->CreateBuffer(&bufferDesc, &initData, &m_pIndexBuffer);
-		if (FAILED(result))
+		if (!m_Vertices.empty())
 		{
-			std::wcout << L"Failed to create index buffer\n";
-			assert(false);
+			Vector3 min = m_Vertices[0].position;
+			Vector3 max = m_Vertices[0].position;
+			for (const Vertex& vertex : m_Vertices)
+			{
+				min = Vector3::Min(min, vertex.position);
+				max = Vector3::Max(max, vertex.position);
+			}
+
+			m_BoundsCenter = (min + max) * 0.5f;
+			for (const Vertex& vertex : m_Vertices)
+			{
+				m_BoundsRadius = std::max(m_BoundsRadius, (vertex.position - m_BoundsCenter).Magnitude());
+			}
 		}
 	}
 
 	Mesh::~Mesh()
 	{
-		if (m_pIndexBuffer) m_pIndexBuffer->Release();
-		if (m_pVertexBuffer) m_pVertexBuffer->Release();
+		m_Backend.DestroyBuffer(m_IndexBuffer);
+		m_Backend.DestroyBuffer(m_VertexBuffer);
 	}
 
-	void Mesh::Render(const Camera& camera, ID3D11DeviceContext* pDeviceContext) const
+	void Mesh::MarkTexturesUsed() const
 	{
-		pDeviceContext->IASetPrimitiveTopology(D3D11_PRIMITIVE_TOPOLOGY_TRIANGLELIST);
-		pDeviceContext->IASetInputLayout(m_pEffect->GetInputLayout());
+		if (m_Material.pDiffuseMap) m_Material.pDiffuseMap->MarkUsed();
+		if (m_Material.pNormalGlossSpecularMap) m_Material.pNormalGlossSpecularMap->MarkUsed();
+	}
 
-		constexpr UINT stride = sizeof(Vertex);
-		constexpr UINT offset = 0;
-		pDeviceContext->IASetVertexBuffers(0, 1, &m_pVertexBuffer, &stride, &offset);
-		pDeviceContext->IASetIndexBuffer(m_pIndexBuffer, DXGI_FORMAT_R32_UINT, 0);
+	void Mesh::SetDiffuseMap(std::shared_ptr<Texture> pTexture, const Vector4& uvTransform)
+	{
+		m_Material.pDiffuseMap = std::move(pTexture);
+		m_Material.diffuseUVTransform = uvTransform;
+	}
 
-		m_pEffect->SetWorldViewProjMatrix(worldMatrix * camera.viewMatrix * camera.projectionMatrix);
-		m_pEffect->SetDiffuseMap(m_pDiffuseMap.get());
+	Texture* Mesh::GetDiffuseMap() const
+	{
+		return m_Material.pDiffuseMap.get();
+	}
 
-		D3DX11_TECHNIQUE_DESC techniqueDesc{};
-		m_pEffect->GetTechnique()->GetDesc(&techniqueDesc);
-		for (UINT i = 0; i < techniqueDesc.Passes; ++i)
-		{
-			m_pEffect->GetTechnique()->GetPassByIndex(i)->Apply(0, pDeviceContext);
-			pDeviceContext->DrawIndexed(m_NumIndices, 0, 0);
-		}
+	BufferHandle Mesh::GetVertexBuffer() const
+	{
+		return m_VertexBuffer;
 	}
 
-	void Mesh::SetDiffuseMap(const std::string_view& filepath)
+	BufferHandle Mesh::GetIndexBuffer() const
 	{
-		m_pDiffuseMap = std::make_unique<Texture>(m_pDevice, filepath);
+		return m_IndexBuffer;
+	}
+
+	uint32_t Mesh::GetNumIndices() const
+	{
+		return m_NumIndices;
+	}
+
+	BoundingSphere Mesh::GetBounds() const
+	{
+		return { m_BoundsCenter, m_BoundsRadius };
+	}
+
+	void Mesh::SetMaterial(Material material)
+	{
+		m_Material = std::move(material);
+	}
+
+	const Material& Mesh::GetMaterial() const
+	{
+		return m_Material;
+	}
+
+	float Mesh::GetUVDensity() const
+	{
+		return m_UVDensity;
+	}
+
+	uint32_t Mesh::EstimateMip(const Camera& camera, float screenHeight, uint32_t textureWidth, uint32_t textureHeight) const
+	{
+		//Assumes a uniform scale
+		return EstimateMip(camera, screenHeight, textureWidth, textureHeight, transform.TransformPoint(m_BoundsCenter), std::abs(transform.GetScale().x));
+	}
+
+	uint32_t Mesh::EstimateMip(const Camera& camera, float screenHeight, uint32_t textureWidth, uint32_t textureHeight, const Matrix& worldMatrix) const
+	{
+		//Assumes a uniform scale as well, the length of one axis is the scale
+		return EstimateMip(camera, screenHeight, textureWidth, textureHeight, worldMatrix.TransformPoint(m_BoundsCenter), worldMatrix.GetAxisX().Magnitude());
+	}
+
+	void Mesh::RequestTextureMips(const Camera& camera, float screenHeight) const
+	{
+		RequestTextureMips(camera, screenHeight, transform.TransformPoint(m_BoundsCenter), std::abs(transform.GetScale().x));
+	}
+
+	void Mesh::RequestTextureMips(const Camera& camera, float screenHeight, const Matrix& worldMatrix) const
+	{
+		RequestTextureMips(camera, screenHeight, worldMatrix.TransformPoint(m_BoundsCenter), worldMatrix.GetAxisX().Magnitude());
+	}
+
+	uint32_t Mesh::EstimateMip(const Camera& camera, float screenHeight, uint32_t textureWidth, uint32_t textureHeight, const Vector3& worldCenter, float worldScale) const
+	{
+		if (m_UVDensity <= 0.0f || screenHeight <= 0.0f || worldScale <= 0.0f)
+			return 0;
+
+		const float distance = std::max((worldCenter - camera.origin).Magnitude() - m_BoundsRadius * worldScale, camera.nearPlane);
+
+		//camera.fov holds tan(fovAngle / 2)
+		const float pixelsPerWorldUnit = screenHeight / (2.0f * distance * camera.fov);
+		const float texelsPerWorldUnit = m_UVDensity * std::sqrt(static_cast<float>(textureWidth) * static_cast<float>(textureHeight)) / worldScale;
+
+		const float mip = std::log2(texelsPerWorldUnit / pixelsPerWorldUnit);
+		return mip > 0.0f ? static_cast<uint32_t>(mip) : 0;
+	}
+
+	void Mesh::RequestTextureMips(const Camera& camera, float screenHeight, const Vector3& worldCenter, float worldScale) const
+	{
+		for (Texture* pTexture : { m_Material.pDiffuseMap.get(), m_Material.pNormalGlossSpecularMap.get() })
+		{
+			if (pTexture != nullptr)
+			{
+				pTexture->RequestMip(EstimateMip(camera, screenHeight, pTexture->GetWidth(), pTexture->GetHeight(), worldCenter, worldScale));
+			}
+		}
 	}
 }
@@ -1,27 +1,24 @@
 #pragma once
 
 #include "Camera.h"
-#include "Effect.h"
+#include "Frustum.h"
+#include "GraphicsBackend.h"
+#include "Material.h"
 #include "Matrix.h"
 #include "Texture.h"
+#include "Transform.h"
+#include "Vertex.h"
 
 namespace dae
 {
-	struct Vertex
-	{
-		Vector3 position;
-		Vector2 texCoord;
-		Vector3 normal;
-		Vector3 tangent;
-	};
-
 	class Mesh final
 	{
 	public:
-		Matrix worldMatrix;
+		Transform transform;
 
 	public:
-		Mesh(ID3D11Device* pDevice, const std::vector<Vertex>& vertices, const std::vector<uint32_t>& indices);
+		// The buffers are created on backend, which must outlive the mesh. The mesh is drawn through a BackendScene.
+		Mesh(GraphicsBackend& backend, const std::vector<Vertex>& vertices, const std::vector<uint32_t>& indices);
 		~Mesh();
 
 		Mesh(const Mesh&)				= delete;
@@ -29,21 +26,50 @@ namespace dae
 		Mesh(Mesh&&)					= delete;
 		Mesh& operator=(Mesh&&)			= delete;
 
-		void Render(const Camera& camera, ID3D11DeviceContext* pDeviceContext) const;
+		// Restores evicted textures, call on the main thread before TextureResidency::Update so this frame counts as a use
+		void MarkTexturesUsed() const;
+
+		// uvTransform maps the mesh UVs into a sub-region of a shared texture (xy scale, zw offset)
+		void SetDiffuseMap(std::shared_ptr<Texture> pTexture, const Vector4& uvTransform = { 1.0f, 1.0f, 0.0f, 0.0f });
+		Texture* GetDiffuseMap() const;
 
-		void SetDiffuseMap(const std::string_view& filepath);
+		// Shared with InstanceBatch, which draws the same buffers many times. 0 when they could not be created.
+		BufferHandle GetVertexBuffer() const;
+		BufferHandle GetIndexBuffer() const;
+		uint32_t GetNumIndices() const;
+		// Object space
+		BoundingSphere GetBounds() const;
+
+		void SetMaterial(Material material);
+		const Material& GetMaterial() const;
+
+		// UV units per object space unit, averaged over the surface area
+		float GetUVDensity() const;
+		// Finest mip of a texture with this size that still maps at least one texel to a pixel, from the closest point of the bounds
+		uint32_t EstimateMip(const Camera& camera, float screenHeight, uint32_t textureWidth, uint32_t textureHeight) const;
+		// The same for a copy of the mesh placed with worldMatrix instead of transform, e.g. an InstanceBatch instance
+		uint32_t EstimateMip(const Camera& camera, float screenHeight, uint32_t textureWidth, uint32_t textureHeight, const Matrix& worldMatrix) const;
+		// Feeds the estimate of every material texture into texture streaming, call once per frame
+		void RequestTextureMips(const Camera& camera, float screenHeight) const;
+		void RequestTextureMips(const Camera& camera, float screenHeight, const Matrix& worldMatrix) const;
 
 	private:
 		std::vector<Vertex> m_Vertices;
 		std::vector<uint32_t> m_Indices;
 		uint32_t m_NumIndices;
 
-		std::unique_ptr<Effect> m_pEffect;
-		std::unique_ptr<Texture> m_pDiffuseMap;
+		float m_UVDensity{};
+		Vector3 m_BoundsCenter{};
+		float m_BoundsRadius{};
 
-		ID3D11Buffer* m_pVertexBuffer;
-		ID3D11Buffer* m_pIndexBuffer;
+		Material m_Material{};
 
-		ID3D11Device* m_pDevice;
+		GraphicsBackend& m_Backend;
+		BufferHandle m_VertexBuffer;
+		BufferHandle m_IndexBuffer;
+
+	private:
+		uint32_t EstimateMip(const Camera& camera, float screenHeight, uint32_t textureWidth, uint32_t textureHeight, const Vector3& worldCenter, float worldScale) const;
+		void RequestTextureMips(const Camera& camera, float screenHeight, const Vector3& worldCenter, float worldScale) const;
 	};
 }
@@ -0,0 +1,92 @@
+#include "PageTable.h"
+
+#include <algorithm>
+#include <bit>
+
+namespace dae
+{
+	uint32_t PageId::Pack() const
+	{
+		return (textureId << 24) | (mip << 20) | (x << 10) | y;
+	}
+
+	PageId PageId::Unpack(uint32_t key)
+	{
+		return { key >> 24, (key >> 20) & 0xF, (key >> 10) & 0x3FF, key & 0x3FF };
+	}
+
+	PageId PageId::GetParent() const
+	{
+		return { textureId, mip + 1, x / 2, y / 2 };
+	}
+
+	PageTable::PageTable(uint32_t widthInPages, uint32_t heightInPages)
+		: m_Width{ std::bit_ceil(std::clamp(widthInPages, 1u, MaxPagesPerAxis)) }
+		, m_Height{ std::bit_ceil(std::clamp(heightInPages, 1u, MaxPagesPerAxis)) }
+	{
+		//The coarsest mip is a single page
+		for (uint32_t mip = 0; mip < MaxVirtualMips; ++mip)
+		{
+			m_Mips.emplace_back(static_cast<size_t>(GetWidth(mip)) * GetHeight(mip), InvalidPage);
+			if (GetWidth(mip) == 1 && GetHeight(mip) == 1)
+				break;
+		}
+	}
+
+	uint32_t PageTable::GetMipCount() const
+	{
+		return static_cast<uint32_t>(m_Mips.size());
+	}
+
+	uint32_t PageTable::GetWidth(uint32_t mip) const
+	{
+		return std::max(m_Width >> mip, 1u);
+	}
+
+	uint32_t PageTable::GetHeight(uint32_t mip) const
+	{
+		return std::max(m_Height >> mip, 1u);
+	}
+
+	bool PageTable::IsInside(uint32_t mip, uint32_t x, uint32_t y) const
+	{
+		return mip < GetMipCount() && x < GetWidth(mip) && y < GetHeight(mip);
+	}
+
+	uint32_t PageTable::GetSlot(uint32_t mip, uint32_t x, uint32_t y) const
+	{
+		if (!IsInside(mip, x, y))
+			return InvalidPage;
+
+		return m_Mips[mip][static_cast<size_t>(y) * GetWidth(mip) + x];
+	}
+
+	void PageTable::Map(uint32_t mip, uint32_t x, uint32_t y, uint32_t slot)
+	{
+		if (IsInside(mip, x, y))
+		{
+			m_Mips[mip][static_cast<size_t>(y) * GetWidth(mip) + x] = slot;
+		}
+	}
+
+	void PageTable::Unmap(uint32_t mip, uint32_t x, uint32_t y)
+	{
+		Map(mip, x, y, InvalidPage);
+	}
+
+	uint32_t PageTable::Resolve(uint32_t& mip, uint32_t& x, uint32_t& y) const
+	{
+		for (; mip < GetMipCount(); ++mip, x /= 2, y /= 2)
+		{
+			const uint32_t slot = GetSlot(mip, x, y);
+			if (slot != InvalidPage)
+				return slot;
+		}
+		return InvalidPage;
+	}
+
+	const std::vector<uint32_t>& PageTable::GetMipData(uint32_t mip) const
+	{
+		return m_Mips[mip];
+	}
+}
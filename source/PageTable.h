@@ -0,0 +1,62 @@
+#pragma once
+
+#include <cstdint>
+#include <vector>
+
+namespace dae
+{
+	// Address of one page of a virtual texture
+	struct PageId
+	{
+		uint32_t textureId{};
+		uint32_t mip{};
+		uint32_t x{};
+		uint32_t y{};
+
+		// The key in the feedback buffer: 8 bit texture, 4 bit mip, 10 bit x, 10 bit y
+		uint32_t Pack() const;
+		static PageId Unpack(uint32_t key);
+
+		// The page one mip coarser that covers this one
+		PageId GetParent() const;
+	};
+
+	constexpr uint32_t InvalidPage{ 0xFFFFFFFF };
+	constexpr uint32_t MaxVirtualTextures{ 255 };
+	constexpr uint32_t MaxPagesPerAxis{ 1024 };
+	constexpr uint32_t MaxVirtualMips{ 15 };
+
+	// Maps every page of every mip of a virtual texture to a physical cache slot.
+	// The size in pages is rounded up to a power of two so every page has exactly one parent.
+	class PageTable final
+	{
+	public:
+		PageTable(uint32_t widthInPages, uint32_t heightInPages);
+		~PageTable() = default;
+
+		PageTable(const PageTable&)				= delete;
+		PageTable& operator=(const PageTable&)	= delete;
+		PageTable(PageTable&&)					= delete;
+		PageTable& operator=(PageTable&&)		= delete;
+
+		uint32_t GetMipCount() const;
+		uint32_t GetWidth(uint32_t mip) const;
+		uint32_t GetHeight(uint32_t mip) const;
+		bool IsInside(uint32_t mip, uint32_t x, uint32_t y) const;
+
+		uint32_t GetSlot(uint32_t mip, uint32_t x, uint32_t y) const;
+		void Map(uint32_t mip, uint32_t x, uint32_t y, uint32_t slot);
+		void Unmap(uint32_t mip, uint32_t x, uint32_t y);
+
+		// Walks up the mip chain until a mapped page is found, mip/x/y are updated to that page
+		uint32_t Resolve(uint32_t& mip, uint32_t& x, uint32_t& y) const;
+
+		// One slot index per page, row major, InvalidPage when not resident. Meant for uploading as a R32_UINT texture.
+		const std::vector<uint32_t>& GetMipData(uint32_t mip) const;
+
+	private:
+		std::vector<std::vector<uint32_t>> m_Mips;
+		uint32_t m_Width;
+		uint32_t m_Height;
+	};
+}
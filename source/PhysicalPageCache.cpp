@@ -0,0 +1,88 @@
+#include "PhysicalPageCache.h"
+#include "PageTable.h"
+
+namespace dae
+{
+	PhysicalPageCache::PhysicalPageCache(uint32_t numSlots)
+		: m_Slots(numSlots, Slot{ InvalidPage, 0, false })
+	{
+		//Popped from the back, so slot 0 is handed out first
+		m_FreeSlots.reserve(numSlots);
+		for (uint32_t slot = numSlots; slot > 0; --slot)
+		{
+			m_FreeSlots.push_back(slot - 1);
+		}
+		m_PageToSlot.reserve(numSlots);
+	}
+
+	uint32_t PhysicalPageCache::GetNumSlots() const
+	{
+		return static_cast<uint32_t>(m_Slots.size());
+	}
+
+	uint32_t PhysicalPageCache::GetNumUsedSlots() const
+	{
+		return static_cast<uint32_t>(m_Slots.size() - m_FreeSlots.size());
+	}
+
+	uint32_t PhysicalPageCache::Find(uint32_t pageKey) const
+	{
+		const auto it = m_PageToSlot.find(pageKey);
+		return it != m_PageToSlot.end() ? it->second : InvalidPage;
+	}
+
+	uint32_t PhysicalPageCache::GetPageKey(uint32_t slot) const
+	{
+		return m_Slots[slot].pageKey;
+	}
+
+	void PhysicalPageCache::Touch(uint32_t slot, uint32_t frame)
+	{
+		m_Slots[slot].lastUsedFrame = frame;
+	}
+
+	uint32_t PhysicalPageCache::Allocate(uint32_t pageKey, uint32_t frame, uint32_t& evictedKey, bool isPinned)
+	{
+		evictedKey = InvalidPage;
+
+		uint32_t slot = InvalidPage;
+		if (!m_FreeSlots.empty())
+		{
+			slot = m_FreeSlots.back();
+			m_FreeSlots.pop_back();
+		}
+		else
+		{
+			//Only a handful of pages are loaded per frame, a linear scan beats keeping a list sorted
+			uint32_t oldestFrame = frame;
+			for (uint32_t i = 0; i < m_Slots.size(); ++i)
+			{
+				if (!m_Slots[i].isPinned && m_Slots[i].lastUsedFrame < oldestFrame)
+				{
+					oldestFrame = m_Slots[i].lastUsedFrame;
+					slot = i;
+				}
+			}
+
+			if (slot == InvalidPage)
+				return InvalidPage;
+
+			evictedKey = m_Slots[slot].pageKey;
+			m_PageToSlot.erase(evictedKey);
+		}
+
+		m_Slots[slot] = { pageKey, frame, isPinned };
+		m_PageToSlot[pageKey] = slot;
+		return slot;
+	}
+
+	void PhysicalPageCache::Free(uint32_t slot)
+	{
+		if (m_Slots[slot].pageKey == InvalidPage)
+			return;
+
+		m_PageToSlot.erase(m_Slots[slot].pageKey);
+		m_Slots[slot] = { InvalidPage, 0, false };
+		m_FreeSlots.push_back(slot);
+	}
+}
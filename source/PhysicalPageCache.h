@@ -0,0 +1,47 @@
+#pragma once
+
+#include <cstdint>
+#include <unordered_map>
+#include <vector>
+
+namespace dae
+{
+	// Fixed number of equally sized page slots shared by all virtual textures, recycled least recently used first
+	class PhysicalPageCache final
+	{
+	public:
+		explicit PhysicalPageCache(uint32_t numSlots);
+		~PhysicalPageCache() = default;
+
+		PhysicalPageCache(const PhysicalPageCache&)				= delete;
+		PhysicalPageCache& operator=(const PhysicalPageCache&)	= delete;
+		PhysicalPageCache(PhysicalPageCache&&)					= delete;
+		PhysicalPageCache& operator=(PhysicalPageCache&&)		= delete;
+
+		uint32_t GetNumSlots() const;
+		uint32_t GetNumUsedSlots() const;
+
+		// Slot holding the packed page, InvalidPage when it is not cached
+		uint32_t Find(uint32_t pageKey) const;
+		uint32_t GetPageKey(uint32_t slot) const;
+		void Touch(uint32_t slot, uint32_t frame);
+
+		// Takes a free slot or recycles the least recently used one that was not touched this frame.
+		// evictedKey receives the page that lived in the slot before (InvalidPage if none).
+		// Returns InvalidPage when every slot is pinned or in use this frame.
+		uint32_t Allocate(uint32_t pageKey, uint32_t frame, uint32_t& evictedKey, bool isPinned = false);
+		void Free(uint32_t slot);
+
+	private:
+		struct Slot
+		{
+			uint32_t pageKey;
+			uint32_t lastUsedFrame;
+			bool isPinned;
+		};
+
+		std::vector<Slot> m_Slots;
+		std::vector<uint32_t> m_FreeSlots;
+		std::unordered_map<uint32_t, uint32_t> m_PageToSlot;
+	};
+}
@@ -0,0 +1,494 @@
+#include "PixelConversion.h"
+
+#include <algorithm>
+#include <cfloat>
+#include <chrono>
+#include <cstring>
+#include <functional>
+#include <immintrin.h>
+#include <iostream>
+#include <random>
+#include <vector>
+
+#if defined(_MSC_VER)
+#include <intrin.h>
+#endif
+
+#if defined(__GNUC__) || defined(__clang__)
+#define TARGET_SSE41 __attribute__((target("sse4.1")))
+#define TARGET_AVX2 __attribute__((target("avx2")))
+#else
+#define TARGET_SSE41
+#define TARGET_AVX2
+#endif
+
+namespace dae
+{
+	namespace PixelConversion
+	{
+		namespace
+		{
+			constexpr size_t bytesPerPixel{ 4 };
+
+			struct ShuffleMasks
+			{
+				alignas(32) uint8_t shuffle[32];
+				alignas(32) uint8_t fill[32];
+			};
+
+			//pshufb masks for 4 pixels, repeated for both AVX2 lanes
+			ShuffleMasks CreateShuffleMasks(ChannelOrder order, uint8_t srcBytesPerPixel)
+			{
+				const uint8_t channels[4]{ order.r, order.g, order.b, order.a };
+
+				ShuffleMasks masks{};
+				for (uint8_t p = 0; p < 8; ++p)
+				{
+					for (uint8_t c = 0; c < 4; ++c)
+					{
+						const bool isMissing = channels[c] == NoChannel;
+						masks.shuffle[p * 4 + c] = isMissing ? 0x80 : static_cast<uint8_t>((p % 4) * srcBytesPerPixel + channels[c]);
+						masks.fill[p * 4 + c] = isMissing ? 0xFF : 0x00;
+					}
+				}
+				return masks;
+			}
+
+			bool HasSSE41()
+			{
+#if defined(_MSC_VER)
+				int registers[4]{};
+				__cpuid(registers, 1);
+				return (registers[2] & (1 << 19)) != 0;
+#else
+				__builtin_cpu_init();
+				return __builtin_cpu_supports("sse4.1");
+#endif
+			}
+
+			//CPUID reports AVX2, XGETBV whether the OS saves the ymm registers
+			bool HasAVX2()
+			{
+#if defined(_MSC_VER)
+				int registers[4]{};
+				__cpuid(registers, 1);
+				const bool hasOSXSAVE = (registers[2] & (1 << 27)) != 0;
+				if (!hasOSXSAVE || (_xgetbv(0) & 0x6) != 0x6)
+					return false;
+
+				__cpuidex(registers, 7, 0);
+				return (registers[1] & (1 << 5)) != 0;
+#else
+				__builtin_cpu_init();
+				return __builtin_cpu_supports("avx2");
+#endif
+			}
+
+			uint8_t MultiplyUnorm(uint32_t a, uint32_t b)
+			{
+				//Exact round(a * b / 255) for 8 bit inputs
+				const uint32_t t = a * b + 128;
+				return static_cast<uint8_t>((t + (t >> 8)) >> 8);
+			}
+
+#pragma region Scalar
+			void ExpandToRGBAScalar(const uint8_t* pSrc, uint8_t* pDst, size_t numPixels, ChannelOrder order)
+			{
+				const uint8_t channels[4]{ order.r, order.g, order.b, order.a };
+				for (size_t i = 0; i < numPixels; ++i)
+				{
+					const uint8_t* pIn = pSrc + i * 3;
+					uint8_t* pOut = pDst + i * bytesPerPixel;
+					for (int c = 0; c < 4; ++c)
+					{
+						pOut[c] = channels[c] == NoChannel ? 0xFF : pIn[channels[c]];
+					}
+				}
+			}
+
+			void SwizzleToRGBAScalar(const uint8_t* pSrc, uint8_t* pDst, size_t numPixels, ChannelOrder order)
+			{
+				const uint8_t channels[4]{ order.r, order.g, order.b, order.a };
+				for (size_t i = 0; i < numPixels; ++i)
+				{
+					uint8_t in[4];
+					memcpy(in, pSrc + i * bytesPerPixel, bytesPerPixel);
+
+					uint8_t* pOut = pDst + i * bytesPerPixel;
+					for (int c = 0; c < 4; ++c)
+					{
+						pOut[c] = channels[c] == NoChannel ? 0xFF : in[channels[c]];
+					}
+				}
+			}
+
+			void ExpandPaletteScalar(const uint8_t* pIndices, const uint32_t* pPalette, uint8_t* pDst, size_t numPixels)
+			{
+				for (size_t i = 0; i < numPixels; ++i)
+				{
+					memcpy(pDst + i * bytesPerPixel, &pPalette[pIndices[i]], bytesPerPixel);
+				}
+			}
+
+			void PremultiplyAlphaScalar(uint8_t* pPixels, size_t numPixels)
+			{
+				for (size_t i = 0; i < numPixels; ++i)
+				{
+					uint8_t* pPixel = pPixels + i * bytesPerPixel;
+					pPixel[0] = MultiplyUnorm(pPixel[0], pPixel[3]);
+					pPixel[1] = MultiplyUnorm(pPixel[1], pPixel[3]);
+					pPixel[2] = MultiplyUnorm(pPixel[2], pPixel[3]);
+				}
+			}
+#pragma endregion
+
+#pragma region SSE4.1
+			TARGET_SSE41 void ExpandToRGBASSE41(const uint8_t* pSrc, uint8_t* pDst, size_t numPixels, ChannelOrder order)
+			{
+				const ShuffleMasks masks = CreateShuffleMasks(order, 3);
+				const __m128i shuffle = _mm_load_si128(reinterpret_cast<const __m128i*>(masks.shuffle));
+				const __m128i fill = _mm_load_si128(reinterpret_cast<const __m128i*>(masks.fill));
+
+				//16 pixels = 48 source bytes = 3 loads per iteration
+				size_t i = 0;
+				for (; i + 16 <= numPixels; i += 16)
+				{
+					const __m128i v0 = _mm_loadu_si128(reinterpret_cast<const __m128i*>(pSrc + i * 3));
+					const __m128i v1 = _mm_loadu_si128(reinterpret_cast<const __m128i*>(pSrc + i * 3 + 16));
+					const __m128i v2 = _mm_loadu_si128(reinterpret_cast<const __m128i*>(pSrc + i * 3 + 32));
+
+					const __m128i p0 = v0;
+					const __m128i p1 = _mm_alignr_epi8(v1, v0, 12);
+					const __m128i p2 = _mm_alignr_epi8(v2, v1, 8);
+					const __m128i p3 = _mm_srli_si128(v2, 4);
+
+					__m128i* pOut = reinterpret_cast<__m128i*>(pDst + i * bytesPerPixel);
+					_mm_storeu_si128(pOut + 0, _mm_or_si128(_mm_shuffle_epi8(p0, shuffle), fill));
+					_mm_storeu_si128(pOut + 1, _mm_or_si128(_mm_shuffle_epi8(p1, shuffle), fill));
+					_mm_storeu_si128(pOut + 2, _mm_or_si128(_mm_shuffle_epi8(p2, shuffle), fill));
+					_mm_storeu_si128(pOut + 3, _mm_or_si128(_mm_shuffle_epi8(p3, shuffle), fill));
+				}
+
+				ExpandToRGBAScalar(pSrc + i * 3, pDst + i * bytesPerPixel, numPixels - i, order);
+			}
+
+			TARGET_SSE41 void SwizzleToRGBASSE41(const uint8_t* pSrc, uint8_t* pDst, size_t numPixels, ChannelOrder order)
+			{
+				const ShuffleMasks masks = CreateShuffleMasks(order, 4);
+				const __m128i shuffle = _mm_load_si128(reinterpret_cast<const __m128i*>(masks.shuffle));
+				const __m128i fill = _mm_load_si128(reinterpret_cast<const __m128i*>(masks.fill));
+
+				size_t i = 0;
+				for (; i + 4 <= numPixels; i += 4)
+				{
+					const __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i*>(pSrc + i * bytesPerPixel));
+					_mm_storeu_si128(reinterpret_cast<__m128i*>(pDst + i * bytesPerPixel), _mm_or_si128(_mm_shuffle_epi8(v, shuffle), fill));
+				}
+
+				SwizzleToRGBAScalar(pSrc + i * bytesPerPixel, pDst + i * bytesPerPixel, numPixels - i, order);
+			}
+
+			//Two pixels widened to 16 bit per channel
+			TARGET_SSE41 __m128i Premultiply2(__m128i v)
+			{
+				//Multiplying the alpha channel by 255 leaves it untouched
+				const __m128i alphaOne = _mm_set_epi16(255, 0, 0, 0, 255, 0, 0, 0);
+
+				__m128i alpha = _mm_shufflelo_epi16(v, _MM_SHUFFLE(3, 3, 3, 3));
+				alpha = _mm_shufflehi_epi16(alpha, _MM_SHUFFLE(3, 3, 3, 3));
+				alpha = _mm_or_si128(alpha, alphaOne);
+
+				__m128i t = _mm_add_epi16(_mm_mullo_epi16(v, alpha), _mm_set1_epi16(128));
+				t = _mm_add_epi16(t, _mm_srli_epi16(t, 8));
+				return _mm_srli_epi16(t, 8);
+			}
+
+			TARGET_SSE41 void PremultiplyAlphaSSE41(uint8_t* pPixels, size_t numPixels)
+			{
+				const __m128i zero = _mm_setzero_si128();
+
+				size_t i = 0;
+				for (; i + 4 <= numPixels; i += 4)
+				{
+					__m128i* pBlock = reinterpret_cast<__m128i*>(pPixels + i * bytesPerPixel);
+					const __m128i v = _mm_loadu_si128(pBlock);
+
+					const __m128i lo = Premultiply2(_mm_unpacklo_epi8(v, zero));
+					const __m128i hi = Premultiply2(_mm_unpackhi_epi8(v, zero));
+					_mm_storeu_si128(pBlock, _mm_packus_epi16(lo, hi));
+				}
+
+				PremultiplyAlphaScalar(pPixels + i * bytesPerPixel, numPixels - i);
+			}
+#pragma endregion
+
+#pragma region AVX2
+			TARGET_AVX2 void ExpandToRGBAAVX2(const uint8_t* pSrc, uint8_t* pDst, size_t numPixels, ChannelOrder order)
+			{
+				const ShuffleMasks masks = CreateShuffleMasks(order, 3);
+				const __m256i shuffle = _mm256_load_si256(reinterpret_cast<const __m256i*>(masks.shuffle));
+				const __m256i fill = _mm256_load_si256(reinterpret_cast<const __m256i*>(masks.fill));
+
+				//8 pixels per iteration, the second 16 byte load reads 4 bytes past the 24 that are used
+				size_t i = 0;
+				for (; i + 10 <= numPixels; i += 8)
+				{
+					const __m128i lo = _mm_loadu_si128(reinterpret_cast<const __m128i*>(pSrc + i * 3));
+					const __m128i hi = _mm_loadu_si128(reinterpret_cast<const __m128i*>(pSrc + i * 3 + 12));
+					const __m256i v = _mm256_inserti128_si256(_mm256_castsi128_si256(lo), hi, 1);
+
+					_mm256_storeu_si256(reinterpret_cast<__m256i*>(pDst + i * bytesPerPixel), _mm256_or_si256(_mm256_shuffle_epi8(v, shuffle), fill));
+				}
+
+				ExpandToRGBAScalar(pSrc + i * 3, pDst + i * bytesPerPixel, numPixels - i, order);
+			}
+
+			TARGET_AVX2 void SwizzleToRGBAAVX2(const uint8_t* pSrc, uint8_t* pDst, size_t numPixels, ChannelOrder order)
+			{
+				const ShuffleMasks masks = CreateShuffleMasks(order, 4);
+				const __m256i shuffle = _mm256_load_si256(reinterpret_cast<const __m256i*>(masks.shuffle));
+				const __m256i fill = _mm256_load_si256(reinterpret_cast<const __m256i*>(masks.fill));
+
+				size_t i = 0;
+				for (; i + 8 <= numPixels; i += 8)
+				{
+					const __m256i v = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(pSrc + i * bytesPerPixel));
+					_mm256_storeu_si256(reinterpret_cast<__m256i*>(pDst + i * bytesPerPixel), _mm256_or_si256(_mm256_shuffle_epi8(v, shuffle), fill));
+				}
+
+				SwizzleToRGBAScalar(pSrc + i * bytesPerPixel, pDst + i * bytesPerPixel, numPixels - i, order);
+			}
+
+			TARGET_AVX2 void ExpandPaletteAVX2(const uint8_t* pIndices, const uint32_t* pPalette, uint8_t* pDst, size_t numPixels)
+			{
+				const int* pTable = reinterpret_cast<const int*>(pPalette);
+
+				size_t i = 0;
+				for (; i + 8 <= numPixels; i += 8)
+				{
+					const __m256i indices = _mm256_cvtepu8_epi32(_mm_loadl_epi64(reinterpret_cast<const __m128i*>(pIndices + i)));
+					_mm256_storeu_si256(reinterpret_cast<__m256i*>(pDst + i * bytesPerPixel), _mm256_i32gather_epi32(pTable, indices, 4));
+				}
+
+				ExpandPaletteScalar(pIndices + i, pPalette, pDst + i * bytesPerPixel, numPixels - i);
+			}
+
+			//Four pixels widened to 16 bit per channel
+			TARGET_AVX2 __m256i Premultiply4(__m256i v)
+			{
+				const __m256i alphaShuffle = _mm256_setr_epi8(
+					6, 7, 6, 7, 6, 7, 6, 7, 14, 15, 14, 15, 14, 15, 14, 15,
+					6, 7, 6, 7, 6, 7, 6, 7, 14, 15, 14, 15, 14, 15, 14, 15);
+				const __m256i alphaOne = _mm256_set_epi16(255, 0, 0, 0, 255, 0, 0, 0, 255, 0, 0, 0, 255, 0, 0, 0);
+
+				const __m256i alpha = _mm256_or_si256(_mm256_shuffle_epi8(v, alphaShuffle), alphaOne);
+
+				__m256i t = _mm256_add_epi16(_mm256_mullo_epi16(v, alpha), _mm256_set1_epi16(128));
+				t = _mm256_add_epi16(t, _mm256_srli_epi16(t, 8));
+				return _mm256_srli_epi16(t, 8);
+			}
+
+			TARGET_AVX2 void PremultiplyAlphaAVX2(uint8_t* pPixels, size_t numPixels)
+			{
+				const __m256i zero = _mm256_setzero_si256();
+
+				size_t i = 0;
+				for (; i + 8 <= numPixels; i += 8)
+				{
+					__m256i* pBlock = reinterpret_cast<__m256i*>(pPixels + i * bytesPerPixel);
+					const __m256i v = _mm256_loadu_si256(pBlock);
+
+					//unpack and pack both work per 128 bit lane, so the pixel order is preserved
+					const __m256i lo = Premultiply4(_mm256_unpacklo_epi8(v, zero));
+					const __m256i hi = Premultiply4(_mm256_unpackhi_epi8(v, zero));
+					_mm256_storeu_si256(pBlock, _mm256_packus_epi16(lo, hi));
+				}
+
+				PremultiplyAlphaScalar(pPixels + i * bytesPerPixel, numPixels - i);
+			}
+#pragma endregion
+		}
+
+		InstructionSet GetBestInstructionSet()
+		{
+			static const InstructionSet instructionSet = []
+			{
+				if (IsSupported(InstructionSet::AVX2)) return InstructionSet::AVX2;
+				if (IsSupported(InstructionSet::SSE41)) return InstructionSet::SSE41;
+				return InstructionSet::Scalar;
+			}();
+
+			return instructionSet;
+		}
+
+		const char* GetName(InstructionSet instructionSet)
+		{
+			switch (instructionSet)
+			{
+				case InstructionSet::Scalar:	return "Scalar";
+				case InstructionSet::SSE41:		return "SSE4.1";
+				case InstructionSet::AVX2:		return "AVX2";
+			}
+
+			return "Unknown";
+		}
+
+		bool IsSupported(InstructionSet instructionSet)
+		{
+			switch (instructionSet)
+			{
+				case InstructionSet::Scalar:	return true;
+				case InstructionSet::SSE41:		return HasSSE41();
+				case InstructionSet::AVX2:		return HasAVX2();
+			}
+
+			return false;
+		}
+
+		void ExpandToRGBA(const uint8_t* pSrc, uint8_t* pDst, size_t numPixels, ChannelOrder order, InstructionSet instructionSet)
+		{
+			switch (instructionSet)
+			{
+				case InstructionSet::AVX2:		ExpandToRGBAAVX2(pSrc, pDst, numPixels, order); break;
+				case InstructionSet::SSE41:		ExpandToRGBASSE41(pSrc, pDst, numPixels, order); break;
+				case InstructionSet::Scalar:	ExpandToRGBAScalar(pSrc, pDst, numPixels, order); break;
+			}
+		}
+
+		void SwizzleToRGBA(const uint8_t* pSrc, uint8_t* pDst, size_t numPixels, ChannelOrder order, InstructionSet instructionSet)
+		{
+			switch (instructionSet)
+			{
+				case InstructionSet::AVX2:		SwizzleToRGBAAVX2(pSrc, pDst, numPixels, order); break;
+				case InstructionSet::SSE41:		SwizzleToRGBASSE41(pSrc, pDst, numPixels, order); break;
+				case InstructionSet::Scalar:	SwizzleToRGBAScalar(pSrc, pDst, numPixels, order); break;
+			}
+		}
+
+		void ExpandPalette(const uint8_t* pIndices, const uint32_t* pPalette, uint8_t* pDst, size_t numPixels, InstructionSet instructionSet)
+		{
+			//There is no gather before AVX2, the scalar lookup is as fast as it gets
+			if (instructionSet == InstructionSet::AVX2)
+			{
+				ExpandPaletteAVX2(pIndices, pPalette, pDst, numPixels);
+			}
+			else
+			{
+				ExpandPaletteScalar(pIndices, pPalette, pDst, numPixels);
+			}
+		}
+
+		void PremultiplyAlpha(uint8_t* pPixels, size_t numPixels, InstructionSet instructionSet)
+		{
+			switch (instructionSet)
+			{
+				case InstructionSet::AVX2:		PremultiplyAlphaAVX2(pPixels, numPixels); break;
+				case InstructionSet::SSE41:		PremultiplyAlphaSSE41(pPixels, numPixels); break;
+				case InstructionSet::Scalar:	PremultiplyAlphaScalar(pPixels, numPixels); break;
+			}
+		}
+
+		void Benchmark()
+		{
+			using Clock = std::chrono::high_resolution_clock;
+
+			constexpr size_t numPixels{ 1024 * 1024 };
+			constexpr size_t maxTestPixels{ 67 };
+			constexpr int numRepetitions{ 20 };
+
+			std::mt19937 random{ 1337 };
+			std::uniform_int_distribution<int> byteDistribution{ 0, 255 };
+
+			std::vector<uint8_t> input(numPixels * bytesPerPixel);
+			for (uint8_t& byte : input)
+			{
+				byte = static_cast<uint8_t>(byteDistribution(random));
+			}
+
+			std::vector<uint32_t> palette(256);
+			for (uint32_t& color : palette)
+			{
+				color = static_cast<uint32_t>(random());
+			}
+
+			std::vector<uint8_t> output(numPixels * bytesPerPixel);
+			std::vector<uint8_t> expected(maxTestPixels * bytesPerPixel);
+			std::vector<uint8_t> actual(maxTestPixels * bytesPerPixel);
+
+			const std::vector<ChannelOrder> orders24
+			{
+				{ 0, 1, 2, NoChannel },			//RGB
+				{ 2, 1, 0, NoChannel }			//BGR
+			};
+
+			const std::vector<ChannelOrder> orders32
+			{
+				{ 0, 1, 2, 3 },					//RGBA
+				{ 1, 2, 3, 0 },					//ARGB
+				{ 2, 1, 0, NoChannel },			//BGRX
+				{ 2, 1, 0, 3 }					//BGRA
+			};
+
+			const std::vector<ChannelOrder> noOrder{ ChannelOrder{} };
+
+			struct Kernel
+			{
+				const char* pName;
+				std::function<void(const uint8_t*, uint8_t*, size_t, ChannelOrder, InstructionSet)> function;
+				const std::vector<ChannelOrder>& orders;
+			};
+
+			const Kernel kernels[]
+			{
+				{ "RGB -> RGBA", [](const uint8_t* pSrc, uint8_t* pDst, size_t n, ChannelOrder order, InstructionSet set) { ExpandToRGBA(pSrc, pDst, n, order, set); }, orders24 },
+				{ "BGRA -> RGBA", [](const uint8_t* pSrc, uint8_t* pDst, size_t n, ChannelOrder order, InstructionSet set) { SwizzleToRGBA(pSrc, pDst, n, order, set); }, orders32 },
+				{ "Palette -> RGBA", [&palette](const uint8_t* pSrc, uint8_t* pDst, size_t n, ChannelOrder, InstructionSet set) { ExpandPalette(pSrc, palette.data(), pDst, n, set); }, noOrder },
+				{ "Premultiply", [](const uint8_t* pSrc, uint8_t* pDst, size_t n, ChannelOrder, InstructionSet set) { memcpy(pDst, pSrc, n * bytesPerPixel); PremultiplyAlpha(pDst, n, set); }, noOrder }
+			};
+
+			std::vector<InstructionSet> instructionSets;
+			for (InstructionSet instructionSet : { InstructionSet::Scalar, InstructionSet::SSE41, InstructionSet::AVX2 })
+			{
+				if (IsSupported(instructionSet))
+				{
+					instructionSets.push_back(instructionSet);
+				}
+			}
+
+			for (const Kernel& kernel : kernels)
+			{
+				std::cout << kernel.pName << "\n";
+
+				for (const InstructionSet instructionSet : instructionSets)
+				{
+					//Every image size up to maxTestPixels covers all vector widths and scalar tails
+					bool isCorrect{ true };
+					for (const ChannelOrder& order : kernel.orders)
+					{
+						for (size_t n = 0; n <= maxTestPixels && isCorrect; ++n)
+						{
+							std::fill(expected.begin(), expected.end(), uint8_t{ 0xCD });
+							std::fill(actual.begin(), actual.end(), uint8_t{ 0xCD });
+
+							kernel.function(input.data(), expected.data(), n, order, InstructionSet::Scalar);
+							kernel.function(input.data(), actual.data(), n, order, instructionSet);
+							isCorrect = expected == actual;
+						}
+					}
+
+					float bestMilliseconds{ FLT_MAX };
+					for (int repetition = 0; repetition < numRepetitions; ++repetition)
+					{
+						const Clock::time_point start = Clock::now();
+						kernel.function(input.data(), output.data(), numPixels, kernel.orders.back(), instructionSet);
+						bestMilliseconds = std::min(bestMilliseconds, std::chrono::duration<float, std::milli>(Clock::now() - start).count());
+					}
+
+					const float megaPixelsPerSecond = numPixels / (bestMilliseconds * 1000.0f);
+					std::cout << "  " << GetName(instructionSet) << ": " << bestMilliseconds << " ms, "
+						<< megaPixelsPerSecond << " MPix/s" << (isCorrect ? "" : " MISMATCH") << "\n";
+				}
+			}
+		}
+	}
+}
@@ -0,0 +1,46 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+namespace dae
+{
+	// Conversion kernels from the byte layouts of decoded images to tightly packed RGBA8, Texture maps SDL surfaces onto them
+	namespace PixelConversion
+	{
+		enum class InstructionSet
+		{
+			Scalar,
+			SSE41,
+			AVX2
+		};
+
+		// Source byte index of every destination channel, NoChannel writes 255 (opaque alpha)
+		struct ChannelOrder
+		{
+			uint8_t r;
+			uint8_t g;
+			uint8_t b;
+			uint8_t a;
+		};
+
+		constexpr uint8_t NoChannel{ 0xFF };
+
+		InstructionSet GetBestInstructionSet();
+		const char* GetName(InstructionSet instructionSet);
+		// Whether the CPU runs the kernels of this set, every set is always compiled in
+		bool IsSupported(InstructionSet instructionSet);
+
+		// 3 bytes per source pixel (RGB24, BGR24, ...)
+		void ExpandToRGBA(const uint8_t* pSrc, uint8_t* pDst, size_t numPixels, ChannelOrder order, InstructionSet instructionSet = GetBestInstructionSet());
+		// 4 bytes per source pixel (BGRA32, ARGB32, XRGB32, ...), pSrc may equal pDst
+		void SwizzleToRGBA(const uint8_t* pSrc, uint8_t* pDst, size_t numPixels, ChannelOrder order, InstructionSet instructionSet = GetBestInstructionSet());
+		// 1 byte index per source pixel, the palette holds RGBA8 entries
+		void ExpandPalette(const uint8_t* pIndices, const uint32_t* pPalette, uint8_t* pDst, size_t numPixels, InstructionSet instructionSet = GetBestInstructionSet());
+		// In place, rgb = rgb * a / 255 rounded to nearest
+		void PremultiplyAlpha(uint8_t* pPixels, size_t numPixels, InstructionSet instructionSet = GetBestInstructionSet());
+
+		// Verifies every kernel against the scalar path and prints the throughput per instruction set
+		void Benchmark();
+	}
+}
@@ -0,0 +1,73 @@
+#include "Quaternion.h"
+
+#include <cmath>
+
+namespace dae
+{
+	float Quaternion::Magnitude() const
+	{
+		return sqrtf(x * x + y * y + z * z + w * w);
+	}
+
+	float Quaternion::Normalize()
+	{
+		const float m = Magnitude();
+		x /= m;
+		y /= m;
+		z /= m;
+		w /= m;
+
+		return m;
+	}
+
+	Quaternion Quaternion::Normalized() const
+	{
+		const float m = Magnitude();
+		return { x / m, y / m, z / m, w / m };
+	}
+
+	Quaternion Quaternion::CreateFromAxisAngle(const Vector3& axis, float angle)
+	{
+		const Vector3 normalizedAxis = axis.Normalized();
+		const float halfSin = sinf(angle * 0.5f);
+		return { normalizedAxis.x * halfSin, normalizedAxis.y * halfSin, normalizedAxis.z * halfSin, cosf(angle * 0.5f) };
+	}
+
+	Quaternion Quaternion::CreateRotation(float pitch, float yaw, float roll)
+	{
+		//Matrix::CreateRotationX turns the opposite way of Y and Z, hence the negated pitch
+		return CreateFromAxisAngle(Vector3::UnitX, -pitch) * CreateFromAxisAngle(Vector3::UnitY, yaw) * CreateFromAxisAngle(Vector3::UnitZ, roll);
+	}
+
+	Quaternion Quaternion::CreateRotation(const Vector3& r)
+	{
+		return CreateRotation(r.x, r.y, r.z);
+	}
+
+	Quaternion Quaternion::Slerp(const Quaternion& q1, const Quaternion& q2, float factor)
+	{
+		//q and -q are the same rotation, take the one on the short arc
+		float cosAngle = Dot(q1, q2);
+		const float sign = cosAngle < 0.0f ? -1.0f : 1.0f;
+		cosAngle *= sign;
+
+		float weight1 = 1.0f - factor;
+		float weight2 = factor;
+		if (cosAngle < 0.9995f)
+		{
+			const float angle = acosf(cosAngle);
+			const float invSin = 1.0f / sinf(angle);
+			weight1 = sinf(weight1 * angle) * invSin;
+			weight2 = sinf(weight2 * angle) * invSin;
+		}
+		weight2 *= sign;
+
+		const Quaternion result{
+			q1.x * weight1 + q2.x * weight2,
+			q1.y * weight1 + q2.y * weight2,
+			q1.z * weight1 + q2.z * weight2,
+			q1.w * weight1 + q2.w * weight2
+		};
+		return result.Normalized();
+	}
+}
@@ -0,0 +1,102 @@
+#pragma once
+#include "Matrix.h"
+#include "Vector3.h"
+
+namespace dae
+{
+	// Unit quaternion for rotations. Products compose in the same order as Matrix: a * b rotates by a, then by b,
+	// so (a * b).ToMatrix() equals a.ToMatrix() * b.ToMatrix().
+	struct Quaternion
+	{
+		float x{};
+		float y{};
+		float z{};
+		float w{ 1.0f };
+
+		constexpr Quaternion() = default;
+		constexpr Quaternion(float _x, float _y, float _z, float _w) : x(_x), y(_y), z(_z), w(_w) {}
+
+		float Magnitude() const;
+		float Normalize();
+		Quaternion Normalized() const;
+
+		// Inverse of a unit quaternion
+		constexpr Quaternion Conjugate() const;
+
+		constexpr Vector3 Rotate(const Vector3& v) const;
+		constexpr Matrix ToMatrix() const;
+
+		// Same rotation as Matrix::CreateRotationY/Z for the Y and Z axes
+		static Quaternion CreateFromAxisAngle(const Vector3& axis, float angle);
+		// Same rotation as Matrix::CreateRotation(pitch, yaw, roll)
+		static Quaternion CreateRotation(float pitch, float yaw, float roll);
+		static Quaternion CreateRotation(const Vector3& r);
+
+		static constexpr float Dot(const Quaternion& q1, const Quaternion& q2);
+		// Shortest path, falls back to a normalized lerp for nearly equal rotations
+		static Quaternion Slerp(const Quaternion& q1, const Quaternion& q2, float factor);
+
+		constexpr Quaternion operator*(const Quaternion& q) const;
+		constexpr const Quaternion& operator*=(const Quaternion& q);
+		constexpr bool operator==(const Quaternion& q) const = default;
+
+		static const Quaternion Identity;
+	};
+
+	inline constexpr Quaternion Quaternion::Identity{ 0.0f, 0.0f, 0.0f, 1.0f };
+
+	constexpr Quaternion Quaternion::Conjugate() const
+	{
+		return { -x, -y, -z, w };
+	}
+
+	constexpr Vector3 Quaternion::Rotate(const Vector3& v) const
+	{
+		//v + 2w(u x v) + 2u x (u x v), u being the vector part
+		const Vector3 u{ x, y, z };
+		const Vector3 t = 2.0f * Vector3::Cross(u, v);
+		return v + w * t + Vector3::Cross(u, t);
+	}
+
+	constexpr Matrix Quaternion::ToMatrix() const
+	{
+		const float xx = x * x;
+		const float yy = y * y;
+		const float zz = z * z;
+		const float xy = x * y;
+		const float xz = x * z;
+		const float yz = y * z;
+		const float wx = w * x;
+		const float wy = w * y;
+		const float wz = w * z;
+
+		return {
+			Vector3{ 1.0f - 2.0f * (yy + zz), 2.0f * (xy + wz), 2.0f * (xz - wy) },
+			Vector3{ 2.0f * (xy - wz), 1.0f - 2.0f * (xx + zz), 2.0f * (yz + wx) },
+			Vector3{ 2.0f * (xz + wy), 2.0f * (yz - wx), 1.0f - 2.0f * (xx + yy) },
+			Vector3::Zero
+		};
+	}
+
+	constexpr float Quaternion::Dot(const Quaternion& q1, const Quaternion& q2)
+	{
+		return q1.x * q2.x + q1.y * q2.y + q1.z * q2.z + q1.w * q2.w;
+	}
+
+	constexpr Quaternion Quaternion::operator*(const Quaternion& q) const
+	{
+		//Hamilton product q * this, so this rotation is applied first
+		return {
+			q.w * x + q.x * w + q.y * z - q.z * y,
+			q.w * y - q.x * z + q.y * w + q.z * x,
+			q.w * z + q.x * y - q.y * x + q.z * w,
+			q.w * w - q.x * x - q.y * y - q.z * z
+		};
+	}
+
+	constexpr const Quaternion& Quaternion::operator*=(const Quaternion& q)
+	{
+		*this = *this * q;
+		return *this;
+	}
+}
@@ -0,0 +1,199 @@
+#pragma once
+
+#include <chrono>
+#include <cstdint>
+#include <cstring>
+#include <functional>
+#include <vector>
+
+namespace dae
+{
+	// Pixels of one rendered frame, tightly packed RGBA8
+	struct CapturedFrame
+	{
+		uint64_t frameIndex{};
+		uint32_t width{};
+		uint32_t height{};
+		std::vector<uint8_t> pixels{};
+	};
+
+	enum class ReadbackStatus : uint8_t
+	{
+		Ready,
+		// The copy has not finished on the GPU yet, only returned when not waiting
+		Pending,
+		Failed
+	};
+
+	// Reads rendered frames back without waiting for the GPU. Every submitted frame is copied into the next free slot and
+	// only mapped a few frames later, when the copy has long finished, so reading back frame N overlaps with rendering
+	// N + 1 and onwards. The render thread only waits when every slot is still in flight. Frames are delivered in
+	// submission order.
+	//
+	// Target owns the slots: D3D11ReadbackTarget uses staging textures, tests use a synthetic frame source. It provides
+	//		uint32_t GetNumSlots() const;
+	//		uint32_t GetWidth() const;
+	//		uint32_t GetHeight() const;
+	//		void Copy(uint32_t slot);															// queues a copy of the current output
+	//		ReadbackStatus Map(uint32_t slot, bool isWaiting, const uint8_t*& pData, uint32_t& rowPitch);
+	//		void Unmap(uint32_t slot);															// only after Ready
+	template<typename Target>
+	class ReadbackQueue final
+	{
+	public:
+		using FrameCallback = std::function<void(CapturedFrame&&)>;
+
+		struct Statistics
+		{
+			uint32_t numSubmitted{};
+			uint32_t numCaptured{};
+			uint32_t numFailed{};
+			// Submits that found every slot in flight and had to wait for the oldest
+			uint32_t numStalls{};
+			// Polls that found the oldest copy still running
+			uint32_t numPending{};
+			// Mapping and copying out of the slots, on the calling thread
+			float readbackMilliseconds{};
+		};
+
+	public:
+		// onFrame is called on the thread that calls Submit, Poll and Flush
+		ReadbackQueue(Target& target, FrameCallback onFrame);
+		~ReadbackQueue() = default;
+
+		ReadbackQueue(const ReadbackQueue&)				= delete;
+		ReadbackQueue& operator=(const ReadbackQueue&)	= delete;
+		ReadbackQueue(ReadbackQueue&&)					= delete;
+		ReadbackQueue& operator=(ReadbackQueue&&)		= delete;
+
+		// After the frame is rendered into the target's output
+		void Submit(uint64_t frameIndex);
+		// Delivers every frame whose copy finished, oldest first, without waiting
+		void Poll();
+		// Waits for and delivers every frame in flight
+		void Flush();
+
+		uint32_t GetNumInFlight() const;
+		const Statistics& GetStatistics() const;
+
+	private:
+		struct Slot
+		{
+			uint64_t frameIndex;
+		};
+
+		Target& m_Target;
+		FrameCallback m_OnFrame;
+
+		// Ring of in flight slots, m_First is the oldest
+		std::vector<Slot> m_Slots{};
+		uint32_t m_First{ 0 };
+		uint32_t m_NumInFlight{ 0 };
+
+		Statistics m_Statistics{};
+
+	private:
+		// Pending only when not waiting
+		ReadbackStatus ReadOldest(bool isWaiting);
+	};
+
+	template<typename Target>
+	ReadbackQueue<Target>::ReadbackQueue(Target& target, FrameCallback onFrame)
+		: m_Target{ target }
+		, m_OnFrame{ std::move(onFrame) }
+		, m_Slots(target.GetNumSlots())
+	{
+	}
+
+	template<typename Target>
+	void ReadbackQueue<Target>::Submit(uint64_t frameIndex)
+	{
+		if (m_Slots.empty())
+			return;
+
+		//Frees the oldest slot, this is the only place the render thread waits on the GPU
+		if (m_NumInFlight == m_Slots.size())
+		{
+			++m_Statistics.numStalls;
+			ReadOldest(true);
+		}
+
+		const uint32_t slot = (m_First + m_NumInFlight) % static_cast<uint32_t>(m_Slots.size());
+		m_Target.Copy(slot);
+		m_Slots[slot].frameIndex = frameIndex;
+		++m_NumInFlight;
+		++m_Statistics.numSubmitted;
+	}
+
+	template<typename Target>
+	void ReadbackQueue<Target>::Poll()
+	{
+		while (m_NumInFlight > 0)
+		{
+			if (ReadOldest(false) == ReadbackStatus::Pending)
+			{
+				++m_Statistics.numPending;
+				return;
+			}
+		}
+	}
+
+	template<typename Target>
+	void ReadbackQueue<Target>::Flush()
+	{
+		while (m_NumInFlight > 0)
+		{
+			ReadOldest(true);
+		}
+	}
+
+	template<typename Target>
+	uint32_t ReadbackQueue<Target>::GetNumInFlight() const
+	{
+		return m_NumInFlight;
+	}
+
+	template<typename Target>
+	const typename ReadbackQueue<Target>::Statistics& ReadbackQueue<Target>::GetStatistics() const
+	{
+		return m_Statistics;
+	}
+
+	template<typename Target>
+	ReadbackStatus ReadbackQueue<Target>::ReadOldest(bool isWaiting)
+	{
+		const auto start = std::chrono::steady_clock::now();
+
+		const uint32_t slot = m_First;
+		const uint8_t* pData{ nullptr };
+		uint32_t rowPitch{ 0 };
+		const ReadbackStatus status = m_Target.Map(slot, isWaiting, pData, rowPitch);
+		if (status == ReadbackStatus::Pending)
+			return status;
+
+		m_First = (m_First + 1) % static_cast<uint32_t>(m_Slots.size());
+		--m_NumInFlight;
+
+		if (status == ReadbackStatus::Failed)
+		{
+			++m_Statistics.numFailed;
+			return status;
+		}
+
+		//Rows of a mapped texture are padded, the frame is handed on tightly packed
+		CapturedFrame frame{ m_Slots[slot].frameIndex, m_Target.GetWidth(), m_Target.GetHeight() };
+		const size_t packedPitch = static_cast<size_t>(frame.width) * 4;
+		frame.pixels.resize(packedPitch * frame.height);
+		for (uint32_t y = 0; y < frame.height; ++y)
+		{
+			std::memcpy(frame.pixels.data() + y * packedPitch, pData + static_cast<size_t>(y) * rowPitch, packedPitch);
+		}
+		m_Target.Unmap(slot);
+
+		m_Statistics.readbackMilliseconds += std::chrono::duration<float, std::milli>(std::chrono::steady_clock::now() - start).count();
+		++m_Statistics.numCaptured;
+
+		m_OnFrame(std::move(frame));
+		return status;
+	}
+}
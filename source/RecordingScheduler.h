@@ -0,0 +1,180 @@
+#pragma once
+
+#include "ThreadPool.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <span>
+#include <vector>
+
+namespace dae
+{
+	// [begin, end) of the items one context records
+	struct RecordingRange
+	{
+		uint32_t begin;
+		uint32_t end;
+	};
+
+	// Records a sorted draw list on several threads. The list is split into contiguous ranges, every range is recorded
+	// into its own deferred context and the command lists are executed in range order, so the draws reach the GPU in
+	// exactly the order of the list. Short lists are recorded straight into the immediate context.
+	//
+	// Target owns the contexts and names their types: D3D11RecordingTarget uses D3D11 deferred contexts, tests use a
+	// fake that logs what was recorded where. It provides
+	//		uint32_t GetNumDeferredContexts() const;
+	//		Context& GetImmediateContext();
+	//		Context& BeginDeferred(uint32_t index);				// on a worker thread, index < GetNumDeferredContexts()
+	//		CommandList FinishDeferred(uint32_t index);			// on the same worker thread
+	//		void Execute(CommandList commandList);				// on the calling thread, in range order
+	template<typename Target>
+	class RecordingScheduler final
+	{
+	public:
+		using Context = typename Target::Context;
+		using CommandList = typename Target::CommandList;
+
+		struct Statistics
+		{
+			uint32_t numItems{};
+			// 1 when the list was recorded into the immediate context
+			uint32_t numRanges{};
+			float recordMilliseconds{};
+			float executeMilliseconds{};
+		};
+
+	public:
+		// numThreads includes the calling thread, 0 uses one thread per logical core
+		RecordingScheduler(Target& target, uint32_t numThreads = 0, uint32_t minItemsPerRange = 64);
+		~RecordingScheduler() = default;
+
+		RecordingScheduler(const RecordingScheduler&)				= delete;
+		RecordingScheduler& operator=(const RecordingScheduler&)	= delete;
+		RecordingScheduler(RecordingScheduler&&)					= delete;
+		RecordingScheduler& operator=(RecordingScheduler&&)			= delete;
+
+		// Splits [0, numItems) into at most maxRanges ordered ranges of at least minItemsPerRange items, sizes differ by
+		// at most one. A list shorter than minItemsPerRange still gets one range, an empty list none.
+		static void Partition(uint32_t numItems, uint32_t maxRanges, uint32_t minItemsPerRange, std::vector<RecordingRange>& ranges);
+
+		// Calls record(Context&, RecordingRange) for every range and blocks until all command lists are executed.
+		// record runs concurrently for different ranges, everything it touches besides its context must be read only.
+		template<typename RecordFunction>
+		void Record(uint32_t numItems, const RecordFunction& record);
+
+		// Lists shorter than twice this are recorded into the immediate context, 1 splits every list of two or more
+		void SetMinItemsPerRange(uint32_t minItemsPerRange);
+		uint32_t GetMinItemsPerRange() const;
+
+		std::span<const RecordingRange> GetRanges() const;
+		const Statistics& GetStatistics() const;
+
+	private:
+		Target& m_Target;
+		ThreadPool m_ThreadPool;
+		uint32_t m_MinItemsPerRange;
+
+		std::vector<RecordingRange> m_Ranges{};
+		std::vector<CommandList> m_CommandLists{};
+
+		Statistics m_Statistics{};
+	};
+
+	template<typename Target>
+	RecordingScheduler<Target>::RecordingScheduler(Target& target, uint32_t numThreads, uint32_t minItemsPerRange)
+		: m_Target{ target }
+		, m_ThreadPool{ numThreads }
+		, m_MinItemsPerRange{ std::max(minItemsPerRange, 1u) }
+	{
+	}
+
+	template<typename Target>
+	void RecordingScheduler<Target>::Partition(uint32_t numItems, uint32_t maxRanges, uint32_t minItemsPerRange, std::vector<RecordingRange>& ranges)
+	{
+		ranges.clear();
+		if (numItems == 0)
+			return;
+
+		const uint32_t numRanges = std::clamp(numItems / std::max(minItemsPerRange, 1u), 1u, std::max(maxRanges, 1u));
+		const uint32_t rangeSize = numItems / numRanges;
+		const uint32_t numLargerRanges = numItems % numRanges;
+
+		uint32_t begin{ 0 };
+		for (uint32_t i = 0; i < numRanges; ++i)
+		{
+			const uint32_t end = begin + rangeSize + (i < numLargerRanges ? 1 : 0);
+			ranges.push_back({ begin, end });
+			begin = end;
+		}
+	}
+
+	template<typename Target>
+	template<typename RecordFunction>
+	void RecordingScheduler<Target>::Record(uint32_t numItems, const RecordFunction& record)
+	{
+		const auto start = std::chrono::steady_clock::now();
+
+		const uint32_t maxRanges = std::min(m_ThreadPool.GetNumThreads(), m_Target.GetNumDeferredContexts());
+		Partition(numItems, maxRanges, m_MinItemsPerRange, m_Ranges);
+
+		m_Statistics.numItems = numItems;
+		m_Statistics.numRanges = static_cast<uint32_t>(m_Ranges.size());
+
+		//A deferred context only pays off when there is something to record in parallel
+		if (m_Ranges.size() <= 1)
+		{
+			if (!m_Ranges.empty())
+			{
+				record(m_Target.GetImmediateContext(), m_Ranges[0]);
+			}
+
+			m_Statistics.recordMilliseconds = std::chrono::duration<float, std::milli>(std::chrono::steady_clock::now() - start).count();
+			m_Statistics.executeMilliseconds = 0.0f;
+			return;
+		}
+
+		m_CommandLists.resize(m_Ranges.size());
+		m_ThreadPool.ParallelFor(static_cast<uint32_t>(m_Ranges.size()), [&](uint32_t index)
+			{
+				record(m_Target.BeginDeferred(index), m_Ranges[index]);
+				m_CommandLists[index] = m_Target.FinishDeferred(index);
+			});
+
+		const auto executeStart = std::chrono::steady_clock::now();
+
+		for (CommandList& commandList : m_CommandLists)
+		{
+			m_Target.Execute(commandList);
+			commandList = {};
+		}
+
+		const auto end = std::chrono::steady_clock::now();
+		m_Statistics.recordMilliseconds = std::chrono::duration<float, std::milli>(executeStart - start).count();
+		m_Statistics.executeMilliseconds = std::chrono::duration<float, std::milli>(end - executeStart).count();
+	}
+
+	template<typename Target>
+	void RecordingScheduler<Target>::SetMinItemsPerRange(uint32_t minItemsPerRange)
+	{
+		m_MinItemsPerRange = std::max(minItemsPerRange, 1u);
+	}
+
+	template<typename Target>
+	uint32_t RecordingScheduler<Target>::GetMinItemsPerRange() const
+	{
+		return m_MinItemsPerRange;
+	}
+
+	template<typename Target>
+	std::span<const RecordingRange> RecordingScheduler<Target>::GetRanges() const
+	{
+		return m_Ranges;
+	}
+
+	template<typename Target>
+	const typename RecordingScheduler<Target>::Statistics& RecordingScheduler<Target>::GetStatistics() const
+	{
+		return m_Statistics;
+	}
+}
@@ -0,0 +1,347 @@
+#include "RenderGraph.h"
+
+#include <cassert>
+#include <iostream>
+#include <queue>
+
+namespace dae
+{
+	size_t RenderGraphTextureDesc::GetSize() const
+	{
+		size_t bytesPerPixel{ 4 };
+		switch (format)
+		{
+		case RenderGraphFormat::RGBA16Float:
+			bytesPerPixel = 8;
+			break;
+		case RenderGraphFormat::RGBA8:
+		case RenderGraphFormat::R32Float:
+		case RenderGraphFormat::Depth24Stencil8:
+			bytesPerPixel = 4;
+			break;
+		}
+		return static_cast<size_t>(width) * height * bytesPerPixel;
+	}
+
+	RenderGraph::Handle RenderGraph::CreateTexture(const std::string& name, const RenderGraphTextureDesc& desc)
+	{
+		return AddTexture(name, desc, false);
+	}
+
+	RenderGraph::Handle RenderGraph::ImportTexture(const std::string& name, const RenderGraphTextureDesc& desc)
+	{
+		return AddTexture(name, desc, true);
+	}
+
+	uint32_t RenderGraph::AddPass(const std::string& name, std::function<void()> execute)
+	{
+		m_Passes.push_back({ name, std::move(execute), {}, {}, false, false });
+		return static_cast<uint32_t>(m_Passes.size() - 1);
+	}
+
+	void RenderGraph::Read(uint32_t pass, Handle texture)
+	{
+		assert(pass < m_Passes.size() && texture < m_Versions.size());
+
+		m_Passes[pass].reads.push_back(texture);
+		m_Versions[texture].readers.push_back(pass);
+	}
+
+	RenderGraph::Handle RenderGraph::Write(uint32_t pass, Handle texture)
+	{
+		assert(pass < m_Passes.size() && texture < m_Versions.size());
+
+		Texture& writtenTexture = m_Textures[m_Versions[texture].texture];
+		if (writtenTexture.latestVersion != texture)
+		{
+			std::cout << "Failed to write " << writtenTexture.name << " in " << m_Passes[pass].name << ", it was written since!\n";
+			return InvalidHandle;
+		}
+
+		const Handle version = static_cast<Handle>(m_Versions.size());
+		m_Versions.push_back({ m_Versions[texture].texture, texture, pass, {} });
+		writtenTexture.latestVersion = version;
+
+		m_Passes[pass].writes.push_back(version);
+		return version;
+	}
+
+	void RenderGraph::SetSideEffects(uint32_t pass)
+	{
+		assert(pass < m_Passes.size());
+		m_Passes[pass].hasSideEffects = true;
+	}
+
+	bool RenderGraph::Compile()
+	{
+		m_PassOrder.clear();
+		m_PhysicalTextures.clear();
+		m_Statistics = {};
+
+		CullPasses();
+		if (!OrderPasses())
+		{
+			std::cout << "Failed to compile render graph, its passes depend on each other in a cycle!\n";
+			m_PassOrder.clear();
+			return false;
+		}
+		AssignPhysicalTextures();
+
+		m_Statistics.numPasses = static_cast<uint32_t>(m_Passes.size());
+		m_Statistics.numCulledPasses = static_cast<uint32_t>(m_Passes.size() - m_PassOrder.size());
+		m_Statistics.numPhysicalTextures = static_cast<uint32_t>(m_PhysicalTextures.size());
+		for (const RenderGraphTextureDesc& desc : m_PhysicalTextures)
+		{
+			m_Statistics.physicalBytes += desc.GetSize();
+		}
+		return true;
+	}
+
+	void RenderGraph::Execute() const
+	{
+		for (const uint32_t pass : m_PassOrder)
+		{
+			if (m_Passes[pass].execute)
+			{
+				m_Passes[pass].execute();
+			}
+		}
+	}
+
+	void RenderGraph::Clear()
+	{
+		m_Textures.clear();
+		m_Versions.clear();
+		m_Passes.clear();
+		m_PassOrder.clear();
+		m_PhysicalTextures.clear();
+		m_Statistics = {};
+	}
+
+	std::span<const uint32_t> RenderGraph::GetPassOrder() const
+	{
+		return m_PassOrder;
+	}
+
+	bool RenderGraph::IsCulled(uint32_t pass) const
+	{
+		return m_Passes[pass].isCulled;
+	}
+
+	const std::string& RenderGraph::GetPassName(uint32_t pass) const
+	{
+		return m_Passes[pass].name;
+	}
+
+	uint32_t RenderGraph::GetTextureIndex(Handle texture) const
+	{
+		return m_Versions[texture].texture;
+	}
+
+	const RenderGraphTextureDesc& RenderGraph::GetTextureDesc(Handle texture) const
+	{
+		return m_Textures[m_Versions[texture].texture].desc;
+	}
+
+	uint32_t RenderGraph::GetPhysicalIndex(Handle texture) const
+	{
+		return m_Textures[m_Versions[texture].texture].physicalIndex;
+	}
+
+	std::span<const RenderGraphTextureDesc> RenderGraph::GetPhysicalTextures() const
+	{
+		return m_PhysicalTextures;
+	}
+
+	const RenderGraph::Statistics& RenderGraph::GetStatistics() const
+	{
+		return m_Statistics;
+	}
+
+	void RenderGraph::PrintStatistics() const
+	{
+		constexpr float toMegaBytes{ 1.0f / (1024.0f * 1024.0f) };
+
+		std::cout << "Render graph: " << m_Statistics.numPasses - m_Statistics.numCulledPasses << " passes (" << m_Statistics.numCulledPasses << " culled), "
+			<< m_Statistics.numTextures << " transient textures in " << m_Statistics.numPhysicalTextures << " ("
+			<< m_Statistics.physicalBytes * toMegaBytes << "/" << m_Statistics.textureBytes * toMegaBytes << " MB)\n";
+	}
+
+	RenderGraph::Handle RenderGraph::AddTexture(const std::string& name, const RenderGraphTextureDesc& desc, bool isImported)
+	{
+		const Handle version = static_cast<Handle>(m_Versions.size());
+		m_Versions.push_back({ static_cast<uint32_t>(m_Textures.size()), InvalidHandle, InvalidIndex, {} });
+		m_Textures.push_back({ name, desc, isImported, version, InvalidIndex, InvalidIndex, InvalidIndex });
+		return version;
+	}
+
+	void RenderGraph::CullPasses()
+	{
+		//Walk back from the passes with visible results, everything they read must be written
+		std::vector<uint32_t> stack{};
+		for (uint32_t pass = 0; pass < m_Passes.size(); ++pass)
+		{
+			Pass& currentPass = m_Passes[pass];
+			currentPass.isCulled = true;
+
+			bool isRoot = currentPass.hasSideEffects;
+			for (const Handle version : currentPass.writes)
+			{
+				isRoot = isRoot || m_Textures[m_Versions[version].texture].isImported;
+			}
+
+			if (isRoot)
+			{
+				currentPass.isCulled = false;
+				stack.push_back(pass);
+			}
+		}
+
+		while (!stack.empty())
+		{
+			const uint32_t pass = stack.back();
+			stack.pop_back();
+
+			for (const Handle version : m_Passes[pass].reads)
+			{
+				const uint32_t writer = m_Versions[version].writer;
+				if (writer != InvalidIndex && m_Passes[writer].isCulled)
+				{
+					m_Passes[writer].isCulled = false;
+					stack.push_back(writer);
+				}
+			}
+		}
+	}
+
+	bool RenderGraph::OrderPasses()
+	{
+		std::vector<std::vector<uint32_t>> dependents(m_Passes.size());
+		std::vector<uint32_t> numDependencies(m_Passes.size(), 0);
+
+		const auto addEdge = [&](uint32_t from, uint32_t to)
+			{
+				if (from == InvalidIndex || from == to || m_Passes[from].isCulled || m_Passes[to].isCulled)
+					return;
+
+				dependents[from].push_back(to);
+				++numDependencies[to];
+			};
+
+		for (const Version& version : m_Versions)
+		{
+			//Read after write
+			for (const uint32_t reader : version.readers)
+			{
+				addEdge(version.writer, reader);
+			}
+
+			if (version.previous == InvalidHandle)
+				continue;
+
+			//Write after read and write after write, the new version overwrites the texture the old one lives in
+			const Version& previous = m_Versions[version.previous];
+			for (const uint32_t reader : previous.readers)
+			{
+				addEdge(reader, version.writer);
+			}
+			addEdge(previous.writer, version.writer);
+		}
+
+		//Ties go to the pass that was added first, so an already ordered setup keeps its order
+		std::priority_queue<uint32_t, std::vector<uint32_t>, std::greater<uint32_t>> ready{};
+		uint32_t numPasses{ 0 };
+		for (uint32_t pass = 0; pass < m_Passes.size(); ++pass)
+		{
+			if (m_Passes[pass].isCulled)
+				continue;
+
+			++numPasses;
+			if (numDependencies[pass] == 0)
+			{
+				ready.push(pass);
+			}
+		}
+
+		while (!ready.empty())
+		{
+			const uint32_t pass = ready.top();
+			ready.pop();
+			m_PassOrder.push_back(pass);
+
+			for (const uint32_t dependent : dependents[pass])
+			{
+				if (--numDependencies[dependent] == 0)
+				{
+					ready.push(dependent);
+				}
+			}
+		}
+
+		return m_PassOrder.size() == numPasses;
+	}
+
+	void RenderGraph::AssignPhysicalTextures()
+	{
+		for (Texture& texture : m_Textures)
+		{
+			texture.firstUse = InvalidIndex;
+			texture.lastUse = InvalidIndex;
+			texture.physicalIndex = InvalidIndex;
+		}
+
+		for (uint32_t position = 0; position < m_PassOrder.size(); ++position)
+		{
+			const Pass& pass = m_Passes[m_PassOrder[position]];
+			const auto use = [&](Handle version)
+				{
+					Texture& texture = m_Textures[m_Versions[version].texture];
+					if (texture.firstUse == InvalidIndex)
+					{
+						texture.firstUse = position;
+					}
+					texture.lastUse = position;
+				};
+
+			for (const Handle version : pass.reads) use(version);
+			for (const Handle version : pass.writes) use(version);
+		}
+
+		//Greedy in order of first use, which needs the fewest textures per desc for intervals
+		std::vector<uint32_t> transients{};
+		for (uint32_t i = 0; i < m_Textures.size(); ++i)
+		{
+			if (!m_Textures[i].isImported && m_Textures[i].firstUse != InvalidIndex)
+			{
+				transients.push_back(i);
+			}
+		}
+		std::stable_sort(transients.begin(), transients.end(), [this](uint32_t a, uint32_t b) { return m_Textures[a].firstUse < m_Textures[b].firstUse; });
+
+		std::vector<uint32_t> physicalLastUse{};
+		for (const uint32_t index : transients)
+		{
+			Texture& texture = m_Textures[index];
+			m_Statistics.textureBytes += texture.desc.GetSize();
+			++m_Statistics.numTextures;
+
+			for (uint32_t physical = 0; physical < m_PhysicalTextures.size(); ++physical)
+			{
+				if (m_PhysicalTextures[physical] == texture.desc && physicalLastUse[physical] < texture.firstUse)
+				{
+					texture.physicalIndex = physical;
+					break;
+				}
+			}
+
+			if (texture.physicalIndex == InvalidIndex)
+			{
+				texture.physicalIndex = static_cast<uint32_t>(m_PhysicalTextures.size());
+				m_PhysicalTextures.push_back(texture.desc);
+				physicalLastUse.push_back(0);
+			}
+
+			physicalLastUse[texture.physicalIndex] = texture.lastUse;
+		}
+	}
+}
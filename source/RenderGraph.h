@@ -0,0 +1,145 @@
+#pragma once
+
+#include <cstdint>
+#include <functional>
+#include <span>
+#include <string>
+#include <vector>
+
+namespace dae
+{
+	enum class RenderGraphFormat
+	{
+		RGBA8,
+		RGBA16Float,
+		R32Float,
+		Depth24Stencil8
+	};
+
+	struct RenderGraphTextureDesc
+	{
+		uint32_t width;
+		uint32_t height;
+		RenderGraphFormat format;
+
+		bool operator==(const RenderGraphTextureDesc&) const = default;
+
+		size_t GetSize() const;
+	};
+
+	// Frame setup as passes that declare the textures they read and write. Compile culls the passes nothing depends on,
+	// orders the rest by their dependencies and assigns the transient textures to physical ones: textures with the same
+	// desc whose lifetimes do not overlap share one. D3D11 cannot place resources in shared memory, reusing whole
+	// textures is the aliasing it allows. No D3D types in here, RenderGraphTextures creates the physical textures.
+	//
+	// A handle names one version of a texture, every write returns a new one. Reading a version depends on the pass that
+	// wrote it, writing a version waits for every pass that read the one before.
+	class RenderGraph final
+	{
+	public:
+		using Handle = uint32_t;
+		static constexpr Handle InvalidHandle{ UINT32_MAX };
+		static constexpr uint32_t InvalidIndex{ UINT32_MAX };
+
+		struct Statistics
+		{
+			uint32_t numPasses{};
+			uint32_t numCulledPasses{};
+			// Transient textures used by a pass that is not culled
+			uint32_t numTextures{};
+			uint32_t numPhysicalTextures{};
+			size_t textureBytes{};
+			size_t physicalBytes{};
+		};
+
+	public:
+		RenderGraph() = default;
+		~RenderGraph() = default;
+
+		RenderGraph(const RenderGraph&)				= delete;
+		RenderGraph& operator=(const RenderGraph&)	= delete;
+		RenderGraph(RenderGraph&&)					= delete;
+		RenderGraph& operator=(RenderGraph&&)		= delete;
+
+		// Created and aliased by the graph, the content is undefined before the first write
+		Handle CreateTexture(const std::string& name, const RenderGraphTextureDesc& desc);
+		// Owned outside the graph (the back buffer), never aliased. A pass writing it is never culled.
+		Handle ImportTexture(const std::string& name, const RenderGraphTextureDesc& desc);
+
+		// Returns the pass index, execute runs in Execute once the pass is ordered
+		uint32_t AddPass(const std::string& name, std::function<void()> execute);
+		void Read(uint32_t pass, Handle texture);
+		// Only the latest version of a texture can be written, InvalidHandle otherwise
+		Handle Write(uint32_t pass, Handle texture);
+		// Kept even when nothing reads what it writes
+		void SetSideEffects(uint32_t pass);
+
+		// False when passes depend on each other in a cycle
+		bool Compile();
+		// Runs the passes in compiled order
+		void Execute() const;
+		// Removes all passes and textures
+		void Clear();
+
+		std::span<const uint32_t> GetPassOrder() const;
+		bool IsCulled(uint32_t pass) const;
+		const std::string& GetPassName(uint32_t pass) const;
+
+		// Texture a version belongs to, textures are numbered in creation order
+		uint32_t GetTextureIndex(Handle texture) const;
+		const RenderGraphTextureDesc& GetTextureDesc(Handle texture) const;
+		// Index into GetPhysicalTextures, InvalidIndex for imported and unused textures
+		uint32_t GetPhysicalIndex(Handle texture) const;
+		std::span<const RenderGraphTextureDesc> GetPhysicalTextures() const;
+
+		const Statistics& GetStatistics() const;
+		void PrintStatistics() const;
+
+	private:
+		struct Texture
+		{
+			std::string name;
+			RenderGraphTextureDesc desc;
+			bool isImported;
+			Handle latestVersion;
+			// Positions in the pass order
+			uint32_t firstUse;
+			uint32_t lastUse;
+			uint32_t physicalIndex;
+		};
+
+		struct Version
+		{
+			uint32_t texture;
+			Handle previous;
+			// InvalidIndex for the version a texture starts with
+			uint32_t writer;
+			std::vector<uint32_t> readers;
+		};
+
+		struct Pass
+		{
+			std::string name;
+			std::function<void()> execute;
+			std::vector<Handle> reads;
+			std::vector<Handle> writes;
+			bool hasSideEffects;
+			bool isCulled;
+		};
+
+		std::vector<Texture> m_Textures{};
+		std::vector<Version> m_Versions{};
+		std::vector<Pass> m_Passes{};
+
+		std::vector<uint32_t> m_PassOrder{};
+		std::vector<RenderGraphTextureDesc> m_PhysicalTextures{};
+
+		Statistics m_Statistics{};
+
+	private:
+		Handle AddTexture(const std::string& name, const RenderGraphTextureDesc& desc, bool isImported);
+		void CullPasses();
+		bool OrderPasses();
+		void AssignPhysicalTextures();
+	};
+}
@@ -0,0 +1,161 @@
+#include "pch.h"
+#include "RenderGraphTextures.h"
+
+namespace dae
+{
+	RenderGraphTextures::RenderGraphTextures(ID3D11Device* pDevice)
+		: m_pDevice{ pDevice }
+	{
+	}
+
+	RenderGraphTextures::~RenderGraphTextures()
+	{
+		for (PhysicalTexture& physicalTexture : m_PhysicalTextures)
+		{
+			Release(physicalTexture);
+		}
+	}
+
+	bool RenderGraphTextures::Realize(const RenderGraph& graph)
+	{
+		m_pGraph = &graph;
+
+		const std::span<const RenderGraphTextureDesc> descs = graph.GetPhysicalTextures();
+		for (size_t i = descs.size(); i < m_PhysicalTextures.size(); ++i)
+		{
+			Release(m_PhysicalTextures[i]);
+		}
+		m_PhysicalTextures.resize(descs.size(), PhysicalTexture{});
+
+		bool isRealized{ true };
+		for (size_t i = 0; i < descs.size(); ++i)
+		{
+			PhysicalTexture& physicalTexture = m_PhysicalTextures[i];
+			if (physicalTexture.pTexture != nullptr && physicalTexture.desc == descs[i])
+				continue;
+
+			Release(physicalTexture);
+			physicalTexture.desc = descs[i];
+			isRealized = Create(physicalTexture) && isRealized;
+		}
+		return isRealized;
+	}
+
+	ID3D11RenderTargetView* RenderGraphTextures::GetRenderTargetView(RenderGraph::Handle texture) const
+	{
+		const PhysicalTexture* pPhysicalTexture = Find(texture);
+		return pPhysicalTexture != nullptr ? pPhysicalTexture->pRenderTargetView : nullptr;
+	}
+
+	ID3D11DepthStencilView* RenderGraphTextures::GetDepthStencilView(RenderGraph::Handle texture) const
+	{
+		const PhysicalTexture* pPhysicalTexture = Find(texture);
+		return pPhysicalTexture != nullptr ? pPhysicalTexture->pDepthStencilView : nullptr;
+	}
+
+	ID3D11ShaderResourceView* RenderGraphTextures::GetShaderResourceView(RenderGraph::Handle texture) const
+	{
+		const PhysicalTexture* pPhysicalTexture = Find(texture);
+		return pPhysicalTexture != nullptr ? pPhysicalTexture->pShaderResourceView : nullptr;
+	}
+
+	bool RenderGraphTextures::Create(PhysicalTexture& physicalTexture) const
+	{
+		const bool isDepth = physicalTexture.desc.format == RenderGraphFormat::Depth24Stencil8;
+
+		DXGI_FORMAT format{ DXGI_FORMAT_R8G8B8A8_UNORM };
+		switch (physicalTexture.desc.format)
+		{
+		case RenderGraphFormat::RGBA8:
+			format = DXGI_FORMAT_R8G8B8A8_UNORM;
+			break;
+		case RenderGraphFormat::RGBA16Float:
+			format = DXGI_FORMAT_R16G16B16A16_FLOAT;
+			break;
+		case RenderGraphFormat::R32Float:
+			format = DXGI_FORMAT_R32_FLOAT;
+			break;
+		case RenderGraphFormat::Depth24Stencil8:
+			format = DXGI_FORMAT_R24G8_TYPELESS;
+			break;
+		}
+
+		D3D11_TEXTURE2D_DESC textureDesc{};
+		textureDesc.Width				= physicalTexture.desc.width;
+		textureDesc.Height				= physicalTexture.desc.height;
+		textureDesc.MipLevels			= 1;
+		textureDesc.ArraySize			= 1;
+		textureDesc.Format				= format;
+		textureDesc.SampleDesc.Count	= 1;
+		textureDesc.SampleDesc.Quality	= 0;
+		textureDesc.Usage				= D3D11_USAGE_DEFAULT;
+		textureDesc.BindFlags			= D3D11_BIND_SHADER_RESOURCE | (isDepth ? D3D11_BIND_DEPTH_STENCIL : D3D11_BIND_RENDER_TARGET);
+		textureDesc.CPUAccessFlags		= 0;
+		textureDesc.MiscFlags			= 0;
+
+		HRESULT result = m_pDevice->CreateTexture2D(&textureDesc, nullptr, &physicalTexture.pTexture);
+		if (FAILED(result))
+		{
+			std::cout << "Failed to create render graph texture!\n";
+			physicalTexture.pTexture = nullptr;
+			return false;
+		}
+
+		D3D11_SHADER_RESOURCE_VIEW_DESC srvDesc{};
+		srvDesc.Format						= isDepth ? DXGI_FORMAT_R24_UNORM_X8_TYPELESS : format;
+		srvDesc.ViewDimension				= D3D11_SRV_DIMENSION_TEXTURE2D;
+		srvDesc.Texture2D.MostDetailedMip	= 0;
+		srvDesc.Texture2D.MipLevels			= 1;
+
+		result = m_pDevice->CreateShaderResourceView(physicalTexture.pTexture, &srvDesc, &physicalTexture.pShaderResourceView);
+		if (FAILED(result))
+		{
+			std::cout << "Failed to create render graph shader resource view!\n";
+			physicalTexture.pShaderResourceView = nullptr;
+			Release(physicalTexture);
+			return false;
+		}
+
+		if (isDepth)
+		{
+			D3D11_DEPTH_STENCIL_VIEW_DESC depthStencilViewDesc{};
+			depthStencilViewDesc.Format				= DXGI_FORMAT_D24_UNORM_S8_UINT;
+			depthStencilViewDesc.ViewDimension		= D3D11_DSV_DIMENSION_TEXTURE2D;
+			depthStencilViewDesc.Texture2D.MipSlice	= 0;
+
+			result = m_pDevice->CreateDepthStencilView(physicalTexture.pTexture, &depthStencilViewDesc, &physicalTexture.pDepthStencilView);
+		}
+		else
+		{
+			result = m_pDevice->CreateRenderTargetView(physicalTexture.pTexture, nullptr, &physicalTexture.pRenderTargetView);
+		}
+
+		if (FAILED(result))
+		{
+			std::cout << "Failed to create render graph target view!\n";
+			physicalTexture.pDepthStencilView = nullptr;
+			physicalTexture.pRenderTargetView = nullptr;
+			Release(physicalTexture);
+			return false;
+		}
+		return true;
+	}
+
+	void RenderGraphTextures::Release(PhysicalTexture& physicalTexture)
+	{
+		if (physicalTexture.pShaderResourceView) physicalTexture.pShaderResourceView->Release();
+		if (physicalTexture.pDepthStencilView) physicalTexture.pDepthStencilView->Release();
+		if (physicalTexture.pRenderTargetView) physicalTexture.pRenderTargetView->Release();
+		if (physicalTexture.pTexture) physicalTexture.pTexture->Release();
+		physicalTexture = {};
+	}
+
+	const RenderGraphTextures::PhysicalTexture* RenderGraphTextures::Find(RenderGraph::Handle texture) const
+	{
+		if (m_pGraph == nullptr)
+			return nullptr;
+
+		const uint32_t physicalIndex = m_pGraph->GetPhysicalIndex(texture);
+		return physicalIndex < m_PhysicalTextures.size() ? &m_PhysicalTextures[physicalIndex] : nullptr;
+	}
+}
@@ -0,0 +1,51 @@
+#pragma once
+
+#include "RenderGraph.h"
+
+#include <vector>
+
+namespace dae
+{
+	// The physical textures of a compiled RenderGraph with their views. Passes look views up by handle, aliased
+	// textures return the same views. Color textures can be rendered to and sampled, depth textures are typeless so the
+	// depth can be sampled too.
+	class RenderGraphTextures final
+	{
+	public:
+		explicit RenderGraphTextures(ID3D11Device* pDevice);
+		~RenderGraphTextures();
+
+		RenderGraphTextures(const RenderGraphTextures&)				= delete;
+		RenderGraphTextures& operator=(const RenderGraphTextures&)	= delete;
+		RenderGraphTextures(RenderGraphTextures&&)					= delete;
+		RenderGraphTextures& operator=(RenderGraphTextures&&)		= delete;
+
+		// Creates what the compiled graph needs, textures whose desc did not change since the last call are kept.
+		// The graph must outlive the lookups.
+		bool Realize(const RenderGraph& graph);
+
+		// nullptr for imported textures and the wrong kind of view
+		ID3D11RenderTargetView* GetRenderTargetView(RenderGraph::Handle texture) const;
+		ID3D11DepthStencilView* GetDepthStencilView(RenderGraph::Handle texture) const;
+		ID3D11ShaderResourceView* GetShaderResourceView(RenderGraph::Handle texture) const;
+
+	private:
+		struct PhysicalTexture
+		{
+			RenderGraphTextureDesc desc;
+			ID3D11Texture2D* pTexture;
+			ID3D11RenderTargetView* pRenderTargetView;
+			ID3D11DepthStencilView* pDepthStencilView;
+			ID3D11ShaderResourceView* pShaderResourceView;
+		};
+
+		ID3D11Device* m_pDevice;
+		const RenderGraph* m_pGraph{ nullptr };
+		std::vector<PhysicalTexture> m_PhysicalTextures{};
+
+	private:
+		bool Create(PhysicalTexture& physicalTexture) const;
+		static void Release(PhysicalTexture& physicalTexture);
+		const PhysicalTexture* Find(RenderGraph::Handle texture) const;
+	};
+}
@@ -1,15 +1,50 @@
 #include "pch.h"
 #include "Renderer.h"
+#include "Material.h"
+#include "TextureLoader.h"
 
 namespace dae
 {
 	Renderer::Renderer(SDL_Window* pWindow)
 		: m_pWindow(pWindow)
 		, m_Camera{ Vector3::Zero, 45.0f }
+		, m_TextureResidency{ 256 * 1024 * 1024 }
 	{
 		//Initialize
 		SDL_GetWindowSize(pWindow, &m_Width, &m_Height);
+		Initialize();
+	}
+
+	Renderer::Renderer(uint32_t width, uint32_t height)
+		: m_Width{ static_cast<int>(width) }
+		, m_Height{ static_cast<int>(height) }
+		, m_Camera{ Vector3::Zero, 45.0f }
+		, m_TextureResidency{ 256 * 1024 * 1024 }
+	{
+		Initialize();
+	}
 
+	Renderer::~Renderer()
+	{
+		EndCapture();
+
+		if (m_pRenderTargetView) m_pRenderTargetView->Release();
+		if (m_pRenderTargetBuffer) m_pRenderTargetBuffer->Release();
+		if (m_pSwapChain) m_pSwapChain->Release();
+
+		if (m_pDeviceContext1) m_pDeviceContext1->Release();
+		if (m_pDeviceContext)
+		{
+			m_pDeviceContext->ClearState();
+			m_pDeviceContext->Flush();
+			m_pDeviceContext->Release();
+		}
+
+		if (m_pDevice) m_pDevice->Release();
+	}
+
+	void Renderer::Initialize()
+	{
 		//Initialize Camera
 		float aspectRatio = static_cast<float>(m_Width) / m_Height;
 		m_Camera.Initialize(aspectRatio, 0.001f, 1000.0f, 45.0f, { 0.0f, 0.0f, -50.0f });
@@ -27,36 +62,110 @@ namespace dae
 			std::cout << "DirectX initialization failed!\n";
 		}
 
+		m_pEffectCache = std::make_unique<EffectCache>(m_pDevice);
+		m_pStateFilter = std::make_unique<D3D11StateFilter>(D3D11StateTarget{ m_pDeviceContext, m_pDeviceContext1 });
+		m_pBackend = std::make_unique<D3D11Backend>(m_pDevice, *m_pStateFilter, *m_pEffectCache);
+		m_pRecordingTarget = std::make_unique<D3D11RecordingTarget>(m_pDevice, m_pBackend.get());
+		m_pRecordingScheduler = std::make_unique<D3D11RecordingScheduler>(*m_pRecordingTarget, 0, MinDrawsPerRecordingRange);
+		m_pRenderGraphTextures = std::make_unique<RenderGraphTextures>(m_pDevice);
+		if (m_IsInitialized && !BuildRenderGraph())
+		{
+			m_IsInitialized = false;
+		}
+
+		CreateScene();
+	}
+
+	void Renderer::CreateScene()
+	{
 		//Create test mesh
 		std::vector<Vertex> vertices;
 		std::vector<uint32_t> indices;
 		Utils::ParseOBJ("Resources/vehicle.obj", vertices, indices);
 
-		m_pTestMesh = std::make_unique<Mesh>(m_pDevice, vertices, indices);
-		m_pTestMesh->SetDiffuseMap("Resources/vehicle_diffuse.png");
-	}
+		m_pTestMesh = std::make_unique<Mesh>(*m_pBackend, vertices, indices);
 
-	Renderer::~Renderer()
-	{
-		if (m_pRenderTargetView) m_pRenderTargetView->Release();
-		if (m_pRenderTargetBuffer) m_pRenderTargetBuffer->Release();
-		if (m_pDepthStencilView) m_pDepthStencilView->Release();
-		if (m_pDepthStencilBuffer) m_pDepthStencilBuffer->Release();
-		if (m_pSwapChain) m_pSwapChain->Release();
+		//Load material, the normal, gloss and specular maps are packed into one texture on first run
+		//The diffuse map and its variants share one atlas, every instance of the batch picks a variant with its material index
+		//The packed map and its manifest are generated, they go into the (ignored) material cache next to the shader cache
+		TextureLoader textureLoader{};
+		MaterialImport::Manifest manifest{};
+		const bool isImported = MaterialImport::Import("Resources/MaterialCache/vehicle.material", "Resources/MaterialCache/vehicle_normal_gloss_specular.png", {
+			"Resources/vehicle_diffuse.png",
+			"Resources/vehicle_normal.png",
+			"Resources/vehicle_gloss.png",
+			"Resources/vehicle_specular.png",
+			{ "Resources/uv_grid_2.png" }
+		}, manifest, textureLoader);
 
-		if (m_pDeviceContext)
+		if (!isImported)
 		{
-			m_pDeviceContext->ClearState();
-			m_pDeviceContext->Flush();
-			m_pDeviceContext->Release();
+			manifest.normalGlossSpecularMap.clear();
 		}
 
-		if (m_pDevice) m_pDevice->Release();
+		Material material = MaterialImport::Load(m_pDevice, manifest, textureLoader);
+
+		const TextureLoader::Statistics& loadStatistics = textureLoader.GetStatistics();
+		std::cout << "Loaded " << loadStatistics.numImages << " textures on " << loadStatistics.numThreads << " threads"
+			<< " (decode " << loadStatistics.decodeMilliseconds << " ms, upload " << loadStatistics.uploadMilliseconds << " ms)\n";
+
+		m_pTestMesh->SetMaterial(std::move(material));
+
+		const Material& meshMaterial = m_pTestMesh->GetMaterial();
+		m_TextureResidency.Register(meshMaterial.pDiffuseMap.get());
+		m_TextureResidency.Register(meshMaterial.pNormalGlossSpecularMap.get());
+
+		//The plain and the instanced variant of the same pass, both share the mesh buffers and the material
+		const PipelineHandle pipeline = m_pBackend->CreatePipeline({ L"Resources/PosCol3D.fx", {}, 0 });
+		const PipelineHandle instancedPipeline = m_pBackend->CreatePipeline({ L"Resources/PosCol3D.fx", { { Effect::InstancedDefine, "1" } }, 0 });
+		m_pEffectCache->PrintStatistics();
+
+		m_pScene = std::make_unique<BackendScene>(*m_pBackend);
+		const uint32_t sceneMaterial = m_pScene->AddMaterial(m_pBackend->ImportTexture(meshMaterial.pDiffuseMap.get()),
+			m_pBackend->ImportTexture(meshMaterial.pNormalGlossSpecularMap.get()), meshMaterial.diffuseUVTransform);
+		const uint32_t sceneMesh = m_pScene->AddMesh(m_pTestMesh->GetVertexBuffer(), m_pTestMesh->GetIndexBuffer(), m_pTestMesh->GetNumIndices(), m_pTestMesh->GetBounds(), pipeline);
+		const uint32_t instancedSceneMesh = m_pScene->AddMesh(m_pTestMesh->GetVertexBuffer(), m_pTestMesh->GetIndexBuffer(), m_pTestMesh->GetNumIndices(), m_pTestMesh->GetBounds(), instancedPipeline);
+
+		//A 25 x 20 grid of vehicles behind the test mesh, each turned a bit further and alternating the diffuse variants
+		m_pInstanceBatch = std::make_unique<InstanceBatch>(*m_pBackend, m_pTestMesh.get(), m_pEffectCache->Get(L"Resources/PosCol3D.fx", { { Effect::InstancedDefine, "1" } }));
+		m_pInstanceBatch->SetMaterialUVTransforms(meshMaterial.diffuseUVTransforms);
+		const uint32_t numMaterials = std::max(static_cast<uint32_t>(meshMaterial.diffuseUVTransforms.size()), 1u);
+		constexpr int numColumns{ 25 };
+		constexpr int numRows{ 20 };
+		constexpr float spacing{ 40.0f };
+		for (int row = 0; row < numRows; ++row)
+		{
+			for (int column = 0; column < numColumns; ++column)
+			{
+				const float x = (column - numColumns / 2) * spacing;
+				const float z = 100.0f + row * spacing;
+				const uint32_t index = static_cast<uint32_t>(row * numColumns + column);
+				m_pInstanceBatch->Add(Matrix::CreateRotationY(static_cast<float>(index) * 0.3f) * Matrix::CreateTranslation(x, 0.0f, z), index % numMaterials);
+			}
+		}
+
+		m_TestMeshObject = m_pScene->AddObject(sceneMesh, sceneMaterial, m_pTestMesh->transform.GetWorldMatrix());
+		m_InstanceBatchObject = m_pScene->AddObject(instancedSceneMesh, sceneMaterial, Matrix{});
 	}
 
 	void Renderer::Update(const Timer* pTimer)
 	{
 		m_Camera.Update(pTimer);
+
+		//Usage and mip requests of this frame have to be in before residency decides what to evict or restore
+		if (m_IsInitialized)
+		{
+			m_pInstanceBatch->Update(m_Camera, static_cast<float>(m_Height));
+		}
+		m_pTestMesh->RequestTextureMips(m_Camera, static_cast<float>(m_Height));
+		m_pTestMesh->MarkTexturesUsed();
+		m_TextureResidency.Update();
+
+		if (m_IsInitialized)
+		{
+			m_pScene->SetObjectWorld(m_TestMeshObject, m_pTestMesh->transform.GetWorldMatrix());
+			m_pScene->SetObjectInstances(m_InstanceBatchObject, m_pInstanceBatch->GetInstanceBuffer(), sizeof(InstanceData), m_pInstanceBatch->GetNumVisible());
+		}
 	}
 
 	void Renderer::Render() const
@@ -64,13 +173,168 @@ namespace dae
 		if (!m_IsInitialized)
 			return;
 
+		m_pRecordingTarget->BeginFrame();
+		m_pBackend->BeginFrame();
+		m_RenderGraph.Execute();
+		m_pBackend->EndFrame();
+
+		//Copies this frame and hands on the ones whose copy finished, frames rendered since then are still in flight
+		if (m_pReadbackQueue)
+		{
+			m_pReadbackQueue->Submit(m_FrameIndex);
+			m_pReadbackQueue->Poll();
+		}
+		++m_FrameIndex;
+
+		if (m_pSwapChain)
+		{
+			m_pSwapChain->Present(0, 0);
+		}
+		else
+		{
+			//Present would submit the frame, offscreen nothing else makes the GPU start on it
+			m_pDeviceContext->Flush();
+		}
+	}
+
+	bool Renderer::BeginCapture(const std::string& pathPrefix, CaptureEncoder::Format format)
+	{
+		if (!m_IsInitialized)
+			return false;
+
+		EndCapture();
+
+		m_pReadbackTarget = std::make_unique<D3D11ReadbackTarget>(m_pDevice, m_pDeviceContext, m_pRenderTargetBuffer);
+		if (m_pReadbackTarget->GetNumSlots() == 0)
+		{
+			std::cout << "Failed to begin capture!\n";
+			m_pReadbackTarget.reset();
+			return false;
+		}
+
+		m_pCaptureEncoder = std::make_unique<CaptureEncoder>(pathPrefix, format, &Texture::SavePNG);
+		m_pReadbackQueue = std::make_unique<D3D11ReadbackQueue>(*m_pReadbackTarget, [this](CapturedFrame&& frame)
+			{
+				m_pCaptureEncoder->Encode(std::move(frame));
+			});
+		return true;
+	}
+
+	void Renderer::EndCapture()
+	{
+		if (!m_pReadbackQueue)
+			return;
+
+		m_pReadbackQueue->Flush();
+		m_pCaptureEncoder->Finish();
+		PrintCaptureStatistics();
+
+		m_pReadbackQueue.reset();
+		m_pCaptureEncoder.reset();
+		m_pReadbackTarget.reset();
+	}
+
+	void Renderer::RenderScene(ID3D11DepthStencilView* pDepthStencilView) const
+	{
 		constexpr float clearColor[4] = { 0.0f, 0.0f, 0.3f, 1.0f };
 		m_pDeviceContext->ClearRenderTargetView(m_pRenderTargetView, clearColor);
-		m_pDeviceContext->ClearDepthStencilView(m_pDepthStencilView, D3D11_CLEAR_DEPTH | D3D11_CLEAR_STENCIL, 1.0f, 0);
+		m_pDeviceContext->ClearDepthStencilView(pDepthStencilView, D3D11_CLEAR_DEPTH | D3D11_CLEAR_STENCIL, 1.0f, 0);
+
+		m_pRecordingTarget->SetOutput({ m_pRenderTargetView, pDepthStencilView, m_Viewport });
 
-		m_pTestMesh->Render(m_Camera, m_pDeviceContext);
+		//Everything the draws read is written before recording starts, the ranges only share the effects
+		m_pScene->Prepare(m_Camera);
+		if (!m_pBackend->IsConstantBufferRangeSupported())
+		{
+			//Every draw rewrites the scene's one per draw buffer, which only works in order on one context
+			m_pScene->Submit(*m_pBackend, { 0, m_pScene->GetNumDraws() });
+			return;
+		}
 
-		m_pSwapChain->Present(0, 0);
+		m_pRecordingScheduler->Record(m_pScene->GetNumDraws(), [this](D3D11Backend& backend, RecordingRange range)
+			{
+				m_pScene->Submit(backend, range);
+			});
+	}
+
+	void Renderer::SetTextureBudget(size_t budgetBytes)
+	{
+		m_TextureResidency.SetBudget(budgetBytes);
+	}
+
+	void Renderer::ToggleForcedRecordingRanges()
+	{
+		const bool isForced = m_pRecordingScheduler->GetMinItemsPerRange() != 1;
+		m_pRecordingScheduler->SetMinItemsPerRange(isForced ? 1 : MinDrawsPerRecordingRange);
+		std::cout << "Recording ranges of at least " << m_pRecordingScheduler->GetMinItemsPerRange() << " draw(s)\n";
+	}
+
+	void Renderer::PrintStatistics() const
+	{
+		m_TextureResidency.PrintStatistics();
+		m_pEffectCache->PrintStatistics();
+		m_pInstanceBatch->PrintStatistics();
+		m_pScene->PrintStatistics();
+		m_RenderGraph.PrintStatistics();
+
+		const D3D11StateFilter::Statistics stateStatistics = m_pRecordingTarget->GetStateStatistics();
+		std::cout << "State calls: " << stateStatistics.numSubmitted << " submitted, " << stateStatistics.numFiltered << " filtered\n";
+
+		const D3D11RecordingScheduler::Statistics& recordingStatistics = m_pRecordingScheduler->GetStatistics();
+		std::cout << "Recording: " << recordingStatistics.numItems << " draws in " << recordingStatistics.numRanges << " range(s)"
+			<< " (record " << recordingStatistics.recordMilliseconds << " ms, execute " << recordingStatistics.executeMilliseconds << " ms)\n";
+
+		if (m_pReadbackQueue)
+		{
+			PrintCaptureStatistics();
+		}
+	}
+
+	void Renderer::BenchmarkFrame()
+	{
+		if (!m_IsInitialized)
+			return;
+
+		m_pRecordingTarget->BeginFrame();
+		m_pRecordingTarget->SetOutput({ m_pRenderTargetView, nullptr, m_Viewport });
+
+		BackendScene::Benchmark(*m_pBackend);
+
+		//Closes the count, it covers every frame of the benchmark
+		m_pStateFilter->BeginFrame();
+		const D3D11StateFilter::Statistics& stateStatistics = m_pStateFilter->GetStatistics();
+		std::cout << "State calls over all frames: " << stateStatistics.numSubmitted << " submitted, " << stateStatistics.numFiltered << " filtered\n";
+	}
+
+	void Renderer::PrintCaptureStatistics() const
+	{
+		const D3D11ReadbackQueue::Statistics& readbackStatistics = m_pReadbackQueue->GetStatistics();
+		std::cout << "Readback: " << readbackStatistics.numCaptured << " of " << readbackStatistics.numSubmitted << " frames read back"
+			<< " (" << readbackStatistics.numStalls << " stalls, " << readbackStatistics.numPending << " polls pending, "
+			<< readbackStatistics.readbackMilliseconds << " ms copying)\n";
+		m_pCaptureEncoder->PrintStatistics();
+	}
+
+	bool Renderer::BuildRenderGraph()
+	{
+		const uint32_t width = static_cast<uint32_t>(m_Width);
+		const uint32_t height = static_cast<uint32_t>(m_Height);
+
+		const RenderGraph::Handle backBuffer = m_RenderGraph.ImportTexture("BackBuffer", { width, height, RenderGraphFormat::RGBA8 });
+		const RenderGraph::Handle depthBuffer = m_RenderGraph.CreateTexture("Depth", { width, height, RenderGraphFormat::Depth24Stencil8 });
+
+		//Clears and draws the draw queue, the back buffer is bound directly
+		const uint32_t scenePass = m_RenderGraph.AddPass("Scene", [this, depthBuffer]
+			{
+				RenderScene(m_pRenderGraphTextures->GetDepthStencilView(depthBuffer));
+			});
+		m_RenderGraph.Write(scenePass, backBuffer);
+		m_RenderGraph.Write(scenePass, depthBuffer);
+
+		if (!m_RenderGraph.Compile())
+			return false;
+
+		return m_pRenderGraphTextures->Realize(m_RenderGraph);
 	}
 
 	HRESULT Renderer::InitializeDirectX()
@@ -89,9 +353,49 @@ namespace dae
 			return result;
 		}
 
+		result = m_pWindow != nullptr ? CreateSwapChain() : CreateOffscreenTarget();
+		if (FAILED(result))
+		{
+			return result;
+		}
+
+		result = m_pDevice->CreateRenderTargetView(m_pRenderTargetBuffer, nullptr, &m_pRenderTargetView);
+		if (FAILED(result))
+		{
+			return result;
+		}
+
+		m_Viewport.Width	= static_cast<float>(m_Width);
+		m_Viewport.Height	= static_cast<float>(m_Height);
+		m_Viewport.TopLeftX	= 0;
+		m_Viewport.TopLeftY	= 0;
+		m_Viewport.MaxDepth	= 1.0f;
+		m_Viewport.MinDepth	= 0.0f;
+
+		m_pDeviceContext->RSSetViewports(1, &m_Viewport);
+
+		//Only needed for constant buffer ranges, every draw updates one small buffer without them
+		D3D11_FEATURE_DATA_D3D11_OPTIONS options{};
+		if (SUCCEEDED(m_pDevice->CheckFeatureSupport(D3D11_FEATURE_D3D11_OPTIONS, &options, sizeof(options))) && options.ConstantBufferOffsetting)
+		{
+			if (FAILED(m_pDeviceContext->QueryInterface(IID_PPV_ARGS(&m_pDeviceContext1))))
+			{
+				m_pDeviceContext1 = nullptr;
+			}
+		}
+		if (m_pDeviceContext1 == nullptr)
+		{
+			std::cout << "Constant buffer offsetting is not supported, drawing on one context\n";
+		}
+
+		return S_OK;
+	}
+
+	HRESULT Renderer::CreateSwapChain()
+	{
 		IDXGIFactory1* pDxgiFactory;
 		
-		result = CreateDXGIFactory1(IID_PPV_ARGS(&pDxgiFactory));
+		HRESULT result = CreateDXGIFactory1(IID_PPV_ARGS(&pDxgiFactory));
 		if (FAILED(result))
 		{
 			return result;
@@ -123,62 +427,33 @@ namespace dae
 			return result;
 		}
 
-		D3D11_TEXTURE2D_DESC depthStencilDesc;
-		depthStencilDesc.Width					= m_Width;
-		depthStencilDesc.Height					= m_Height;
-		depthStencilDesc.MipLevels				= 1;
-		depthStencilDesc.ArraySize				= 1;
-		depthStencilDesc.Format					= DXGI_FORMAT_D24_UNORM_S8_UINT;
-		depthStencilDesc.SampleDesc.Count		= 1;
-		depthStencilDesc.SampleDesc.Quality		= 0;
-		depthStencilDesc.Usage					= D3D11_USAGE_DEFAULT;
-		depthStencilDesc.BindFlags				= D3D11_BIND_DEPTH_STENCIL;
-		depthStencilDesc.CPUAccessFlags			= 0;
-		depthStencilDesc.MiscFlags				= 0;
-
-		D3D11_DEPTH_STENCIL_VIEW_DESC depthStencilViewDesc{};
-		depthStencilViewDesc.Format				= depthStencilDesc.Format;
-		depthStencilViewDesc.ViewDimension		= D3D11_DSV_DIMENSION_TEXTURE2D;
-		depthStencilViewDesc.Texture2D.MipSlice	= 0;
-
-		result = m_pDevice->CreateTexture2D(&depthStencilDesc, nullptr, &m_pDepthStencilBuffer);
-		if (FAILED(result))
-		{
-			return result;
-		}
-
-		result = m_pDevice->CreateDepthStencilView(m_pDepthStencilBuffer, &depthStencilViewDesc, &m_pDepthStencilView);
-		if (FAILED(result))
-		{
-			return result;
-		}
-
 		result = m_pSwapChain->GetBuffer(0, IID_PPV_ARGS(&m_pRenderTargetBuffer));
 		if (FAILED(result))
 		{
 			return result;
 		}
 
-		result = m_pDevice->CreateRenderTargetView(m_pRenderTargetBuffer, nullptr, &m_pRenderTargetView);
-		if (FAILED(result))
-		{
-			return result;
-		}
-
-		m_pDeviceContext->OMSetRenderTargets(1, &m_pRenderTargetView, m_pDepthStencilView);
-
-		D3D11_VIEWPORT viewport{};
-		viewport.Width		= static_cast<float>(m_Width);
-		viewport.Height		= static_cast<float>(m_Height);
-		viewport.TopLeftX	= 0;
-		viewport.TopLeftY	= 0;
-		viewport.MaxDepth	= 1.0f;
-		viewport.MinDepth	= 0.0f;
-
-		m_pDeviceContext->RSSetViewports(1, &viewport);
-
 		pDxgiFactory->Release();
 
 		return S_OK;
 	}
+
+	HRESULT Renderer::CreateOffscreenTarget()
+	{
+		//Same format as the swap chain, so captures look the same in both modes
+		D3D11_TEXTURE2D_DESC desc{};
+		desc.Width				= static_cast<uint32_t>(m_Width);
+		desc.Height				= static_cast<uint32_t>(m_Height);
+		desc.MipLevels			= 1;
+		desc.ArraySize			= 1;
+		desc.Format				= DXGI_FORMAT_R8G8B8A8_UNORM;
+		desc.SampleDesc.Count	= 1;
+		desc.SampleDesc.Quality	= 0;
+		desc.Usage				= D3D11_USAGE_DEFAULT;
+		desc.BindFlags			= D3D11_BIND_RENDER_TARGET;
+		desc.CPUAccessFlags		= 0;
+		desc.MiscFlags			= 0;
+
+		return m_pDevice->CreateTexture2D(&desc, nullptr, &m_pRenderTargetBuffer);
+	}
 }
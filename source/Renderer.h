@@ -1,7 +1,17 @@
 #pragma once
 
 #include "Mesh.h"
+#include "BackendScene.h"
 #include "Camera.h"
+#include "CaptureEncoder.h"
+#include "D3D11Backend.h"
+#include "D3D11ReadbackTarget.h"
+#include "D3D11RecordingTarget.h"
+#include "EffectCache.h"
+#include "InstanceBatch.h"
+#include "RenderGraph.h"
+#include "RenderGraphTextures.h"
+#include "TextureResidency.h"
 
 struct SDL_Window;
 struct SDL_Surface;
@@ -12,6 +22,8 @@ namespace dae
 	{
 	public:
 		Renderer(SDL_Window* pWindow);
+		// Offscreen, renders into an owned texture of any size instead of a swap chain
+		Renderer(uint32_t width, uint32_t height);
 		~Renderer();
 
 		Renderer(const Renderer&) = delete;
@@ -22,7 +34,23 @@ namespace dae
 		void Update(const Timer* pTimer);
 		void Render() const;
 
+		void SetTextureBudget(size_t budgetBytes);
+		// Splits even the shortest draw list over deferred contexts, so the parallel path runs with the test scene
+		void ToggleForcedRecordingRanges();
+		void PrintStatistics() const;
+		// Every frame rendered until EndCapture is read back and written to <pathPrefix><frame index>.png or .raw.
+		// The readback trails rendering by a few frames and encoding runs on its own thread.
+		bool BeginCapture(const std::string& pathPrefix, CaptureEncoder::Format format);
+		// Writes the frames still in flight and prints the capture statistics
+		void EndCapture();
+
+		// Runs BackendScene::Benchmark on a D3D11Backend, drawing into the back buffer without presenting
+		void BenchmarkFrame();
+
 	private:
+		// Shorter draw lists are recorded into the immediate context unless ranges are forced
+		static constexpr uint32_t MinDrawsPerRecordingRange{ 64 };
+
 		SDL_Window* m_pWindow{};
 
 		int m_Width{};
@@ -34,17 +62,57 @@ namespace dae
 
 		ID3D11Device* m_pDevice;
 		ID3D11DeviceContext* m_pDeviceContext;
-		IDXGISwapChain* m_pSwapChain;
-
-		ID3D11Texture2D* m_pDepthStencilBuffer;
-		ID3D11DepthStencilView* m_pDepthStencilView;
+		// nullptr without constant buffer offsetting (D3D 11.1)
+		ID3D11DeviceContext1* m_pDeviceContext1{};
+		// nullptr when offscreen
+		IDXGISwapChain* m_pSwapChain{};
 
+		// The swap chain's back buffer, or an owned texture when offscreen
 		ID3D11Texture2D* m_pRenderTargetBuffer;
 		ID3D11RenderTargetView* m_pRenderTargetView;
 
+		D3D11_VIEWPORT m_Viewport{};
+
+		TextureResidency<Texture> m_TextureResidency;
+
+		// Created with the device, every pipeline gets its effect from here
+		std::unique_ptr<EffectCache> m_pEffectCache;
+
+		// Every draw binds its state through here, calls that would bind what is already bound are dropped
+		std::unique_ptr<D3D11StateFilter> m_pStateFilter;
+		// Owns the buffers and pipelines of the scene, draws on the immediate context
+		std::unique_ptr<D3D11Backend> m_pBackend;
+		// Long draw lists are split over deferred contexts, recorded in parallel and executed in order
+		std::unique_ptr<D3D11RecordingTarget> m_pRecordingTarget;
+		std::unique_ptr<D3D11RecordingScheduler> m_pRecordingScheduler;
+
+		// Culls, sorts and writes the constants of a frame, ranges of its sorted draws are recorded in parallel
+		std::unique_ptr<BackendScene> m_pScene;
+		uint32_t m_TestMeshObject{ UINT32_MAX };
+		uint32_t m_InstanceBatchObject{ UINT32_MAX };
+
 		std::unique_ptr<Mesh> m_pTestMesh;
+		// Copies of the test mesh in one draw call
+		std::unique_ptr<InstanceBatch> m_pInstanceBatch;
+
+		// The passes of a frame, built once. The depth buffer is a transient texture of the graph.
+		RenderGraph m_RenderGraph;
+		std::unique_ptr<RenderGraphTextures> m_pRenderGraphTextures;
+
+		// Set between BeginCapture and EndCapture
+		std::unique_ptr<D3D11ReadbackTarget> m_pReadbackTarget;
+		std::unique_ptr<D3D11ReadbackQueue> m_pReadbackQueue;
+		std::unique_ptr<CaptureEncoder> m_pCaptureEncoder;
+		mutable uint64_t m_FrameIndex{ 0 };
 
 	private:
+		void Initialize();
 		HRESULT InitializeDirectX();
+		HRESULT CreateSwapChain();
+		HRESULT CreateOffscreenTarget();
+		bool BuildRenderGraph();
+		void CreateScene();
+		void RenderScene(ID3D11DepthStencilView* pDepthStencilView) const;
+		void PrintCaptureStatistics() const;
 	};
 }
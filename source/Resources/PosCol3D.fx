@@ -2,8 +2,35 @@
 // Global Variables
 // --------------------------------------------------------
 
-float4x4 gWorldViewProj : WorldViewProjection;
-Texture2D gDiffuseMap : DiffuseMap;
+// Laid out like PerFrameConstants and PerDrawConstants (ConstantBuffers.h). BackendScene binds ranges of one ring buffer
+// to these registers after applying the pass; without constant buffer offsetting a small per draw buffer is bound instead.
+cbuffer cbPerFrame : register(b0)
+{
+    row_major float4x4 gViewInverse : ViewInverse;
+    row_major float4x4 gViewProj : ViewProjection;
+};
+
+cbuffer cbPerDraw : register(b1)
+{
+    row_major float4x4 gWorldViewProj : WorldViewProjection;
+    row_major float4x4 gWorldMatrix : World;
+    float4 gDiffuseUVTransform : DiffuseUVTransform; // xy scale, zw offset into an atlas
+    bool gUseNormalGlossSpecularMap;
+};
+
+Texture2D gDiffuseMap : DiffuseMap : register(t0);
+Texture2D gNormalGlossSpecularMap : NormalGlossSpecularMap : register(t1); // rg normal xy, b gloss, a specular
+
+// Instancing, compiled with INSTANCED defined. The world matrix comes from the instance buffer and the material index
+// picks the diffuse UV transform (an atlas region) per instance.
+#define MAX_INSTANCE_MATERIALS 16
+float4 gInstanceUVTransforms[MAX_INSTANCE_MATERIALS];
+
+static const float3 gLightDirection = normalize(float3(0.577f, -0.577f, 0.577f));
+static const float gLightIntensity = 7.0f;
+static const float gShininess = 25.0f;
+static const float3 gAmbient = float3(0.025f, 0.025f, 0.025f);
+static const float PI = 3.14159265f;
 
 SamplerState gSamPoint
 {
@@ -36,12 +63,21 @@ struct VS_INPUT
     float2 TexCoord : TEXCOORD;
     float3 Normal : NORMAL;
     float3 Tangent : TANGENT;
+#ifdef INSTANCED
+    float4 World0 : INSTANCE_WORLD0;
+    float4 World1 : INSTANCE_WORLD1;
+    float4 World2 : INSTANCE_WORLD2;
+    float4 World3 : INSTANCE_WORLD3;
+    uint MaterialIndex : INSTANCE_MATERIAL;
+#endif
 };
 
 struct VS_OUTPUT
 {
     float4 Position : SV_POSITION;
-    float2 TexCoord : TEXCOORD;
+    float4 WorldPosition : WORLD;
+    float2 TexCoord : TEXCOORD; // diffuse, moved into its atlas region
+    float2 MeshTexCoord : TEXCOORD1; // untransformed, the normal gloss specular map is not part of the atlas
     float3 Normal : NORMAL;
     float3 Tangent : TANGENT;
 };
@@ -55,24 +91,73 @@ float4 SampleDiffuseMap(SamplerState state, float2 position)
     return gDiffuseMap.Sample(state, position);
 }
 
+// Normal z is not stored, it is reconstructed from the unit length
+float3 SampleNormal(float4 packed, VS_OUTPUT input)
+{
+    float2 normalXY = packed.rg * 2.0f - 1.0f;
+    float normalZ = sqrt(saturate(1.0f - dot(normalXY, normalXY)));
+
+    float3 normal = normalize(input.Normal);
+    float3 tangent = normalize(input.Tangent);
+    float3 binormal = cross(normal, tangent);
+    float3x3 tangentSpace = float3x3(tangent, binormal, normal);
+
+    return normalize(mul(float3(normalXY, normalZ), tangentSpace));
+}
+
 float4 Shade(SamplerState state, VS_OUTPUT input)
 {
-    return SampleDiffuseMap(state, input.TexCoord);
+    float4 diffuseColor = SampleDiffuseMap(state, input.TexCoord);
+    if (!gUseNormalGlossSpecularMap)
+        return diffuseColor;
+
+    float4 packed = gNormalGlossSpecularMap.Sample(state, input.MeshTexCoord);
+    float3 normal = SampleNormal(packed, input);
+    float gloss = packed.b;
+    float specular = packed.a;
+
+    float observedArea = saturate(dot(normal, -gLightDirection));
+    float3 lambert = diffuseColor.rgb * gLightIntensity / PI;
+
+    float3 viewDirection = normalize(input.WorldPosition.xyz - gViewInverse[3].xyz);
+    float3 reflected = reflect(-gLightDirection, normal);
+    float phong = specular * pow(saturate(dot(reflected, viewDirection)), gloss * gShininess);
+
+    return float4((lambert + phong) * observedArea + gAmbient, diffuseColor.a);
 }
 
 // --------------------------------------------------------
 // Vertex Shader
 // --------------------------------------------------------
 
+#ifdef INSTANCED
+VS_OUTPUT VS(VS_INPUT input)
+{
+    float4x4 world = float4x4(input.World0, input.World1, input.World2, input.World3);
+    float4 uvTransform = gInstanceUVTransforms[min(input.MaterialIndex, MAX_INSTANCE_MATERIALS - 1)];
+
+    VS_OUTPUT output = (VS_OUTPUT)0;
+    output.WorldPosition = mul(float4(input.Position, 1.0f), world);
+    output.Position = mul(output.WorldPosition, gViewProj);
+    output.TexCoord = input.TexCoord * uvTransform.xy + uvTransform.zw;
+    output.MeshTexCoord = input.TexCoord;
+    output.Normal = mul(normalize(input.Normal), (float3x3)world);
+    output.Tangent = mul(normalize(input.Tangent), (float3x3)world);
+    return output;
+}
+#else
 VS_OUTPUT VS(VS_INPUT input)
 {
     VS_OUTPUT output = (VS_OUTPUT)0;
     output.Position = mul(float4(input.Position, 1.0f), gWorldViewProj);
-    output.TexCoord = input.TexCoord;
-    output.Normal = input.Normal;
-    output.Tangent = input.Tangent;
+    output.WorldPosition = mul(float4(input.Position, 1.0f), gWorldMatrix);
+    output.TexCoord = input.TexCoord * gDiffuseUVTransform.xy + gDiffuseUVTransform.zw;
+    output.MeshTexCoord = input.TexCoord;
+    output.Normal = mul(normalize(input.Normal), (float3x3)gWorldMatrix);
+    output.Tangent = mul(normalize(input.Tangent), (float3x3)gWorldMatrix);
     return output;
 }
+#endif
 
 // --------------------------------------------------------
 // Pixel Shader(s)
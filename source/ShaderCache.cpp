@@ -0,0 +1,237 @@
+#include "ShaderCache.h"
+
+#include <algorithm>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <iterator>
+#include <set>
+#include <sstream>
+
+namespace dae
+{
+	namespace
+	{
+		constexpr uint32_t entryMagic{ 0x43485344 }; //"DSHC"
+		constexpr uint32_t entryVersion{ 1 };
+		constexpr const char* pEntryExtension{ ".bin" };
+
+		struct EntryHeader
+		{
+			uint32_t magic;
+			uint32_t version;
+			uint64_t key;
+			uint64_t size;
+			uint64_t contentHash;
+		};
+
+		bool ReadFile(const std::filesystem::path& filepath, std::string& content)
+		{
+			std::ifstream file(filepath, std::ios::binary);
+			if (!file)
+				return false;
+
+			content.assign(std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>());
+			return true;
+		}
+
+		//Name of the file in an #include line, empty for any other line
+		std::string GetIncludeName(const std::string& line)
+		{
+			const size_t start = line.find_first_not_of(" \t");
+			if (start == std::string::npos || line.compare(start, 8, "#include") != 0)
+				return {};
+
+			const size_t open = line.find_first_of("\"<", start + 8);
+			if (open == std::string::npos)
+				return {};
+
+			const size_t close = line.find(line[open] == '"' ? '"' : '>', open + 1);
+			if (close == std::string::npos)
+				return {};
+
+			return line.substr(open + 1, close - open - 1);
+		}
+
+		//Hashes the file and then its includes depth first; every file is hashed once, which also stops include cycles
+		bool HashSourceTree(const std::filesystem::path& filepath, std::set<std::filesystem::path>& visited, uint64_t& hash)
+		{
+			const std::filesystem::path normalized = filepath.lexically_normal();
+			if (!visited.insert(normalized).second)
+				return true;
+
+			std::string content;
+			if (!ReadFile(normalized, content))
+				return false;
+
+			hash = ShaderCache::Hash(content.data(), content.size(), hash);
+
+			std::istringstream stream{ content };
+			std::string line;
+			while (std::getline(stream, line))
+			{
+				const std::string includeName = GetIncludeName(line);
+				if (includeName.empty())
+					continue;
+
+				//A missing include is hashed as its name, the compiler reports the error itself
+				if (!HashSourceTree(normalized.parent_path() / includeName, visited, hash))
+				{
+					hash = ShaderCache::Hash(includeName.data(), includeName.size(), hash);
+				}
+			}
+
+			return true;
+		}
+	}
+
+	ShaderCache::ShaderCache(std::filesystem::path directory)
+		: m_Directory{ std::move(directory) }
+	{
+	}
+
+	uint64_t ShaderCache::CalculateKey(const std::filesystem::path& sourcePath, const std::vector<ShaderDefine>& defines, uint32_t flags, uint32_t compilerVersion)
+	{
+		uint64_t hash{ hashSeed };
+
+		std::set<std::filesystem::path> visited;
+		if (!HashSourceTree(sourcePath, visited, hash))
+			return 0;
+
+		std::vector<const ShaderDefine*> sortedDefines;
+		for (const ShaderDefine& define : defines)
+		{
+			sortedDefines.push_back(&define);
+		}
+		std::sort(sortedDefines.begin(), sortedDefines.end(), [](const ShaderDefine* pA, const ShaderDefine* pB) { return pA->name < pB->name; });
+
+		//The separators keep ("AB", "") and ("A", "B") apart
+		for (const ShaderDefine* pDefine : sortedDefines)
+		{
+			hash = Hash(pDefine->name.c_str(), pDefine->name.size() + 1, hash);
+			hash = Hash(pDefine->value.c_str(), pDefine->value.size() + 1, hash);
+		}
+
+		hash = Hash(&flags, sizeof(flags), hash);
+		hash = Hash(&compilerVersion, sizeof(compilerVersion), hash);
+
+		//0 is reserved for unreadable sources
+		return hash != 0 ? hash : 1;
+	}
+
+	bool ShaderCache::Load(uint64_t key, std::vector<uint8_t>& binary)
+	{
+		binary.clear();
+
+		std::ifstream file(GetEntryPath(key), std::ios::binary);
+		if (!file)
+		{
+			++m_Statistics.numMisses;
+			return false;
+		}
+
+		EntryHeader header{};
+		file.read(reinterpret_cast<char*>(&header), sizeof(header));
+
+		bool isValid = file && header.magic == entryMagic && header.version == entryVersion && header.key == key;
+		if (isValid)
+		{
+			binary.resize(header.size);
+			file.read(reinterpret_cast<char*>(binary.data()), static_cast<std::streamsize>(binary.size()));
+
+			//Nothing may follow the binary, a truncated or appended file is as bad as a flipped bit
+			isValid = file && file.peek() == std::ifstream::traits_type::eof() && Hash(binary.data(), binary.size()) == header.contentHash;
+		}
+
+		if (!isValid)
+		{
+			binary.clear();
+			++m_Statistics.numRejected;
+			++m_Statistics.numMisses;
+			return false;
+		}
+
+		++m_Statistics.numHits;
+		return true;
+	}
+
+	bool ShaderCache::Store(uint64_t key, const void* pBinary, size_t size)
+	{
+		std::error_code error{};
+		std::filesystem::create_directories(m_Directory, error);
+
+		const std::filesystem::path entryPath = GetEntryPath(key);
+		std::filesystem::path temporaryPath = entryPath;
+		temporaryPath += ".tmp";
+
+		{
+			std::ofstream file(temporaryPath, std::ios::binary | std::ios::trunc);
+			if (!file)
+			{
+				std::cout << "Failed to write shader cache entry \"" << temporaryPath.string() << "\"!\n";
+				return false;
+			}
+
+			const EntryHeader header{ entryMagic, entryVersion, key, size, Hash(pBinary, size) };
+			file.write(reinterpret_cast<const char*>(&header), sizeof(header));
+			file.write(static_cast<const char*>(pBinary), static_cast<std::streamsize>(size));
+
+			if (!file)
+			{
+				std::cout << "Failed to write shader cache entry \"" << temporaryPath.string() << "\"!\n";
+				file.close();
+				std::filesystem::remove(temporaryPath, error);
+				return false;
+			}
+		}
+
+		std::filesystem::rename(temporaryPath, entryPath, error);
+		if (error)
+		{
+			std::cout << "Failed to write shader cache entry \"" << entryPath.string() << "\"!\n";
+			std::filesystem::remove(temporaryPath, error);
+			return false;
+		}
+
+		++m_Statistics.numStores;
+		return true;
+	}
+
+	void ShaderCache::Clear()
+	{
+		std::error_code error{};
+		for (const std::filesystem::directory_entry& entry : std::filesystem::directory_iterator(m_Directory, error))
+		{
+			if (entry.path().extension() == pEntryExtension)
+			{
+				std::filesystem::remove(entry.path(), error);
+			}
+		}
+	}
+
+	std::filesystem::path ShaderCache::GetEntryPath(uint64_t key) const
+	{
+		std::ostringstream name;
+		name << std::hex << std::setw(16) << std::setfill('0') << key << pEntryExtension;
+		return m_Directory / name.str();
+	}
+
+	const ShaderCache::Statistics& ShaderCache::GetStatistics() const
+	{
+		return m_Statistics;
+	}
+
+	uint64_t ShaderCache::Hash(const void* pData, size_t size, uint64_t seed)
+	{
+		constexpr uint64_t prime{ 0x100000001b3ull };
+
+		const uint8_t* pBytes = static_cast<const uint8_t*>(pData);
+		uint64_t hash{ seed };
+		for (size_t i = 0; i < size; ++i)
+		{
+			hash ^= pBytes[i];
+			hash *= prime;
+		}
+		return hash;
+	}
+}
@@ -0,0 +1,64 @@
+#pragma once
+
+#include <cstdint>
+#include <filesystem>
+#include <string>
+#include <vector>
+
+namespace dae
+{
+	// Preprocessor define passed to the shader compiler
+	struct ShaderDefine
+	{
+		std::string name;
+		std::string value;
+	};
+
+	// Compiled shader binaries on disk, one file per key. The key hashes everything that changes the compiler output,
+	// so an edited source, include, define, flag or compiler simply misses and gets compiled and stored again.
+	// No D3D types in here, the hashing, invalidation and storage behave the same on every platform.
+	class ShaderCache final
+	{
+	public:
+		struct Statistics
+		{
+			uint32_t numHits{};
+			uint32_t numMisses{};
+			// Entries that existed but failed the header or content check, they count as misses too
+			uint32_t numRejected{};
+			uint32_t numStores{};
+		};
+
+	public:
+		explicit ShaderCache(std::filesystem::path directory);
+		~ShaderCache() = default;
+
+		ShaderCache(const ShaderCache&)				= delete;
+		ShaderCache& operator=(const ShaderCache&)	= delete;
+		ShaderCache(ShaderCache&&)					= delete;
+		ShaderCache& operator=(ShaderCache&&)		= delete;
+
+		// Hash of the source, every file it includes (quoted or angled, relative to the including file, recursively),
+		// the defines in any order, the compile flags and the compiler version. 0 when the source cannot be read.
+		static uint64_t CalculateKey(const std::filesystem::path& sourcePath, const std::vector<ShaderDefine>& defines, uint32_t flags, uint32_t compilerVersion);
+
+		// False on a miss or a damaged entry
+		bool Load(uint64_t key, std::vector<uint8_t>& binary);
+		// Written to a temporary file first, a crash mid write never leaves a half entry behind
+		bool Store(uint64_t key, const void* pBinary, size_t size);
+		// Removes every entry in the directory
+		void Clear();
+
+		std::filesystem::path GetEntryPath(uint64_t key) const;
+		const Statistics& GetStatistics() const;
+
+		// 64 bit FNV-1a, continue a hash by passing the previous result as seed
+		static uint64_t Hash(const void* pData, size_t size, uint64_t seed = hashSeed);
+
+	private:
+		static constexpr uint64_t hashSeed{ 0xcbf29ce484222325ull };
+
+		std::filesystem::path m_Directory;
+		Statistics m_Statistics{};
+	};
+}
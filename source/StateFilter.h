@@ -0,0 +1,471 @@
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <cstdint>
+#include <utility>
+
+namespace dae
+{
+	// Caches what is bound to the pipeline and drops calls that would bind it again. Target receives the calls that
+	// survive and names the handle types: D3D11StateTarget forwards to a device context, tests use a recording mock.
+	// No D3D types in here, the tracking behaves the same on every platform.
+	//
+	// Multi slot calls are trimmed to the range of slots that actually change. Anything that binds state behind the
+	// filter's back (an effect pass, a Clear, another library) makes the cache wrong, call Invalidate after it.
+	template<typename Target>
+	class StateFilter final
+	{
+	public:
+		using Topology = typename Target::Topology;
+		using Format = typename Target::Format;
+		using Buffer = typename Target::Buffer;
+		using InputLayout = typename Target::InputLayout;
+		using VertexShader = typename Target::VertexShader;
+		using PixelShader = typename Target::PixelShader;
+		using ShaderResourceView = typename Target::ShaderResourceView;
+		using SamplerState = typename Target::SamplerState;
+		using RenderTargetView = typename Target::RenderTargetView;
+		using DepthStencilView = typename Target::DepthStencilView;
+		using BlendState = typename Target::BlendState;
+		using DepthStencilState = typename Target::DepthStencilState;
+		using RasterizerState = typename Target::RasterizerState;
+		using Pass = typename Target::Pass;
+
+		// Tracked slots per stage, calls on higher slots are always forwarded
+		static constexpr uint32_t MaxVertexBuffers{ 8 };
+		static constexpr uint32_t MaxConstantBuffers{ 14 };
+		static constexpr uint32_t MaxShaderResources{ 16 };
+		static constexpr uint32_t MaxSamplers{ 16 };
+
+		struct Statistics
+		{
+			uint32_t numSubmitted{};
+			uint32_t numFiltered{};
+		};
+
+	public:
+		explicit StateFilter(Target target);
+		~StateFilter() = default;
+
+		StateFilter(const StateFilter&)				= delete;
+		StateFilter& operator=(const StateFilter&)	= delete;
+		StateFilter(StateFilter&&)					= delete;
+		StateFilter& operator=(StateFilter&&)		= delete;
+
+		void IASetPrimitiveTopology(Topology topology);
+		void IASetInputLayout(InputLayout* pInputLayout);
+		void IASetVertexBuffers(uint32_t startSlot, uint32_t numBuffers, Buffer* const* ppBuffers, const uint32_t* pStrides, const uint32_t* pOffsets);
+		void IASetIndexBuffer(Buffer* pBuffer, Format format, uint32_t offset);
+
+		void VSSetShader(VertexShader* pShader);
+		void PSSetShader(PixelShader* pShader);
+		// pFirstConstants and pNumConstants may be nullptr to bind whole buffers
+		void VSSetConstantBuffers(uint32_t startSlot, uint32_t numBuffers, Buffer* const* ppBuffers, const uint32_t* pFirstConstants = nullptr, const uint32_t* pNumConstants = nullptr);
+		void PSSetConstantBuffers(uint32_t startSlot, uint32_t numBuffers, Buffer* const* ppBuffers, const uint32_t* pFirstConstants = nullptr, const uint32_t* pNumConstants = nullptr);
+		void PSSetShaderResources(uint32_t startSlot, uint32_t numViews, ShaderResourceView* const* ppViews);
+		void PSSetSamplers(uint32_t startSlot, uint32_t numSamplers, SamplerState* const* ppSamplers);
+
+		void OMSetRenderTargets(uint32_t numViews, RenderTargetView* const* ppViews, DepthStencilView* pDepthStencilView);
+		void OMSetBlendState(BlendState* pState, const float blendFactor[4], uint32_t sampleMask);
+		void OMSetDepthStencilState(DepthStencilState* pState, uint32_t stencilRef);
+		void RSSetState(RasterizerState* pState);
+
+		// An effect pass binds shaders, constant buffers, resources, samplers and states itself. It is applied again only
+		// when the pass or the version of its variables changed, and afterwards everything it binds is unknown.
+		void ApplyPass(Pass* pPass, uint64_t variablesVersion);
+
+		// Draws are never filtered
+		void DrawIndexed(uint32_t indexCount, uint32_t startIndex, int32_t baseVertex);
+		void DrawIndexedInstanced(uint32_t indexCount, uint32_t instanceCount, uint32_t startIndex, int32_t baseVertex, uint32_t startInstance);
+
+		// Forget everything, the next call of every kind is forwarded
+		void Invalidate();
+
+		// Starts counting a new frame, GetStatistics returns the frame before
+		void BeginFrame();
+		const Statistics& GetStatistics() const;
+
+		Target& GetTarget();
+
+	private:
+		template<typename T>
+		struct Cached
+		{
+			T value{};
+			bool isKnown{ false };
+
+			// False when value is already bound
+			bool Update(const T& newValue)
+			{
+				if (isKnown && value == newValue)
+					return false;
+
+				value = newValue;
+				isKnown = true;
+				return true;
+			}
+		};
+
+		struct VertexBufferSlot
+		{
+			Buffer* pBuffer;
+			uint32_t stride;
+			uint32_t offset;
+
+			bool operator==(const VertexBufferSlot&) const = default;
+		};
+
+		struct IndexBufferState
+		{
+			Buffer* pBuffer;
+			Format format;
+			uint32_t offset;
+
+			bool operator==(const IndexBufferState&) const = default;
+		};
+
+		struct ConstantBufferSlot
+		{
+			Buffer* pBuffer;
+			uint32_t firstConstant;
+			uint32_t numConstants;
+
+			bool operator==(const ConstantBufferSlot&) const = default;
+		};
+
+		struct RenderTargetState
+		{
+			uint32_t numViews;
+			RenderTargetView* pView;
+			DepthStencilView* pDepthStencilView;
+
+			bool operator==(const RenderTargetState&) const = default;
+		};
+
+		struct BlendStateState
+		{
+			BlendState* pState;
+			std::array<float, 4> blendFactor;
+			uint32_t sampleMask;
+
+			bool operator==(const BlendStateState&) const = default;
+		};
+
+		struct DepthStencilStateState
+		{
+			DepthStencilState* pState;
+			uint32_t stencilRef;
+
+			bool operator==(const DepthStencilStateState&) const = default;
+		};
+
+		struct PassState
+		{
+			Pass* pPass;
+			uint64_t variablesVersion;
+
+			bool operator==(const PassState&) const = default;
+		};
+
+		Target m_Target;
+
+		Cached<Topology> m_Topology{};
+		Cached<InputLayout*> m_InputLayout{};
+		std::array<Cached<VertexBufferSlot>, MaxVertexBuffers> m_VertexBuffers{};
+		Cached<IndexBufferState> m_IndexBuffer{};
+
+		Cached<VertexShader*> m_VertexShader{};
+		Cached<PixelShader*> m_PixelShader{};
+		std::array<Cached<ConstantBufferSlot>, MaxConstantBuffers> m_VSConstantBuffers{};
+		std::array<Cached<ConstantBufferSlot>, MaxConstantBuffers> m_PSConstantBuffers{};
+		std::array<Cached<ShaderResourceView*>, MaxShaderResources> m_PSShaderResources{};
+		std::array<Cached<SamplerState*>, MaxSamplers> m_PSSamplers{};
+
+		Cached<RenderTargetState> m_RenderTargets{};
+		Cached<BlendStateState> m_BlendState{};
+		Cached<DepthStencilStateState> m_DepthStencilState{};
+		Cached<RasterizerState*> m_RasterizerState{};
+
+		Cached<PassState> m_Pass{};
+
+		Statistics m_Statistics{};
+		Statistics m_FrameStatistics{};
+
+	private:
+		// Updates the cached slots and narrows [startSlot, startSlot + count) to the slots that change. False when none does.
+		template<typename T, size_t N, typename GetValue>
+		bool UpdateSlots(std::array<Cached<T>, N>& slots, uint32_t& startSlot, uint32_t& count, const GetValue& getValue);
+		// Counts the call and returns changed
+		bool Submit(bool changed);
+		void InvalidatePassState();
+	};
+
+	template<typename Target>
+	StateFilter<Target>::StateFilter(Target target)
+		: m_Target{ std::move(target) }
+	{
+	}
+
+	template<typename Target>
+	void StateFilter<Target>::IASetPrimitiveTopology(Topology topology)
+	{
+		if (Submit(m_Topology.Update(topology)))
+		{
+			m_Target.IASetPrimitiveTopology(topology);
+		}
+	}
+
+	template<typename Target>
+	void StateFilter<Target>::IASetInputLayout(InputLayout* pInputLayout)
+	{
+		if (Submit(m_InputLayout.Update(pInputLayout)))
+		{
+			m_Target.IASetInputLayout(pInputLayout);
+		}
+	}
+
+	template<typename Target>
+	void StateFilter<Target>::IASetVertexBuffers(uint32_t startSlot, uint32_t numBuffers, Buffer* const* ppBuffers, const uint32_t* pStrides, const uint32_t* pOffsets)
+	{
+		const uint32_t firstSlot = startSlot;
+		const auto getValue = [&](uint32_t i) { return VertexBufferSlot{ ppBuffers[i], pStrides[i], pOffsets[i] }; };
+		if (Submit(UpdateSlots(m_VertexBuffers, startSlot, numBuffers, getValue)))
+		{
+			const uint32_t skipped = startSlot - firstSlot;
+			m_Target.IASetVertexBuffers(startSlot, numBuffers, ppBuffers + skipped, pStrides + skipped, pOffsets + skipped);
+		}
+	}
+
+	template<typename Target>
+	void StateFilter<Target>::IASetIndexBuffer(Buffer* pBuffer, Format format, uint32_t offset)
+	{
+		if (Submit(m_IndexBuffer.Update({ pBuffer, format, offset })))
+		{
+			m_Target.IASetIndexBuffer(pBuffer, format, offset);
+		}
+	}
+
+	template<typename Target>
+	void StateFilter<Target>::VSSetShader(VertexShader* pShader)
+	{
+		if (Submit(m_VertexShader.Update(pShader)))
+		{
+			m_Target.VSSetShader(pShader);
+		}
+	}
+
+	template<typename Target>
+	void StateFilter<Target>::PSSetShader(PixelShader* pShader)
+	{
+		if (Submit(m_PixelShader.Update(pShader)))
+		{
+			m_Target.PSSetShader(pShader);
+		}
+	}
+
+	template<typename Target>
+	void StateFilter<Target>::VSSetConstantBuffers(uint32_t startSlot, uint32_t numBuffers, Buffer* const* ppBuffers, const uint32_t* pFirstConstants, const uint32_t* pNumConstants)
+	{
+		//A whole buffer binding is cached as range 0, 0
+		const uint32_t firstSlot = startSlot;
+		const auto getValue = [&](uint32_t i) { return ConstantBufferSlot{ ppBuffers[i], pFirstConstants ? pFirstConstants[i] : 0, pNumConstants ? pNumConstants[i] : 0 }; };
+		if (Submit(UpdateSlots(m_VSConstantBuffers, startSlot, numBuffers, getValue)))
+		{
+			const uint32_t skipped = startSlot - firstSlot;
+			m_Target.VSSetConstantBuffers(startSlot, numBuffers, ppBuffers + skipped, pFirstConstants ? pFirstConstants + skipped : nullptr, pNumConstants ? pNumConstants + skipped : nullptr);
+		}
+	}
+
+	template<typename Target>
+	void StateFilter<Target>::PSSetConstantBuffers(uint32_t startSlot, uint32_t numBuffers, Buffer* const* ppBuffers, const uint32_t* pFirstConstants, const uint32_t* pNumConstants)
+	{
+		const uint32_t firstSlot = startSlot;
+		const auto getValue = [&](uint32_t i) { return ConstantBufferSlot{ ppBuffers[i], pFirstConstants ? pFirstConstants[i] : 0, pNumConstants ? pNumConstants[i] : 0 }; };
+		if (Submit(UpdateSlots(m_PSConstantBuffers, startSlot, numBuffers, getValue)))
+		{
+			const uint32_t skipped = startSlot - firstSlot;
+			m_Target.PSSetConstantBuffers(startSlot, numBuffers, ppBuffers + skipped, pFirstConstants ? pFirstConstants + skipped : nullptr, pNumConstants ? pNumConstants + skipped : nullptr);
+		}
+	}
+
+	template<typename Target>
+	void StateFilter<Target>::PSSetShaderResources(uint32_t startSlot, uint32_t numViews, ShaderResourceView* const* ppViews)
+	{
+		const uint32_t firstSlot = startSlot;
+		const auto getValue = [&](uint32_t i) { return ppViews[i]; };
+		if (Submit(UpdateSlots(m_PSShaderResources, startSlot, numViews, getValue)))
+		{
+			m_Target.PSSetShaderResources(startSlot, numViews, ppViews + (startSlot - firstSlot));
+		}
+	}
+
+	template<typename Target>
+	void StateFilter<Target>::PSSetSamplers(uint32_t startSlot, uint32_t numSamplers, SamplerState* const* ppSamplers)
+	{
+		const uint32_t firstSlot = startSlot;
+		const auto getValue = [&](uint32_t i) { return ppSamplers[i]; };
+		if (Submit(UpdateSlots(m_PSSamplers, startSlot, numSamplers, getValue)))
+		{
+			m_Target.PSSetSamplers(startSlot, numSamplers, ppSamplers + (startSlot - firstSlot));
+		}
+	}
+
+	template<typename Target>
+	void StateFilter<Target>::OMSetRenderTargets(uint32_t numViews, RenderTargetView* const* ppViews, DepthStencilView* pDepthStencilView)
+	{
+		//Only single target bindings are cached, MRT is always forwarded
+		const bool isCacheable = numViews <= 1;
+		const bool changed = isCacheable
+			? m_RenderTargets.Update({ numViews, numViews == 1 ? ppViews[0] : nullptr, pDepthStencilView })
+			: true;
+
+		if (!isCacheable)
+		{
+			m_RenderTargets.isKnown = false;
+		}
+
+		if (Submit(changed))
+		{
+			m_Target.OMSetRenderTargets(numViews, ppViews, pDepthStencilView);
+		}
+	}
+
+	template<typename Target>
+	void StateFilter<Target>::OMSetBlendState(BlendState* pState, const float blendFactor[4], uint32_t sampleMask)
+	{
+		//nullptr blend factor means 1, 1, 1, 1
+		const std::array<float, 4> factor = blendFactor != nullptr
+			? std::array<float, 4>{ blendFactor[0], blendFactor[1], blendFactor[2], blendFactor[3] }
+			: std::array<float, 4>{ 1.0f, 1.0f, 1.0f, 1.0f };
+
+		if (Submit(m_BlendState.Update({ pState, factor, sampleMask })))
+		{
+			m_Target.OMSetBlendState(pState, blendFactor, sampleMask);
+		}
+	}
+
+	template<typename Target>
+	void StateFilter<Target>::OMSetDepthStencilState(DepthStencilState* pState, uint32_t stencilRef)
+	{
+		if (Submit(m_DepthStencilState.Update({ pState, stencilRef })))
+		{
+			m_Target.OMSetDepthStencilState(pState, stencilRef);
+		}
+	}
+
+	template<typename Target>
+	void StateFilter<Target>::RSSetState(RasterizerState* pState)
+	{
+		if (Submit(m_RasterizerState.Update(pState)))
+		{
+			m_Target.RSSetState(pState);
+		}
+	}
+
+	template<typename Target>
+	void StateFilter<Target>::ApplyPass(Pass* pPass, uint64_t variablesVersion)
+	{
+		if (Submit(m_Pass.Update({ pPass, variablesVersion })))
+		{
+			m_Target.ApplyPass(pPass);
+
+			//Input assembler state and render targets are not touched by a pass
+			InvalidatePassState();
+			m_Pass.Update({ pPass, variablesVersion });
+		}
+	}
+
+	template<typename Target>
+	void StateFilter<Target>::DrawIndexed(uint32_t indexCount, uint32_t startIndex, int32_t baseVertex)
+	{
+		m_Target.DrawIndexed(indexCount, startIndex, baseVertex);
+	}
+
+	template<typename Target>
+	void StateFilter<Target>::DrawIndexedInstanced(uint32_t indexCount, uint32_t instanceCount, uint32_t startIndex, int32_t baseVertex, uint32_t startInstance)
+	{
+		m_Target.DrawIndexedInstanced(indexCount, instanceCount, startIndex, baseVertex, startInstance);
+	}
+
+	template<typename Target>
+	void StateFilter<Target>::Invalidate()
+	{
+		m_Topology.isKnown = false;
+		m_InputLayout.isKnown = false;
+		for (Cached<VertexBufferSlot>& slot : m_VertexBuffers) slot.isKnown = false;
+		m_IndexBuffer.isKnown = false;
+		m_RenderTargets.isKnown = false;
+		InvalidatePassState();
+	}
+
+	template<typename Target>
+	void StateFilter<Target>::BeginFrame()
+	{
+		m_FrameStatistics = m_Statistics;
+		m_Statistics = {};
+	}
+
+	template<typename Target>
+	const typename StateFilter<Target>::Statistics& StateFilter<Target>::GetStatistics() const
+	{
+		return m_FrameStatistics;
+	}
+
+	template<typename Target>
+	Target& StateFilter<Target>::GetTarget()
+	{
+		return m_Target;
+	}
+
+	template<typename Target>
+	template<typename T, size_t N, typename GetValue>
+	bool StateFilter<Target>::UpdateSlots(std::array<Cached<T>, N>& slots, uint32_t& startSlot, uint32_t& count, const GetValue& getValue)
+	{
+		uint32_t firstChanged{ count };
+		uint32_t lastChanged{ 0 };
+		for (uint32_t i = 0; i < count; ++i)
+		{
+			const uint32_t slot = startSlot + i;
+			const bool changed = slot < N ? slots[slot].Update(getValue(i)) : true;
+			if (changed)
+			{
+				firstChanged = std::min(firstChanged, i);
+				lastChanged = i;
+			}
+		}
+
+		if (firstChanged == count)
+			return false;
+
+		startSlot += firstChanged;
+		count = lastChanged - firstChanged + 1;
+		return true;
+	}
+
+	template<typename Target>
+	bool StateFilter<Target>::Submit(bool changed)
+	{
+		++m_Statistics.numSubmitted;
+		if (!changed)
+		{
+			++m_Statistics.numFiltered;
+		}
+		return changed;
+	}
+
+	template<typename Target>
+	void StateFilter<Target>::InvalidatePassState()
+	{
+		m_VertexShader.isKnown = false;
+		m_PixelShader.isKnown = false;
+		for (Cached<ConstantBufferSlot>& slot : m_VSConstantBuffers) slot.isKnown = false;
+		for (Cached<ConstantBufferSlot>& slot : m_PSConstantBuffers) slot.isKnown = false;
+		for (Cached<ShaderResourceView*>& slot : m_PSShaderResources) slot.isKnown = false;
+		for (Cached<SamplerState*>& slot : m_PSSamplers) slot.isKnown = false;
+		m_BlendState.isKnown = false;
+		m_DepthStencilState.isKnown = false;
+		m_RasterizerState.isKnown = false;
+		m_Pass.isKnown = false;
+	}
+}
@@ -1,26 +1,434 @@
 #include "pch.h"
 #include "Texture.h"
+#include "PixelConversion.h"
 
 #include <cassert>
 #include <iostream>
 
 namespace dae
 {
+	namespace
+	{
+		constexpr uint32_t bytesPerPixel{ 4 };
+
+		uint32_t CalculateMipCount(uint32_t width, uint32_t height)
+		{
+			uint32_t mipCount{ 1 };
+			while (width > 1 || height > 1)
+			{
+				width = std::max(width / 2, 1u);
+				height = std::max(height / 2, 1u);
+				++mipCount;
+			}
+			return mipCount;
+		}
+
+		bool GetByteIndex(uint32_t mask, uint8_t& index)
+		{
+			if (mask == 0)
+			{
+				index = PixelConversion::NoChannel;
+				return true;
+			}
+
+			for (uint8_t byte = 0; byte < 4; ++byte)
+			{
+				if (mask == (0xFFu << (byte * 8)))
+				{
+					index = byte;
+					return true;
+				}
+			}
+			return false;
+		}
+
+		//Only formats where every channel is a whole byte map onto the shuffle kernels
+		bool GetChannelOrder(const SDL_PixelFormat* pFormat, PixelConversion::ChannelOrder& order)
+		{
+#if SDL_BYTEORDER == SDL_BIG_ENDIAN
+			(void)pFormat;
+			(void)order;
+			return false;
+#else
+			if (pFormat->Rmask == 0 || pFormat->Gmask == 0 || pFormat->Bmask == 0)
+				return false;
+
+			if (!GetByteIndex(pFormat->Rmask, order.r) || !GetByteIndex(pFormat->Gmask, order.g)
+				|| !GetByteIndex(pFormat->Bmask, order.b) || !GetByteIndex(pFormat->Amask, order.a))
+				return false;
+
+			if (pFormat->BytesPerPixel == 3)
+				return order.r < 3 && order.g < 3 && order.b < 3 && order.a == PixelConversion::NoChannel;
+
+			return pFormat->BytesPerPixel == 4;
+#endif
+		}
+
+		//Picks the kernel matching the surface format, falls back to SDL_ConvertSurfaceFormat for exotic layouts
+		bool ConvertSurface(SDL_Surface* pSurface, Image& image, bool premultiplyAlpha = false)
+		{
+			const SDL_PixelFormat* pFormat = pSurface->format;
+
+			const bool isPalettized = pFormat->palette != nullptr && pFormat->BitsPerPixel == 8;
+			PixelConversion::ChannelOrder order{};
+			const bool isByteAligned = !isPalettized && GetChannelOrder(pFormat, order);
+
+			if (!isPalettized && !isByteAligned)
+			{
+				//Packed or sub-byte formats, let SDL bring them to RGBA32 first
+				SDL_Surface* pConverted = SDL_ConvertSurfaceFormat(pSurface, SDL_PIXELFORMAT_RGBA32, 0);
+				if (pConverted == nullptr)
+					return false;
+
+				const bool isConverted = ConvertSurface(pConverted, image, premultiplyAlpha);
+				SDL_FreeSurface(pConverted);
+				return isConverted;
+			}
+
+			image.width = static_cast<uint32_t>(pSurface->w);
+			image.height = static_cast<uint32_t>(pSurface->h);
+
+			const size_t rowSize = static_cast<size_t>(image.width) * bytesPerPixel;
+			image.pixels.resize(rowSize * image.height);
+
+			uint32_t palette[256]{};
+			if (isPalettized)
+			{
+				const int numColors = std::min(pFormat->palette->ncolors, 256);
+				memcpy(palette, pFormat->palette->colors, numColors * sizeof(SDL_Color));
+
+				uint32_t colorKey{};
+				if (SDL_GetColorKey(pSurface, &colorKey) == 0 && colorKey < 256)
+				{
+					reinterpret_cast<uint8_t*>(&palette[colorKey])[3] = 0;
+				}
+			}
+
+			if (SDL_MUSTLOCK(pSurface))
+			{
+				SDL_LockSurface(pSurface);
+			}
+
+			const PixelConversion::InstructionSet instructionSet = PixelConversion::GetBestInstructionSet();
+			for (uint32_t y = 0; y < image.height; ++y)
+			{
+				const uint8_t* pSrcRow = static_cast<const uint8_t*>(pSurface->pixels) + static_cast<size_t>(y) * pSurface->pitch;
+				uint8_t* pDstRow = &image.pixels[y * rowSize];
+
+				if (isPalettized)
+				{
+					PixelConversion::ExpandPalette(pSrcRow, palette, pDstRow, image.width, instructionSet);
+				}
+				else if (pFormat->BytesPerPixel == 3)
+				{
+					PixelConversion::ExpandToRGBA(pSrcRow, pDstRow, image.width, order, instructionSet);
+				}
+				else
+				{
+					PixelConversion::SwizzleToRGBA(pSrcRow, pDstRow, image.width, order, instructionSet);
+				}
+			}
+
+			if (SDL_MUSTLOCK(pSurface))
+			{
+				SDL_UnlockSurface(pSurface);
+			}
+
+			if (premultiplyAlpha)
+			{
+				PixelConversion::PremultiplyAlpha(image.pixels.data(), static_cast<size_t>(image.width) * image.height, instructionSet);
+			}
+
+			return true;
+		}
+
+		//Box filters an RGBA8 level into the next (half sized) level
+		std::vector<uint8_t> Downsample(const std::vector<uint8_t>& src, uint32_t srcWidth, uint32_t srcHeight)
+		{
+			const uint32_t dstWidth = std::max(srcWidth / 2, 1u);
+			const uint32_t dstHeight = std::max(srcHeight / 2, 1u);
+
+			std::vector<uint8_t> dst(static_cast<size_t>(dstWidth) * dstHeight * bytesPerPixel);
+			for (uint32_t y = 0; y < dstHeight; ++y)
+			{
+				const uint32_t y0 = std::min(y * 2, srcHeight - 1);
+				const uint32_t y1 = std::min(y * 2 + 1, srcHeight - 1);
+
+				for (uint32_t x = 0; x < dstWidth; ++x)
+				{
+					const uint32_t x0 = std::min(x * 2, srcWidth - 1);
+					const uint32_t x1 = std::min(x * 2 + 1, srcWidth - 1);
+
+					for (uint32_t c = 0; c < bytesPerPixel; ++c)
+					{
+						const uint32_t sum =
+							src[(static_cast<size_t>(y0) * srcWidth + x0) * bytesPerPixel + c] +
+							src[(static_cast<size_t>(y0) * srcWidth + x1) * bytesPerPixel + c] +
+							src[(static_cast<size_t>(y1) * srcWidth + x0) * bytesPerPixel + c] +
+							src[(static_cast<size_t>(y1) * srcWidth + x1) * bytesPerPixel + c];
+
+						dst[(static_cast<size_t>(y) * dstWidth + x) * bytesPerPixel + c] = static_cast<uint8_t>((sum + 2) / 4);
+					}
+				}
+			}
+
+			return dst;
+		}
+	}
+
 	Texture::Texture(ID3D11Device* pDevice, const std::string_view& filepath)
+		: m_pDevice{ pDevice }
+		, m_Filepath{ filepath }
+	{
+		Image image{};
+		if (!DecodeImage(m_Filepath, image))
+		{
+			assert(false);
+			return;
+		}
+
+		BuildMipChain(std::move(image));
+		if (!Upload(0))
+		{
+			assert(false);
+		}
+	}
+
+	Texture::Texture(ID3D11Device* pDevice, const std::string_view& filepath, const Image& image)
+		: m_pDevice{ pDevice }
+		, m_Filepath{ filepath }
+	{
+		BuildMipChain(image);
+		if (!Upload(0))
+		{
+			assert(false);
+		}
+	}
+
+	Texture::Texture(ID3D11Device* pDevice, Image&& image, uint32_t maxMipCount)
+		: m_pDevice{ pDevice }
+		, m_MaxMipCount{ maxMipCount }
+	{
+		BuildMipChain(std::move(image));
+		if (!Upload(0))
+		{
+			assert(false);
+		}
+	}
+
+	Texture::~Texture()
+	{
+		Evict();
+	}
+
+	ID3D11ShaderResourceView* Texture::GetShaderResourceView() const
+	{
+		return m_pShaderResourceView;
+	}
+
+	const std::string& Texture::GetFilepath() const
+	{
+		return m_Filepath;
+	}
+
+	uint32_t Texture::GetWidth() const
+	{
+		return m_Width;
+	}
+
+	uint32_t Texture::GetHeight() const
+	{
+		return m_Height;
+	}
+
+	uint32_t Texture::GetMipCount() const
+	{
+		return m_MipCount;
+	}
+
+	bool Texture::IsResident() const
+	{
+		return m_pShaderResourceView != nullptr;
+	}
+
+	uint32_t Texture::GetResidentMip() const
+	{
+		return m_ResidentMip;
+	}
+
+	size_t Texture::GetMipSize(uint32_t mip) const
 	{
-		SDL_Surface* pSurface = IMG_Load(filepath.data());
+		const size_t width = std::max(m_Width >> mip, 1u);
+		const size_t height = std::max(m_Height >> mip, 1u);
+		return width * height * bytesPerPixel;
+	}
+
+	size_t Texture::GetResidentSize(uint32_t topMip) const
+	{
+		size_t size{ 0 };
+		for (uint32_t mip = topMip; mip < m_MipCount; ++mip)
+		{
+			size += GetMipSize(mip);
+		}
+		return size;
+	}
+
+	size_t Texture::GetResidentSize() const
+	{
+		return IsResident() ? GetResidentSize(m_ResidentMip) : 0;
+	}
+
+	void Texture::MarkUsed()
+	{
+		m_IsUsed = true;
+
+		//Restore on demand, a texture that is about to be sampled must have something bound
+		if (!IsResident())
+		{
+			Upload(m_ResidentMip);
+		}
+	}
+
+	bool Texture::ConsumeUsed()
+	{
+		const bool isUsed = m_IsUsed;
+		m_IsUsed = false;
+		return isUsed;
+	}
+
+	void Texture::RequestMip(uint32_t mip)
+	{
+		m_RequestedMip = std::min(m_RequestedMip, mip);
+	}
+
+	uint32_t Texture::ConsumeRequestedMip()
+	{
+		const uint32_t requestedMip = m_RequestedMip;
+		m_RequestedMip = NoMipRequest;
+		return requestedMip;
+	}
+
+	bool Texture::SetResidentMip(uint32_t topMip)
+	{
+		topMip = std::min(topMip, m_MipCount - 1);
+		if (IsResident() && topMip == m_ResidentMip)
+			return true;
+
+		Evict();
+		return Upload(topMip);
+	}
+
+	void Texture::Evict()
+	{
+		if (m_pShaderResourceView)
+		{
+			m_pShaderResourceView->Release();
+			m_pShaderResourceView = nullptr;
+		}
+
+		if (m_pBuffer)
+		{
+			m_pBuffer->Release();
+			m_pBuffer = nullptr;
+		}
+	}
+
+	bool Texture::DecodeImage(const std::string& filepath, Image& image)
+	{
+		SDL_Surface* pSurface = IMG_Load(filepath.c_str());
 		if (pSurface == nullptr)
 		{
 			std::cout << "Failed to load image \"" << filepath << "\" into memory!\n";
-			assert(false);
+			return false;
+		}
+
+		const bool isConverted = ConvertSurface(pSurface, image);
+		if (!isConverted)
+		{
+			std::cout << "Unsupported pixel format " << SDL_GetPixelFormatName(pSurface->format->format) << " in \"" << filepath << "\"!\n";
+		}
+
+		SDL_FreeSurface(pSurface);
+		return isConverted;
+	}
+
+	bool Texture::SavePNG(const std::string& filepath, const Image& image)
+	{
+		SDL_Surface* pSurface = SDL_CreateRGBSurfaceWithFormatFrom(
+			const_cast<uint8_t*>(image.pixels.data()),
+			static_cast<int>(image.width),
+			static_cast<int>(image.height),
+			32,
+			static_cast<int>(image.width * bytesPerPixel),
+			SDL_PIXELFORMAT_RGBA32);
+
+		if (pSurface == nullptr)
+		{
+			std::cout << "Failed to create surface for \"" << filepath << "\"!\n";
+			return false;
+		}
+
+		const bool isSaved = IMG_SavePNG(pSurface, filepath.c_str()) == 0;
+		if (!isSaved)
+		{
+			std::cout << "Failed to save image \"" << filepath << "\"! (" << IMG_GetError() << ")\n";
+		}
+
+		SDL_FreeSurface(pSurface);
+		return isSaved;
+	}
+
+	void Texture::BuildMipChain(Image image)
+	{
+		m_Width = image.width;
+		m_Height = image.height;
+		m_MipCount = CalculateMipCount(m_Width, m_Height);
+		if (m_MaxMipCount != 0)
+		{
+			m_MipCount = std::min(m_MipCount, m_MaxMipCount);
+		}
+
+		m_MipLevels.clear();
+		m_MipLevels.reserve(m_MipCount);
+		m_MipLevels.push_back(std::move(image.pixels));
+
+		uint32_t levelWidth = m_Width;
+		uint32_t levelHeight = m_Height;
+		for (uint32_t mip = 1; mip < m_MipCount; ++mip)
+		{
+			m_MipLevels.push_back(Downsample(m_MipLevels.back(), levelWidth, levelHeight));
+			levelWidth = std::max(levelWidth / 2, 1u);
+			levelHeight = std::max(levelHeight / 2, 1u);
+		}
+	}
+
+	bool Texture::Upload(uint32_t topMip)
+	{
+		if (m_MipLevels.empty())
+			return false;
+
+		//Only the levels from topMip downwards are uploaded
+		topMip = std::min(topMip, m_MipCount - 1);
+
+		const uint32_t numLevels = m_MipCount - topMip;
+
+		std::vector<D3D11_SUBRESOURCE_DATA> initData(numLevels);
+		for (uint32_t i = 0; i < numLevels; ++i)
+		{
+			const uint32_t width = std::max(m_Width >> (topMip + i), 1u);
+			const uint32_t height = std::max(m_Height >> (topMip + i), 1u);
+
+			initData[i].pSysMem = m_MipLevels[topMip + i].data();
+			initData[i].SysMemPitch = width * bytesPerPixel;
+			initData[i].SysMemSlicePitch = width * height * bytesPerPixel;
 		}
 
 		DXGI_FORMAT format = DXGI_FORMAT_R8G8B8A8_UNORM;
 
 		D3D11_TEXTURE2D_DESC desc{};
-		desc.Width					= pSurface->w;
-		desc.Height					= pSurface->h;
-		desc.MipLevels				= 1;
+		desc.Width					= std::max(m_Width >> topMip, 1u);
+		desc.Height					= std::max(m_Height >> topMip, 1u);
+		desc.MipLevels				= numLevels;
 		desc.ArraySize				= 1;
 		desc.Format					= format;
 		desc.SampleDesc.Count		= 1;
@@ -30,42 +438,28 @@ namespace dae
 		desc.CPUAccessFlags			= 0;
 		desc.MiscFlags				= 0;
 
-		D3D11_SUBRESOURCE_DATA initData{};
-		initData.pSysMem = pSurface->pixels;
-		initData.SysMemPitch = static_cast<UINT>(pSurface->pitch);
-		initData.SysMemSlicePitch = static_cast<UINT>(pSurface->h * pSurface->pitch);
-
-		HRESULT hr = pDevice->CreateTexture2D(&desc, &initData, &m_pBuffer);
+		HRESULT hr = m_pDevice->CreateTexture2D(&desc, initData.data(), &m_pBuffer);
 		if (FAILED(hr))
 		{
-			std::cout << "Failed to create Texture2D! (" << filepath << ")\n";
-			assert(false);
+			std::cout << "Failed to create Texture2D! (" << m_Filepath << ")\n";
+			return false;
 		}
 
 		D3D11_SHADER_RESOURCE_VIEW_DESC srvDesc{};
 		srvDesc.Format				= format;
 		srvDesc.ViewDimension		= D3D11_SRV_DIMENSION_TEXTURE2D;
-		srvDesc.Texture2D.MipLevels	= 1;
+		srvDesc.Texture2D.MipLevels	= numLevels;
 
-		hr = pDevice->CreateShaderResourceView(m_pBuffer, &srvDesc, &m_pShaderResourceView);
+		hr = m_pDevice->CreateShaderResourceView(m_pBuffer, &srvDesc, &m_pShaderResourceView);
 		if (FAILED(hr))
 		{
-			std::cout << "Failed to create ShaderResourceView! (" << filepath << ")\n";
-			assert(false);
+			std::cout << "Failed to create ShaderResourceView! (" << m_Filepath << ")\n";
+			m_pBuffer->Release();
+			m_pBuffer = nullptr;
+			return false;
 		}
 
-		SDL_FreeSurface(pSurface);
-	}
-
-	Texture::~Texture()
-	{
-		if (m_pShaderResourceView) m_pShaderResourceView->Release();
-		if (m_pBuffer) m_pBuffer->Release();
-	}
-
-	ID3D11ShaderResourceView* Texture::GetShaderResourceView() const
-	{
-		return m_pShaderResourceView;
+		m_ResidentMip = topMip;
+		return true;
 	}
 }
-
@@ -1,6 +1,10 @@
 #pragma once
 
+#include "Image.h"
+
+#include <string>
 #include <string_view>
+#include <vector>
 
 namespace dae
 {
@@ -8,6 +12,8 @@ namespace dae
 	{
 	public:
 		Texture(ID3D11Device* pDevice, const std::string_view& filepath);
+		Texture(ID3D11Device* pDevice, const std::string_view& filepath, const Image& image);
+		Texture(ID3D11Device* pDevice, Image&& image, uint32_t maxMipCount = 0);
 		~Texture();
 
 		Texture(const Texture&)				= delete;
@@ -17,8 +23,56 @@ namespace dae
 
 		ID3D11ShaderResourceView* GetShaderResourceView() const;
 
+		const std::string& GetFilepath() const;
+		uint32_t GetWidth() const;
+		uint32_t GetHeight() const;
+		uint32_t GetMipCount() const;
+
+		// Residency
+		bool IsResident() const;
+		uint32_t GetResidentMip() const;
+		size_t GetMipSize(uint32_t mip) const;
+		size_t GetResidentSize(uint32_t topMip) const;
+		size_t GetResidentSize() const;
+
+		void MarkUsed();
+		bool ConsumeUsed();
+
+		// Streaming hint, every draw requests the finest mip it needs and the finest request of the frame wins
+		void RequestMip(uint32_t mip);
+		// Returns NoMipRequest when nothing was requested since the last call
+		uint32_t ConsumeRequestedMip();
+
+		static constexpr uint32_t NoMipRequest{ 0xFFFFFFFF };
+
+		bool SetResidentMip(uint32_t topMip);
+		void Evict();
+
+		static bool DecodeImage(const std::string& filepath, Image& image);
+		static bool SavePNG(const std::string& filepath, const Image& image);
+
 	private:
-		ID3D11Texture2D* m_pBuffer;
+		ID3D11Device* m_pDevice;
+		std::string m_Filepath;
+
+		// The whole mip chain is built once and kept in memory, dropping or restoring mips only re-uploads it
+		std::vector<std::vector<uint8_t>> m_MipLevels{};
+
+		uint32_t m_Width{};
+		uint32_t m_Height{};
+		uint32_t m_MipCount{};
+		uint32_t m_MaxMipCount{};
+		uint32_t m_ResidentMip{};
+
+		uint32_t m_RequestedMip{ NoMipRequest };
+
+		bool m_IsUsed{ false };
+
+		ID3D11Texture2D* m_pBuffer{ nullptr };
 		ID3D11ShaderResourceView* m_pShaderResourceView{ nullptr };
+
+	private:
+		void BuildMipChain(Image image);
+		bool Upload(uint32_t topMip);
 	};
 }
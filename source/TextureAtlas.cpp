@@ -0,0 +1,41 @@
+#include "pch.h"
+#include "TextureAtlas.h"
+#include "Texture.h"
+
+namespace dae
+{
+	TextureAtlas::TextureAtlas(ID3D11Device* pDevice, const std::vector<Image>& images, uint32_t gutter, uint32_t maxSize)
+	{
+		Image atlas{};
+		if (!AtlasLayout::Build(images, gutter, maxSize, atlas, m_Regions))
+			return;
+
+		m_Size = atlas.width;
+		m_pTexture = std::make_shared<Texture>(pDevice, std::move(atlas), AtlasLayout::GetMipCount(gutter));
+	}
+
+	bool TextureAtlas::IsValid() const
+	{
+		return m_pTexture != nullptr;
+	}
+
+	const std::shared_ptr<Texture>& TextureAtlas::GetTexture() const
+	{
+		return m_pTexture;
+	}
+
+	const TextureAtlas::Region& TextureAtlas::GetRegion(uint32_t index) const
+	{
+		return m_Regions[index];
+	}
+
+	uint32_t TextureAtlas::GetNumRegions() const
+	{
+		return static_cast<uint32_t>(m_Regions.size());
+	}
+
+	uint32_t TextureAtlas::GetSize() const
+	{
+		return m_Size;
+	}
+}
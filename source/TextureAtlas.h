@@ -0,0 +1,37 @@
+#pragma once
+
+#include "AtlasLayout.h"
+
+namespace dae
+{
+	class Texture;
+
+	// Packs small textures into one padded atlas so meshes using them share a single shader resource view
+	class TextureAtlas final
+	{
+	public:
+		using Region = AtlasLayout::Region;
+
+	public:
+		// gutter is the number of edge texels replicated around every region, it also limits the mip count (see AtlasLayout)
+		TextureAtlas(ID3D11Device* pDevice, const std::vector<Image>& images, uint32_t gutter = 8, uint32_t maxSize = 4096);
+		~TextureAtlas() = default;
+
+		TextureAtlas(const TextureAtlas&)				= delete;
+		TextureAtlas& operator=(const TextureAtlas&)	= delete;
+		TextureAtlas(TextureAtlas&&)					= delete;
+		TextureAtlas& operator=(TextureAtlas&&)			= delete;
+
+		bool IsValid() const;
+
+		const std::shared_ptr<Texture>& GetTexture() const;
+		const Region& GetRegion(uint32_t index) const;
+		uint32_t GetNumRegions() const;
+		uint32_t GetSize() const;
+
+	private:
+		std::shared_ptr<Texture> m_pTexture;
+		std::vector<Region> m_Regions;
+		uint32_t m_Size{};
+	};
+}
@@ -0,0 +1,116 @@
+#include "pch.h"
+#include "TextureLoader.h"
+#include "Texture.h"
+
+#include <chrono>
+
+namespace dae
+{
+	namespace
+	{
+		using Clock = std::chrono::high_resolution_clock;
+
+		float MillisecondsSince(const Clock::time_point& start)
+		{
+			return std::chrono::duration<float, std::milli>(Clock::now() - start).count();
+		}
+	}
+
+	TextureLoader::TextureLoader(uint32_t numThreads)
+		: m_ThreadPool{ numThreads }
+	{
+	}
+
+	std::vector<std::unique_ptr<Texture>> TextureLoader::LoadTextures(ID3D11Device* pDevice, const std::vector<std::string>& filepaths)
+	{
+		const uint32_t numImages = static_cast<uint32_t>(filepaths.size());
+
+		std::vector<uint8_t> isDecoded;
+		std::vector<Image> images = DecodeImages(filepaths, isDecoded);
+
+		std::vector<std::unique_ptr<Texture>> textures(numImages);
+
+		const Clock::time_point uploadStart = Clock::now();
+		for (uint32_t i = 0; i < numImages; ++i)
+		{
+			if (isDecoded[i])
+			{
+				textures[i] = std::make_unique<Texture>(pDevice, filepaths[i], images[i]);
+			}
+
+			//Release the pixels as soon as they are on the device
+			images[i] = {};
+		}
+		m_Statistics.uploadMilliseconds = MillisecondsSince(uploadStart);
+
+		return textures;
+	}
+
+	std::vector<Image> TextureLoader::DecodeImages(const std::vector<std::string>& filepaths, std::vector<uint8_t>& isDecoded)
+	{
+		const uint32_t numImages = static_cast<uint32_t>(filepaths.size());
+
+		std::vector<Image> images(numImages);
+		isDecoded.assign(numImages, false);
+
+		const Clock::time_point decodeStart = Clock::now();
+		m_ThreadPool.ParallelFor(numImages, [&](uint32_t index)
+		{
+			isDecoded[index] = Texture::DecodeImage(filepaths[index], images[index]);
+		});
+		m_Statistics.decodeMilliseconds = MillisecondsSince(decodeStart);
+		m_Statistics.uploadMilliseconds = 0.0f;
+
+		m_Statistics.numThreads = m_ThreadPool.GetNumThreads();
+		m_Statistics.numImages = numImages;
+
+		return images;
+	}
+
+	const TextureLoader::Statistics& TextureLoader::GetStatistics() const
+	{
+		return m_Statistics;
+	}
+
+	void TextureLoader::BenchmarkDecode(const std::vector<std::string>& filepaths, uint32_t maxThreads, uint32_t numRepetitions)
+	{
+		if (maxThreads == 0)
+		{
+			maxThreads = static_cast<uint32_t>(std::max(SDL_GetCPUCount(), 1));
+		}
+		numRepetitions = std::max(numRepetitions, 1u);
+
+		const uint32_t numImages = static_cast<uint32_t>(filepaths.size());
+		std::cout << "Decoding " << numImages << " images, best of " << numRepetitions << " runs\n";
+
+		float singleThreadedMilliseconds{ 0.0f };
+		for (uint32_t numThreads = 1; ; numThreads = std::min(numThreads * 2, maxThreads))
+		{
+			ThreadPool threadPool{ numThreads };
+
+			float bestMilliseconds{ FLT_MAX };
+			for (uint32_t repetition = 0; repetition < numRepetitions; ++repetition)
+			{
+				std::vector<Image> images(numImages);
+
+				const Clock::time_point start = Clock::now();
+				threadPool.ParallelFor(numImages, [&](uint32_t index)
+				{
+					Texture::DecodeImage(filepaths[index], images[index]);
+				});
+				bestMilliseconds = std::min(bestMilliseconds, MillisecondsSince(start));
+			}
+
+			if (numThreads == 1)
+			{
+				singleThreadedMilliseconds = bestMilliseconds;
+			}
+
+			std::cout << "  " << numThreads << " thread(s): " << bestMilliseconds << " ms"
+				<< " (speedup x" << singleThreadedMilliseconds / bestMilliseconds << ")\n";
+
+			if (numThreads == maxThreads)
+				break;
+		}
+	}
+}
@@ -0,0 +1,49 @@
+#pragma once
+
+#include "ThreadPool.h"
+
+#include <string>
+
+namespace dae
+{
+	class Texture;
+	struct Image;
+
+	class TextureLoader final
+	{
+	public:
+		struct Statistics
+		{
+			uint32_t numThreads{};
+			uint32_t numImages{};
+			float decodeMilliseconds{};
+			float uploadMilliseconds{};
+		};
+
+	public:
+		// numThreads includes the calling thread, 0 uses one thread per logical core
+		explicit TextureLoader(uint32_t numThreads = 0);
+		~TextureLoader() = default;
+
+		TextureLoader(const TextureLoader&)				= delete;
+		TextureLoader& operator=(const TextureLoader&)	= delete;
+		TextureLoader(TextureLoader&&)					= delete;
+		TextureLoader& operator=(TextureLoader&&)		= delete;
+
+		// Decodes all files in parallel, then creates the textures in one pass on the calling thread.
+		// Files that fail to decode result in a nullptr at their index.
+		std::vector<std::unique_ptr<Texture>> LoadTextures(ID3D11Device* pDevice, const std::vector<std::string>& filepaths);
+
+		// Only decodes, for import steps that process the pixels before creating textures
+		std::vector<Image> DecodeImages(const std::vector<std::string>& filepaths, std::vector<uint8_t>& isDecoded);
+
+		const Statistics& GetStatistics() const;
+
+		// Decodes the files with 1, 2, 4, ... up to maxThreads threads and prints the timings
+		static void BenchmarkDecode(const std::vector<std::string>& filepaths, uint32_t maxThreads = 0, uint32_t numRepetitions = 5);
+
+	private:
+		ThreadPool m_ThreadPool;
+		Statistics m_Statistics{};
+	};
+}
@@ -0,0 +1,366 @@
+#pragma once
+
+#include <algorithm>
+#include <cstdint>
+#include <iostream>
+#include <vector>
+
+namespace dae
+{
+	// Keeps the registered textures under a memory budget: mips finer than requested are streamed out, textures not used
+	// this frame lose their top mips and then get evicted, visible ones only lose resolution. No D3D types in here,
+	// Renderer uses TextureResidency<Texture>, tests use a fake texture. TextureType provides
+	//		static constexpr uint32_t NoMipRequest;
+	//		bool IsResident() const;
+	//		uint32_t GetWidth() const;
+	//		uint32_t GetHeight() const;
+	//		uint32_t GetMipCount() const;
+	//		uint32_t GetResidentMip() const;
+	//		size_t GetResidentSize(uint32_t topMip) const;
+	//		size_t GetResidentSize() const;						// 0 when evicted
+	//		bool ConsumeUsed();
+	//		uint32_t ConsumeRequestedMip();
+	//		bool SetResidentMip(uint32_t topMip);				// evicted when the upload fails
+	//		void Evict();
+	template<typename TextureType>
+	class TextureResidency final
+	{
+	public:
+		struct Statistics
+		{
+			size_t budgetBytes{};
+			size_t residentBytes{};
+			size_t peakResidentBytes{};
+
+			uint32_t numEvictions{};
+			uint32_t numMipDrops{};
+			uint32_t numStreamingDrops{};
+			uint32_t numRestores{};
+			uint32_t numOverBudgetFrames{};
+		};
+
+	public:
+		explicit TextureResidency(size_t budgetBytes);
+		~TextureResidency() = default;
+
+		TextureResidency(const TextureResidency&)				= delete;
+		TextureResidency& operator=(const TextureResidency&)	= delete;
+		TextureResidency(TextureResidency&&)					= delete;
+		TextureResidency& operator=(TextureResidency&&)			= delete;
+
+		void Register(TextureType* pTexture);
+		void Unregister(TextureType* pTexture);
+
+		//Call once per frame, after all textures of the frame were marked as used and their mips requested
+		void Update();
+
+		void SetBudget(size_t budgetBytes);
+		size_t GetBudget() const;
+
+		// Textures never drop below this resolution, an evicted texture is gone completely instead
+		void SetMinResidentSize(uint32_t minSize);
+
+		float GetBudgetPressure() const;
+		const Statistics& GetStatistics() const;
+		void PrintStatistics() const;
+
+	private:
+		struct Entry
+		{
+			TextureType* pTexture;
+			uint64_t lastUsedFrame;
+			uint32_t requestedMip;
+			bool wasResident;
+		};
+
+		std::vector<Entry> m_Entries;
+
+		size_t m_BudgetBytes;
+		uint32_t m_MinResidentSize{ 64 };
+		uint64_t m_Frame{ 0 };
+
+		Statistics m_Statistics{};
+
+	private:
+		size_t CalculateResidentBytes() const;
+		uint32_t GetMaxDroppedMip(const TextureType* pTexture) const;
+
+		void StreamMips(size_t& residentBytes);
+		void RestoreMips(size_t& residentBytes);
+		void EnforceBudget(size_t& residentBytes);
+	};
+
+	template<typename TextureType>
+	TextureResidency<TextureType>::TextureResidency(size_t budgetBytes)
+		: m_BudgetBytes{ budgetBytes }
+	{
+		m_Statistics.budgetBytes = budgetBytes;
+	}
+
+	template<typename TextureType>
+	void TextureResidency<TextureType>::Register(TextureType* pTexture)
+	{
+		if (pTexture == nullptr)
+			return;
+
+		const auto it = std::find_if(m_Entries.begin(), m_Entries.end(), [pTexture](const Entry& entry) { return entry.pTexture == pTexture; });
+		if (it != m_Entries.end())
+			return;
+
+		m_Entries.push_back({ pTexture, m_Frame, 0, pTexture->IsResident() });
+	}
+
+	template<typename TextureType>
+	void TextureResidency<TextureType>::Unregister(TextureType* pTexture)
+	{
+		std::erase_if(m_Entries, [pTexture](const Entry& entry) { return entry.pTexture == pTexture; });
+	}
+
+	template<typename TextureType>
+	void TextureResidency<TextureType>::Update()
+	{
+		++m_Frame;
+
+		for (Entry& entry : m_Entries)
+		{
+			//Used without a request means the user has no idea about the texel density, keep full resolution
+			const uint32_t requestedMip = entry.pTexture->ConsumeRequestedMip();
+			if (entry.pTexture->ConsumeUsed())
+			{
+				entry.lastUsedFrame = m_Frame;
+				entry.requestedMip = requestedMip == TextureType::NoMipRequest ? 0 : std::min(requestedMip, GetMaxDroppedMip(entry.pTexture));
+			}
+
+			//Texture::MarkUsed re-uploads evicted textures on demand
+			if (!entry.wasResident && entry.pTexture->IsResident())
+			{
+				++m_Statistics.numRestores;
+			}
+		}
+
+		size_t residentBytes = CalculateResidentBytes();
+
+		StreamMips(residentBytes);
+		RestoreMips(residentBytes);
+		EnforceBudget(residentBytes);
+
+		for (Entry& entry : m_Entries)
+		{
+			entry.wasResident = entry.pTexture->IsResident();
+		}
+
+		m_Statistics.residentBytes = residentBytes;
+		m_Statistics.peakResidentBytes = std::max(m_Statistics.peakResidentBytes, residentBytes);
+	}
+
+	template<typename TextureType>
+	void TextureResidency<TextureType>::SetBudget(size_t budgetBytes)
+	{
+		m_BudgetBytes = budgetBytes;
+		m_Statistics.budgetBytes = budgetBytes;
+	}
+
+	template<typename TextureType>
+	size_t TextureResidency<TextureType>::GetBudget() const
+	{
+		return m_BudgetBytes;
+	}
+
+	template<typename TextureType>
+	void TextureResidency<TextureType>::SetMinResidentSize(uint32_t minSize)
+	{
+		m_MinResidentSize = std::max(minSize, 1u);
+	}
+
+	template<typename TextureType>
+	float TextureResidency<TextureType>::GetBudgetPressure() const
+	{
+		if (m_BudgetBytes == 0)
+			return 0.0f;
+
+		return static_cast<float>(m_Statistics.residentBytes) / static_cast<float>(m_BudgetBytes);
+	}
+
+	template<typename TextureType>
+	const typename TextureResidency<TextureType>::Statistics& TextureResidency<TextureType>::GetStatistics() const
+	{
+		return m_Statistics;
+	}
+
+	template<typename TextureType>
+	void TextureResidency<TextureType>::PrintStatistics() const
+	{
+		constexpr float toMegaBytes{ 1.0f / (1024.0f * 1024.0f) };
+
+		std::cout << "Textures: " << m_Statistics.residentBytes * toMegaBytes << "/" << m_BudgetBytes * toMegaBytes << " MB"
+			<< " (pressure " << GetBudgetPressure() * 100.0f << "%, peak " << m_Statistics.peakResidentBytes * toMegaBytes << " MB)"
+			<< " evictions: " << m_Statistics.numEvictions
+			<< " mip drops: " << m_Statistics.numMipDrops
+			<< " streamed: " << m_Statistics.numStreamingDrops
+			<< " restores: " << m_Statistics.numRestores
+			<< " over budget frames: " << m_Statistics.numOverBudgetFrames << "\n";
+	}
+
+	template<typename TextureType>
+	size_t TextureResidency<TextureType>::CalculateResidentBytes() const
+	{
+		size_t residentBytes{ 0 };
+		for (const Entry& entry : m_Entries)
+		{
+			residentBytes += entry.pTexture->GetResidentSize();
+		}
+		return residentBytes;
+	}
+
+	template<typename TextureType>
+	uint32_t TextureResidency<TextureType>::GetMaxDroppedMip(const TextureType* pTexture) const
+	{
+		uint32_t mip{ 0 };
+		while (mip + 1 < pTexture->GetMipCount()
+			&& (pTexture->GetWidth() >> (mip + 1)) >= m_MinResidentSize
+			&& (pTexture->GetHeight() >> (mip + 1)) >= m_MinResidentSize)
+		{
+			++mip;
+		}
+		return mip;
+	}
+
+	template<typename TextureType>
+	void TextureResidency<TextureType>::StreamMips(size_t& residentBytes)
+	{
+		//Mips finer than what is visible are dropped, one level of slack avoids re-uploading on every small camera move
+		constexpr uint32_t hysteresis{ 1 };
+
+		for (Entry& entry : m_Entries)
+		{
+			TextureType* pTexture = entry.pTexture;
+			if (entry.lastUsedFrame != m_Frame || !pTexture->IsResident() || pTexture->GetResidentMip() + hysteresis >= entry.requestedMip)
+				continue;
+
+			const size_t currentSize = pTexture->GetResidentSize();
+			const uint32_t currentMip = pTexture->GetResidentMip();
+			if (pTexture->SetResidentMip(entry.requestedMip))
+			{
+				residentBytes -= currentSize - pTexture->GetResidentSize();
+				m_Statistics.numStreamingDrops += entry.requestedMip - currentMip;
+			}
+			else
+			{
+				//Upload failed, the texture is evicted now
+				residentBytes -= currentSize;
+				++m_Statistics.numEvictions;
+			}
+		}
+	}
+
+	template<typename TextureType>
+	void TextureResidency<TextureType>::RestoreMips(size_t& residentBytes)
+	{
+		//Recently used textures get one mip back per frame while there is headroom, but never finer than requested
+		for (Entry& entry : m_Entries)
+		{
+			TextureType* pTexture = entry.pTexture;
+			if (entry.lastUsedFrame != m_Frame || !pTexture->IsResident() || pTexture->GetResidentMip() <= entry.requestedMip)
+				continue;
+
+			const uint32_t targetMip = pTexture->GetResidentMip() - 1;
+			const size_t currentSize = pTexture->GetResidentSize();
+			const size_t growth = pTexture->GetResidentSize(targetMip) - currentSize;
+			if (residentBytes + growth > m_BudgetBytes)
+				continue;
+
+			if (pTexture->SetResidentMip(targetMip))
+			{
+				residentBytes += growth;
+				++m_Statistics.numRestores;
+			}
+			else
+			{
+				residentBytes -= currentSize;
+				++m_Statistics.numEvictions;
+			}
+		}
+	}
+
+	template<typename TextureType>
+	void TextureResidency<TextureType>::EnforceBudget(size_t& residentBytes)
+	{
+		if (residentBytes <= m_BudgetBytes)
+			return;
+
+		++m_Statistics.numOverBudgetFrames;
+
+		std::vector<Entry*> lru;
+		lru.reserve(m_Entries.size());
+		for (Entry& entry : m_Entries)
+		{
+			if (entry.pTexture->IsResident())
+			{
+				lru.push_back(&entry);
+			}
+		}
+
+		std::stable_sort(lru.begin(), lru.end(), [](const Entry* pA, const Entry* pB) { return pA->lastUsedFrame < pB->lastUsedFrame; });
+
+		//Drops as many top mips as needed to get back under budget, returns true when that succeeded
+		const auto dropMips = [&](TextureType* pTexture) -> bool
+		{
+			const uint32_t currentMip = pTexture->GetResidentMip();
+			const uint32_t maxMip = GetMaxDroppedMip(pTexture);
+			const size_t currentSize = pTexture->GetResidentSize();
+
+			uint32_t targetMip = currentMip;
+			while (targetMip < maxMip && residentBytes - (currentSize - pTexture->GetResidentSize(targetMip)) > m_BudgetBytes)
+			{
+				++targetMip;
+			}
+
+			if (targetMip == currentMip)
+				return false;
+
+			const size_t savedBytes = currentSize - pTexture->GetResidentSize(targetMip);
+			if (!pTexture->SetResidentMip(targetMip))
+			{
+				//Upload failed, the texture is evicted now
+				residentBytes -= currentSize;
+				++m_Statistics.numEvictions;
+				return residentBytes <= m_BudgetBytes;
+			}
+
+			residentBytes -= savedBytes;
+			m_Statistics.numMipDrops += targetMip - currentMip;
+			return residentBytes <= m_BudgetBytes;
+		};
+
+		//Textures that were not used this frame lose their top mips first, then get evicted
+		for (Entry* pEntry : lru)
+		{
+			if (pEntry->lastUsedFrame == m_Frame)
+				continue;
+
+			if (dropMips(pEntry->pTexture))
+				return;
+
+			//A failed upload while dropping mips already evicted and counted it
+			if (!pEntry->pTexture->IsResident())
+				continue;
+
+			residentBytes -= pEntry->pTexture->GetResidentSize();
+			pEntry->pTexture->Evict();
+			++m_Statistics.numEvictions;
+
+			if (residentBytes <= m_BudgetBytes)
+				return;
+		}
+
+		//Visible textures are never evicted, only their resolution is lowered
+		for (Entry* pEntry : lru)
+		{
+			if (pEntry->lastUsedFrame != m_Frame)
+				continue;
+
+			if (dropMips(pEntry->pTexture))
+				return;
+		}
+	}
+}
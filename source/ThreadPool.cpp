@@ -0,0 +1,93 @@
+#include "ThreadPool.h"
+
+#include <algorithm>
+
+namespace dae
+{
+	ThreadPool::ThreadPool(uint32_t numThreads)
+	{
+		if (numThreads == 0)
+		{
+			numThreads = std::max(std::thread::hardware_concurrency(), 1u);
+		}
+
+		m_Workers.reserve(numThreads - 1);
+		for (uint32_t i = 1; i < numThreads; ++i)
+		{
+			m_Workers.emplace_back(&ThreadPool::WorkerLoop, this);
+		}
+	}
+
+	ThreadPool::~ThreadPool()
+	{
+		{
+			std::lock_guard lock{ m_Mutex };
+			m_IsStopping = true;
+		}
+		m_WorkCondition.notify_all();
+
+		for (std::thread& worker : m_Workers)
+		{
+			worker.join();
+		}
+	}
+
+	uint32_t ThreadPool::GetNumThreads() const
+	{
+		return static_cast<uint32_t>(m_Workers.size()) + 1;
+	}
+
+	void ThreadPool::ParallelFor(uint32_t count, const std::function<void(uint32_t)>& job)
+	{
+		if (count == 0)
+			return;
+
+		{
+			std::lock_guard lock{ m_Mutex };
+			m_pJob = &job;
+			m_Count = count;
+			m_NextIndex = 0;
+			m_NumActiveWorkers = static_cast<uint32_t>(m_Workers.size());
+			++m_Generation;
+		}
+		m_WorkCondition.notify_all();
+
+		RunJobs();
+
+		std::unique_lock lock{ m_Mutex };
+		m_DoneCondition.wait(lock, [this] { return m_NumActiveWorkers == 0; });
+		m_pJob = nullptr;
+	}
+
+	void ThreadPool::WorkerLoop()
+	{
+		uint64_t generation{ 0 };
+
+		std::unique_lock lock{ m_Mutex };
+		while (true)
+		{
+			m_WorkCondition.wait(lock, [this, generation] { return m_IsStopping || m_Generation != generation; });
+			if (m_IsStopping)
+				return;
+
+			generation = m_Generation;
+
+			lock.unlock();
+			RunJobs();
+			lock.lock();
+
+			if (--m_NumActiveWorkers == 0)
+			{
+				m_DoneCondition.notify_one();
+			}
+		}
+	}
+
+	void ThreadPool::RunJobs()
+	{
+		for (uint32_t index = m_NextIndex++; index < m_Count; index = m_NextIndex++)
+		{
+			(*m_pJob)(index);
+		}
+	}
+}
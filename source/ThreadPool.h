@@ -0,0 +1,47 @@
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <functional>
+#include <mutex>
+#include <thread>
+
+namespace dae
+{
+	class ThreadPool final
+	{
+	public:
+		// numThreads includes the calling thread, 0 uses one thread per logical core
+		explicit ThreadPool(uint32_t numThreads = 0);
+		~ThreadPool();
+
+		ThreadPool(const ThreadPool&)				= delete;
+		ThreadPool& operator=(const ThreadPool&)	= delete;
+		ThreadPool(ThreadPool&&)					= delete;
+		ThreadPool& operator=(ThreadPool&&)			= delete;
+
+		uint32_t GetNumThreads() const;
+
+		// Runs job(0) ... job(count - 1) spread over all threads and blocks until every job finished.
+		// The calling thread helps out, nested calls are not supported.
+		void ParallelFor(uint32_t count, const std::function<void(uint32_t)>& job);
+
+	private:
+		std::vector<std::thread> m_Workers;
+
+		std::mutex m_Mutex;
+		std::condition_variable m_WorkCondition;
+		std::condition_variable m_DoneCondition;
+
+		const std::function<void(uint32_t)>* m_pJob{ nullptr };
+		std::atomic<uint32_t> m_NextIndex{ 0 };
+		uint32_t m_Count{ 0 };
+		uint32_t m_NumActiveWorkers{ 0 };
+		uint64_t m_Generation{ 0 };
+		bool m_IsStopping{ false };
+
+	private:
+		void WorkerLoop();
+		void RunJobs();
+	};
+}
@@ -0,0 +1,148 @@
+#include "Transform.h"
+
+namespace dae
+{
+	namespace
+	{
+		bool AreIdentical(const Vector3& v1, const Vector3& v2)
+		{
+			return v1.x == v2.x && v1.y == v2.y && v1.z == v2.z;
+		}
+	}
+
+	Transform::Transform(const Vector3& position, const Quaternion& rotation, const Vector3& scale)
+		: m_Position{ position }
+		, m_Rotation{ rotation }
+		, m_Scale{ scale }
+		, m_IsWorldMatrixDirty{ true }
+		, m_IsInverseWorldMatrixDirty{ true }
+	{
+	}
+
+	const Vector3& Transform::GetPosition() const
+	{
+		return m_Position;
+	}
+
+	const Quaternion& Transform::GetRotation() const
+	{
+		return m_Rotation;
+	}
+
+	const Vector3& Transform::GetScale() const
+	{
+		return m_Scale;
+	}
+
+	void Transform::SetPosition(const Vector3& position)
+	{
+		if (AreIdentical(position, m_Position))
+			return;
+
+		m_Position = position;
+		MarkDirty();
+	}
+
+	void Transform::SetRotation(const Quaternion& rotation)
+	{
+		if (rotation == m_Rotation)
+			return;
+
+		m_Rotation = rotation;
+		MarkDirty();
+	}
+
+	void Transform::SetScale(const Vector3& scale)
+	{
+		if (AreIdentical(scale, m_Scale))
+			return;
+
+		m_Scale = scale;
+		MarkDirty();
+	}
+
+	void Transform::SetScale(float scale)
+	{
+		SetScale({ scale, scale, scale });
+	}
+
+	void Transform::Translate(const Vector3& translation)
+	{
+		SetPosition(m_Position + translation);
+	}
+
+	void Transform::Rotate(const Quaternion& rotation)
+	{
+		//Renormalize so repeated small rotations do not drift away from unit length
+		SetRotation((m_Rotation * rotation).Normalized());
+	}
+
+	Vector3 Transform::GetForward() const
+	{
+		return m_Rotation.Rotate(Vector3::UnitZ);
+	}
+
+	Vector3 Transform::GetRight() const
+	{
+		return m_Rotation.Rotate(Vector3::UnitX);
+	}
+
+	Vector3 Transform::GetUp() const
+	{
+		return m_Rotation.Rotate(Vector3::UnitY);
+	}
+
+	Vector3 Transform::TransformPoint(const Vector3& point) const
+	{
+		return m_Rotation.Rotate({ point.x * m_Scale.x, point.y * m_Scale.y, point.z * m_Scale.z }) + m_Position;
+	}
+
+	const Matrix& Transform::GetWorldMatrix() const
+	{
+		if (m_IsWorldMatrixDirty)
+		{
+			const Matrix rotation = m_Rotation.ToMatrix();
+			m_WorldMatrix = {
+				rotation.GetAxisX() * m_Scale.x,
+				rotation.GetAxisY() * m_Scale.y,
+				rotation.GetAxisZ() * m_Scale.z,
+				m_Position
+			};
+			m_IsWorldMatrixDirty = false;
+		}
+		return m_WorldMatrix;
+	}
+
+	const Matrix& Transform::GetInverseWorldMatrix() const
+	{
+		if (m_IsInverseWorldMatrixDirty)
+		{
+			//(S * R * T)^-1 = T^-1 * R^T * S^-1, element (i, j) of the 3x3 part is R[j][i] / s[j]
+			const Matrix rotation = m_Rotation.ToMatrix();
+			const Vector3 axisX = rotation.GetAxisX() / m_Scale.x;
+			const Vector3 axisY = rotation.GetAxisY() / m_Scale.y;
+			const Vector3 axisZ = rotation.GetAxisZ() / m_Scale.z;
+
+			m_InverseWorldMatrix = {
+				{ axisX.x, axisY.x, axisZ.x },
+				{ axisX.y, axisY.y, axisZ.y },
+				{ axisX.z, axisY.z, axisZ.z },
+				{ -Vector3::Dot(m_Position, axisX), -Vector3::Dot(m_Position, axisY), -Vector3::Dot(m_Position, axisZ) }
+			};
+			m_IsInverseWorldMatrixDirty = false;
+		}
+		return m_InverseWorldMatrix;
+	}
+
+	Transform Transform::operator*(const Transform& parent) const
+	{
+		const Vector3 scale{ m_Scale.x * parent.m_Scale.x, m_Scale.y * parent.m_Scale.y, m_Scale.z * parent.m_Scale.z };
+		return Transform{ parent.TransformPoint(m_Position), m_Rotation * parent.m_Rotation, scale };
+	}
+
+	void Transform::MarkDirty()
+	{
+		m_IsWorldMatrixDirty = true;
+		m_IsInverseWorldMatrixDirty = true;
+	}
+}
@@ -0,0 +1,54 @@
+#pragma once
+#include "Matrix.h"
+#include "Quaternion.h"
+#include "Vector3.h"
+
+namespace dae
+{
+	// Translation, rotation and scale. The world matrix (scale, then rotate, then translate) and its inverse are cached
+	// and only rebuilt on the first request after an input changed; setting an unchanged value keeps the cache.
+	class Transform final
+	{
+	public:
+		Transform() = default;
+		explicit Transform(const Vector3& position, const Quaternion& rotation = Quaternion::Identity, const Vector3& scale = { 1.0f, 1.0f, 1.0f });
+
+		const Vector3& GetPosition() const;
+		const Quaternion& GetRotation() const;
+		const Vector3& GetScale() const;
+
+		void SetPosition(const Vector3& position);
+		void SetRotation(const Quaternion& rotation);
+		void SetScale(const Vector3& scale);
+		void SetScale(float scale);
+
+		void Translate(const Vector3& translation);
+		// Applied after the current rotation
+		void Rotate(const Quaternion& rotation);
+
+		Vector3 GetForward() const;
+		Vector3 GetRight() const;
+		Vector3 GetUp() const;
+
+		Vector3 TransformPoint(const Vector3& point) const;
+
+		const Matrix& GetWorldMatrix() const;
+		// Built from the parts instead of a general inverse, for a camera this is the view matrix
+		const Matrix& GetInverseWorldMatrix() const;
+
+		// This transform inside parent. Exact unless parent scales non uniformly and this transform is rotated.
+		Transform operator*(const Transform& parent) const;
+
+	private:
+		Vector3 m_Position{};
+		Quaternion m_Rotation{};
+		Vector3 m_Scale{ 1.0f, 1.0f, 1.0f };
+
+		mutable Matrix m_WorldMatrix{};
+		mutable Matrix m_InverseWorldMatrix{};
+		mutable bool m_IsWorldMatrixDirty{ false };
+		mutable bool m_IsInverseWorldMatrixDirty{ false };
+
+		void MarkDirty();
+	};
+}
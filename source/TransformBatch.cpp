@@ -0,0 +1,463 @@
+#include "TransformBatch.h"
+#include "Matrix.h"
+
+#include <algorithm>
+#include <cassert>
+#include <chrono>
+#include <cstring>
+#include <iostream>
+#include <random>
+#include <vector>
+
+#if defined(DAE_MATH_SSE2)
+#include <immintrin.h>
+#endif
+
+#if defined(__GNUC__) || defined(__clang__)
+#define TARGET_AVX __attribute__((target("avx")))
+#else
+#define TARGET_AVX
+#endif
+
+namespace dae
+{
+	namespace TransformBatch
+	{
+		namespace
+		{
+			enum class Mode
+			{
+				Point,
+				Vector,
+				Project
+			};
+
+			// Viewport as screen = ndc * scale + offset, y flipped
+			struct Mapping
+			{
+				float scaleX{ 1.0f };
+				float offsetX{ 0.0f };
+				float scaleY{ 1.0f };
+				float offsetY{ 0.0f };
+				float scaleZ{ 1.0f };
+				float offsetZ{ 0.0f };
+			};
+
+			Mapping CreateMapping(const Viewport& viewport)
+			{
+				return {
+					0.5f * viewport.width, viewport.x + 0.5f * viewport.width,
+					-0.5f * viewport.height, viewport.y + 0.5f * viewport.height,
+					viewport.maxDepth - viewport.minDepth, viewport.minDepth
+				};
+			}
+
+			//Same evaluation order as MatrixSIMD::Transform, the SIMD kernels below follow it lane by lane
+			template<Mode mode>
+			void TransformOne(const float* pM, const Mapping& mapping, float x, float y, float z, float& outX, float& outY, float& outZ)
+			{
+				if constexpr (mode == Mode::Vector)
+				{
+					outX = pM[0] * x + pM[4] * y + pM[8] * z;
+					outY = pM[1] * x + pM[5] * y + pM[9] * z;
+					outZ = pM[2] * x + pM[6] * y + pM[10] * z;
+				}
+				else
+				{
+					const float clipX = pM[0] * x + pM[4] * y + pM[8] * z + pM[12];
+					const float clipY = pM[1] * x + pM[5] * y + pM[9] * z + pM[13];
+					const float clipZ = pM[2] * x + pM[6] * y + pM[10] * z + pM[14];
+
+					if constexpr (mode == Mode::Point)
+					{
+						outX = clipX;
+						outY = clipY;
+						outZ = clipZ;
+					}
+					else
+					{
+						const float invW = 1.0f / (pM[3] * x + pM[7] * y + pM[11] * z + pM[15]);
+						outX = clipX * invW * mapping.scaleX + mapping.offsetX;
+						outY = clipY * invW * mapping.scaleY + mapping.offsetY;
+						outZ = clipZ * invW * mapping.scaleZ + mapping.offsetZ;
+					}
+				}
+			}
+
+			template<Mode mode>
+			void TransformSoAScalar(const float* pM, const Mapping& mapping, const PointsSoA& points, const OutputSoA& result, size_t first)
+			{
+				for (size_t i = first; i < points.x.size(); ++i)
+				{
+					TransformOne<mode>(pM, mapping, points.x[i], points.y[i], points.z[i], result.x[i], result.y[i], result.z[i]);
+				}
+			}
+
+			template<Mode mode>
+			void TransformAoSScalar(const float* pM, const Mapping& mapping, std::span<const Vector3> points, std::span<Vector3> result, size_t first)
+			{
+				for (size_t i = first; i < points.size(); ++i)
+				{
+					const Vector3 point = points[i];
+					TransformOne<mode>(pM, mapping, point.x, point.y, point.z, result[i].x, result[i].y, result[i].z);
+				}
+			}
+
+#if defined(DAE_MATH_SSE2)
+#pragma region SSE2
+			struct ColumnsSSE2
+			{
+				__m128 m[16];
+				__m128 scale[3];
+				__m128 offset[3];
+			};
+
+			ColumnsSSE2 BroadcastSSE2(const float* pM, const Mapping& mapping)
+			{
+				ColumnsSSE2 columns{};
+				for (int i = 0; i < 16; ++i)
+				{
+					columns.m[i] = _mm_set1_ps(pM[i]);
+				}
+				columns.scale[0] = _mm_set1_ps(mapping.scaleX);
+				columns.scale[1] = _mm_set1_ps(mapping.scaleY);
+				columns.scale[2] = _mm_set1_ps(mapping.scaleZ);
+				columns.offset[0] = _mm_set1_ps(mapping.offsetX);
+				columns.offset[1] = _mm_set1_ps(mapping.offsetY);
+				columns.offset[2] = _mm_set1_ps(mapping.offsetZ);
+				return columns;
+			}
+
+			template<Mode mode>
+			void TransformSSE2(const ColumnsSSE2& c, __m128 x, __m128 y, __m128 z, __m128& outX, __m128& outY, __m128& outZ)
+			{
+				__m128 clip[3];
+				for (int column = 0; column < 3; ++column)
+				{
+					clip[column] = _mm_mul_ps(c.m[0 + column], x);
+					clip[column] = _mm_add_ps(clip[column], _mm_mul_ps(c.m[4 + column], y));
+					clip[column] = _mm_add_ps(clip[column], _mm_mul_ps(c.m[8 + column], z));
+					if constexpr (mode != Mode::Vector)
+					{
+						clip[column] = _mm_add_ps(clip[column], c.m[12 + column]);
+					}
+				}
+
+				if constexpr (mode == Mode::Project)
+				{
+					__m128 w = _mm_mul_ps(c.m[3], x);
+					w = _mm_add_ps(w, _mm_mul_ps(c.m[7], y));
+					w = _mm_add_ps(w, _mm_mul_ps(c.m[11], z));
+					w = _mm_add_ps(w, c.m[15]);
+					const __m128 invW = _mm_div_ps(_mm_set1_ps(1.0f), w);
+
+					for (int column = 0; column < 3; ++column)
+					{
+						clip[column] = _mm_add_ps(_mm_mul_ps(_mm_mul_ps(clip[column], invW), c.scale[column]), c.offset[column]);
+					}
+				}
+
+				outX = clip[0];
+				outY = clip[1];
+				outZ = clip[2];
+			}
+
+			template<Mode mode>
+			void TransformSoASSE2(const float* pM, const Mapping& mapping, const PointsSoA& points, const OutputSoA& result)
+			{
+				const ColumnsSSE2 columns = BroadcastSSE2(pM, mapping);
+				const size_t count = points.x.size();
+
+				size_t i{ 0 };
+				for (; i + 4 <= count; i += 4)
+				{
+					__m128 x, y, z;
+					TransformSSE2<mode>(columns, _mm_loadu_ps(&points.x[i]), _mm_loadu_ps(&points.y[i]), _mm_loadu_ps(&points.z[i]), x, y, z);
+					_mm_storeu_ps(&result.x[i], x);
+					_mm_storeu_ps(&result.y[i], y);
+					_mm_storeu_ps(&result.z[i], z);
+				}
+
+				TransformSoAScalar<mode>(pM, mapping, points, result, i);
+			}
+
+			template<Mode mode>
+			void TransformAoSSSE2(const float* pM, const Mapping& mapping, std::span<const Vector3> points, std::span<Vector3> result)
+			{
+				const ColumnsSSE2 columns = BroadcastSSE2(pM, mapping);
+				const size_t count = points.size();
+
+				//Every 16 byte load reads the x of the next point as well, so the loop stops one point early.
+				//That x comes back out of the transpose as the fourth row and is stored unchanged, which keeps in place calls safe.
+				size_t i{ 0 };
+				for (; i + 4 < count; i += 4)
+				{
+					const float* pSrc = &points[i].x;
+					__m128 p0 = _mm_loadu_ps(pSrc + 0);
+					__m128 p1 = _mm_loadu_ps(pSrc + 3);
+					__m128 p2 = _mm_loadu_ps(pSrc + 6);
+					__m128 p3 = _mm_loadu_ps(pSrc + 9);
+					_MM_TRANSPOSE4_PS(p0, p1, p2, p3);
+
+					__m128 x, y, z;
+					TransformSSE2<mode>(columns, p0, p1, p2, x, y, z);
+					_MM_TRANSPOSE4_PS(x, y, z, p3);
+
+					float* pDst = &result[i].x;
+					_mm_storeu_ps(pDst + 0, x);
+					_mm_storeu_ps(pDst + 3, y);
+					_mm_storeu_ps(pDst + 6, z);
+					_mm_storeu_ps(pDst + 9, p3);
+				}
+
+				TransformAoSScalar<mode>(pM, mapping, points, result, i);
+			}
+#pragma endregion
+
+#pragma region AVX
+			template<Mode mode>
+			TARGET_AVX void TransformSoAAVX(const float* pM, const Mapping& mapping, const PointsSoA& points, const OutputSoA& result)
+			{
+				__m256 m[16];
+				for (int j = 0; j < 16; ++j)
+				{
+					m[j] = _mm256_set1_ps(pM[j]);
+				}
+				const __m256 scale[3]{ _mm256_set1_ps(mapping.scaleX), _mm256_set1_ps(mapping.scaleY), _mm256_set1_ps(mapping.scaleZ) };
+				const __m256 offset[3]{ _mm256_set1_ps(mapping.offsetX), _mm256_set1_ps(mapping.offsetY), _mm256_set1_ps(mapping.offsetZ) };
+
+				const size_t count = points.x.size();
+
+				size_t i{ 0 };
+				for (; i + 8 <= count; i += 8)
+				{
+					const __m256 x = _mm256_loadu_ps(&points.x[i]);
+					const __m256 y = _mm256_loadu_ps(&points.y[i]);
+					const __m256 z = _mm256_loadu_ps(&points.z[i]);
+
+					__m256 clip[3];
+					for (int column = 0; column < 3; ++column)
+					{
+						clip[column] = _mm256_mul_ps(m[0 + column], x);
+						clip[column] = _mm256_add_ps(clip[column], _mm256_mul_ps(m[4 + column], y));
+						clip[column] = _mm256_add_ps(clip[column], _mm256_mul_ps(m[8 + column], z));
+						if constexpr (mode != Mode::Vector)
+						{
+							clip[column] = _mm256_add_ps(clip[column], m[12 + column]);
+						}
+					}
+
+					if constexpr (mode == Mode::Project)
+					{
+						__m256 w = _mm256_mul_ps(m[3], x);
+						w = _mm256_add_ps(w, _mm256_mul_ps(m[7], y));
+						w = _mm256_add_ps(w, _mm256_mul_ps(m[11], z));
+						w = _mm256_add_ps(w, m[15]);
+						const __m256 invW = _mm256_div_ps(_mm256_set1_ps(1.0f), w);
+
+						for (int column = 0; column < 3; ++column)
+						{
+							clip[column] = _mm256_add_ps(_mm256_mul_ps(_mm256_mul_ps(clip[column], invW), scale[column]), offset[column]);
+						}
+					}
+
+					_mm256_storeu_ps(&result.x[i], clip[0]);
+					_mm256_storeu_ps(&result.y[i], clip[1]);
+					_mm256_storeu_ps(&result.z[i], clip[2]);
+				}
+
+				TransformSoAScalar<mode>(pM, mapping, points, result, i);
+			}
+#pragma endregion
+#endif
+
+			template<Mode mode>
+			void DispatchSoA(const Matrix& matrix, const Mapping& mapping, const PointsSoA& points, const OutputSoA& result, InstructionSet instructionSet)
+			{
+				assert(points.y.size() == points.x.size() && points.z.size() == points.x.size());
+				assert(result.x.size() >= points.x.size() && result.y.size() >= points.x.size() && result.z.size() >= points.x.size());
+
+				switch (instructionSet)
+				{
+#if defined(DAE_MATH_SSE2)
+					case InstructionSet::SSE2:	TransformSoASSE2<mode>(matrix.GetData(), mapping, points, result); return;
+					case InstructionSet::AVX:	TransformSoAAVX<mode>(matrix.GetData(), mapping, points, result); return;
+#endif
+					default:					TransformSoAScalar<mode>(matrix.GetData(), mapping, points, result, 0); return;
+				}
+			}
+
+			template<Mode mode>
+			void DispatchAoS(const Matrix& matrix, const Mapping& mapping, std::span<const Vector3> points, std::span<Vector3> result, InstructionSet instructionSet)
+			{
+				assert(result.size() >= points.size());
+
+				switch (instructionSet)
+				{
+#if defined(DAE_MATH_SSE2)
+					//Deinterleaving 8 points costs more than it gains, AVX uses the SSE2 kernel
+					case InstructionSet::SSE2:
+					case InstructionSet::AVX:	TransformAoSSSE2<mode>(matrix.GetData(), mapping, points, result); return;
+#endif
+					default:					TransformAoSScalar<mode>(matrix.GetData(), mapping, points, result, 0); return;
+				}
+			}
+		}
+
+		void TransformPoints(const Matrix& matrix, const PointsSoA& points, const OutputSoA& result, InstructionSet instructionSet)
+		{
+			DispatchSoA<Mode::Point>(matrix, {}, points, result, instructionSet);
+		}
+
+		void TransformPoints(const Matrix& matrix, std::span<const Vector3> points, std::span<Vector3> result, InstructionSet instructionSet)
+		{
+			DispatchAoS<Mode::Point>(matrix, {}, points, result, instructionSet);
+		}
+
+		void TransformVectors(const Matrix& matrix, const PointsSoA& vectors, const OutputSoA& result, InstructionSet instructionSet)
+		{
+			DispatchSoA<Mode::Vector>(matrix, {}, vectors, result, instructionSet);
+		}
+
+		void TransformVectors(const Matrix& matrix, std::span<const Vector3> vectors, std::span<Vector3> result, InstructionSet instructionSet)
+		{
+			DispatchAoS<Mode::Vector>(matrix, {}, vectors, result, instructionSet);
+		}
+
+		void ProjectPoints(const Matrix& worldViewProjection, const PointsSoA& points, const Viewport& viewport, const OutputSoA& result, InstructionSet instructionSet)
+		{
+			DispatchSoA<Mode::Project>(worldViewProjection, CreateMapping(viewport), points, result, instructionSet);
+		}
+
+		void ProjectPoints(const Matrix& worldViewProjection, std::span<const Vector3> points, const Viewport& viewport, std::span<Vector3> result, InstructionSet instructionSet)
+		{
+			DispatchAoS<Mode::Project>(worldViewProjection, CreateMapping(viewport), points, result, instructionSet);
+		}
+
+		void Benchmark()
+		{
+			using Clock = std::chrono::high_resolution_clock;
+
+			//Not a multiple of 8 so the scalar tails are covered too
+			constexpr size_t numPoints{ 1'000'003 };
+			constexpr int numRepetitions{ 10 };
+
+			std::mt19937 random{ 1337 };
+			std::uniform_real_distribution<float> positionDistribution{ -10.0f, 10.0f };
+
+			std::vector<Vector3> points(numPoints);
+			std::vector<float> x(numPoints), y(numPoints), z(numPoints);
+			for (size_t i = 0; i < numPoints; ++i)
+			{
+				points[i] = { positionDistribution(random), positionDistribution(random), positionDistribution(random) };
+				x[i] = points[i].x;
+				y[i] = points[i].y;
+				z[i] = points[i].z;
+			}
+
+			//Camera in front of the cloud so every w is positive
+			const Matrix world = Matrix::CreateRotation(0.3f, 0.7f, -0.2f) * Matrix::CreateTranslation(1.0f, 2.0f, 3.0f);
+			const Matrix view = Matrix::InverseAffine(Matrix::CreateTranslation(0.0f, 0.0f, -40.0f));
+			const Matrix worldViewProjection = world * view * Matrix::CreatePerspectiveFovLH(0.5f, 16.0f / 9.0f, 0.1f, 100.0f);
+			const Viewport viewport{ 0.0f, 0.0f, 1280.0f, 720.0f, 0.0f, 1.0f };
+
+			std::vector<Vector3> expected(numPoints);
+			std::vector<Vector3> resultAoS(numPoints);
+			std::vector<float> resultX(numPoints), resultY(numPoints), resultZ(numPoints);
+
+			const PointsSoA pointsSoA{ x, y, z };
+			const OutputSoA outputSoA{ resultX, resultY, resultZ };
+
+			std::vector<InstructionSet> instructionSets;
+			for (InstructionSet instructionSet : { InstructionSet::Scalar, InstructionSet::SSE2, InstructionSet::AVX })
+			{
+				if (MatrixSIMD::IsSupported(instructionSet))
+				{
+					instructionSets.push_back(instructionSet);
+				}
+			}
+
+			const auto millionPointsPerSecond = [](const Clock::time_point& start)
+			{
+				const float seconds = std::chrono::duration<float>(Clock::now() - start).count();
+				return static_cast<float>(numPoints) * numRepetitions / seconds / 1'000'000.0f;
+			};
+
+			const auto isEqual = [&](size_t i)
+			{
+				const Vector3 aos = resultAoS[i];
+				return aos.x == expected[i].x && aos.y == expected[i].y && aos.z == expected[i].z
+					&& resultX[i] == expected[i].x && resultY[i] == expected[i].y && resultZ[i] == expected[i].z;
+			};
+
+			std::cout << "Transforming " << numPoints << " points, million points per second\n";
+
+			for (Mode mode : { Mode::Point, Mode::Vector, Mode::Project })
+			{
+				const char* pName = mode == Mode::Point ? "TransformPoints" : mode == Mode::Vector ? "TransformVectors" : "ProjectPoints";
+				const Mapping mapping = CreateMapping(viewport);
+
+				//Reference: one Matrix call per point, then the same divide and viewport mapping
+				Clock::time_point start = Clock::now();
+				for (int repetition = 0; repetition < numRepetitions; ++repetition)
+				{
+					for (size_t i = 0; i < numPoints; ++i)
+					{
+						if (mode == Mode::Point)
+						{
+							expected[i] = world.TransformPoint(points[i]);
+						}
+						else if (mode == Mode::Vector)
+						{
+							expected[i] = world.TransformVector(points[i]);
+						}
+						else
+						{
+							const Vector4 clip = worldViewProjection.TransformPoint(Vector4{ points[i], 1.0f });
+							const float invW = 1.0f / clip.w;
+							expected[i] = {
+								clip.x * invW * mapping.scaleX + mapping.offsetX,
+								clip.y * invW * mapping.scaleY + mapping.offsetY,
+								clip.z * invW * mapping.scaleZ + mapping.offsetZ
+							};
+						}
+					}
+				}
+				std::cout << "  " << pName << " Matrix: " << millionPointsPerSecond(start) << "\n";
+
+				for (InstructionSet instructionSet : instructionSets)
+				{
+					float soaThroughput{};
+					float aosThroughput{};
+
+					start = Clock::now();
+					for (int repetition = 0; repetition < numRepetitions; ++repetition)
+					{
+						if (mode == Mode::Point) TransformPoints(world, pointsSoA, outputSoA, instructionSet);
+						else if (mode == Mode::Vector) TransformVectors(world, pointsSoA, outputSoA, instructionSet);
+						else ProjectPoints(worldViewProjection, pointsSoA, viewport, outputSoA, instructionSet);
+					}
+					soaThroughput = millionPointsPerSecond(start);
+
+					start = Clock::now();
+					for (int repetition = 0; repetition < numRepetitions; ++repetition)
+					{
+						if (mode == Mode::Point) TransformPoints(world, points, resultAoS, instructionSet);
+						else if (mode == Mode::Vector) TransformVectors(world, points, resultAoS, instructionSet);
+						else ProjectPoints(worldViewProjection, points, viewport, resultAoS, instructionSet);
+					}
+					aosThroughput = millionPointsPerSecond(start);
+
+					bool isValid{ true };
+					for (size_t i = 0; i < numPoints && isValid; ++i)
+					{
+						isValid = isEqual(i);
+					}
+
+					std::cout << "  " << pName << " " << MatrixSIMD::GetName(instructionSet) << ": SoA " << soaThroughput << ", AoS " << aosThroughput
+						<< (isValid ? "" : " MISMATCH") << "\n";
+				}
+			}
+		}
+	}
+}
@@ -0,0 +1,60 @@
+#pragma once
+
+#include "MatrixSIMD.h"
+
+#include <span>
+
+namespace dae
+{
+	struct Matrix;
+	struct Vector3;
+
+	// Transforms many points at once. SoA input is 4 (SSE2) or 8 (AVX) points per iteration, AoS is deinterleaved 4 at a time.
+	// Every output span must be at least as long as the input, results are bit identical to Matrix::TransformPoint.
+	namespace TransformBatch
+	{
+		using MatrixSIMD::InstructionSet;
+
+		// Target rectangle in pixels, y grows downwards like D3D11_VIEWPORT
+		struct Viewport
+		{
+			float x{ 0.0f };
+			float y{ 0.0f };
+			float width{ 1.0f };
+			float height{ 1.0f };
+			float minDepth{ 0.0f };
+			float maxDepth{ 1.0f };
+		};
+
+		// Structure of arrays, all spans have the same length
+		struct PointsSoA
+		{
+			std::span<const float> x;
+			std::span<const float> y;
+			std::span<const float> z;
+		};
+
+		struct OutputSoA
+		{
+			std::span<float> x;
+			std::span<float> y;
+			std::span<float> z;
+		};
+
+		// (x, y, z, 1) * M, the w row is ignored
+		void TransformPoints(const Matrix& matrix, const PointsSoA& points, const OutputSoA& result, InstructionSet instructionSet = MatrixSIMD::CompiledInstructionSet);
+		void TransformPoints(const Matrix& matrix, std::span<const Vector3> points, std::span<Vector3> result, InstructionSet instructionSet = MatrixSIMD::CompiledInstructionSet);
+
+		// (x, y, z, 0) * M, no translation
+		void TransformVectors(const Matrix& matrix, const PointsSoA& vectors, const OutputSoA& result, InstructionSet instructionSet = MatrixSIMD::CompiledInstructionSet);
+		void TransformVectors(const Matrix& matrix, std::span<const Vector3> vectors, std::span<Vector3> result, InstructionSet instructionSet = MatrixSIMD::CompiledInstructionSet);
+
+		// Clip space, perspective divide and viewport mapping: x/y in pixels, z in [minDepth, maxDepth].
+		// Points on or behind the camera plane (w <= 0) are not meaningful, cull them first.
+		void ProjectPoints(const Matrix& worldViewProjection, const PointsSoA& points, const Viewport& viewport, const OutputSoA& result, InstructionSet instructionSet = MatrixSIMD::CompiledInstructionSet);
+		void ProjectPoints(const Matrix& worldViewProjection, std::span<const Vector3> points, const Viewport& viewport, std::span<Vector3> result, InstructionSet instructionSet = MatrixSIMD::CompiledInstructionSet);
+
+		// Verifies against the one point at a time Matrix path and prints the throughput in million points per second
+		void Benchmark();
+	}
+}
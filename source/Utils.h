@@ -1,16 +1,60 @@
 #pragma once
+#include <chrono>
 #include <fstream>
 #include <vector>
 #include "Math.h"
-#include "Mesh.h"
+#include "VectorBatch.h"
+#include "Vertex.h"
 
 namespace dae
 {
 	namespace Utils
 	{
-		//Just parses vertices and indices
 #pragma warning(push)
 #pragma warning(disable : 4505) //Warning unreferenced local function
+		//Cheap per vertex tangents: the triangle tangents are summed per vertex, then made orthonormal to the normal
+		static void CalculateTangents(std::vector<Vertex>& vertices, const std::vector<uint32_t>& indices,
+			VectorBatch::Precision precision = VectorBatch::Precision::Fast, MatrixSIMD::InstructionSet instructionSet = MatrixSIMD::CompiledInstructionSet)
+		{
+			for (auto& v : vertices)
+			{
+				v.tangent = {};
+			}
+
+			//Cheap Tangent Calculations
+			for (uint32_t i = 0; i < indices.size(); i += 3)
+			{
+				uint32_t index0 = indices[i];
+				uint32_t index1 = indices[size_t(i) + 1];
+				uint32_t index2 = indices[size_t(i) + 2];
+
+				const Vector3& p0 = vertices[index0].position;
+				const Vector3& p1 = vertices[index1].position;
+				const Vector3& p2 = vertices[index2].position;
+				const Vector2& uv0 = vertices[index0].texCoord;
+				const Vector2& uv1 = vertices[index1].texCoord;
+				const Vector2& uv2 = vertices[index2].texCoord;
+
+				const Vector3 edge0 = p1 - p0;
+				const Vector3 edge1 = p2 - p0;
+				const Vector2 diffX = Vector2(uv1.x - uv0.x, uv2.x - uv0.x);
+				const Vector2 diffY = Vector2(uv1.y - uv0.y, uv2.y - uv0.y);
+				float r = 1.f / Vector2::Cross(diffX, diffY);
+
+				Vector3 tangent = (edge0 * diffY.y - edge1 * diffY.x) * r;
+				vertices[index0].tangent += tangent;
+				vertices[index1].tangent += tangent;
+				vertices[index2].tangent += tangent;
+			}
+
+			//Create the Tangents (reject), batched straight on the vertex array
+			if (!vertices.empty())
+			{
+				VectorBatch::RejectNormalize(&vertices[0].tangent, &vertices[0].normal, vertices.size(), sizeof(Vertex), precision, instructionSet);
+			}
+		}
+
+		//Just parses vertices and indices
 		static bool ParseOBJ(const std::string& filename, std::vector<Vertex>& vertices, std::vector<uint32_t>& indices, bool flipAxisAndWinding = true)
 		{
 			std::ifstream file(filename);
@@ -118,48 +162,67 @@ namespace dae
 				file.ignore(1000, '\n');
 			}
 
-			//Cheap Tangent Calculations
-			for (uint32_t i = 0; i < indices.size(); i += 3)
-			{
-				uint32_t index0 = indices[i];
-				uint32_t index1 = indices[size_t(i) + 1];
-				uint32_t index2 = indices[size_t(i) + 2];
-
-				const Vector3& p0 = vertices[index0].position;
-				const Vector3& p1 = vertices[index1].position;
-				const Vector3& p2 = vertices[index2].position;
-				const Vector2& uv0 = vertices[index0].texCoord;
-				const Vector2& uv1 = vertices[index1].texCoord;
-				const Vector2& uv2 = vertices[index2].texCoord;
+			CalculateTangents(vertices, indices);
 
-				const Vector3 edge0 = p1 - p0;
-				const Vector3 edge1 = p2 - p0;
-				const Vector2 diffX = Vector2(uv1.x - uv0.x, uv2.x - uv0.x);
-				const Vector2 diffY = Vector2(uv1.y - uv0.y, uv2.y - uv0.y);
-				float r = 1.f / Vector2::Cross(diffX, diffY);
-
-				Vector3 tangent = (edge0 * diffY.y - edge1 * diffY.x) * r;
-				vertices[index0].tangent += tangent;
-				vertices[index1].tangent += tangent;
-				vertices[index2].tangent += tangent;
-			}
-
-			//Create the Tangents (reject)
-			for (auto& v : vertices)
+			if (flipAxisAndWinding)
 			{
-				v.tangent = Vector3::Reject(v.tangent, v.normal).Normalized();
-
-				if(flipAxisAndWinding)
+				for (auto& v : vertices)
 				{
 					v.position.z *= -1.f;
 					v.normal.z *= -1.f;
 					v.tangent.z *= -1.f;
 				}
-
 			}
 
 			return true;
 		}
+		//Times CalculateTangents on a mesh per instruction set and precision, and the largest deviation from the Vector3 path
+		static void BenchmarkTangents(const std::string& filename)
+		{
+			using Clock = std::chrono::high_resolution_clock;
+			constexpr int numRepetitions{ 50 };
+
+			std::vector<Vertex> vertices;
+			std::vector<uint32_t> indices;
+			if (!ParseOBJ(filename, vertices, indices, false))
+			{
+				std::cout << "Failed to load " << filename << "!\n";
+				return;
+			}
+
+			std::vector<Vertex> expected{ vertices };
+			CalculateTangents(expected, indices, VectorBatch::Precision::Precise, MatrixSIMD::InstructionSet::Scalar);
+
+			std::cout << "Tangent pass of " << filename << " (" << vertices.size() << " vertices), ms per pass and max tangent deviation\n";
+			for (MatrixSIMD::InstructionSet instructionSet : { MatrixSIMD::InstructionSet::Scalar, MatrixSIMD::InstructionSet::SSE2, MatrixSIMD::InstructionSet::AVX })
+			{
+				if (!MatrixSIMD::IsSupported(instructionSet))
+					continue;
+
+				for (VectorBatch::Precision precision : { VectorBatch::Precision::Fast, VectorBatch::Precision::Precise })
+				{
+					if (instructionSet == MatrixSIMD::InstructionSet::Scalar && precision == VectorBatch::Precision::Fast)
+						continue;
+
+					const Clock::time_point start = Clock::now();
+					for (int repetition = 0; repetition < numRepetitions; ++repetition)
+					{
+						CalculateTangents(vertices, indices, precision, instructionSet);
+					}
+					const float milliseconds = std::chrono::duration<float, std::milli>(Clock::now() - start).count() / numRepetitions;
+
+					float maxDeviation{};
+					for (size_t i = 0; i < vertices.size(); ++i)
+					{
+						const Vector3 difference = vertices[i].tangent - expected[i].tangent;
+						maxDeviation = std::max({ maxDeviation, std::abs(difference.x), std::abs(difference.y), std::abs(difference.z) });
+					}
+
+					std::cout << "  " << MatrixSIMD::GetName(instructionSet) << (precision == VectorBatch::Precision::Fast ? " fast: " : " precise: ")
+						<< milliseconds << " ms, deviation " << maxDeviation << "\n";
+				}
+			}
+		}
 #pragma warning(pop)
 	}
 }
\ No newline at end of file
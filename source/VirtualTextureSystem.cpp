@@ -0,0 +1,285 @@
+#include "VirtualTextureSystem.h"
+
+#include <algorithm>
+#include <chrono>
+#include <iostream>
+#include <random>
+
+namespace dae
+{
+	namespace
+	{
+		using Clock = std::chrono::high_resolution_clock;
+
+		float MillisecondsSince(const Clock::time_point& start)
+		{
+			return std::chrono::duration<float, std::milli>(Clock::now() - start).count();
+		}
+	}
+
+	VirtualTextureSystem::VirtualTextureSystem(uint32_t numPhysicalPages, uint32_t pageSize, PageLoader pageLoader)
+		: m_PageSize{ std::max(pageSize, 1u) }
+		, m_PageLoader{ std::move(pageLoader) }
+		, m_Cache{ numPhysicalPages }
+	{
+	}
+
+	uint32_t VirtualTextureSystem::AddTexture(uint32_t width, uint32_t height)
+	{
+		if (m_PageTables.size() >= MaxVirtualTextures)
+		{
+			std::cout << "Failed to add virtual texture, the maximum of " << MaxVirtualTextures << " is reached!\n";
+			return InvalidPage;
+		}
+
+		const uint32_t textureId = static_cast<uint32_t>(m_PageTables.size());
+		m_PageTables.push_back(std::make_unique<PageTable>((width + m_PageSize - 1) / m_PageSize, (height + m_PageSize - 1) / m_PageSize));
+
+		//The single page of the coarsest mip stays resident, it is the fallback of every other page
+		const PageId coarsestPage{ textureId, m_PageTables.back()->GetMipCount() - 1, 0, 0 };
+		Load(coarsestPage, coarsestPage.Pack(), true);
+
+		return textureId;
+	}
+
+	uint32_t VirtualTextureSystem::GetNumTextures() const
+	{
+		return static_cast<uint32_t>(m_PageTables.size());
+	}
+
+	uint32_t VirtualTextureSystem::GetPageSize() const
+	{
+		return m_PageSize;
+	}
+
+	const PageTable& VirtualTextureSystem::GetPageTable(uint32_t textureId) const
+	{
+		return *m_PageTables[textureId];
+	}
+
+	const PhysicalPageCache& VirtualTextureSystem::GetCache() const
+	{
+		return m_Cache;
+	}
+
+	void VirtualTextureSystem::Update(const uint32_t* pFeedback, size_t numTexels, uint32_t maxLoads)
+	{
+		++m_Frame;
+
+		const Clock::time_point reduceStart = Clock::now();
+		const std::vector<FeedbackAnalyzer::PageRequest>& requests = m_FeedbackAnalyzer.Reduce(pFeedback, numTexels);
+
+		//A resident page keeps itself alive, a missing one needs its closest resident ancestor as fallback
+		m_MissingPages.clear();
+		for (const FeedbackAnalyzer::PageRequest& request : requests)
+		{
+			if (!IsValid(request.page))
+				continue;
+
+			for (PageId page = request.page; page.mip < m_PageTables[page.textureId]->GetMipCount(); page = page.GetParent())
+			{
+				const uint32_t pageKey = page.Pack();
+				const uint32_t slot = m_Cache.Find(pageKey);
+				if (slot != InvalidPage)
+				{
+					m_Cache.Touch(slot, m_Frame);
+					break;
+				}
+
+				m_MissingPages.push_back({ page, pageKey, request.count });
+			}
+		}
+
+		//Siblings share their ancestors, merge those before prioritizing
+		std::sort(m_MissingPages.begin(), m_MissingPages.end(), [](const auto& a, const auto& b) { return a.pageKey < b.pageKey; });
+		size_t numMissing{ 0 };
+		for (size_t i = 0; i < m_MissingPages.size(); ++i)
+		{
+			if (numMissing > 0 && m_MissingPages[numMissing - 1].pageKey == m_MissingPages[i].pageKey)
+			{
+				m_MissingPages[numMissing - 1].count += m_MissingPages[i].count;
+			}
+			else
+			{
+				m_MissingPages[numMissing++] = m_MissingPages[i];
+			}
+		}
+		m_MissingPages.resize(numMissing);
+
+		std::sort(m_MissingPages.begin(), m_MissingPages.end(), [](const auto& a, const auto& b)
+		{
+			if (a.page.mip != b.page.mip)
+				return a.page.mip > b.page.mip;
+			return a.count > b.count;
+		});
+
+		m_Statistics.reduceMilliseconds = MillisecondsSince(reduceStart);
+		m_Statistics.numFeedbackTexels = static_cast<uint32_t>(numTexels);
+		m_Statistics.numUniquePages = static_cast<uint32_t>(requests.size());
+		m_Statistics.numMissingPages = static_cast<uint32_t>(m_MissingPages.size());
+		m_Statistics.numDeferredLoads = 0;
+
+		uint32_t numLoads{ 0 };
+		for (const FeedbackAnalyzer::PageRequest& request : m_MissingPages)
+		{
+			if (numLoads == maxLoads)
+			{
+				m_Statistics.numDeferredLoads = static_cast<uint32_t>(m_MissingPages.size()) - numLoads;
+				break;
+			}
+
+			const bool isPinned = request.page.mip == m_PageTables[request.page.textureId]->GetMipCount() - 1;
+			if (!Load(request.page, request.pageKey, isPinned))
+			{
+				//The cache is full with pages of this frame, the rest has to wait
+				m_Statistics.numDeferredLoads = static_cast<uint32_t>(m_MissingPages.size()) - numLoads;
+				break;
+			}
+			++numLoads;
+		}
+	}
+
+	const VirtualTextureSystem::Statistics& VirtualTextureSystem::GetStatistics() const
+	{
+		return m_Statistics;
+	}
+
+	void VirtualTextureSystem::PrintStatistics() const
+	{
+		std::cout << "Virtual texturing: " << m_Cache.GetNumUsedSlots() << "/" << m_Cache.GetNumSlots() << " pages"
+			<< " feedback: " << m_Statistics.numFeedbackTexels << " texels -> " << m_Statistics.numUniquePages << " pages"
+			<< " (" << m_Statistics.reduceMilliseconds << " ms)"
+			<< " missing: " << m_Statistics.numMissingPages
+			<< " loads: " << m_Statistics.numLoads
+			<< " deferred: " << m_Statistics.numDeferredLoads
+			<< " evictions: " << m_Statistics.numEvictions << "\n";
+	}
+
+	bool VirtualTextureSystem::IsValid(const PageId& page) const
+	{
+		return page.textureId < m_PageTables.size() && m_PageTables[page.textureId]->IsInside(page.mip, page.x, page.y);
+	}
+
+	bool VirtualTextureSystem::Load(const PageId& page, uint32_t pageKey, bool isPinned)
+	{
+		uint32_t evictedKey{ InvalidPage };
+		const uint32_t slot = m_Cache.Allocate(pageKey, m_Frame, evictedKey, isPinned);
+		if (slot == InvalidPage)
+			return false;
+
+		if (evictedKey != InvalidPage)
+		{
+			const PageId evictedPage = PageId::Unpack(evictedKey);
+			m_PageTables[evictedPage.textureId]->Unmap(evictedPage.mip, evictedPage.x, evictedPage.y);
+			++m_Statistics.numEvictions;
+		}
+
+		if (!m_PageLoader(page, slot))
+		{
+			m_Cache.Free(slot);
+			return true;
+		}
+
+		m_PageTables[page.textureId]->Map(page.mip, page.x, page.y, slot);
+		++m_Statistics.numLoads;
+		return true;
+	}
+
+	void VirtualTextureSystem::Benchmark()
+	{
+		constexpr uint32_t numTextures{ 16 };
+		constexpr uint32_t textureSize{ 16384 };
+		constexpr uint32_t pageSize{ 128 };
+		constexpr uint32_t numPhysicalPages{ 1024 };
+		constexpr uint32_t maxLoadsPerFrame{ 32 };
+
+		//Feedback is rendered at 1/8 of 1280x720
+		constexpr uint32_t feedbackWidth{ 160 };
+		constexpr uint32_t feedbackHeight{ 90 };
+		constexpr uint32_t numMovingFrames{ 300 };
+		constexpr uint32_t numStaticFrames{ 200 };
+
+		uint32_t numLoaderCalls{ 0 };
+		VirtualTextureSystem system{ numPhysicalPages, pageSize, [&numLoaderCalls](const PageId&, uint32_t) { ++numLoaderCalls; return true; } };
+		for (uint32_t i = 0; i < numTextures; ++i)
+		{
+			system.AddTexture(textureSize, textureSize);
+		}
+
+		std::mt19937 random{ 1337 };
+		std::uniform_int_distribution<uint32_t> jitterDistribution{ 0, 3 };
+
+		//Every screen column band shows another texture, mips get coarser towards the top of the screen like a ground plane
+		std::vector<uint32_t> feedback(feedbackWidth * feedbackHeight);
+		const auto generateFeedback = [&](uint32_t scroll)
+		{
+			for (uint32_t y = 0; y < feedbackHeight; ++y)
+			{
+				const uint32_t mip = std::min((feedbackHeight - 1 - y) / 12, 6u);
+				for (uint32_t x = 0; x < feedbackWidth; ++x)
+				{
+					uint32_t& texel = feedback[y * feedbackWidth + x];
+					if (jitterDistribution(random) == 0)
+					{
+						texel = InvalidPage;
+						continue;
+					}
+
+					const uint32_t textureId = (x / 20) % numTextures;
+					const uint32_t pagesPerAxis = std::max((textureSize / pageSize) >> mip, 1u);
+					const uint32_t pageX = ((x % 20 / 4 + scroll) >> mip) % pagesPerAxis;
+					const uint32_t pageY = ((y / 4 + scroll / 2) >> mip) % pagesPerAxis;
+					texel = PageId{ textureId, mip, pageX, pageY }.Pack();
+				}
+			}
+		};
+
+		//Every mapped page must be the one the cache holds in that slot and vice versa
+		const auto isConsistent = [&system]() -> bool
+		{
+			uint32_t numMapped{ 0 };
+			for (uint32_t textureId = 0; textureId < system.GetNumTextures(); ++textureId)
+			{
+				const PageTable& pageTable = system.GetPageTable(textureId);
+				for (uint32_t mip = 0; mip < pageTable.GetMipCount(); ++mip)
+				{
+					for (uint32_t y = 0; y < pageTable.GetHeight(mip); ++y)
+					{
+						for (uint32_t x = 0; x < pageTable.GetWidth(mip); ++x)
+						{
+							const uint32_t slot = pageTable.GetSlot(mip, x, y);
+							if (slot == InvalidPage)
+								continue;
+
+							++numMapped;
+							if (system.GetCache().GetPageKey(slot) != PageId{ textureId, mip, x, y }.Pack())
+								return false;
+						}
+					}
+				}
+			}
+			return numMapped == system.GetCache().GetNumUsedSlots();
+		};
+
+		float totalReduceMilliseconds{ 0.0f };
+		bool isValid{ true };
+		for (uint32_t frame = 0; frame < numMovingFrames + numStaticFrames; ++frame)
+		{
+			generateFeedback(std::min(frame, numMovingFrames));
+			system.Update(feedback.data(), feedback.size(), maxLoadsPerFrame);
+			totalReduceMilliseconds += system.GetStatistics().reduceMilliseconds;
+
+			isValid = isValid && isConsistent();
+		}
+
+		//A static view has to converge to every requested page being resident
+		const bool hasConverged = system.GetStatistics().numMissingPages == 0;
+
+		std::cout << "Virtual texturing: " << numTextures << " textures of " << textureSize << "x" << textureSize
+			<< ", " << numPhysicalPages << " physical pages of " << pageSize << "x" << pageSize << "\n";
+		std::cout << "  feedback reduction: " << totalReduceMilliseconds / (numMovingFrames + numStaticFrames) << " ms/frame for "
+			<< feedback.size() << " texels\n";
+		std::cout << "  loads: " << numLoaderCalls << " evictions: " << system.GetStatistics().numEvictions << "\n";
+		std::cout << "  page table " << (isValid ? "consistent" : "MISMATCH") << ", static view " << (hasConverged ? "converged" : "DID NOT CONVERGE") << "\n";
+	}
+}
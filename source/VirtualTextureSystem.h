@@ -0,0 +1,77 @@
+#pragma once
+
+#include "FeedbackAnalyzer.h"
+#include "PageTable.h"
+#include "PhysicalPageCache.h"
+
+#include <functional>
+#include <memory>
+#include <vector>
+
+namespace dae
+{
+	// Keeps the pages a frame actually sampled in a fixed size physical cache.
+	// Independent of D3D: the loader callback fills a physical slot, the page tables are uploaded by the caller.
+	// The renderer has no feedback pass yet, the system only runs on synthetic feedback (benchmark and tests).
+	class VirtualTextureSystem final
+	{
+	public:
+		// Fills the given physical slot with the page, returns false when the data is not available (yet)
+		using PageLoader = std::function<bool(const PageId& page, uint32_t slot)>;
+
+		struct Statistics
+		{
+			uint32_t numFeedbackTexels{};
+			uint32_t numUniquePages{};
+			uint32_t numMissingPages{};
+			uint32_t numLoads{};
+			uint32_t numEvictions{};
+			uint32_t numDeferredLoads{};
+			float reduceMilliseconds{};
+		};
+
+	public:
+		VirtualTextureSystem(uint32_t numPhysicalPages, uint32_t pageSize, PageLoader pageLoader);
+		~VirtualTextureSystem() = default;
+
+		VirtualTextureSystem(const VirtualTextureSystem&)				= delete;
+		VirtualTextureSystem& operator=(const VirtualTextureSystem&)	= delete;
+		VirtualTextureSystem(VirtualTextureSystem&&)					= delete;
+		VirtualTextureSystem& operator=(VirtualTextureSystem&&)			= delete;
+
+		// Returns the id a feedback pass writes for this texture, or InvalidPage when the maximum is reached
+		uint32_t AddTexture(uint32_t width, uint32_t height);
+		uint32_t GetNumTextures() const;
+		uint32_t GetPageSize() const;
+
+		const PageTable& GetPageTable(uint32_t textureId) const;
+		const PhysicalPageCache& GetCache() const;
+
+		// Reduces one frame of feedback, keeps the requested pages alive and loads at most maxLoads missing pages,
+		// coarsest mips first so every sample has a fallback as soon as possible
+		void Update(const uint32_t* pFeedback, size_t numTexels, uint32_t maxLoads);
+
+		const Statistics& GetStatistics() const;
+		void PrintStatistics() const;
+
+		// Runs synthetic feedback through the system, checks the page table against the cache and prints timings
+		static void Benchmark();
+
+	private:
+		uint32_t m_PageSize;
+		PageLoader m_PageLoader;
+
+		std::vector<std::unique_ptr<PageTable>> m_PageTables;
+		PhysicalPageCache m_Cache;
+		FeedbackAnalyzer m_FeedbackAnalyzer;
+
+		std::vector<FeedbackAnalyzer::PageRequest> m_MissingPages;
+
+		uint32_t m_Frame{ 0 };
+		Statistics m_Statistics{};
+
+	private:
+		bool IsValid(const PageId& page) const;
+		bool Load(const PageId& page, uint32_t pageKey, bool isPinned);
+	};
+}
@@ -6,25 +6,168 @@
 
 #undef main
 #include "Renderer.h"
+#include "BackendScene.h"
+#include "CaptureEncoder.h"
+#include "DrawQueue.h"
 #include "Effect.h"
+#include "Frustum.h"
+#include "HeadlessBackend.h"
+#include "MathBenchmark.h"
+#include "MatrixSIMD.h"
+#include "PixelConversion.h"
+#include "TextureLoader.h"
+#include "TransformBatch.h"
+#include "VectorBatch.h"
+#include "VirtualTextureSystem.h"
+
+#include <span>
+#include <string_view>
 
 using namespace dae;
 
+namespace
+{
+	//--benchmark-* flags, the arguments after the flag are passed on
+	struct BenchmarkCommand
+	{
+		std::string_view flag;
+		void (*pRun)(std::span<char*> arguments);
+	};
+
+	const BenchmarkCommand g_BenchmarkCommands[]
+	{
+		{ "--benchmark-decode", [](std::span<char*>)
+			{
+				//The worker threads call IMG_Load, the codecs have to be loaded before them
+				IMG_Init(IMG_INIT_PNG);
+				TextureLoader::BenchmarkDecode({
+					"Resources/vehicle_diffuse.png",
+					"Resources/vehicle_normal.png",
+					"Resources/vehicle_gloss.png",
+					"Resources/vehicle_specular.png"
+				});
+				IMG_Quit();
+			} },
+		{ "--benchmark-pixel-conversion", [](std::span<char*>) { PixelConversion::Benchmark(); } },
+		{ "--benchmark-matrix", [](std::span<char*>) { MatrixSIMD::Benchmark(); } },
+		{ "--benchmark-transform-batch", [](std::span<char*>) { TransformBatch::Benchmark(); } },
+		{ "--benchmark-normalize", [](std::span<char*>)
+			{
+				VectorBatch::Benchmark();
+				Utils::BenchmarkTangents("Resources/vehicle.obj");
+			} },
+		{ "--benchmark-frustum", [](std::span<char*>) { Frustum::Benchmark(); } },
+		{ "--benchmark-draw-queue", [](std::span<char*>) { DrawQueue::Benchmark(); } },
+		//--benchmark-math [--json results.json]
+		{ "--benchmark-math", [](std::span<char*> arguments)
+			{
+				const MathBenchmark::Options options{};
+				const std::vector<MathBenchmark::Result> results = MathBenchmark::Run(options);
+				MathBenchmark::Print(results);
+
+				if (arguments.size() >= 2 && std::string_view{ arguments[0] } == "--json")
+				{
+					MathBenchmark::WriteJSON(arguments[1], results, options);
+				}
+			} },
+		//CPU cost of culling, sorting and submitting a frame, no GPU involved
+		{ "--benchmark-frame", [](std::span<char*>)
+			{
+				for (const bool isConstantBufferRangeSupported : { true, false })
+				{
+					HeadlessBackend backend{ isConstantBufferRangeSupported };
+					BackendScene::Benchmark(backend);
+					backend.PrintStatistics();
+				}
+			} },
+		{ "--benchmark-virtual-texturing", [](std::span<char*>) { VirtualTextureSystem::Benchmark(); } }
+	};
+}
+
 void ShutDown(SDL_Window* pWindow)
 {
 	SDL_DestroyWindow(pWindow);
+	IMG_Quit();
 	SDL_Quit();
 }
 
 int main(int argc, char* args[])
 {
-	//Unreferenced parameters
-	(void)argc;
-	(void)args;
+	//Benchmarks, before SDL is initialized since none of them open a window
+	for (int i = 1; i < argc; ++i)
+	{
+		const auto command = std::find_if(std::begin(g_BenchmarkCommands), std::end(g_BenchmarkCommands),
+			[flag = std::string_view{ args[i] }](const BenchmarkCommand& entry) { return entry.flag == flag; });
+
+		if (command != std::end(g_BenchmarkCommands))
+		{
+			command->pRun({ args + i + 1, static_cast<size_t>(argc - i - 1) });
+			return 0;
+		}
+	}
 
 	//Create window + surfaces
 	SDL_Init(SDL_INIT_VIDEO);
 
+	//Load the codecs up front, lazy initialization inside IMG_Load is not thread safe
+	IMG_Init(IMG_INIT_PNG);
+
+	//--capture frames [--size width height] [--raw] [--output path_prefix]
+	//Renders offscreen without a window and writes every frame to an image file
+	for (int i = 1; i < argc; ++i)
+	{
+		if (std::string_view{ args[i] } != "--capture" || i + 1 >= argc)
+			continue;
+
+		const uint32_t numFrames = static_cast<uint32_t>(std::max(std::atoi(args[i + 1]), 0));
+		uint32_t captureWidth = 1280;
+		uint32_t captureHeight = 720;
+		CaptureEncoder::Format format = CaptureEncoder::Format::PNG;
+		std::string pathPrefix = "capture_";
+		for (int j = i + 2; j < argc; ++j)
+		{
+			const std::string_view option{ args[j] };
+			if (option == "--size" && j + 2 < argc)
+			{
+				captureWidth = static_cast<uint32_t>(std::max(std::atoi(args[j + 1]), 1));
+				captureHeight = static_cast<uint32_t>(std::max(std::atoi(args[j + 2]), 1));
+				j += 2;
+			}
+			else if (option == "--raw")
+			{
+				format = CaptureEncoder::Format::Raw;
+			}
+			else if (option == "--output" && j + 1 < argc)
+			{
+				pathPrefix = args[++j];
+			}
+		}
+
+		const auto pTimer = new Timer();
+		const auto pRenderer = new Renderer(captureWidth, captureHeight);
+
+		if (pRenderer->BeginCapture(pathPrefix, format))
+		{
+			pTimer->Start();
+			for (uint32_t frame = 0; frame < numFrames; ++frame)
+			{
+				pRenderer->Update(pTimer);
+				pRenderer->Render();
+				pTimer->Update();
+			}
+			pTimer->Stop();
+
+			pRenderer->EndCapture();
+		}
+
+		delete pRenderer;
+		delete pTimer;
+
+		IMG_Quit();
+		SDL_Quit();
+		return 0;
+	}
+
 	const uint32_t width = 640;
 	const uint32_t height = 480;
 
@@ -41,6 +184,20 @@ int main(int argc, char* args[])
 	const auto pTimer = new Timer();
 	const auto pRenderer = new Renderer(pWindow);
 
+	//The same frame as --benchmark-frame, submitted to the device
+	for (int i = 1; i < argc; ++i)
+	{
+		if (std::string_view{ args[i] } == "--benchmark-frame-d3d11")
+		{
+			pRenderer->BenchmarkFrame();
+
+			delete pRenderer;
+			delete pTimer;
+			ShutDown(pWindow);
+			return 0;
+		}
+	}
+
 	//Start loop
 	pTimer->Start();
 	float printTimer = 0.f;
@@ -63,6 +220,10 @@ int main(int argc, char* args[])
 						case SDL_SCANCODE_F2:
 							Effect::CycleTechnique();
 							break;
+
+						case SDL_SCANCODE_F3:
+							pRenderer->ToggleForcedRecordingRanges();
+							break;
 					}
 					break;
 			}
@@ -81,6 +242,7 @@ int main(int argc, char* args[])
 		{
 			printTimer = 0.f;
 			std::cout << "dFPS: " << pTimer->GetdFPS() << std::endl;
+			pRenderer->PrintStatistics();
 		}
 	}
 	pTimer->Stop();
@@ -16,6 +16,7 @@
 // DirectX Headers
 #include <dxgi.h>
 #include <d3d11.h>
+#include <d3d11_1.h>
 #include <d3dcompiler.h>
 #include <d3dx11effect.h>
 
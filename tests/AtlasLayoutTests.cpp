@@ -0,0 +1,192 @@
+#include "AtlasLayout.h"
+#include "TestFramework.h"
+
+using namespace dae;
+
+namespace
+{
+	constexpr uint32_t bytesPerPixel{ 4 };
+
+	//Every texel holds the image index in red and its own coordinates in green and blue
+	Image CreateImage(uint32_t index, uint32_t width, uint32_t height)
+	{
+		Image image{ width, height, {} };
+		image.pixels.resize(static_cast<size_t>(width) * height * bytesPerPixel);
+		for (uint32_t y = 0; y < height; ++y)
+		{
+			for (uint32_t x = 0; x < width; ++x)
+			{
+				uint8_t* pPixel = &image.pixels[(static_cast<size_t>(y) * width + x) * bytesPerPixel];
+				pPixel[0] = static_cast<uint8_t>(index + 1);
+				pPixel[1] = static_cast<uint8_t>(x);
+				pPixel[2] = static_cast<uint8_t>(y);
+				pPixel[3] = 255;
+			}
+		}
+		return image;
+	}
+
+	bool IsSameTexel(const Image& atlas, uint32_t atlasX, uint32_t atlasY, const Image& image, uint32_t x, uint32_t y)
+	{
+		const uint8_t* pAtlasPixel = &atlas.pixels[(static_cast<size_t>(atlasY) * atlas.width + atlasX) * bytesPerPixel];
+		const uint8_t* pPixel = &image.pixels[(static_cast<size_t>(y) * image.width + x) * bytesPerPixel];
+		return std::equal(pPixel, pPixel + bytesPerPixel, pAtlasPixel);
+	}
+
+	bool IsOverlapping(const Int2& positionA, const Int2& sizeA, const Int2& positionB, const Int2& sizeB)
+	{
+		return positionA.x < positionB.x + sizeB.x && positionB.x < positionA.x + sizeA.x &&
+			positionA.y < positionB.y + sizeB.y && positionB.y < positionA.y + sizeA.y;
+	}
+
+	const std::vector<Image> g_Images{
+		CreateImage(0, 20, 12),
+		CreateImage(1, 7, 30),
+		CreateImage(2, 16, 16),
+		CreateImage(3, 1, 1),
+		CreateImage(4, 33, 5)
+	};
+}
+
+DAE_TEST(MipCountFollowsTheGutter)
+{
+	DAE_CHECK_EQUAL(AtlasLayout::GetMipCount(0), 1u);
+	DAE_CHECK_EQUAL(AtlasLayout::GetMipCount(1), 1u);
+	DAE_CHECK_EQUAL(AtlasLayout::GetMipCount(2), 2u);
+	DAE_CHECK_EQUAL(AtlasLayout::GetMipCount(3), 2u);
+	DAE_CHECK_EQUAL(AtlasLayout::GetMipCount(8), 4u);
+}
+
+DAE_TEST(PackedRectanglesStayInsideAndApart)
+{
+	const std::vector<Int2> sizes{ { 40, 24 }, { 8, 64 }, { 64, 8 }, { 16, 16 }, { 24, 40 }, { 8, 8 }, { 32, 32 } };
+	std::vector<Int2> positions{};
+	DAE_CHECK(AtlasLayout::Pack(sizes, 128, 8, positions));
+	DAE_CHECK_EQUAL(positions.size(), sizes.size());
+
+	for (size_t i = 0; i < sizes.size(); ++i)
+	{
+		DAE_CHECK_EQUAL(positions[i].x % 8, 0);
+		DAE_CHECK_EQUAL(positions[i].y % 8, 0);
+		DAE_CHECK(positions[i].x >= 0 && positions[i].x + sizes[i].x <= 128);
+		DAE_CHECK(positions[i].y >= 0 && positions[i].y + sizes[i].y <= 128);
+
+		for (size_t j = i + 1; j < sizes.size(); ++j)
+		{
+			DAE_CHECK(!IsOverlapping(positions[i], sizes[i], positions[j], sizes[j]));
+		}
+	}
+
+	//Wider than the square, and more area than the square
+	DAE_CHECK(!AtlasLayout::Pack({ { 129, 8 } }, 128, 8, positions));
+	DAE_CHECK(!AtlasLayout::Pack({ { 128, 128 }, { 8, 8 } }, 128, 8, positions));
+}
+
+DAE_TEST(RegionsHoldTheImagesAndMatchTheirUVTransforms)
+{
+	constexpr uint32_t gutter{ 4 };
+	Image atlas{};
+	std::vector<AtlasLayout::Region> regions{};
+	DAE_CHECK(AtlasLayout::Build(g_Images, gutter, 1024, atlas, regions));
+	DAE_CHECK_EQUAL(regions.size(), g_Images.size());
+	DAE_CHECK_EQUAL(atlas.width, atlas.height);
+	DAE_CHECK_EQUAL(atlas.width & (atlas.width - 1), 0u);
+	DAE_CHECK_EQUAL(atlas.pixels.size(), static_cast<size_t>(atlas.width) * atlas.height * bytesPerPixel);
+
+	const float size = static_cast<float>(atlas.width);
+	for (size_t i = 0; i < regions.size(); ++i)
+	{
+		const AtlasLayout::Region& region = regions[i];
+		const Image& image = g_Images[i];
+		DAE_CHECK_EQUAL(region.width, image.width);
+		DAE_CHECK_EQUAL(region.height, image.height);
+
+		bool isCopied{ true };
+		for (uint32_t y = 0; y < image.height; ++y)
+		{
+			for (uint32_t x = 0; x < image.width; ++x)
+			{
+				isCopied = isCopied && IsSameTexel(atlas, region.x + x, region.y + y, image, x, y);
+			}
+		}
+		DAE_CHECK(isCopied);
+
+		//Mesh UVs 0 and 1 land on the region edges
+		DAE_CHECK_EQUAL(region.uvTransform.z * size, static_cast<float>(region.x));
+		DAE_CHECK_EQUAL(region.uvTransform.w * size, static_cast<float>(region.y));
+		DAE_CHECK_EQUAL((region.uvTransform.x + region.uvTransform.z) * size, static_cast<float>(region.x + region.width));
+		DAE_CHECK_EQUAL((region.uvTransform.y + region.uvTransform.w) * size, static_cast<float>(region.y + region.height));
+	}
+}
+
+DAE_TEST(GuttersReplicateTheEdgeTexels)
+{
+	constexpr uint32_t gutter{ 4 };
+	Image atlas{};
+	std::vector<AtlasLayout::Region> regions{};
+	DAE_CHECK(AtlasLayout::Build(g_Images, gutter, 1024, atlas, regions));
+
+	for (size_t i = 0; i < regions.size(); ++i)
+	{
+		const AtlasLayout::Region& region = regions[i];
+		const Image& image = g_Images[i];
+		const int32_t border = static_cast<int32_t>(gutter);
+
+		//Every texel of the border holds the closest texel of the image, corners included
+		bool isReplicated{ true };
+		for (int32_t dy = -border; dy < static_cast<int32_t>(image.height) + border; ++dy)
+		{
+			for (int32_t dx = -border; dx < static_cast<int32_t>(image.width) + border; ++dx)
+			{
+				const uint32_t x = static_cast<uint32_t>(Clamp(dx, 0, static_cast<int32_t>(image.width) - 1));
+				const uint32_t y = static_cast<uint32_t>(Clamp(dy, 0, static_cast<int32_t>(image.height) - 1));
+				isReplicated = isReplicated && IsSameTexel(atlas, region.x + dx, region.y + dy, image, x, y);
+			}
+		}
+		DAE_CHECK(isReplicated);
+	}
+}
+
+DAE_TEST(MipsBelowTheCountNeverReachPastTheGutter)
+{
+	for (const uint32_t gutter : { 1u, 2u, 5u, 8u })
+	{
+		Image atlas{};
+		std::vector<AtlasLayout::Region> regions{};
+		DAE_CHECK(AtlasLayout::Build(g_Images, gutter, 1024, atlas, regions));
+
+		//The box filtered texels of a mip that cover a region only read from the region and its gutter
+		const uint32_t mipCount = AtlasLayout::GetMipCount(gutter);
+		for (uint32_t mip = 0; mip < mipCount; ++mip)
+		{
+			for (const AtlasLayout::Region& region : regions)
+			{
+				const uint32_t firstX = (region.x >> mip) << mip;
+				const uint32_t firstY = (region.y >> mip) << mip;
+				const uint32_t endX = (((region.x + region.width - 1) >> mip) + 1) << mip;
+				const uint32_t endY = (((region.y + region.height - 1) >> mip) + 1) << mip;
+
+				DAE_CHECK(firstX + gutter >= region.x);
+				DAE_CHECK(firstY + gutter >= region.y);
+				DAE_CHECK(endX <= region.x + region.width + gutter);
+				DAE_CHECK(endY <= region.y + region.height + gutter);
+			}
+		}
+	}
+}
+
+DAE_TEST(ImagesBeyondTheMaximumSizeFail)
+{
+	Image atlas{};
+	std::vector<AtlasLayout::Region> regions{};
+
+	//Already the first square tried is too large
+	DAE_CHECK(!AtlasLayout::Build({ CreateImage(0, 60, 60) }, 4, 64, atlas, regions));
+	DAE_CHECK(regions.empty());
+	DAE_CHECK(!AtlasLayout::Build({}, 4, 64, atlas, regions));
+
+	DAE_CHECK(AtlasLayout::Build({ CreateImage(0, 56, 56) }, 4, 64, atlas, regions));
+	DAE_CHECK_EQUAL(atlas.width, 64u);
+}
+
+DAE_TEST_MAIN()
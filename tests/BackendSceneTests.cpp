@@ -0,0 +1,380 @@
+#include "BackendScene.h"
+#include "ConstantRingAllocator.h"
+#include "HeadlessBackend.h"
+#include "MathHelpers.h"
+#include "TestFramework.h"
+
+#include <cstring>
+
+using namespace dae;
+
+namespace
+{
+	using CommandType = HeadlessBackend::CommandType;
+
+	constexpr uint32_t perFrameSize{ ConstantRingAllocator::GetAllocationSize(sizeof(PerFrameConstants)) };
+	constexpr uint32_t perDrawSize{ ConstantRingAllocator::GetAllocationSize(sizeof(PerDrawConstants)) };
+
+	//A quad of two triangles is all a draw needs
+	uint32_t AddQuad(BackendScene& scene, PipelineHandle pipeline)
+	{
+		const Vertex vertices[4]{
+			{ { -0.5f, -0.5f, 0.0f }, { 0.0f, 1.0f }, -Vector3::UnitZ, Vector3::UnitX },
+			{ { 0.5f, -0.5f, 0.0f }, { 1.0f, 1.0f }, -Vector3::UnitZ, Vector3::UnitX },
+			{ { 0.5f, 0.5f, 0.0f }, { 1.0f, 0.0f }, -Vector3::UnitZ, Vector3::UnitX },
+			{ { -0.5f, 0.5f, 0.0f }, { 0.0f, 0.0f }, -Vector3::UnitZ, Vector3::UnitX }
+		};
+		const uint32_t indices[6]{ 0, 1, 2, 0, 2, 3 };
+		return scene.AddMesh(vertices, indices, pipeline);
+	}
+
+	//Looks down +z from the origin
+	Camera CreateCamera()
+	{
+		Camera camera{};
+		camera.Initialize(1.0f, 0.1f, 100.0f, 90.0f, { 0.0f, 0.0f, 0.0f });
+		camera.SetRotation(0.0f, 0.0f);
+		camera.CalculateViewMatrix();
+		camera.CalculateProjectionMatrix();
+		return camera;
+	}
+
+	bool AreEqual(const Vector3& a, const Vector3& b)
+	{
+		return dae::AreEqual(a.x, b.x, 1e-4f) && dae::AreEqual(a.y, b.y, 1e-4f) && dae::AreEqual(a.z, b.z, 1e-4f);
+	}
+
+	void RenderFrame(HeadlessBackend& backend, BackendScene& scene, const Camera& camera)
+	{
+		backend.BeginFrame();
+		scene.Render(camera);
+		backend.EndFrame();
+	}
+
+	uint32_t CountCommands(const HeadlessBackend& backend, CommandType type, uint32_t slot)
+	{
+		uint32_t count{ 0 };
+		for (const HeadlessBackend::Command& command : backend.GetCommands())
+		{
+			count += command.type == type && command.slot == slot ? 1 : 0;
+		}
+		return count;
+	}
+}
+
+DAE_TEST(ObjectsOutsideTheFrustumAreCulled)
+{
+	HeadlessBackend backend{};
+	BackendScene scene{ backend };
+	const PipelineHandle pipeline = backend.CreatePipeline({ L"Test.fx", {}, 0 });
+	const uint32_t mesh = AddQuad(scene, pipeline);
+	const uint32_t material = scene.AddMaterial(0, 0);
+
+	scene.AddObject(mesh, material, Matrix::CreateTranslation(0.0f, 0.0f, 10.0f));
+	scene.AddObject(mesh, material, Matrix::CreateTranslation(0.0f, 0.0f, -10.0f));
+	scene.AddObject(mesh, material, Matrix::CreateTranslation(1000.0f, 0.0f, 10.0f));
+	scene.AddObject(mesh, material, Matrix::CreateTranslation(0.0f, 0.0f, 500.0f));
+	const uint32_t moved = scene.AddObject(mesh, material, Matrix::CreateTranslation(0.0f, 0.0f, -20.0f));
+
+	const Camera camera = CreateCamera();
+	RenderFrame(backend, scene, camera);
+	DAE_CHECK_EQUAL(scene.GetStatistics().numObjects, 5u);
+	DAE_CHECK_EQUAL(scene.GetStatistics().numVisible, 1u);
+	DAE_CHECK_EQUAL(backend.GetNumCommands(CommandType::DrawIndexed), 1u);
+
+	scene.SetObjectWorld(moved, Matrix::CreateTranslation(2.0f, 0.0f, 20.0f));
+	RenderFrame(backend, scene, camera);
+	DAE_CHECK_EQUAL(scene.GetStatistics().numVisible, 2u);
+	DAE_CHECK_EQUAL(backend.GetStatistics().numTriangles, 4u);
+}
+
+DAE_TEST(StateIsBoundOncePerSortedGroup)
+{
+	HeadlessBackend backend{};
+	backend.SetRecording(true);
+	BackendScene scene{ backend };
+
+	const PipelineHandle pipeline = backend.CreatePipeline({ L"Test.fx", {}, 0 });
+	const uint32_t meshes[2]{ AddQuad(scene, pipeline), AddQuad(scene, pipeline) };
+	const TextureHandle texture = backend.CreateTexture({ 1, 1, RenderGraphFormat::RGBA8 }, nullptr);
+	const uint32_t materials[2]{ scene.AddMaterial(texture, 0), scene.AddMaterial(0, texture) };
+
+	//Interleaved, so only sorting groups them
+	constexpr uint32_t numObjects{ 16 };
+	for (uint32_t i = 0; i < numObjects; ++i)
+	{
+		scene.AddObject(meshes[i % 2], materials[(i / 2) % 2], Matrix::CreateTranslation(0.0f, 0.0f, 5.0f + static_cast<float>(i)));
+	}
+
+	RenderFrame(backend, scene, CreateCamera());
+
+	const BackendScene::Statistics& statistics = scene.GetStatistics();
+	DAE_CHECK_EQUAL(statistics.numVisible, numObjects);
+	DAE_CHECK_EQUAL(statistics.numPipelineChanges, 1u);
+	DAE_CHECK_EQUAL(statistics.numMaterialChanges, 2u);
+	//Each material group draws both meshes
+	DAE_CHECK_EQUAL(statistics.numMeshChanges, 4u);
+
+	DAE_CHECK_EQUAL(backend.GetNumCommands(CommandType::SetPipeline), 1u);
+	DAE_CHECK_EQUAL(backend.GetNumCommands(CommandType::SetTexture), 4u);
+	DAE_CHECK_EQUAL(backend.GetNumCommands(CommandType::SetVertexBuffers), 4u);
+	DAE_CHECK_EQUAL(backend.GetNumCommands(CommandType::SetIndexBuffer), 4u);
+	DAE_CHECK_EQUAL(backend.GetNumCommands(CommandType::DrawIndexed), numObjects);
+	DAE_CHECK_EQUAL(backend.GetStatistics().numInvalidDraws, 0u);
+
+	//No binding between two draws of the same group
+	uint32_t numDrawsSinceBinding{ 0 };
+	uint32_t numBindings{ 0 };
+	for (const HeadlessBackend::Command& command : backend.GetCommands())
+	{
+		if (command.type == CommandType::DrawIndexed)
+		{
+			++numDrawsSinceBinding;
+		}
+		else if (command.type == CommandType::SetVertexBuffers)
+		{
+			DAE_CHECK(numBindings == 0 || numDrawsSinceBinding == numObjects / 4);
+			++numBindings;
+			numDrawsSinceBinding = 0;
+		}
+	}
+}
+
+DAE_TEST(EveryDrawBindsItsOwnConstantRange)
+{
+	HeadlessBackend backend{ true };
+	backend.SetRecording(true);
+	BackendScene scene{ backend };
+
+	const PipelineHandle pipeline = backend.CreatePipeline({ L"Test.fx", {}, 0 });
+	const uint32_t mesh = AddQuad(scene, pipeline);
+	const uint32_t material = scene.AddMaterial(0, 0);
+
+	constexpr uint32_t numObjects{ 3 };
+	for (uint32_t i = 0; i < numObjects; ++i)
+	{
+		scene.AddObject(mesh, material, Matrix::CreateTranslation(static_cast<float>(i), 0.0f, 10.0f + static_cast<float>(i)));
+	}
+
+	const Camera camera = CreateCamera();
+	RenderFrame(backend, scene, camera);
+
+	//One update holds the whole frame
+	DAE_CHECK_EQUAL(backend.GetNumCommands(CommandType::UpdateBuffer), 1u);
+	DAE_CHECK_EQUAL(backend.GetStatistics().uploadedBytes, static_cast<size_t>(perFrameSize + numObjects * perDrawSize));
+
+	BufferHandle constantBuffer{ 0 };
+	std::vector<uint32_t> firstConstants{};
+	for (const HeadlessBackend::Command& command : backend.GetCommands())
+	{
+		if (command.type != CommandType::SetConstantBuffer)
+			continue;
+
+		constantBuffer = command.handle;
+		if (command.slot == ConstantBuffers::PerFrameSlot)
+		{
+			DAE_CHECK_EQUAL(command.argument, 0u);
+		}
+		else
+		{
+			firstConstants.push_back(command.argument);
+		}
+	}
+
+	DAE_CHECK_EQUAL(firstConstants.size(), static_cast<size_t>(numObjects));
+	const std::span<const uint8_t> data = backend.GetBufferData(constantBuffer);
+	for (uint32_t i = 0; i < firstConstants.size(); ++i)
+	{
+		DAE_CHECK_EQUAL(firstConstants[i], (perFrameSize + i * perDrawSize) / ConstantRingAllocator::ConstantSize);
+
+		//Nearest first, the objects were added front to back
+		PerDrawConstants constants{};
+		std::memcpy(static_cast<void*>(&constants), data.data() + firstConstants[i] * ConstantRingAllocator::ConstantSize, sizeof(constants));
+		DAE_CHECK(AreEqual(constants.world.GetTranslation(), { static_cast<float>(i), 0.0f, 10.0f + static_cast<float>(i) }));
+		DAE_CHECK_EQUAL(constants.useNormalGlossSpecularMap, 0u);
+	}
+
+	PerFrameConstants perFrame{};
+	std::memcpy(static_cast<void*>(&perFrame), data.data(), sizeof(perFrame));
+	DAE_CHECK(AreEqual(perFrame.viewInverse.GetTranslation(), camera.origin));
+}
+
+DAE_TEST(WithoutRangesEveryDrawUpdatesOneBuffer)
+{
+	HeadlessBackend backend{ false };
+	backend.SetRecording(true);
+	BackendScene scene{ backend };
+
+	const PipelineHandle pipeline = backend.CreatePipeline({ L"Test.fx", {}, 0 });
+	const uint32_t mesh = AddQuad(scene, pipeline);
+	const uint32_t material = scene.AddMaterial(0, 0);
+
+	constexpr uint32_t numObjects{ 4 };
+	for (uint32_t i = 0; i < numObjects; ++i)
+	{
+		scene.AddObject(mesh, material, Matrix::CreateTranslation(0.0f, 0.0f, 10.0f + static_cast<float>(i)));
+	}
+
+	RenderFrame(backend, scene, CreateCamera());
+
+	//The per frame buffer, then one per draw
+	DAE_CHECK_EQUAL(backend.GetNumCommands(CommandType::UpdateBuffer), 1u + numObjects);
+	DAE_CHECK_EQUAL(backend.GetNumCommands(CommandType::DrawIndexed), numObjects);
+	DAE_CHECK_EQUAL(CountCommands(backend, CommandType::SetConstantBuffer, ConstantBuffers::PerDrawSlot), 1u);
+	for (const HeadlessBackend::Command& command : backend.GetCommands())
+	{
+		if (command.type == CommandType::SetConstantBuffer)
+		{
+			DAE_CHECK_EQUAL(command.argument, 0u);
+		}
+	}
+	DAE_CHECK_EQUAL(backend.GetStatistics().numInvalidDraws, 0u);
+}
+
+DAE_TEST(InstancedObjectsDrawTheirInstanceBuffer)
+{
+	HeadlessBackend backend{};
+	backend.SetRecording(true);
+	BackendScene scene{ backend };
+
+	const PipelineHandle pipeline = backend.CreatePipeline({ L"Test.fx", { { "INSTANCED", "1" } }, 0 });
+	const uint32_t mesh = AddQuad(scene, pipeline);
+	const uint32_t material = scene.AddMaterial(0, 0);
+	const BufferHandle instanceBuffer = backend.CreateBuffer({ BufferUsage::Vertex, 64 * 8, true }, nullptr);
+
+	//Behind the camera, instances are never culled by the scene
+	const uint32_t object = scene.AddObject(mesh, material, Matrix::CreateTranslation(0.0f, 0.0f, -10.0f));
+	scene.SetObjectInstances(object, instanceBuffer, 64, 8);
+
+	const Camera camera = CreateCamera();
+	RenderFrame(backend, scene, camera);
+	DAE_CHECK_EQUAL(scene.GetStatistics().numVisible, 1u);
+	DAE_CHECK_EQUAL(backend.GetNumCommands(CommandType::DrawIndexed), 0u);
+	DAE_CHECK_EQUAL(backend.GetNumCommands(CommandType::DrawIndexedInstanced), 1u);
+	DAE_CHECK_EQUAL(backend.GetStatistics().numTriangles, 16u);
+	for (const HeadlessBackend::Command& command : backend.GetCommands())
+	{
+		if (command.type == CommandType::DrawIndexedInstanced)
+		{
+			DAE_CHECK_EQUAL(command.argument, 8u);
+		}
+	}
+
+	//The world matrix comes from the instances
+	const std::span<const uint8_t> data = backend.GetBufferData(backend.GetCommands()[0].handle);
+	PerDrawConstants constants{};
+	std::memcpy(static_cast<void*>(&constants), data.data() + perFrameSize, sizeof(constants));
+	DAE_CHECK(AreEqual(constants.world.GetTranslation(), { 0.0f, 0.0f, 0.0f }));
+
+	scene.SetObjectInstances(object, instanceBuffer, 64, 0);
+	RenderFrame(backend, scene, camera);
+	DAE_CHECK_EQUAL(scene.GetStatistics().numVisible, 0u);
+	DAE_CHECK_EQUAL(backend.GetNumCommands(CommandType::DrawIndexedInstanced), 0u);
+
+	backend.DestroyBuffer(instanceBuffer);
+}
+
+DAE_TEST(EveryRangeBindsItsOwnState)
+{
+	HeadlessBackend backend{ true };
+	backend.SetRecording(true);
+	BackendScene scene{ backend };
+
+	const PipelineHandle pipeline = backend.CreatePipeline({ L"Test.fx", {}, 0 });
+	const uint32_t mesh = AddQuad(scene, pipeline);
+	const uint32_t material = scene.AddMaterial(0, 0);
+
+	constexpr uint32_t numObjects{ 10 };
+	for (uint32_t i = 0; i < numObjects; ++i)
+	{
+		scene.AddObject(mesh, material, Matrix::CreateTranslation(0.0f, 0.0f, 10.0f + static_cast<float>(i)));
+	}
+
+	backend.BeginFrame();
+	scene.Prepare(CreateCamera());
+	DAE_CHECK_EQUAL(scene.GetNumDraws(), numObjects);
+
+	//As a RecordingScheduler would split them, each range starts without known state
+	scene.Submit(backend, { 0, 4 });
+	scene.Submit(backend, { 4, numObjects });
+	scene.Submit(backend, { numObjects, numObjects + 4 });
+	backend.EndFrame();
+
+	DAE_CHECK_EQUAL(backend.GetNumCommands(CommandType::SetPipeline), 2u);
+	DAE_CHECK_EQUAL(backend.GetNumCommands(CommandType::SetVertexBuffers), 2u);
+	DAE_CHECK_EQUAL(CountCommands(backend, CommandType::SetConstantBuffer, ConstantBuffers::PerFrameSlot), 2u);
+	DAE_CHECK_EQUAL(backend.GetNumCommands(CommandType::DrawIndexed), numObjects);
+	DAE_CHECK_EQUAL(backend.GetStatistics().numInvalidDraws, 0u);
+
+	//The ranges bind the same slices a single submit would
+	uint32_t draw{ 0 };
+	for (const HeadlessBackend::Command& command : backend.GetCommands())
+	{
+		if (command.type == CommandType::SetConstantBuffer && command.slot == ConstantBuffers::PerDrawSlot)
+		{
+			DAE_CHECK_EQUAL(command.argument, (perFrameSize + draw * perDrawSize) / ConstantRingAllocator::ConstantSize);
+			++draw;
+		}
+	}
+	DAE_CHECK_EQUAL(draw, numObjects);
+}
+
+DAE_TEST(FramesFollowEachOtherInTheConstantRing)
+{
+	HeadlessBackend backend{ true };
+	backend.SetRecording(true);
+	BackendScene scene{ backend };
+
+	const PipelineHandle pipeline = backend.CreatePipeline({ L"Test.fx", {}, 0 });
+	const uint32_t mesh = AddQuad(scene, pipeline);
+	const uint32_t material = scene.AddMaterial(0, 0);
+	scene.AddObject(mesh, material, Matrix::CreateTranslation(0.0f, 0.0f, 10.0f));
+
+	const Camera camera = CreateCamera();
+	constexpr uint32_t frameSize{ perFrameSize + perDrawSize };
+	uint32_t expectedOffset{ 0 };
+	uint32_t numWraps{ 0 };
+	for (uint32_t frame = 0; frame < 16; ++frame)
+	{
+		RenderFrame(backend, scene, camera);
+
+		const HeadlessBackend::Command* pUpdate{ nullptr };
+		uint32_t perFrameConstant{ UINT32_MAX };
+		for (const HeadlessBackend::Command& command : backend.GetCommands())
+		{
+			if (command.type == CommandType::UpdateBuffer)
+			{
+				pUpdate = &command;
+			}
+			else if (command.type == CommandType::SetConstantBuffer && command.slot == ConstantBuffers::PerFrameSlot)
+			{
+				perFrameConstant = command.argument;
+			}
+		}
+
+		DAE_CHECK(pUpdate != nullptr);
+		if (pUpdate == nullptr)
+			return;
+
+		//Wrapping starts over at 0, otherwise the frame follows the last one so the GPU can still read that
+		if (pUpdate->offset != expectedOffset)
+		{
+			DAE_CHECK_EQUAL(pUpdate->offset, 0u);
+			++numWraps;
+		}
+		DAE_CHECK_EQUAL(perFrameConstant, pUpdate->offset / ConstantRingAllocator::ConstantSize);
+		expectedOffset = pUpdate->offset + frameSize;
+	}
+
+	DAE_CHECK(numWraps > 0);
+	DAE_CHECK_EQUAL(scene.GetStatistics().numConstantDiscards, numWraps + 1);
+}
+
+DAE_TEST(MeshWithoutGeometryIsRejected)
+{
+	HeadlessBackend backend{};
+	BackendScene scene{ backend };
+	DAE_CHECK_EQUAL(scene.AddMesh({}, {}, backend.CreatePipeline({ L"Test.fx", {}, 0 })), UINT32_MAX);
+}
+
+DAE_TEST_MAIN()
@@ -0,0 +1,162 @@
+#include "CaptureEncoder.h"
+#include "TestFramework.h"
+
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <fstream>
+#include <iterator>
+
+using namespace dae;
+
+namespace
+{
+	// Collects what would be written. Closing the gate holds the encoder thread inside the writer.
+	class FakePNGWriter final
+	{
+	public:
+		CaptureEncoder::PNGWriter GetWriter()
+		{
+			return [this](const std::string& filepath, const Image& image)
+				{
+					std::unique_lock lock{ m_Mutex };
+					++m_NumEntered;
+					m_Condition.notify_all();
+					m_Condition.wait(lock, [this] { return m_IsOpen; });
+
+					m_Filepaths.push_back(filepath);
+					return image.width * image.height * 4 == image.pixels.size();
+				};
+		}
+
+		void SetOpen(bool isOpen)
+		{
+			{
+				const std::lock_guard lock{ m_Mutex };
+				m_IsOpen = isOpen;
+			}
+			m_Condition.notify_all();
+		}
+
+		void WaitUntilEntered(uint32_t numEntered)
+		{
+			std::unique_lock lock{ m_Mutex };
+			m_Condition.wait(lock, [&] { return m_NumEntered >= numEntered; });
+		}
+
+		std::vector<std::string> GetFilepaths() const
+		{
+			const std::lock_guard lock{ m_Mutex };
+			return m_Filepaths;
+		}
+
+	private:
+		mutable std::mutex m_Mutex{};
+		std::condition_variable m_Condition{};
+		bool m_IsOpen{ true };
+		uint32_t m_NumEntered{ 0 };
+		std::vector<std::string> m_Filepaths{};
+	};
+
+	CapturedFrame CreateFrame(uint64_t frameIndex, uint32_t width = 2, uint32_t height = 2)
+	{
+		CapturedFrame frame{ frameIndex, width, height };
+		frame.pixels.resize(static_cast<size_t>(width) * height * 4);
+		for (size_t i = 0; i < frame.pixels.size(); ++i)
+		{
+			frame.pixels[i] = static_cast<uint8_t>(i + frameIndex);
+		}
+		return frame;
+	}
+}
+
+DAE_TEST(FinishWaitsForEveryFrameInOrder)
+{
+	FakePNGWriter writer{};
+	CaptureEncoder encoder{ "frame_", CaptureEncoder::Format::PNG, writer.GetWriter() };
+
+	for (uint64_t frameIndex = 0; frameIndex < 20; ++frameIndex)
+	{
+		encoder.Encode(CreateFrame(frameIndex));
+	}
+	encoder.Finish();
+
+	const std::vector<std::string> filepaths = writer.GetFilepaths();
+	DAE_CHECK_EQUAL(filepaths.size(), 20u);
+	DAE_CHECK(!filepaths.empty() && filepaths.front() == "frame_000000.png");
+	DAE_CHECK(filepaths.size() == 20 && filepaths.back() == "frame_000019.png");
+
+	const CaptureEncoder::Statistics statistics = encoder.GetStatistics();
+	DAE_CHECK_EQUAL(statistics.numWritten, 20u);
+	DAE_CHECK_EQUAL(statistics.numFailed, 0u);
+	DAE_CHECK_EQUAL(statistics.bytesWritten, 20u * 16u);
+}
+
+DAE_TEST(EncodeBlocksOnceTheQueueIsFull)
+{
+	FakePNGWriter writer{};
+	CaptureEncoder encoder{ "frame_", CaptureEncoder::Format::PNG, writer.GetWriter(), 2 };
+
+	//Frame 0 is taken off the queue and held in the writer, frames 1 and 2 fill the queue
+	writer.SetOpen(false);
+	encoder.Encode(CreateFrame(0));
+	writer.WaitUntilEntered(1);
+	encoder.Encode(CreateFrame(1));
+	encoder.Encode(CreateFrame(2));
+	DAE_CHECK_EQUAL(encoder.GetStatistics().numBlocked, 0u);
+
+	std::atomic<bool> isEncoded{ false };
+	std::thread producer{ [&]()
+		{
+			encoder.Encode(CreateFrame(3));
+			isEncoded = true;
+		} };
+
+	//The producer has to wait until the writer frees a slot
+	const auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds{ 5 };
+	while (encoder.GetStatistics().numBlocked == 0 && std::chrono::steady_clock::now() < deadline)
+	{
+		std::this_thread::yield();
+	}
+	DAE_CHECK_EQUAL(encoder.GetStatistics().numBlocked, 1u);
+	DAE_CHECK(!isEncoded);
+
+	writer.SetOpen(true);
+	producer.join();
+	encoder.Finish();
+
+	DAE_CHECK(isEncoded);
+	const std::vector<std::string> filepaths = writer.GetFilepaths();
+	DAE_CHECK((filepaths == std::vector<std::string>{ "frame_000000.png", "frame_000001.png", "frame_000002.png", "frame_000003.png" }));
+}
+
+DAE_TEST(RawFramesCarryTheirSizeInTheName)
+{
+	CaptureEncoder encoder{ "capture_test_", CaptureEncoder::Format::Raw, nullptr };
+	const CapturedFrame frame = CreateFrame(42, 3, 2);
+	const std::string filepath = encoder.GetFilepath(frame);
+	DAE_CHECK_EQUAL(filepath, std::string{ "capture_test_000042_3x2.raw" });
+
+	encoder.Encode(CreateFrame(42, 3, 2));
+	encoder.Finish();
+	DAE_CHECK_EQUAL(encoder.GetStatistics().numWritten, 1u);
+
+	std::ifstream file{ filepath, std::ios::binary };
+	const std::vector<uint8_t> bytes{ std::istreambuf_iterator<char>{ file }, std::istreambuf_iterator<char>{} };
+	DAE_CHECK(bytes == frame.pixels);
+
+	file.close();
+	std::remove(filepath.c_str());
+}
+
+DAE_TEST(PNGWithoutAWriterFails)
+{
+	CaptureEncoder encoder{ "frame_", CaptureEncoder::Format::PNG, nullptr };
+	encoder.Encode(CreateFrame(0));
+	encoder.Finish();
+
+	DAE_CHECK_EQUAL(encoder.GetStatistics().numWritten, 0u);
+	DAE_CHECK_EQUAL(encoder.GetStatistics().numFailed, 1u);
+}
+
+DAE_TEST_MAIN()
@@ -0,0 +1,166 @@
+#include "ConstantRingAllocator.h"
+#include "TestFramework.h"
+
+using namespace dae;
+
+namespace
+{
+	using MapMode = ConstantRingAllocator::MapMode;
+
+	//Begins a frame of numAllocations allocations of size, allocates them and ends it
+	bool RunFrame(ConstantRingAllocator& ring, uint32_t numAllocations, uint32_t size, MapMode& mapMode, std::vector<ConstantAllocation>& allocations)
+	{
+		allocations.clear();
+		if (!ring.BeginFrame(numAllocations * ConstantRingAllocator::GetAllocationSize(size), mapMode))
+			return false;
+
+		for (uint32_t i = 0; i < numAllocations; ++i)
+		{
+			ConstantAllocation allocation{};
+			if (!ring.Allocate(size, allocation))
+				return false;
+			allocations.push_back(allocation);
+		}
+		ring.EndFrame();
+		return true;
+	}
+}
+
+DAE_TEST(AllocationSizesAreMultiplesOf256Bytes)
+{
+	DAE_CHECK_EQUAL(ConstantRingAllocator::GetAllocationSize(1), 256u);
+	DAE_CHECK_EQUAL(ConstantRingAllocator::GetAllocationSize(64), 256u);
+	DAE_CHECK_EQUAL(ConstantRingAllocator::GetAllocationSize(256), 256u);
+	DAE_CHECK_EQUAL(ConstantRingAllocator::GetAllocationSize(257), 512u);
+	DAE_CHECK_EQUAL(ConstantRingAllocator::GetAllocationSize(1000), 1024u);
+
+	static_assert(ConstantRingAllocator::GetAllocationSize(200) == 256);
+
+	//The capacity is rounded down as well
+	const ConstantRingAllocator ring{ 1000 };
+	DAE_CHECK_EQUAL(ring.GetCapacity(), 768u);
+}
+
+DAE_TEST(AllocationsAreAlignedTo16Constants)
+{
+	ConstantRingAllocator ring{ 64 * 1024 };
+	MapMode mapMode{};
+	std::vector<ConstantAllocation> allocations{};
+
+	for (const uint32_t size : { 80u, 256u, 300u, 1u })
+	{
+		DAE_CHECK(RunFrame(ring, 5, size, mapMode, allocations));
+		for (const ConstantAllocation& allocation : allocations)
+		{
+			DAE_CHECK_EQUAL(allocation.offset % ConstantRingAllocator::Alignment, 0u);
+			DAE_CHECK_EQUAL(allocation.size, ConstantRingAllocator::GetAllocationSize(size));
+
+			uint32_t firstConstant{};
+			uint32_t numConstants{};
+			ConstantRingAllocator::GetConstantRange(allocation, firstConstant, numConstants);
+			DAE_CHECK_EQUAL(firstConstant % 16, 0u);
+			DAE_CHECK_EQUAL(numConstants % 16, 0u);
+			DAE_CHECK_EQUAL(firstConstant * ConstantRingAllocator::ConstantSize, allocation.offset);
+			DAE_CHECK(numConstants * ConstantRingAllocator::ConstantSize >= size);
+		}
+
+		//Allocations of a frame follow each other without gaps
+		for (size_t i = 1; i < allocations.size(); ++i)
+		{
+			DAE_CHECK_EQUAL(allocations[i].offset, allocations[i - 1].offset + allocations[i - 1].size);
+		}
+	}
+}
+
+DAE_TEST(FramesFollowEachOtherAndWrapWithDiscard)
+{
+	//Room for 10 allocations, every frame takes 4
+	ConstantRingAllocator ring{ 10 * 256 };
+	MapMode mapMode{};
+	std::vector<ConstantAllocation> allocations{};
+
+	DAE_CHECK(RunFrame(ring, 4, 256, mapMode, allocations));
+	DAE_CHECK(mapMode == MapMode::Discard);
+	DAE_CHECK_EQUAL(allocations.front().offset, 0u);
+
+	DAE_CHECK(RunFrame(ring, 4, 256, mapMode, allocations));
+	DAE_CHECK(mapMode == MapMode::NoOverwrite);
+	DAE_CHECK_EQUAL(allocations.front().offset, 4u * 256u);
+
+	//Only 2 allocations are left, the frame starts over at 0
+	DAE_CHECK(RunFrame(ring, 4, 256, mapMode, allocations));
+	DAE_CHECK(mapMode == MapMode::Discard);
+	DAE_CHECK_EQUAL(allocations.front().offset, 0u);
+
+	DAE_CHECK(RunFrame(ring, 4, 256, mapMode, allocations));
+	DAE_CHECK(mapMode == MapMode::NoOverwrite);
+	DAE_CHECK_EQUAL(ring.GetFrameOffset(), 4u * 256u);
+}
+
+DAE_TEST(AFrameEndingAtTheCapacityWrapsTheNextOne)
+{
+	ConstantRingAllocator ring{ 4 * 256 };
+	MapMode mapMode{};
+	std::vector<ConstantAllocation> allocations{};
+
+	DAE_CHECK(RunFrame(ring, 2, 256, mapMode, allocations));
+	DAE_CHECK(RunFrame(ring, 2, 256, mapMode, allocations));
+	DAE_CHECK(mapMode == MapMode::NoOverwrite);
+	DAE_CHECK(RunFrame(ring, 1, 256, mapMode, allocations));
+	DAE_CHECK(mapMode == MapMode::Discard);
+	DAE_CHECK_EQUAL(allocations.front().offset, 0u);
+}
+
+DAE_TEST(UnusedSpaceOfAFrameIsReusedByTheNext)
+{
+	ConstantRingAllocator ring{ 16 * 256 };
+	MapMode mapMode{};
+
+	DAE_CHECK(ring.BeginFrame(8 * 256, mapMode));
+	ConstantAllocation allocation{};
+	DAE_CHECK(ring.Allocate(256, allocation));
+	ring.EndFrame();
+
+	//Only the one allocation is in flight
+	DAE_CHECK(ring.BeginFrame(256, mapMode));
+	DAE_CHECK(mapMode == MapMode::NoOverwrite);
+	DAE_CHECK_EQUAL(ring.GetFrameOffset(), 256u);
+	ring.EndFrame();
+}
+
+DAE_TEST(TooBigRequestsAreRefused)
+{
+	ConstantRingAllocator ring{ 4 * 256 };
+	MapMode mapMode{};
+	ConstantAllocation allocation{};
+
+	//Larger than the whole ring
+	DAE_CHECK(!ring.BeginFrame(4 * 256 + 1, mapMode));
+
+	//Larger than what the frame reserved
+	DAE_CHECK(ring.BeginFrame(2 * 256, mapMode));
+	DAE_CHECK(!ring.Allocate(3 * 256, allocation));
+	DAE_CHECK(ring.Allocate(300, allocation));
+	DAE_CHECK_EQUAL(allocation.size, 512u);
+	DAE_CHECK(!ring.Allocate(1, allocation));
+	DAE_CHECK(!ring.Allocate(0, allocation));
+	ring.EndFrame();
+
+	//Outside a frame
+	DAE_CHECK(!ring.Allocate(16, allocation));
+}
+
+DAE_TEST(ResetStartsOverWithDiscard)
+{
+	ConstantRingAllocator ring{ 16 * 256 };
+	MapMode mapMode{};
+	std::vector<ConstantAllocation> allocations{};
+
+	DAE_CHECK(RunFrame(ring, 2, 256, mapMode, allocations));
+	ring.Reset();
+	DAE_CHECK(RunFrame(ring, 2, 256, mapMode, allocations));
+	DAE_CHECK(mapMode == MapMode::Discard);
+	DAE_CHECK_EQUAL(allocations.front().offset, 0u);
+}
+
+DAE_TEST_MAIN()
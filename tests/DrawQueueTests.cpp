@@ -0,0 +1,130 @@
+#include "DrawQueue.h"
+#include "TestFramework.h"
+
+#include <algorithm>
+#include <random>
+
+using namespace dae;
+using Item = DrawQueue::Item;
+
+namespace
+{
+	//Keys where only the bytes in varyingBytes (one bit per byte, bit 0 the least significant) differ, every other
+	//byte is the same for all keys and its pass is skipped. The index is the submission order.
+	std::vector<Item> CreateItems(size_t count, uint32_t seed, uint8_t varyingBytes = 0xFF)
+	{
+		std::mt19937_64 random{ seed };
+
+		uint64_t varyingMask{ 0 };
+		for (int byte = 0; byte < 8; ++byte)
+		{
+			if (varyingBytes & (1 << byte))
+			{
+				varyingMask |= 0xFFull << (byte * 8);
+			}
+		}
+
+		const uint64_t shared = random() & ~varyingMask;
+		std::vector<Item> items(count);
+		for (size_t i = 0; i < count; ++i)
+		{
+			items[i] = { shared | (random() & varyingMask), static_cast<uint32_t>(i) };
+		}
+		return items;
+	}
+
+	//Runs the radix sort and std::stable_sort on the same items, both keys and indices have to match
+	bool IsEqualToStableSort(const std::vector<Item>& submitted)
+	{
+		std::vector<Item> expected{ submitted };
+		std::stable_sort(expected.begin(), expected.end(), [](const Item& a, const Item& b) { return a.key < b.key; });
+
+		std::vector<Item> items{ submitted };
+		std::vector<Item> scratch;
+		DrawQueue::RadixSort(items, scratch);
+
+		return std::equal(items.begin(), items.end(), expected.begin(), expected.end(),
+			[](const Item& a, const Item& b) { return a.key == b.key && a.index == b.index; });
+	}
+}
+
+DAE_TEST(RadixSortMatchesStableSortOnRandomKeys)
+{
+	bool isEqual{ true };
+	for (size_t count = 0; count <= 33; ++count)
+	{
+		isEqual = isEqual && IsEqualToStableSort(CreateItems(count, static_cast<uint32_t>(count)));
+	}
+	isEqual = isEqual && IsEqualToStableSort(CreateItems(100'003, 1337));
+	DAE_CHECK(isEqual);
+
+	//Few distinct keys, so stability decides the order of most items
+	std::vector<Item> duplicates = CreateItems(10'000, 7);
+	for (Item& item : duplicates)
+	{
+		item.key %= 5;
+	}
+	DAE_CHECK(IsEqualToStableSort(duplicates));
+}
+
+DAE_TEST(RadixSortMatchesStableSortWithSkippedPasses)
+{
+	//Odd and even numbers of executed passes (the result ends in scratch or in place), only the top or bottom byte,
+	//bytes apart from each other and every pass skipped
+	for (const uint8_t varyingBytes : { 0x00, 0x01, 0x03, 0x07, 0x80, 0xC0, 0x81, 0x5A, 0x7F, 0xFE })
+	{
+		bool isEqual{ true };
+		for (size_t count = 0; count <= 33; ++count)
+		{
+			isEqual = isEqual && IsEqualToStableSort(CreateItems(count, static_cast<uint32_t>(count), varyingBytes));
+		}
+		isEqual = isEqual && IsEqualToStableSort(CreateItems(10'003, 1337, varyingBytes));
+
+		if (!isEqual)
+		{
+			std::cout << "  varying bytes 0x" << std::hex << static_cast<int>(varyingBytes) << std::dec << " differ\n";
+		}
+		DAE_CHECK(isEqual);
+	}
+}
+
+DAE_TEST(RadixSortLeavesZeroAndOneItemsAlone)
+{
+	std::vector<Item> items;
+	std::vector<Item> scratch;
+	DrawQueue::RadixSort(items, scratch);
+	DAE_CHECK(items.empty());
+
+	items = { { 0xDEADBEEF'01234567ull, 42 } };
+	DrawQueue::RadixSort(items, scratch);
+	DAE_CHECK_EQUAL(items.size(), size_t{ 1 });
+	DAE_CHECK(items[0].key == 0xDEADBEEF'01234567ull && items[0].index == 42);
+}
+
+DAE_TEST(SortGroupsOpaqueByStateAndTransparentBackToFront)
+{
+	DrawQueue queue;
+	queue.Submit(DrawQueue::CreateKey(DrawQueue::Pass::Transparent, 1, 1, 1, 0.2f), 0);
+	queue.Submit(DrawQueue::CreateKey(DrawQueue::Pass::Opaque, 2, 5, 1, 0.9f), 1);
+	queue.Submit(DrawQueue::CreateKey(DrawQueue::Pass::Opaque, 1, 3, 1, 0.5f), 2);
+	queue.Submit(DrawQueue::CreateKey(DrawQueue::Pass::Transparent, 1, 1, 1, 0.8f), 3);
+	queue.Submit(DrawQueue::CreateKey(DrawQueue::Pass::Opaque, 2, 5, 1, 0.1f), 4);
+	queue.Submit(DrawQueue::CreateKey(DrawQueue::Pass::Opaque, 1, 3, 1, 0.3f), 5);
+	queue.Sort();
+
+	//Technique 1 front to back, technique 2 front to back, then transparent far to near
+	const std::vector<uint32_t> expected{ 5, 2, 4, 1, 3, 0 };
+	std::vector<uint32_t> order;
+	for (const Item& item : queue.GetItems())
+	{
+		order.push_back(item.index);
+	}
+	DAE_CHECK(order == expected);
+
+	//Submission order switches state on every draw (5 changes), sorted there is one per group boundary
+	DAE_CHECK_EQUAL(queue.GetStatistics().numDraws, 6u);
+	DAE_CHECK_EQUAL(queue.GetStatistics().numStateChanges, 2u);
+	DAE_CHECK_EQUAL(queue.GetStatistics().numStateChangesAvoided, 3u);
+}
+
+DAE_TEST_MAIN()
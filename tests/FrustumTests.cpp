@@ -0,0 +1,248 @@
+#include "Frustum.h"
+#include "MathHelpers.h"
+#include "TestFramework.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <random>
+
+using namespace dae;
+using MatrixSIMD::InstructionSet;
+
+namespace
+{
+	//Past the AVX width twice, so every tail length shows up
+	constexpr size_t maxCount{ 33 };
+
+	std::vector<InstructionSet> GetSupportedInstructionSets()
+	{
+		std::vector<InstructionSet> instructionSets;
+		for (InstructionSet instructionSet : { InstructionSet::Scalar, InstructionSet::SSE2, InstructionSet::AVX })
+		{
+			if (MatrixSIMD::IsSupported(instructionSet))
+			{
+				instructionSets.push_back(instructionSet);
+			}
+		}
+		return instructionSets;
+	}
+
+	//Same camera as Frustum::Benchmark, the bounds below spread around its view volume
+	const Matrix g_ViewProjection = Matrix::InverseAffine(Matrix::CreateLookAtLH({ 3.0f, 5.0f, -60.0f }, { 0.1f, -0.05f, 1.0f }, Vector3::UnitY))
+		* Matrix::CreatePerspectiveFovLH(tanf(45.0f * TO_RADIANS / 2.0f), 16.0f / 9.0f, 1.0f, 100.0f);
+
+	float SignedDistance(const Plane& plane, const Vector3& point)
+	{
+		return Vector3::Dot(plane.normal, point) + plane.distance;
+	}
+
+	//In Frustum::PlaneIndex order: w + x, w - x, w + y, w - y, z, w - z
+	void GetClipDistances(const Vector3& point, float* pDistances)
+	{
+		const Vector4 clip = g_ViewProjection.TransformPoint(point.ToPoint4());
+		const float distances[Frustum::NumPlanes]{ clip.w + clip.x, clip.w - clip.x, clip.w + clip.y, clip.w - clip.y, clip.z, clip.w - clip.z };
+		std::copy(std::begin(distances), std::end(distances), pDistances);
+	}
+
+	std::vector<BoundingSphere> CreateSpheres(size_t count, uint32_t seed)
+	{
+		std::mt19937 random{ seed };
+		std::uniform_real_distribution<float> positionDistribution{ -80.0f, 80.0f };
+		std::uniform_real_distribution<float> sizeDistribution{ 0.1f, 8.0f };
+
+		std::vector<BoundingSphere> spheres(count);
+		for (BoundingSphere& sphere : spheres)
+		{
+			sphere = { { positionDistribution(random), positionDistribution(random), positionDistribution(random) * 0.5f + 40.0f }, sizeDistribution(random) };
+		}
+		return spheres;
+	}
+
+	std::vector<BoundingBox> CreateBoxes(size_t count, uint32_t seed)
+	{
+		std::mt19937 random{ seed };
+		std::uniform_real_distribution<float> positionDistribution{ -80.0f, 80.0f };
+		std::uniform_real_distribution<float> sizeDistribution{ 0.1f, 8.0f };
+
+		std::vector<BoundingBox> boxes(count);
+		for (BoundingBox& box : boxes)
+		{
+			box = { { positionDistribution(random), positionDistribution(random), positionDistribution(random) * 0.5f + 40.0f },
+				{ sizeDistribution(random), sizeDistribution(random), sizeDistribution(random) } };
+		}
+		return boxes;
+	}
+
+	//Runs the batch into a result with one guard element behind it, which has to survive
+	template<typename Bounds>
+	bool IsBatchEqualToScalar(const Frustum& frustum, const std::vector<Bounds>& bounds, InstructionSet instructionSet)
+	{
+		constexpr Containment guard{ static_cast<Containment>(0xCD) };
+		std::vector<Containment> result(bounds.size() + 1, guard);
+		frustum.Classify(std::span<const Bounds>{ bounds }, std::span<Containment>{ result }.first(bounds.size()), instructionSet);
+
+		bool isEqual = result.back() == guard;
+		for (size_t i = 0; i < bounds.size(); ++i)
+		{
+			isEqual = isEqual && result[i] == frustum.Classify(bounds[i]);
+		}
+		return isEqual;
+	}
+}
+
+DAE_TEST(PlanesMatchTheClipSpaceInequalities)
+{
+	std::mt19937 random{ 42 };
+	std::uniform_real_distribution<float> positionDistribution{ -120.0f, 120.0f };
+
+	const Frustum reference{ g_ViewProjection, InstructionSet::Scalar };
+	for (InstructionSet instructionSet : GetSupportedInstructionSets())
+	{
+		const Frustum frustum{ g_ViewProjection, instructionSet };
+
+		//Every extraction path gives the same planes, normalized
+		bool areEqual{ true };
+		bool areNormalized{ true };
+		for (int p = 0; p < Frustum::NumPlanes; ++p)
+		{
+			areEqual = areEqual && memcmp(&frustum.GetPlane(p), &reference.GetPlane(p), sizeof(Plane)) == 0;
+			areNormalized = areNormalized && std::abs(frustum.GetPlane(p).normal.SqrMagnitude() - 1.0f) < 1e-5f;
+		}
+		DAE_CHECK(areEqual);
+		DAE_CHECK(areNormalized);
+
+		//A point is on the inner side of plane p exactly when its clip space inequality holds
+		bool areSidesEqual{ true };
+		for (int i = 0; i < 1000; ++i)
+		{
+			const Vector3 point{ positionDistribution(random), positionDistribution(random), positionDistribution(random) };
+			float distances[Frustum::NumPlanes];
+			GetClipDistances(point, distances);
+
+			for (int p = 0; p < Frustum::NumPlanes; ++p)
+			{
+				const float distance = SignedDistance(frustum.GetPlane(p), point);
+				if (std::abs(distances[p]) > 1e-3f)
+				{
+					areSidesEqual = areSidesEqual && (distance >= 0.0f) == (distances[p] >= 0.0f);
+				}
+			}
+		}
+		DAE_CHECK(areSidesEqual);
+	}
+}
+
+DAE_TEST(PlanesOfAnAxisAlignedCameraAreInWorldUnits)
+{
+	//Looking down +z from the origin, near 1 and far 100
+	const Frustum frustum{ Matrix::CreatePerspectiveFovLH(1.0f, 1.0f, 1.0f, 100.0f) };
+
+	const Plane& nearPlane = frustum.GetPlane(Frustum::Near);
+	const Plane& farPlane = frustum.GetPlane(Frustum::Far);
+	DAE_CHECK(std::abs(nearPlane.normal.z - 1.0f) < 1e-6f && std::abs(nearPlane.distance + 1.0f) < 1e-5f);
+	DAE_CHECK(std::abs(farPlane.normal.z + 1.0f) < 1e-6f && std::abs(farPlane.distance - 100.0f) < 1e-3f);
+
+	//The side planes pass through the eye
+	for (int p : { Frustum::Left, Frustum::Right, Frustum::Bottom, Frustum::Top })
+	{
+		DAE_CHECK(std::abs(frustum.GetPlane(p).distance) < 1e-6f);
+	}
+
+	DAE_CHECK(frustum.Classify(BoundingSphere{ { 0.0f, 0.0f, 50.0f }, 1.0f }) == Containment::Inside);
+	DAE_CHECK(frustum.Classify(BoundingSphere{ { 0.0f, 0.0f, 1.0f }, 0.5f }) == Containment::Intersecting);
+	DAE_CHECK(frustum.Classify(BoundingSphere{ { 0.0f, 0.0f, -5.0f }, 1.0f }) == Containment::Outside);
+	DAE_CHECK(frustum.Classify(BoundingBox{ { 0.0f, 0.0f, 101.0f }, { 1.0f, 1.0f, 0.5f } }) == Containment::Outside);
+	DAE_CHECK(frustum.Classify(BoundingBox{ { 0.0f, 0.0f, 100.0f }, { 1.0f, 1.0f, 0.5f } }) == Containment::Intersecting);
+}
+
+DAE_TEST(BatchedSpheresMatchScalarAtEveryCount)
+{
+	const Frustum frustum{ g_ViewProjection };
+	for (InstructionSet instructionSet : GetSupportedInstructionSets())
+	{
+		bool isEqual{ true };
+		for (size_t count = 0; count <= maxCount; ++count)
+		{
+			isEqual = isEqual && IsBatchEqualToScalar(frustum, CreateSpheres(count, static_cast<uint32_t>(count)), instructionSet);
+		}
+
+		//A large batch hits every classification many times
+		isEqual = isEqual && IsBatchEqualToScalar(frustum, CreateSpheres(10'003, 1337), instructionSet);
+
+		if (!isEqual)
+		{
+			std::cout << "  " << MatrixSIMD::GetName(instructionSet) << " differs\n";
+		}
+		DAE_CHECK(isEqual);
+	}
+}
+
+DAE_TEST(BatchedBoxesMatchScalarAtEveryCount)
+{
+	const Frustum frustum{ g_ViewProjection };
+	for (InstructionSet instructionSet : GetSupportedInstructionSets())
+	{
+		bool isEqual{ true };
+		for (size_t count = 0; count <= maxCount; ++count)
+		{
+			isEqual = isEqual && IsBatchEqualToScalar(frustum, CreateBoxes(count, static_cast<uint32_t>(count)), instructionSet);
+		}
+
+		isEqual = isEqual && IsBatchEqualToScalar(frustum, CreateBoxes(10'003, 1337), instructionSet);
+
+		if (!isEqual)
+		{
+			std::cout << "  " << MatrixSIMD::GetName(instructionSet) << " differs\n";
+		}
+		DAE_CHECK(isEqual);
+	}
+}
+
+DAE_TEST(BoxClassificationIsConservative)
+{
+	const Frustum frustum{ g_ViewProjection };
+	const std::vector<BoundingBox> boxes = CreateBoxes(10'000, 7);
+
+	int counts[3]{};
+	bool isConservative{ true };
+	for (const BoundingBox& box : boxes)
+	{
+		const Containment containment = frustum.Classify(box);
+		++counts[static_cast<int>(containment)];
+
+		//Inside: every corner is inside all planes. Outside: every corner is outside one shared plane.
+		int numOutside[Frustum::NumPlanes]{};
+		bool areCornersInside{ true };
+		for (int corner = 0; corner < 8; ++corner)
+		{
+			const Vector3& e = box.extents;
+			const Vector3 point = box.center + Vector3{ corner & 1 ? e.x : -e.x, corner & 2 ? e.y : -e.y, corner & 4 ? e.z : -e.z };
+
+			float distances[Frustum::NumPlanes];
+			GetClipDistances(point, distances);
+			const float tolerance = 1e-4f * (std::abs(g_ViewProjection.TransformPoint(point.ToPoint4()).w) + 1.0f);
+			for (int p = 0; p < Frustum::NumPlanes; ++p)
+			{
+				areCornersInside = areCornersInside && distances[p] >= -tolerance;
+				numOutside[p] += distances[p] < tolerance ? 1 : 0;
+			}
+		}
+
+		if (containment == Containment::Inside)
+		{
+			isConservative = isConservative && areCornersInside;
+		}
+		else if (containment == Containment::Outside)
+		{
+			isConservative = isConservative && std::any_of(std::begin(numOutside), std::end(numOutside), [](int n) { return n == 8; });
+		}
+	}
+
+	DAE_CHECK(isConservative);
+
+	//The set covers all three outcomes, or the checks above prove little
+	DAE_CHECK(counts[0] > 0 && counts[1] > 0 && counts[2] > 0);
+}
+
+DAE_TEST_MAIN()
@@ -0,0 +1,268 @@
+#include "MatrixSIMD.h"
+#include "Matrix.h"
+#include "TestFramework.h"
+
+#include <algorithm>
+#include <cfloat>
+#include <cmath>
+#include <cstring>
+#include <random>
+
+using namespace dae;
+using namespace dae::MatrixSIMD;
+
+namespace
+{
+	std::vector<InstructionSet> GetSupportedInstructionSets()
+	{
+		std::vector<InstructionSet> instructionSets;
+		for (InstructionSet instructionSet : { InstructionSet::Scalar, InstructionSet::SSE2, InstructionSet::AVX })
+		{
+			if (IsSupported(instructionSet))
+			{
+				instructionSets.push_back(instructionSet);
+			}
+		}
+		return instructionSets;
+	}
+
+	bool IsIdentity(const Matrix& m, float tolerance)
+	{
+		bool isIdentity{ true };
+		for (int r = 0; r < 4; ++r)
+		{
+			for (int c = 0; c < 4; ++c)
+			{
+				isIdentity = isIdentity && std::abs(m[r][c] - (r == c ? 1.0f : 0.0f)) <= tolerance;
+			}
+		}
+		return isIdentity;
+	}
+
+	//Gauss-Jordan with partial pivoting in double precision, the exact inverse the float kernels are measured against
+	bool InverseReference(const Matrix& m, double* pResult)
+	{
+		double a[4][8]{};
+		for (int r = 0; r < 4; ++r)
+		{
+			for (int c = 0; c < 4; ++c)
+			{
+				a[r][c] = m[r][c];
+			}
+			a[r][4 + r] = 1.0;
+		}
+
+		for (int c = 0; c < 4; ++c)
+		{
+			int pivot{ c };
+			for (int r = c + 1; r < 4; ++r)
+			{
+				if (std::abs(a[r][c]) > std::abs(a[pivot][c]))
+					pivot = r;
+			}
+			if (a[pivot][c] == 0.0)
+				return false;
+			std::swap(a[c], a[pivot]);
+
+			const double invPivot = 1.0 / a[c][c];
+			for (int k = 0; k < 8; ++k)
+			{
+				a[c][k] *= invPivot;
+			}
+			for (int r = 0; r < 4; ++r)
+			{
+				if (r == c)
+					continue;
+
+				const double factor = a[r][c];
+				for (int k = 0; k < 8; ++k)
+				{
+					a[r][k] -= factor * a[c][k];
+				}
+			}
+		}
+
+		for (int r = 0; r < 4; ++r)
+		{
+			for (int c = 0; c < 4; ++c)
+			{
+				pResult[r * 4 + c] = a[r][4 + c];
+			}
+		}
+		return true;
+	}
+
+	//Largest element wise error relative to the largest element of the exact inverse, over every matrix the kernel inverts
+	template<typename Kernel>
+	double GetMaxError(const std::vector<Matrix>& matrices, const Kernel& kernel)
+	{
+		double maxError{};
+		for (const Matrix& m : matrices)
+		{
+			double reference[16];
+			Matrix result;
+			if (!InverseReference(m, reference) || !kernel(m.GetData(), result.GetData()))
+				return INFINITY;
+
+			double maxReference{};
+			double maxDifference{};
+			for (int j = 0; j < 16; ++j)
+			{
+				maxReference = std::max(maxReference, std::abs(reference[j]));
+				maxDifference = std::max(maxDifference, std::abs(reference[j] - result.GetData()[j]));
+			}
+			maxError = std::max(maxError, maxDifference / maxReference);
+		}
+		return maxError;
+	}
+
+	//A set of inputs with the largest relative error Inverse and InverseAffine may have on it, about four times what
+	//the kernels measure. InverseAffine only runs on the affine sets (last column 0, 0, 0, 1), a tolerance of 0 skips it.
+	struct AccuracyInput
+	{
+		const char* pName;
+		std::vector<Matrix> matrices;
+		double inverseTolerance;
+		double inverseAffineTolerance;
+	};
+
+	std::vector<AccuracyInput> CreateAccuracyInputs()
+	{
+		constexpr int numMatrices{ 1024 };
+
+		std::mt19937 random{ 1337 };
+		std::uniform_real_distribution<float> valueDistribution{ -2.0f, 2.0f };
+		const auto randomVector = [&](float scale) { return Vector3{ valueDistribution(random), valueDistribution(random), valueDistribution(random) } * scale; };
+
+		std::vector<AccuracyInput> inputs;
+
+		//Well conditioned 3x3 part, once affine and once with a projective last column
+		AccuracyInput affine{ "random affine", std::vector<Matrix>(numMatrices), 1e-6, 1e-6 };
+		AccuracyInput projective{ "random projective", std::vector<Matrix>(numMatrices), 2e-4, 0.0 };
+		for (int i = 0; i < numMatrices; ++i)
+		{
+			for (Matrix* pMatrix : { &affine.matrices[i], &projective.matrices[i] })
+			{
+				float* pM = pMatrix->GetData();
+				for (int j = 0; j < 16; ++j)
+				{
+					pM[j] = valueDistribution(random);
+				}
+				pM[0] += 4.0f; pM[5] += 4.0f; pM[10] += 4.0f;
+				pM[3] = pM[7] = pM[11] = 0.0f;
+				pM[15] = 1.0f;
+			}
+			projective.matrices[i][2][3] = 1.0f;
+			projective.matrices[i][3][3] = valueDistribution(random);
+		}
+		inputs.push_back(std::move(affine));
+		inputs.push_back(std::move(projective));
+
+		//What the renderer inverts, with the engine's depth range of 0.1 to 100
+		AccuracyInput worldViewProjections{ "world view projection", std::vector<Matrix>(numMatrices), 1e-3, 0.0 };
+		for (Matrix& m : worldViewProjections.matrices)
+		{
+			const Vector3 position = randomVector(25.0f);
+			const Matrix world = Matrix::CreateScale(Vector3{ 2.5f, 2.5f, 2.5f } + randomVector(1.0f)) * Matrix::CreateRotation(randomVector(1.0f)) * Matrix::CreateTranslation(position);
+			const Vector3 eye = randomVector(50.0f) + Vector3{ 0.0f, 60.0f, 0.0f };
+			const Matrix view = Matrix::Inverse(Matrix::CreateLookAtLH(eye, (position - eye).Normalized(), Vector3::UnitY));
+			m = world * view * Matrix::CreatePerspectiveFovLH(0.8f + valueDistribution(random) * 0.2f, 16.0f / 9.0f, 0.1f, 100.0f);
+		}
+		inputs.push_back(std::move(worldViewProjections));
+
+		//Axes scaled six orders of magnitude apart, far from the origin
+		AccuracyInput badlyScaled{ "badly scaled", std::vector<Matrix>(numMatrices), 1e-4, 2.5e-5 };
+		for (Matrix& m : badlyScaled.matrices)
+		{
+			m = Matrix::CreateScale(1e-3f, 1.0f, 1e3f) * Matrix::CreateRotation(randomVector(1.0f)) * Matrix::CreateTranslation(randomVector(1e4f));
+		}
+		inputs.push_back(std::move(badlyScaled));
+
+		//A 3x3 part with a condition number of 1e3: one axis squashed between two rotations, the bound is that condition times epsilon
+		AccuracyInput nearSingular{ "near singular", std::vector<Matrix>(numMatrices), 1e3 * FLT_EPSILON, 1e3 * FLT_EPSILON };
+		for (Matrix& m : nearSingular.matrices)
+		{
+			m = Matrix::CreateRotation(randomVector(1.0f)) * Matrix::CreateScale(1.0f, 1.0f, 1e-3f) * Matrix::CreateRotation(randomVector(1.0f))
+				* Matrix::CreateTranslation(randomVector(1.0f));
+		}
+		inputs.push_back(std::move(nearSingular));
+
+		return inputs;
+	}
+}
+
+DAE_TEST(SmallUniformScalesAreInvertible)
+{
+	for (InstructionSet instructionSet : GetSupportedInstructionSets())
+	{
+		for (const float scale : { 1.0f, 0.005f, 0.001f, 1e-6f })
+		{
+			const Matrix m = Matrix::CreateScale(scale, scale, scale) * Matrix::CreateRotation(0.3f, 1.1f, -0.4f)
+				* Matrix::CreateTranslation(scale * 3.0f, -scale, scale * 2.0f);
+
+			Matrix inverse;
+			DAE_CHECK(Inverse(m.GetData(), inverse.GetData(), instructionSet));
+			DAE_CHECK(IsIdentity(m * inverse, 1e-5f));
+
+			Matrix inverseAffine;
+			DAE_CHECK(InverseAffine(m.GetData(), inverseAffine.GetData(), instructionSet));
+			DAE_CHECK(IsIdentity(m * inverseAffine, 1e-5f));
+		}
+	}
+
+	//Through Matrix, which used to assert (and in release keep the matrix) below a scale of about 0.005
+	const Matrix m = Matrix::CreateScale(0.001f, 0.001f, 0.001f) * Matrix::CreateTranslation(0.5f, 0.25f, 0.0f);
+	DAE_CHECK(IsIdentity(m * Matrix::Inverse(m), 1e-5f));
+	DAE_CHECK(IsIdentity(m * Matrix::InverseAffine(m), 1e-5f));
+}
+
+DAE_TEST(SingularMatricesAreRejectedAtEveryScale)
+{
+	for (InstructionSet instructionSet : GetSupportedInstructionSets())
+	{
+		for (const float scale : { 1e-6f, 1.0f, 1e6f })
+		{
+			//Two parallel rows, and a flattened axis
+			const Matrix parallel{
+				Vector4{ scale, 2.0f * scale, 0.0f, 0.0f },
+				Vector4{ 2.0f * scale, 4.0f * scale, 0.0f, 0.0f },
+				Vector4{ 0.0f, 0.0f, scale, 0.0f },
+				Vector4{ scale, scale, scale, 1.0f }
+			};
+			const Matrix flattened = Matrix::CreateScale(scale, 0.0f, scale) * Matrix::CreateTranslation(scale, scale, scale);
+
+			Matrix result = Matrix::CreateTranslation(7.0f, 7.0f, 7.0f);
+			const Matrix untouched = result;
+			DAE_CHECK(!Inverse(parallel.GetData(), result.GetData(), instructionSet));
+			DAE_CHECK(!InverseAffine(parallel.GetData(), result.GetData(), instructionSet));
+			DAE_CHECK(!Inverse(flattened.GetData(), result.GetData(), instructionSet));
+			DAE_CHECK(!InverseAffine(flattened.GetData(), result.GetData(), instructionSet));
+			DAE_CHECK(memcmp(result.GetData(), untouched.GetData(), sizeof(Matrix)) == 0);
+		}
+	}
+}
+
+DAE_TEST(InversesStayCloseToDoublePrecision)
+{
+	const std::vector<AccuracyInput> inputs = CreateAccuracyInputs();
+	for (InstructionSet instructionSet : GetSupportedInstructionSets())
+	{
+		const auto inverse = [instructionSet](const float* pM, float* pResult) { return Inverse(pM, pResult, instructionSet); };
+		const auto inverseAffine = [instructionSet](const float* pM, float* pResult) { return InverseAffine(pM, pResult, instructionSet); };
+
+		for (const AccuracyInput& input : inputs)
+		{
+			const double inverseError = GetMaxError(input.matrices, inverse);
+			const double inverseAffineError = input.inverseAffineTolerance > 0.0 ? GetMaxError(input.matrices, inverseAffine) : 0.0;
+
+			if (inverseError > input.inverseTolerance || inverseAffineError > input.inverseAffineTolerance)
+			{
+				std::cout << "  " << GetName(instructionSet) << " " << input.pName << ": " << inverseError << ", " << inverseAffineError << "\n";
+			}
+			DAE_CHECK(inverseError <= input.inverseTolerance);
+			DAE_CHECK(inverseAffineError <= input.inverseAffineTolerance);
+		}
+	}
+}
+
+DAE_TEST_MAIN()
@@ -0,0 +1,228 @@
+#include "PixelConversion.h"
+#include "TestFramework.h"
+
+#include <algorithm>
+#include <cstring>
+#include <random>
+
+using namespace dae;
+using namespace dae::PixelConversion;
+
+namespace
+{
+	constexpr size_t bytesPerPixel{ 4 };
+
+	//Past every vector width, so each SIMD loop runs at least twice and every scalar tail length shows up
+	constexpr size_t maxWidth{ 33 };
+
+	//Written past the last pixel, a kernel that touches it writes out of bounds
+	constexpr uint8_t guardByte{ 0xCD };
+
+	const std::vector<ChannelOrder> g_Orders24{
+		{ 0, 1, 2, NoChannel },		//RGB
+		{ 2, 1, 0, NoChannel }		//BGR
+	};
+
+	const std::vector<ChannelOrder> g_Orders32{
+		{ 0, 1, 2, 3 },				//RGBA
+		{ 1, 2, 3, 0 },				//ARGB
+		{ 2, 1, 0, NoChannel },		//BGRX
+		{ 2, 1, 0, 3 }				//BGRA
+	};
+
+	std::vector<InstructionSet> GetSupportedInstructionSets()
+	{
+		std::vector<InstructionSet> instructionSets;
+		for (InstructionSet instructionSet : { InstructionSet::SSE41, InstructionSet::AVX2 })
+		{
+			if (IsSupported(instructionSet))
+			{
+				instructionSets.push_back(instructionSet);
+			}
+		}
+		return instructionSets;
+	}
+
+	std::vector<uint8_t> CreateRandomBytes(size_t size, uint32_t seed)
+	{
+		std::mt19937 random{ seed };
+		std::uniform_int_distribution<int> byteDistribution{ 0, 255 };
+
+		std::vector<uint8_t> bytes(size);
+		for (uint8_t& byte : bytes)
+		{
+			byte = static_cast<uint8_t>(byteDistribution(random));
+		}
+		return bytes;
+	}
+
+	//Runs the kernel on width pixels into a buffer with one guard pixel behind them
+	template<typename Kernel>
+	std::vector<uint8_t> Run(size_t width, const Kernel& kernel)
+	{
+		std::vector<uint8_t> output((width + 1) * bytesPerPixel, guardByte);
+		kernel(output.data());
+		return output;
+	}
+}
+
+DAE_TEST(ScalarKernelsPlaceEveryChannel)
+{
+	const uint8_t rgb[]{ 10, 20, 30 };
+	uint8_t rgba[4]{};
+	ExpandToRGBA(rgb, rgba, 1, g_Orders24[1], InstructionSet::Scalar);
+	DAE_CHECK_EQUAL(rgba[0], 30);
+	DAE_CHECK_EQUAL(rgba[1], 20);
+	DAE_CHECK_EQUAL(rgba[2], 10);
+	DAE_CHECK_EQUAL(rgba[3], 255);
+
+	const uint8_t argb[]{ 40, 10, 20, 30 };
+	SwizzleToRGBA(argb, rgba, 1, g_Orders32[1], InstructionSet::Scalar);
+	DAE_CHECK_EQUAL(rgba[0], 10);
+	DAE_CHECK_EQUAL(rgba[1], 20);
+	DAE_CHECK_EQUAL(rgba[2], 30);
+	DAE_CHECK_EQUAL(rgba[3], 40);
+
+	//Every product of two bytes rounds to nearest, alpha itself is kept
+	bool isRounded{ true };
+	for (uint32_t alpha = 0; alpha < 256; ++alpha)
+	{
+		for (uint32_t color = 0; color < 256; ++color)
+		{
+			uint8_t pixel[4]{ static_cast<uint8_t>(color), 0, 255, static_cast<uint8_t>(alpha) };
+			PremultiplyAlpha(pixel, 1, InstructionSet::Scalar);
+
+			const uint32_t expected = (color * alpha * 2 + 255) / 510;
+			isRounded = isRounded && pixel[0] == expected && pixel[1] == 0 && pixel[2] == alpha && pixel[3] == alpha;
+		}
+	}
+	DAE_CHECK(isRounded);
+}
+
+DAE_TEST(ExpandToRGBAMatchesScalarAtEveryWidth)
+{
+	for (InstructionSet instructionSet : GetSupportedInstructionSets())
+	{
+		for (const ChannelOrder& order : g_Orders24)
+		{
+			bool isEqual{ true };
+			for (size_t width = 1; width <= maxWidth; ++width)
+			{
+				//Exactly width pixels, the vector loads must not need more
+				const std::vector<uint8_t> input = CreateRandomBytes(width * 3, static_cast<uint32_t>(width));
+				const std::vector<uint8_t> expected = Run(width, [&](uint8_t* pDst) { ExpandToRGBA(input.data(), pDst, width, order, InstructionSet::Scalar); });
+				const std::vector<uint8_t> actual = Run(width, [&](uint8_t* pDst) { ExpandToRGBA(input.data(), pDst, width, order, instructionSet); });
+				isEqual = isEqual && expected == actual;
+			}
+
+			if (!isEqual)
+			{
+				std::cout << "  " << GetName(instructionSet) << " differs\n";
+			}
+			DAE_CHECK(isEqual);
+		}
+	}
+}
+
+DAE_TEST(SwizzleToRGBAMatchesScalarAtEveryWidth)
+{
+	for (InstructionSet instructionSet : GetSupportedInstructionSets())
+	{
+		for (const ChannelOrder& order : g_Orders32)
+		{
+			bool isEqual{ true };
+			for (size_t width = 1; width <= maxWidth; ++width)
+			{
+				const std::vector<uint8_t> input = CreateRandomBytes(width * bytesPerPixel, static_cast<uint32_t>(width));
+				const std::vector<uint8_t> expected = Run(width, [&](uint8_t* pDst) { SwizzleToRGBA(input.data(), pDst, width, order, InstructionSet::Scalar); });
+				const std::vector<uint8_t> actual = Run(width, [&](uint8_t* pDst) { SwizzleToRGBA(input.data(), pDst, width, order, instructionSet); });
+				isEqual = isEqual && expected == actual;
+
+				//In place, as the header allows
+				std::vector<uint8_t> inPlace = input;
+				SwizzleToRGBA(inPlace.data(), inPlace.data(), width, order, instructionSet);
+				isEqual = isEqual && std::equal(inPlace.begin(), inPlace.end(), expected.begin());
+			}
+
+			if (!isEqual)
+			{
+				std::cout << "  " << GetName(instructionSet) << " differs\n";
+			}
+			DAE_CHECK(isEqual);
+		}
+	}
+}
+
+DAE_TEST(ExpandPaletteMatchesScalarAtEveryWidth)
+{
+	const std::vector<uint8_t> paletteBytes = CreateRandomBytes(256 * sizeof(uint32_t), 1337);
+	std::vector<uint32_t> palette(256);
+	memcpy(palette.data(), paletteBytes.data(), paletteBytes.size());
+
+	for (InstructionSet instructionSet : GetSupportedInstructionSets())
+	{
+		bool isEqual{ true };
+		for (size_t width = 1; width <= maxWidth; ++width)
+		{
+			const std::vector<uint8_t> indices = CreateRandomBytes(width, static_cast<uint32_t>(width));
+			const std::vector<uint8_t> expected = Run(width, [&](uint8_t* pDst) { ExpandPalette(indices.data(), palette.data(), pDst, width, InstructionSet::Scalar); });
+			const std::vector<uint8_t> actual = Run(width, [&](uint8_t* pDst) { ExpandPalette(indices.data(), palette.data(), pDst, width, instructionSet); });
+			isEqual = isEqual && expected == actual;
+		}
+
+		if (!isEqual)
+		{
+			std::cout << "  " << GetName(instructionSet) << " differs\n";
+		}
+		DAE_CHECK(isEqual);
+	}
+}
+
+DAE_TEST(PremultiplyAlphaMatchesScalarAtEveryWidth)
+{
+	for (InstructionSet instructionSet : GetSupportedInstructionSets())
+	{
+		bool isEqual{ true };
+		for (size_t width = 1; width <= maxWidth; ++width)
+		{
+			const std::vector<uint8_t> input = CreateRandomBytes(width * bytesPerPixel, static_cast<uint32_t>(width));
+			const auto premultiply = [&](InstructionSet set)
+			{
+				return Run(width, [&](uint8_t* pPixels)
+				{
+					memcpy(pPixels, input.data(), input.size());
+					PremultiplyAlpha(pPixels, width, set);
+				});
+			};
+
+			isEqual = isEqual && premultiply(InstructionSet::Scalar) == premultiply(instructionSet);
+		}
+
+		if (!isEqual)
+		{
+			std::cout << "  " << GetName(instructionSet) << " differs\n";
+		}
+		DAE_CHECK(isEqual);
+	}
+}
+
+DAE_TEST(ZeroPixelsWriteNothing)
+{
+	for (InstructionSet instructionSet : { InstructionSet::Scalar, InstructionSet::SSE41, InstructionSet::AVX2 })
+	{
+		if (!IsSupported(instructionSet))
+			continue;
+
+		const uint8_t input[bytesPerPixel]{};
+		const uint32_t palette[1]{};
+		std::vector<uint8_t> output(bytesPerPixel, guardByte);
+
+		ExpandToRGBA(input, output.data(), 0, g_Orders24[0], instructionSet);
+		SwizzleToRGBA(input, output.data(), 0, g_Orders32[0], instructionSet);
+		ExpandPalette(input, palette, output.data(), 0, instructionSet);
+		PremultiplyAlpha(output.data(), 0, instructionSet);
+		DAE_CHECK(std::all_of(output.begin(), output.end(), [](uint8_t byte) { return byte == guardByte; }));
+	}
+}
+
+DAE_TEST_MAIN()
@@ -0,0 +1,97 @@
+#include "Quaternion.h"
+#include "MathHelpers.h"
+#include "TestFramework.h"
+
+#include <cmath>
+
+using namespace dae;
+
+namespace
+{
+	bool IsClose(const Vector3& a, const Vector3& b, float tolerance = 1e-5f)
+	{
+		return std::abs(a.x - b.x) <= tolerance && std::abs(a.y - b.y) <= tolerance && std::abs(a.z - b.z) <= tolerance;
+	}
+
+	bool IsClose(const Matrix& a, const Matrix& b, float tolerance = 1e-5f)
+	{
+		bool isClose{ true };
+		for (int r = 0; r < 4; ++r)
+		{
+			for (int c = 0; c < 4; ++c)
+			{
+				isClose = isClose && std::abs(a[r][c] - b[r][c]) <= tolerance;
+			}
+		}
+		return isClose;
+	}
+
+	const Vector3 g_Points[]{ { 1.0f, 0.0f, 0.0f }, { 0.0f, 1.0f, 0.0f }, { 0.0f, 0.0f, 1.0f }, { 0.3f, -2.0f, 1.5f } };
+}
+
+DAE_TEST(ProductOfBasisQuaternionsIsReversedHamilton)
+{
+	//i, j and k as rotations of 180 degrees, a * b is the Hamilton product b * a
+	constexpr Quaternion i{ 1.0f, 0.0f, 0.0f, 0.0f };
+	constexpr Quaternion j{ 0.0f, 1.0f, 0.0f, 0.0f };
+	constexpr Quaternion k{ 0.0f, 0.0f, 1.0f, 0.0f };
+
+	static_assert(i * j == Quaternion{ 0.0f, 0.0f, -1.0f, 0.0f });
+	static_assert(j * i == k);
+	static_assert(k * j == i);
+	static_assert(i * i == Quaternion{ 0.0f, 0.0f, 0.0f, -1.0f });
+	static_assert(Quaternion::Identity * k == k && k * Quaternion::Identity == k);
+}
+
+DAE_TEST(ProductRotatesByTheLeftOperandFirst)
+{
+	const Quaternion a = Quaternion::CreateFromAxisAngle(Vector3::UnitY, PI_DIV_2);
+	const Quaternion b = Quaternion::CreateFromAxisAngle(Vector3::UnitX, PI_DIV_2);
+
+	for (const Vector3& point : g_Points)
+	{
+		DAE_CHECK(IsClose((a * b).Rotate(point), b.Rotate(a.Rotate(point))));
+	}
+
+	//90 degrees about y takes x to -z (like Matrix::CreateRotationY), 90 degrees about x then takes -z to y
+	DAE_CHECK(IsClose(a.Rotate(Vector3::UnitX), Vector3{ 0.0f, 0.0f, -1.0f }));
+	DAE_CHECK(IsClose((a * b).Rotate(Vector3::UnitX), Vector3::UnitY));
+	DAE_CHECK(!IsClose((b * a).Rotate(Vector3::UnitX), Vector3::UnitY));
+}
+
+DAE_TEST(ToMatrixFollowsTheRowVectorConvention)
+{
+	const Quaternion a = Quaternion::CreateRotation(0.4f, -1.2f, 0.7f);
+	const Quaternion b = Quaternion::CreateFromAxisAngle({ 1.0f, 2.0f, -0.5f }, 2.1f);
+
+	//v * M rotates like Rotate, and products of matrices compose like products of quaternions
+	for (const Vector3& point : g_Points)
+	{
+		DAE_CHECK(IsClose(a.ToMatrix().TransformVector(point), a.Rotate(point)));
+		DAE_CHECK(IsClose(a.ToMatrix().TransformPoint(point), a.Rotate(point)));
+	}
+	DAE_CHECK(IsClose((a * b).ToMatrix(), a.ToMatrix() * b.ToMatrix()));
+
+	//The same rotations as the Matrix factories
+	DAE_CHECK(IsClose(Quaternion::CreateFromAxisAngle(Vector3::UnitY, 0.8f).ToMatrix(), Matrix::CreateRotationY(0.8f)));
+	DAE_CHECK(IsClose(Quaternion::CreateFromAxisAngle(Vector3::UnitZ, 0.8f).ToMatrix(), Matrix::CreateRotationZ(0.8f)));
+	DAE_CHECK(IsClose(Quaternion::CreateRotation(0.8f, 0.0f, 0.0f).ToMatrix(), Matrix::CreateRotationX(0.8f)));
+	DAE_CHECK(IsClose(a.ToMatrix(), Matrix::CreateRotation(0.4f, -1.2f, 0.7f)));
+
+	//The conjugate is the transpose
+	DAE_CHECK(IsClose(a.Conjugate().ToMatrix(), Matrix::Transpose(a.ToMatrix())));
+}
+
+DAE_TEST(SlerpTakesTheShortArc)
+{
+	const Quaternion a = Quaternion::CreateFromAxisAngle(Vector3::UnitY, 0.2f);
+	const Quaternion b = Quaternion::CreateFromAxisAngle(Vector3::UnitY, 1.0f);
+	const Quaternion negatedB{ -b.x, -b.y, -b.z, -b.w };
+
+	const Quaternion expected = Quaternion::CreateFromAxisAngle(Vector3::UnitY, 0.6f);
+	DAE_CHECK(IsClose(Quaternion::Slerp(a, b, 0.5f).ToMatrix(), expected.ToMatrix()));
+	DAE_CHECK(IsClose(Quaternion::Slerp(a, negatedB, 0.5f).ToMatrix(), expected.ToMatrix()));
+	DAE_CHECK(std::abs(Quaternion::Slerp(a, a, 0.3f).Magnitude() - 1.0f) < 1e-6f);
+}
+
+DAE_TEST_MAIN()
@@ -0,0 +1,242 @@
+#include "ReadbackQueue.h"
+#include "TestFramework.h"
+
+using namespace dae;
+
+namespace
+{
+	// Renders frames of a known pattern into slots with padded rows. A copy takes latency polls to finish, waiting
+	// finishes it at once.
+	class SyntheticFrames final
+	{
+	public:
+		SyntheticFrames(uint32_t numSlots, uint32_t width, uint32_t height, uint32_t rowPitch, uint32_t latency)
+			: m_Width{ width }
+			, m_Height{ height }
+			, m_RowPitch{ rowPitch }
+			, m_Latency{ latency }
+			, m_Slots(numSlots)
+		{
+		}
+
+		// The frame the next Copy reads
+		void Render(uint64_t frameIndex) { m_RenderedFrame = frameIndex; }
+		void FailNextMap() { m_IsFailingNextMap = true; }
+
+		uint32_t GetNumWaits() const { return m_NumWaits; }
+		bool IsAnySlotMapped() const
+		{
+			for (const Slot& slot : m_Slots)
+			{
+				if (slot.isMapped)
+					return true;
+			}
+			return false;
+		}
+
+		static uint8_t GetPixelByte(uint64_t frameIndex, uint32_t x, uint32_t y, uint32_t channel)
+		{
+			return static_cast<uint8_t>(frameIndex * 31 + x * 7 + y * 13 + channel);
+		}
+
+		uint32_t GetNumSlots() const { return static_cast<uint32_t>(m_Slots.size()); }
+		uint32_t GetWidth() const { return m_Width; }
+		uint32_t GetHeight() const { return m_Height; }
+
+		void Copy(uint32_t slot)
+		{
+			Slot& target = m_Slots[slot];
+			target.data.assign(static_cast<size_t>(m_RowPitch) * m_Height, 0xCD);
+			for (uint32_t y = 0; y < m_Height; ++y)
+			{
+				for (uint32_t x = 0; x < m_Width; ++x)
+				{
+					for (uint32_t channel = 0; channel < 4; ++channel)
+					{
+						target.data[y * m_RowPitch + x * 4 + channel] = GetPixelByte(m_RenderedFrame, x, y, channel);
+					}
+				}
+			}
+			target.remainingPolls = m_Latency;
+		}
+
+		ReadbackStatus Map(uint32_t slot, bool isWaiting, const uint8_t*& pData, uint32_t& rowPitch)
+		{
+			Slot& target = m_Slots[slot];
+			if (target.remainingPolls > 0)
+			{
+				if (!isWaiting)
+				{
+					--target.remainingPolls;
+					return ReadbackStatus::Pending;
+				}
+
+				++m_NumWaits;
+				target.remainingPolls = 0;
+			}
+
+			if (m_IsFailingNextMap)
+			{
+				m_IsFailingNextMap = false;
+				return ReadbackStatus::Failed;
+			}
+
+			target.isMapped = true;
+			pData = target.data.data();
+			rowPitch = m_RowPitch;
+			return ReadbackStatus::Ready;
+		}
+
+		void Unmap(uint32_t slot) { m_Slots[slot].isMapped = false; }
+
+	private:
+		struct Slot
+		{
+			std::vector<uint8_t> data{};
+			uint32_t remainingPolls{};
+			bool isMapped{};
+		};
+
+		const uint32_t m_Width;
+		const uint32_t m_Height;
+		const uint32_t m_RowPitch;
+		const uint32_t m_Latency;
+		std::vector<Slot> m_Slots;
+
+		uint64_t m_RenderedFrame{ 0 };
+		uint32_t m_NumWaits{ 0 };
+		bool m_IsFailingNextMap{ false };
+	};
+
+	using SyntheticReadbackQueue = ReadbackQueue<SyntheticFrames>;
+
+	bool HasPattern(const CapturedFrame& frame)
+	{
+		if (frame.pixels.size() != static_cast<size_t>(frame.width) * frame.height * 4)
+			return false;
+
+		for (uint32_t y = 0; y < frame.height; ++y)
+		{
+			for (uint32_t x = 0; x < frame.width; ++x)
+			{
+				for (uint32_t channel = 0; channel < 4; ++channel)
+				{
+					if (frame.pixels[(y * frame.width + x) * 4 + channel] != SyntheticFrames::GetPixelByte(frame.frameIndex, x, y, channel))
+						return false;
+				}
+			}
+		}
+		return true;
+	}
+
+	void RenderAndSubmit(SyntheticFrames& frames, SyntheticReadbackQueue& queue, uint64_t frameIndex)
+	{
+		frames.Render(frameIndex);
+		queue.Submit(frameIndex);
+	}
+}
+
+DAE_TEST(FramesAreDeliveredInSubmissionOrder)
+{
+	SyntheticFrames frames{ 3, 4, 4, 16, 1 };
+	std::vector<CapturedFrame> captured{};
+	SyntheticReadbackQueue queue{ frames, [&](CapturedFrame&& frame) { captured.push_back(std::move(frame)); } };
+
+	for (uint64_t frameIndex = 0; frameIndex < 10; ++frameIndex)
+	{
+		RenderAndSubmit(frames, queue, frameIndex);
+		queue.Poll();
+	}
+	queue.Flush();
+
+	DAE_CHECK_EQUAL(captured.size(), 10u);
+	for (size_t i = 0; i < captured.size(); ++i)
+	{
+		DAE_CHECK_EQUAL(captured[i].frameIndex, i);
+		DAE_CHECK(HasPattern(captured[i]));
+	}
+	DAE_CHECK_EQUAL(queue.GetNumInFlight(), 0u);
+	DAE_CHECK(!frames.IsAnySlotMapped());
+
+	//A copy finishing one poll later never stalls with three slots
+	DAE_CHECK_EQUAL(queue.GetStatistics().numStalls, 0u);
+	DAE_CHECK_EQUAL(queue.GetStatistics().numCaptured, 10u);
+}
+
+DAE_TEST(SubmitStallsOnlyOnceEverySlotIsInFlight)
+{
+	SyntheticFrames frames{ 3, 2, 2, 8, 100 };
+	std::vector<uint64_t> captured{};
+	SyntheticReadbackQueue queue{ frames, [&](CapturedFrame&& frame) { captured.push_back(frame.frameIndex); } };
+
+	for (uint64_t frameIndex = 0; frameIndex < 3; ++frameIndex)
+	{
+		RenderAndSubmit(frames, queue, frameIndex);
+	}
+	DAE_CHECK_EQUAL(queue.GetNumInFlight(), 3u);
+	DAE_CHECK_EQUAL(queue.GetStatistics().numStalls, 0u);
+	DAE_CHECK_EQUAL(frames.GetNumWaits(), 0u);
+	DAE_CHECK(captured.empty());
+
+	//The fourth frame needs the oldest slot and waits for frame 0 only
+	RenderAndSubmit(frames, queue, 3);
+	DAE_CHECK_EQUAL(queue.GetStatistics().numStalls, 1u);
+	DAE_CHECK_EQUAL(frames.GetNumWaits(), 1u);
+	DAE_CHECK(captured == std::vector<uint64_t>{ 0 });
+	DAE_CHECK_EQUAL(queue.GetNumInFlight(), 3u);
+
+	queue.Flush();
+	DAE_CHECK((captured == std::vector<uint64_t>{ 0, 1, 2, 3 }));
+}
+
+DAE_TEST(PollLeavesRunningCopiesInFlight)
+{
+	SyntheticFrames frames{ 2, 2, 2, 8, 2 };
+	std::vector<uint64_t> captured{};
+	SyntheticReadbackQueue queue{ frames, [&](CapturedFrame&& frame) { captured.push_back(frame.frameIndex); } };
+
+	RenderAndSubmit(frames, queue, 0);
+	queue.Poll();
+	queue.Poll();
+	DAE_CHECK(captured.empty());
+	DAE_CHECK_EQUAL(queue.GetStatistics().numPending, 2u);
+
+	queue.Poll();
+	DAE_CHECK(captured == std::vector<uint64_t>{ 0 });
+	DAE_CHECK_EQUAL(frames.GetNumWaits(), 0u);
+}
+
+DAE_TEST(PaddedRowsArePackedTightly)
+{
+	//Rows of 5 pixels are 20 bytes, mapped textures pad them to 64
+	SyntheticFrames frames{ 2, 5, 3, 64, 0 };
+	std::vector<CapturedFrame> captured{};
+	SyntheticReadbackQueue queue{ frames, [&](CapturedFrame&& frame) { captured.push_back(std::move(frame)); } };
+
+	RenderAndSubmit(frames, queue, 7);
+	queue.Flush();
+
+	DAE_CHECK_EQUAL(captured.size(), 1u);
+	DAE_CHECK_EQUAL(captured[0].width, 5u);
+	DAE_CHECK_EQUAL(captured[0].height, 3u);
+	DAE_CHECK_EQUAL(captured[0].pixels.size(), 5u * 3u * 4u);
+	DAE_CHECK(HasPattern(captured[0]));
+}
+
+DAE_TEST(FailedMapsAreSkipped)
+{
+	SyntheticFrames frames{ 2, 2, 2, 8, 0 };
+	std::vector<uint64_t> captured{};
+	SyntheticReadbackQueue queue{ frames, [&](CapturedFrame&& frame) { captured.push_back(frame.frameIndex); } };
+
+	RenderAndSubmit(frames, queue, 0);
+	RenderAndSubmit(frames, queue, 1);
+	frames.FailNextMap();
+	queue.Flush();
+
+	DAE_CHECK(captured == std::vector<uint64_t>{ 1 });
+	DAE_CHECK_EQUAL(queue.GetStatistics().numFailed, 1u);
+	DAE_CHECK_EQUAL(queue.GetNumInFlight(), 0u);
+}
+
+DAE_TEST_MAIN()
@@ -0,0 +1,313 @@
+#include "DeferredRecordingTarget.h"
+#include "RecordingScheduler.h"
+#include "RecordingStateTarget.h"
+#include "TestFramework.h"
+
+#include <memory>
+#include <mutex>
+
+using namespace dae;
+using namespace dae::Test;
+
+namespace
+{
+	struct FakeBackend
+	{
+		std::vector<StateCall> calls{};
+		RecordingStateFilter stateFilter{ RecordingStateTarget{ &calls } };
+
+		RecordingStateFilter& GetStateFilter() { return stateFilter; }
+	};
+
+	// Deferred contexts without an API. Finishing moves the calls of a context into a command list, executing one
+	// appends its calls to the immediate context's log behind an ExecuteCommandList entry, as the GPU would see them.
+	class FakeContexts final
+	{
+	public:
+		using Backend = FakeBackend;
+		using StateFilter = RecordingStateFilter;
+		// 1 based index into the finished lists, 0 is no list
+		using CommandList = uint32_t;
+
+		struct Output
+		{
+			Object* pRenderTargetView;
+			Object* pDepthStencilView;
+		};
+
+	public:
+		explicit FakeContexts(uint32_t numContexts)
+			: m_pImmediateBackend{ std::make_unique<FakeBackend>() }
+		{
+			for (uint32_t i = 0; i < numContexts; ++i)
+			{
+				m_DeferredBackends.push_back(std::make_unique<FakeBackend>());
+			}
+		}
+
+		uint32_t GetNumDeferredContexts() const { return static_cast<uint32_t>(m_DeferredBackends.size()); }
+		FakeBackend& GetImmediateBackend() const { return *m_pImmediateBackend; }
+		FakeBackend& GetDeferredBackend(uint32_t index) const { return *m_DeferredBackends[index]; }
+
+		CommandList FinishCommandList(uint32_t index)
+		{
+			//Called on the recording threads, the list numbers follow the finishing order and not the range order
+			const std::lock_guard lock{ m_Mutex };
+			m_CommandLists.push_back(std::move(m_DeferredBackends[index]->calls));
+			m_DeferredBackends[index]->calls.clear();
+			return static_cast<uint32_t>(m_CommandLists.size());
+		}
+
+		void ExecuteCommandList(CommandList commandList)
+		{
+			const std::vector<StateCall>& listCalls = m_CommandLists[commandList - 1];
+			std::vector<StateCall>& calls = m_pImmediateBackend->calls;
+			calls.push_back({ "ExecuteCommandList", commandList, {}, {} });
+			calls.insert(calls.end(), listCalls.begin(), listCalls.end());
+		}
+
+		void BindOutput(FakeBackend& backend, const Output& output) const
+		{
+			backend.stateFilter.OMSetRenderTargets(1, &output.pRenderTargetView, output.pDepthStencilView);
+		}
+
+	private:
+		std::unique_ptr<FakeBackend> m_pImmediateBackend;
+		std::vector<std::unique_ptr<FakeBackend>> m_DeferredBackends{};
+
+		std::mutex m_Mutex{};
+		std::vector<std::vector<StateCall>> m_CommandLists{};
+	};
+
+	using FakeRecordingTarget = DeferredRecordingTarget<FakeContexts>;
+	using FakeRecordingScheduler = RecordingScheduler<FakeRecordingTarget>;
+
+	Object g_RenderTarget{ 1 };
+	Object g_DepthStencil{ 2 };
+	Object g_VertexBuffer{ 3 };
+
+	//Every item binds the same vertex buffer and draws with its index as start index
+	void RecordItems(FakeBackend& backend, RecordingRange range)
+	{
+		Object* pVertexBuffer = &g_VertexBuffer;
+		const uint32_t stride{ 32 };
+		const uint32_t offset{ 0 };
+		for (uint32_t i = range.begin; i < range.end; ++i)
+		{
+			backend.stateFilter.IASetVertexBuffers(0, 1, &pVertexBuffer, &stride, &offset);
+			backend.stateFilter.DrawIndexed(3, i, 0);
+		}
+	}
+
+	std::vector<uint32_t> GetDrawnItems(const std::vector<StateCall>& calls)
+	{
+		std::vector<uint32_t> items{};
+		for (const StateCall& call : calls)
+		{
+			if (call.name == "DrawIndexed")
+			{
+				items.push_back(call.values[1]);
+			}
+		}
+		return items;
+	}
+
+	bool IsOutputBind(const StateCall& call)
+	{
+		return call.name == "OMSetRenderTargets" && call.objects.size() == 2 && call.objects[0] == &g_RenderTarget && call.objects[1] == &g_DepthStencil;
+	}
+
+	bool IsSequence(const std::vector<uint32_t>& items, uint32_t count)
+	{
+		if (items.size() != count)
+			return false;
+
+		for (uint32_t i = 0; i < count; ++i)
+		{
+			if (items[i] != i)
+				return false;
+		}
+		return true;
+	}
+}
+
+DAE_TEST(PartitionSplitsIntoEvenContiguousRanges)
+{
+	std::vector<RecordingRange> ranges{};
+	const uint32_t cases[][3]{ { 1000, 4, 64 }, { 1001, 8, 64 }, { 130, 8, 64 }, { 7, 3, 1 }, { 2, 16, 1 }, { 64, 4, 64 }, { 100000, 12, 64 } };
+	for (const auto& [numItems, maxRanges, minItemsPerRange] : cases)
+	{
+		FakeRecordingScheduler::Partition(numItems, maxRanges, minItemsPerRange, ranges);
+
+		DAE_CHECK(!ranges.empty());
+		DAE_CHECK(ranges.size() <= maxRanges);
+
+		uint32_t begin{ 0 };
+		uint32_t minSize{ UINT32_MAX };
+		uint32_t maxSize{ 0 };
+		for (const RecordingRange& range : ranges)
+		{
+			DAE_CHECK_EQUAL(range.begin, begin);
+			DAE_CHECK(range.end > range.begin);
+			minSize = std::min(minSize, range.end - range.begin);
+			maxSize = std::max(maxSize, range.end - range.begin);
+			begin = range.end;
+		}
+		DAE_CHECK_EQUAL(begin, numItems);
+		DAE_CHECK(maxSize - minSize <= 1);
+		DAE_CHECK(minSize >= minItemsPerRange);
+	}
+
+	FakeRecordingScheduler::Partition(1000, 4, 64, ranges);
+	DAE_CHECK_EQUAL(ranges.size(), 4u);
+	FakeRecordingScheduler::Partition(130, 8, 64, ranges);
+	DAE_CHECK_EQUAL(ranges.size(), 2u);
+}
+
+DAE_TEST(PartitionKeepsShortListsWhole)
+{
+	std::vector<RecordingRange> ranges{ { 5, 6 } };
+	FakeRecordingScheduler::Partition(0, 4, 64, ranges);
+	DAE_CHECK(ranges.empty());
+
+	FakeRecordingScheduler::Partition(10, 4, 64, ranges);
+	DAE_CHECK_EQUAL(ranges.size(), 1u);
+	DAE_CHECK_EQUAL(ranges[0].begin, 0u);
+	DAE_CHECK_EQUAL(ranges[0].end, 10u);
+
+	//No deferred context means one range however long the list is
+	FakeRecordingScheduler::Partition(10000, 0, 64, ranges);
+	DAE_CHECK_EQUAL(ranges.size(), 1u);
+}
+
+DAE_TEST(ShortListsAreRecordedIntoTheImmediateContext)
+{
+	FakeRecordingTarget target{ 4u };
+	target.SetOutput({ &g_RenderTarget, &g_DepthStencil });
+	FakeRecordingScheduler scheduler{ target, 4 };
+
+	scheduler.Record(10, RecordItems);
+
+	const std::vector<StateCall>& calls = target.GetImmediateContext().calls;
+	DAE_CHECK_EQUAL(scheduler.GetStatistics().numRanges, 1u);
+	DAE_CHECK(IsSequence(GetDrawnItems(calls), 10));
+	DAE_CHECK_EQUAL(CountCalls(calls, "ExecuteCommandList"), 0u);
+	DAE_CHECK_EQUAL(CountCalls(calls, "IASetVertexBuffers"), 1u);
+}
+
+DAE_TEST(LongListsAreExecutedInRangeOrder)
+{
+	FakeRecordingTarget target{ 4u };
+	target.SetOutput({ &g_RenderTarget, &g_DepthStencil });
+	FakeRecordingScheduler scheduler{ target, 4 };
+
+	scheduler.Record(1000, RecordItems);
+
+	const std::vector<StateCall>& calls = target.GetImmediateContext().calls;
+	DAE_CHECK_EQUAL(scheduler.GetStatistics().numRanges, 4u);
+	DAE_CHECK_EQUAL(CountCalls(calls, "ExecuteCommandList"), 4u);
+	DAE_CHECK(IsSequence(GetDrawnItems(calls), 1000));
+
+	//Nothing is left on a deferred context once its list is finished
+	for (uint32_t i = 0; i < target.GetNumDeferredContexts(); ++i)
+	{
+		DAE_CHECK(target.BeginDeferred(i).calls.size() == 1);
+	}
+}
+
+DAE_TEST(EveryCommandListStartsWithTheOutputAndItsOwnState)
+{
+	FakeRecordingTarget target{ 3u };
+	target.SetOutput({ &g_RenderTarget, &g_DepthStencil });
+	FakeRecordingScheduler scheduler{ target, 3 };
+
+	//The same output and buffer every frame, the filters must not carry them over from the frame before
+	for (uint32_t frame = 0; frame < 2; ++frame)
+	{
+		target.GetImmediateContext().calls.clear();
+		scheduler.Record(300, RecordItems);
+
+		const std::vector<StateCall>& calls = target.GetImmediateContext().calls;
+		uint32_t numLists{ 0 };
+		for (size_t i = 0; i < calls.size(); ++i)
+		{
+			if (calls[i].name != "ExecuteCommandList")
+				continue;
+
+			++numLists;
+			DAE_CHECK(i + 2 < calls.size() && IsOutputBind(calls[i + 1]) && calls[i + 2].name == "IASetVertexBuffers");
+		}
+		DAE_CHECK_EQUAL(numLists, 3u);
+		DAE_CHECK_EQUAL(CountCalls(calls, "IASetVertexBuffers"), 3u);
+	}
+}
+
+DAE_TEST(ExecuteRebindsTheOutputOnTheImmediateContext)
+{
+	FakeRecordingTarget target{ 2u };
+	target.SetOutput({ &g_RenderTarget, &g_DepthStencil });
+	FakeRecordingScheduler scheduler{ target, 2 };
+
+	scheduler.Record(200, RecordItems);
+
+	//A list leaves the immediate context cleared, the output is bound after every list. The bind before the first list
+	//is the one of SetOutput.
+	const std::vector<StateCall>& calls = target.GetImmediateContext().calls;
+	DAE_CHECK(!calls.empty() && IsOutputBind(calls.front()));
+	DAE_CHECK(IsOutputBind(calls.back()));
+
+	uint32_t numRebinds{ 0 };
+	for (size_t i = 1; i < calls.size(); ++i)
+	{
+		numRebinds += calls[i - 1].name == "DrawIndexed" && IsOutputBind(calls[i]) ? 1 : 0;
+	}
+	DAE_CHECK_EQUAL(numRebinds, 2u);
+
+	//Recorded straight into the immediate context after the lists, the draws find the output bound and their own state
+	target.GetImmediateContext().calls.clear();
+	RecordItems(target.GetImmediateContext(), { 0, 1 });
+	DAE_CHECK_EQUAL(CountCalls(target.GetImmediateContext().calls, "IASetVertexBuffers"), 1u);
+}
+
+DAE_TEST(ForcedRangesSplitShortLists)
+{
+	FakeRecordingTarget target{ 4u };
+	target.SetOutput({ &g_RenderTarget, &g_DepthStencil });
+	FakeRecordingScheduler scheduler{ target, 4 };
+
+	scheduler.SetMinItemsPerRange(1);
+	scheduler.Record(2, RecordItems);
+	DAE_CHECK_EQUAL(scheduler.GetStatistics().numRanges, 2u);
+	DAE_CHECK_EQUAL(CountCalls(target.GetImmediateContext().calls, "ExecuteCommandList"), 2u);
+	DAE_CHECK(IsSequence(GetDrawnItems(target.GetImmediateContext().calls), 2));
+
+	scheduler.SetMinItemsPerRange(0);
+	DAE_CHECK_EQUAL(scheduler.GetMinItemsPerRange(), 1u);
+}
+
+DAE_TEST(EmptyCommandListsAreNotExecuted)
+{
+	FakeRecordingTarget target{ 1u };
+	target.SetOutput({ &g_RenderTarget, &g_DepthStencil });
+	target.GetImmediateContext().calls.clear();
+
+	target.Execute(FakeContexts::CommandList{});
+	DAE_CHECK(target.GetImmediateContext().calls.empty());
+}
+
+DAE_TEST(StateStatisticsSumEveryContext)
+{
+	FakeRecordingTarget target{ 4u };
+	target.SetOutput({ &g_RenderTarget, &g_DepthStencil });
+	FakeRecordingScheduler scheduler{ target, 4 };
+
+	scheduler.Record(1000, RecordItems);
+	target.BeginFrame();
+
+	//1000 vertex buffer binds of which one per list gets through, the output bound on every list and after it
+	const FakeRecordingTarget::StateStatistics statistics = target.GetStateStatistics();
+	DAE_CHECK_EQUAL(statistics.numSubmitted, 1000u + 4u + 1u + 4u);
+	DAE_CHECK_EQUAL(statistics.numFiltered, 1000u - 4u);
+}
+
+DAE_TEST_MAIN()
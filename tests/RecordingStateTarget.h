@@ -0,0 +1,129 @@
+#pragma once
+
+#include "StateFilter.h"
+
+#include <cstdint>
+#include <string_view>
+#include <vector>
+
+// A StateFilter target that logs the calls reaching it instead of binding anything, so a test can see what the filter
+// forwarded and what it dropped
+namespace dae::Test
+{
+	// Stands in for every handle type, only its address is compared
+	struct Object
+	{
+		uint32_t id;
+	};
+
+	struct StateCall
+	{
+		std::string_view name;
+		uint32_t startSlot;
+		// The handles of the call in slot order
+		std::vector<const Object*> objects;
+		// Everything else in argument order, strides before offsets for vertex buffers
+		std::vector<uint32_t> values;
+	};
+
+	struct RecordingStateTarget
+	{
+		using Topology = uint32_t;
+		using Format = uint32_t;
+		using Buffer = Object;
+		using InputLayout = Object;
+		using VertexShader = Object;
+		using PixelShader = Object;
+		using ShaderResourceView = Object;
+		using SamplerState = Object;
+		using RenderTargetView = Object;
+		using DepthStencilView = Object;
+		using BlendState = Object;
+		using DepthStencilState = Object;
+		using RasterizerState = Object;
+		using Pass = Object;
+
+		std::vector<StateCall>* pCalls;
+
+		void IASetPrimitiveTopology(Topology topology) { Log("IASetPrimitiveTopology", 0, nullptr, 0, { topology }); }
+		void IASetInputLayout(InputLayout* pInputLayout) { Log("IASetInputLayout", 0, &pInputLayout, 1); }
+		void IASetVertexBuffers(uint32_t startSlot, uint32_t numBuffers, Buffer* const* ppBuffers, const uint32_t* pStrides, const uint32_t* pOffsets)
+		{
+			StateCall& call = Log("IASetVertexBuffers", startSlot, ppBuffers, numBuffers);
+			call.values.insert(call.values.end(), pStrides, pStrides + numBuffers);
+			call.values.insert(call.values.end(), pOffsets, pOffsets + numBuffers);
+		}
+		void IASetIndexBuffer(Buffer* pBuffer, Format format, uint32_t offset) { Log("IASetIndexBuffer", 0, &pBuffer, 1, { format, offset }); }
+
+		void VSSetShader(VertexShader* pShader) { Log("VSSetShader", 0, &pShader, 1); }
+		void PSSetShader(PixelShader* pShader) { Log("PSSetShader", 0, &pShader, 1); }
+		void VSSetConstantBuffers(uint32_t startSlot, uint32_t numBuffers, Buffer* const* ppBuffers, const uint32_t* pFirstConstants, const uint32_t* pNumConstants)
+		{
+			LogConstantBuffers("VSSetConstantBuffers", startSlot, numBuffers, ppBuffers, pFirstConstants, pNumConstants);
+		}
+		void PSSetConstantBuffers(uint32_t startSlot, uint32_t numBuffers, Buffer* const* ppBuffers, const uint32_t* pFirstConstants, const uint32_t* pNumConstants)
+		{
+			LogConstantBuffers("PSSetConstantBuffers", startSlot, numBuffers, ppBuffers, pFirstConstants, pNumConstants);
+		}
+		void PSSetShaderResources(uint32_t startSlot, uint32_t numViews, ShaderResourceView* const* ppViews) { Log("PSSetShaderResources", startSlot, ppViews, numViews); }
+		void PSSetSamplers(uint32_t startSlot, uint32_t numSamplers, SamplerState* const* ppSamplers) { Log("PSSetSamplers", startSlot, ppSamplers, numSamplers); }
+
+		void OMSetRenderTargets(uint32_t numViews, RenderTargetView* const* ppViews, DepthStencilView* pDepthStencilView)
+		{
+			Log("OMSetRenderTargets", 0, ppViews, numViews).objects.push_back(pDepthStencilView);
+		}
+		void OMSetBlendState(BlendState* pState, const float*, uint32_t sampleMask) { Log("OMSetBlendState", 0, &pState, 1, { sampleMask }); }
+		void OMSetDepthStencilState(DepthStencilState* pState, uint32_t stencilRef) { Log("OMSetDepthStencilState", 0, &pState, 1, { stencilRef }); }
+		void RSSetState(RasterizerState* pState) { Log("RSSetState", 0, &pState, 1); }
+
+		void ApplyPass(Pass* pPass) { Log("ApplyPass", 0, &pPass, 1); }
+
+		void DrawIndexed(uint32_t indexCount, uint32_t startIndex, int32_t baseVertex)
+		{
+			Log("DrawIndexed", 0, nullptr, 0, { indexCount, startIndex, static_cast<uint32_t>(baseVertex) });
+		}
+		void DrawIndexedInstanced(uint32_t indexCount, uint32_t instanceCount, uint32_t startIndex, int32_t baseVertex, uint32_t startInstance)
+		{
+			Log("DrawIndexedInstanced", 0, nullptr, 0, { indexCount, instanceCount, startIndex, static_cast<uint32_t>(baseVertex), startInstance });
+		}
+
+	private:
+		template<typename T>
+		StateCall& Log(std::string_view name, uint32_t startSlot, T* const* ppObjects, uint32_t numObjects, std::vector<uint32_t> values = {})
+		{
+			StateCall& call = pCalls->emplace_back(StateCall{ name, startSlot, {}, std::move(values) });
+			if (ppObjects != nullptr)
+			{
+				call.objects.assign(ppObjects, ppObjects + numObjects);
+			}
+			return call;
+		}
+
+		StateCall& Log(std::string_view name, uint32_t startSlot, std::nullptr_t, uint32_t, std::vector<uint32_t> values)
+		{
+			return pCalls->emplace_back(StateCall{ name, startSlot, {}, std::move(values) });
+		}
+
+		void LogConstantBuffers(std::string_view name, uint32_t startSlot, uint32_t numBuffers, Buffer* const* ppBuffers, const uint32_t* pFirstConstants, const uint32_t* pNumConstants)
+		{
+			StateCall& call = Log(name, startSlot, ppBuffers, numBuffers);
+			if (pFirstConstants != nullptr)
+			{
+				call.values.insert(call.values.end(), pFirstConstants, pFirstConstants + numBuffers);
+				call.values.insert(call.values.end(), pNumConstants, pNumConstants + numBuffers);
+			}
+		}
+	};
+
+	using RecordingStateFilter = StateFilter<RecordingStateTarget>;
+
+	inline uint32_t CountCalls(const std::vector<StateCall>& calls, std::string_view name)
+	{
+		uint32_t count{ 0 };
+		for (const StateCall& call : calls)
+		{
+			count += call.name == name ? 1 : 0;
+		}
+		return count;
+	}
+}
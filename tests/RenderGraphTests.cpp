@@ -0,0 +1,207 @@
+#include "RenderGraph.h"
+#include "TestFramework.h"
+
+using namespace dae;
+
+namespace
+{
+	constexpr RenderGraphTextureDesc colorDesc{ 64, 64, RenderGraphFormat::RGBA8 };
+	constexpr RenderGraphTextureDesc depthDesc{ 64, 64, RenderGraphFormat::Depth24Stencil8 };
+
+	bool IsOrder(const RenderGraph& graph, const std::vector<uint32_t>& passes)
+	{
+		const std::span<const uint32_t> order = graph.GetPassOrder();
+		return std::vector<uint32_t>(order.begin(), order.end()) == passes;
+	}
+}
+
+DAE_TEST(PassesNothingDependsOnAreCulled)
+{
+	RenderGraph graph{};
+	std::vector<std::string> executed{};
+	const auto addPass = [&](const std::string& name) { return graph.AddPass(name, [&executed, name]() { executed.push_back(name); }); };
+
+	const RenderGraph::Handle backBuffer = graph.ImportTexture("BackBuffer", colorDesc);
+	const RenderGraph::Handle unused = graph.CreateTexture("Unused", colorDesc);
+	const RenderGraph::Handle debug = graph.CreateTexture("Debug", colorDesc);
+	const RenderGraph::Handle chain = graph.CreateTexture("Chain", colorDesc);
+
+	const uint32_t unusedPass = addPass("Unused");
+	graph.Write(unusedPass, unused);
+
+	//Culled along with the pass reading its output, which has no result of its own
+	const uint32_t chainPass = addPass("Chain");
+	const RenderGraph::Handle chainOutput = graph.Write(chainPass, chain);
+	const uint32_t chainReader = addPass("ChainReader");
+	graph.Read(chainReader, chainOutput);
+	graph.Write(chainReader, unused);
+
+	const uint32_t debugPass = addPass("Debug");
+	graph.Write(debugPass, debug);
+	graph.SetSideEffects(debugPass);
+
+	const uint32_t presentPass = addPass("Present");
+	graph.Write(presentPass, backBuffer);
+
+	DAE_CHECK(graph.Compile());
+	DAE_CHECK(graph.IsCulled(unusedPass));
+	DAE_CHECK(graph.IsCulled(chainPass));
+	DAE_CHECK(graph.IsCulled(chainReader));
+	DAE_CHECK(!graph.IsCulled(debugPass));
+	DAE_CHECK(!graph.IsCulled(presentPass));
+	DAE_CHECK(IsOrder(graph, { debugPass, presentPass }));
+	DAE_CHECK_EQUAL(graph.GetStatistics().numCulledPasses, 3u);
+
+	//Textures only culled passes use get no physical texture
+	DAE_CHECK_EQUAL(graph.GetPhysicalIndex(unused), RenderGraph::InvalidIndex);
+	DAE_CHECK_EQUAL(graph.GetPhysicalIndex(chain), RenderGraph::InvalidIndex);
+	DAE_CHECK_EQUAL(graph.GetPhysicalIndex(backBuffer), RenderGraph::InvalidIndex);
+	DAE_CHECK_EQUAL(graph.GetPhysicalTextures().size(), 1u);
+
+	graph.Execute();
+	DAE_CHECK((executed == std::vector<std::string>{ "Debug", "Present" }));
+}
+
+DAE_TEST(PassesAreOrderedByDependenciesNotDeclaration)
+{
+	RenderGraph graph{};
+	const RenderGraph::Handle backBuffer = graph.ImportTexture("BackBuffer", colorDesc);
+	const RenderGraph::Handle depth = graph.CreateTexture("Depth", depthDesc);
+	const RenderGraph::Handle color = graph.CreateTexture("Color", colorDesc);
+
+	//Declared back to front, the reads are connected once the writes exist
+	const uint32_t compositePass = graph.AddPass("Composite", nullptr);
+	const uint32_t shadingPass = graph.AddPass("Shading", nullptr);
+	const uint32_t depthPass = graph.AddPass("DepthPrepass", nullptr);
+
+	const RenderGraph::Handle depthOutput = graph.Write(depthPass, depth);
+	graph.Read(shadingPass, depthOutput);
+	const RenderGraph::Handle colorOutput = graph.Write(shadingPass, color);
+	graph.Read(compositePass, colorOutput);
+	graph.Write(compositePass, backBuffer);
+
+	DAE_CHECK(graph.Compile());
+	DAE_CHECK(IsOrder(graph, { depthPass, shadingPass, compositePass }));
+}
+
+DAE_TEST(WritesWaitForTheReadersOfTheVersionBefore)
+{
+	RenderGraph graph{};
+	const RenderGraph::Handle backBuffer = graph.ImportTexture("BackBuffer", colorDesc);
+	const RenderGraph::Handle history = graph.CreateTexture("History", colorDesc);
+
+	const uint32_t updatePass = graph.AddPass("UpdateHistory", nullptr);
+	const uint32_t resolvePass = graph.AddPass("Resolve", nullptr);
+	const uint32_t seedPass = graph.AddPass("SeedHistory", nullptr);
+
+	//Seed writes version 1, resolve reads it, update overwrites it and must wait for resolve
+	const RenderGraph::Handle seeded = graph.Write(seedPass, history);
+	graph.Read(resolvePass, seeded);
+	const RenderGraph::Handle updated = graph.Write(updatePass, seeded);
+	graph.Write(resolvePass, backBuffer);
+	graph.SetSideEffects(updatePass);
+
+	DAE_CHECK(updated != RenderGraph::InvalidHandle);
+	DAE_CHECK(graph.Compile());
+	DAE_CHECK(IsOrder(graph, { seedPass, resolvePass, updatePass }));
+
+	//Only the latest version can be written
+	DAE_CHECK_EQUAL(graph.Write(updatePass, seeded), RenderGraph::InvalidHandle);
+}
+
+DAE_TEST(CyclesFailToCompile)
+{
+	RenderGraph graph{};
+	const RenderGraph::Handle backBuffer = graph.ImportTexture("BackBuffer", colorDesc);
+	const RenderGraph::Handle a = graph.CreateTexture("A", colorDesc);
+	const RenderGraph::Handle b = graph.CreateTexture("B", colorDesc);
+
+	const uint32_t passA = graph.AddPass("A", nullptr);
+	const uint32_t passB = graph.AddPass("B", nullptr);
+	const RenderGraph::Handle aOutput = graph.Write(passA, a);
+	const RenderGraph::Handle bOutput = graph.Write(passB, b);
+	graph.Read(passA, bOutput);
+	graph.Read(passB, aOutput);
+	graph.Write(passA, backBuffer);
+
+	DAE_CHECK(!graph.Compile());
+	DAE_CHECK(graph.GetPassOrder().empty());
+
+	//Nothing of the failed graph is left behind
+	graph.Clear();
+	const RenderGraph::Handle clearedBackBuffer = graph.ImportTexture("BackBuffer", colorDesc);
+	graph.Write(graph.AddPass("Present", nullptr), clearedBackBuffer);
+	DAE_CHECK(graph.Compile());
+	DAE_CHECK(IsOrder(graph, { 0 }));
+}
+
+DAE_TEST(TransientsWithDisjointLifetimesShareATexture)
+{
+	RenderGraph graph{};
+	const RenderGraph::Handle backBuffer = graph.ImportTexture("BackBuffer", colorDesc);
+	const RenderGraph::Handle first = graph.CreateTexture("First", colorDesc);
+	const RenderGraph::Handle second = graph.CreateTexture("Second", colorDesc);
+	const RenderGraph::Handle third = graph.CreateTexture("Third", colorDesc);
+	const RenderGraph::Handle depth = graph.CreateTexture("Depth", depthDesc);
+
+	//A ping pong chain, First lives in passes 0 and 1, Second in 1 and 2, Third in 2 and 3
+	const uint32_t pass0 = graph.AddPass("0", nullptr);
+	const RenderGraph::Handle firstOutput = graph.Write(pass0, first);
+	graph.Write(pass0, depth);
+
+	const uint32_t pass1 = graph.AddPass("1", nullptr);
+	graph.Read(pass1, firstOutput);
+	const RenderGraph::Handle secondOutput = graph.Write(pass1, second);
+
+	const uint32_t pass2 = graph.AddPass("2", nullptr);
+	graph.Read(pass2, secondOutput);
+	const RenderGraph::Handle thirdOutput = graph.Write(pass2, third);
+
+	const uint32_t pass3 = graph.AddPass("3", nullptr);
+	graph.Read(pass3, thirdOutput);
+	graph.Write(pass3, backBuffer);
+
+	DAE_CHECK(graph.Compile());
+	DAE_CHECK(IsOrder(graph, { pass0, pass1, pass2, pass3 }));
+
+	DAE_CHECK_EQUAL(graph.GetPhysicalIndex(first), graph.GetPhysicalIndex(third));
+	DAE_CHECK(graph.GetPhysicalIndex(first) != graph.GetPhysicalIndex(second));
+	//Free from pass 1 on, but a depth texture is never a color texture
+	DAE_CHECK(graph.GetPhysicalIndex(depth) != graph.GetPhysicalIndex(second));
+	DAE_CHECK(graph.GetPhysicalIndex(depth) != graph.GetPhysicalIndex(third));
+
+	const RenderGraph::Statistics& statistics = graph.GetStatistics();
+	DAE_CHECK_EQUAL(statistics.numTextures, 4u);
+	DAE_CHECK_EQUAL(statistics.numPhysicalTextures, 3u);
+	DAE_CHECK_EQUAL(statistics.textureBytes, 4u * colorDesc.GetSize());
+	DAE_CHECK_EQUAL(statistics.physicalBytes, 3u * colorDesc.GetSize());
+
+	for (const RenderGraph::Handle texture : { first, second, third, depth })
+	{
+		DAE_CHECK(graph.GetPhysicalTextures()[graph.GetPhysicalIndex(texture)] == graph.GetTextureDesc(texture));
+	}
+}
+
+DAE_TEST(OverlappingTransientsNeverShare)
+{
+	RenderGraph graph{};
+	const RenderGraph::Handle backBuffer = graph.ImportTexture("BackBuffer", colorDesc);
+	const RenderGraph::Handle a = graph.CreateTexture("A", colorDesc);
+	const RenderGraph::Handle b = graph.CreateTexture("B", colorDesc);
+
+	//Both are read by the last pass, so both are alive there
+	const uint32_t passA = graph.AddPass("A", nullptr);
+	const RenderGraph::Handle aOutput = graph.Write(passA, a);
+	const uint32_t passB = graph.AddPass("B", nullptr);
+	const RenderGraph::Handle bOutput = graph.Write(passB, b);
+	const uint32_t combinePass = graph.AddPass("Combine", nullptr);
+	graph.Read(combinePass, aOutput);
+	graph.Read(combinePass, bOutput);
+	graph.Write(combinePass, backBuffer);
+
+	DAE_CHECK(graph.Compile());
+	DAE_CHECK(graph.GetPhysicalIndex(a) != graph.GetPhysicalIndex(b));
+	DAE_CHECK_EQUAL(graph.GetStatistics().numPhysicalTextures, 2u);
+}
+
+DAE_TEST_MAIN()
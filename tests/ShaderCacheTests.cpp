@@ -0,0 +1,218 @@
+#include "ShaderCache.h"
+#include "TestFramework.h"
+
+#include <fstream>
+
+using namespace dae;
+
+namespace
+{
+	namespace fs = std::filesystem;
+
+	// A fresh directory in the working directory, removed again when the test ends
+	class TestDirectory final
+	{
+	public:
+		explicit TestDirectory(const std::string& name)
+			: m_Path{ fs::current_path() / name }
+		{
+			fs::remove_all(m_Path);
+			fs::create_directories(m_Path);
+		}
+
+		~TestDirectory()
+		{
+			std::error_code error{};
+			fs::remove_all(m_Path, error);
+		}
+
+		TestDirectory(const TestDirectory&)				= delete;
+		TestDirectory& operator=(const TestDirectory&)	= delete;
+		TestDirectory(TestDirectory&&)					= delete;
+		TestDirectory& operator=(TestDirectory&&)		= delete;
+
+		const fs::path& GetPath() const { return m_Path; }
+
+		void WriteFile(const std::string& name, const std::string& content) const
+		{
+			std::ofstream file{ m_Path / name, std::ios::binary | std::ios::trunc };
+			file << content;
+		}
+
+	private:
+		fs::path m_Path;
+	};
+
+	const std::vector<uint8_t> g_Binary{ 0x44, 0x58, 0x42, 0x43, 1, 2, 3, 4, 5, 6, 7, 8, 9 };
+
+	uint64_t CalculateKey(const TestDirectory& directory, const std::vector<ShaderDefine>& defines = {}, uint32_t flags = 0, uint32_t compilerVersion = 47)
+	{
+		return ShaderCache::CalculateKey(directory.GetPath() / "Shader.fx", defines, flags, compilerVersion);
+	}
+
+	void WriteShaderTree(const TestDirectory& directory)
+	{
+		fs::create_directories(directory.GetPath() / "Include");
+		directory.WriteFile("Shader.fx", "#include \"Include/Common.fxh\"\nfloat4 main() : SV_Target { return Color(); }\n");
+		directory.WriteFile("Include/Common.fxh", "  #include <Constants.fxh>\nfloat4 Color() { return gColor; }\n");
+		directory.WriteFile("Include/Constants.fxh", "float4 gColor;\n");
+	}
+
+	std::vector<char> ReadBytes(const fs::path& filepath)
+	{
+		std::ifstream file{ filepath, std::ios::binary };
+		return { std::istreambuf_iterator<char>{ file }, std::istreambuf_iterator<char>{} };
+	}
+
+	void WriteBytes(const fs::path& filepath, const std::vector<char>& bytes)
+	{
+		std::ofstream file{ filepath, std::ios::binary | std::ios::trunc };
+		file.write(bytes.data(), static_cast<std::streamsize>(bytes.size()));
+	}
+}
+
+DAE_TEST(KeysChangeWithEveryInput)
+{
+	TestDirectory directory{ "ShaderCacheKeys" };
+	WriteShaderTree(directory);
+
+	const uint64_t key = CalculateKey(directory, { { "A", "1" }, { "B", "" } });
+	DAE_CHECK(key != 0);
+	DAE_CHECK_EQUAL(CalculateKey(directory, { { "A", "1" }, { "B", "" } }), key);
+
+	//Defines in a different order are the same defines
+	DAE_CHECK_EQUAL(CalculateKey(directory, { { "B", "" }, { "A", "1" } }), key);
+	DAE_CHECK(CalculateKey(directory, { { "A", "2" }, { "B", "" } }) != key);
+	DAE_CHECK(CalculateKey(directory, { { "A", "1" } }) != key);
+	DAE_CHECK(CalculateKey(directory, { { "AB", "" } }) != CalculateKey(directory, { { "A", "B" } }));
+
+	DAE_CHECK(CalculateKey(directory, { { "A", "1" }, { "B", "" } }, 1) != key);
+	DAE_CHECK(CalculateKey(directory, { { "A", "1" }, { "B", "" } }, 0, 43) != key);
+
+	//An include of an include, angled and indented
+	directory.WriteFile("Include/Constants.fxh", "float4 gColor;\nfloat gIntensity;\n");
+	DAE_CHECK(CalculateKey(directory, { { "A", "1" }, { "B", "" } }) != key);
+}
+
+DAE_TEST(KeysOfUnreadableSourcesAreZero)
+{
+	TestDirectory directory{ "ShaderCacheMissing" };
+	DAE_CHECK_EQUAL(CalculateKey(directory), 0u);
+
+	//A missing include is left to the compiler, the key still depends on its name
+	directory.WriteFile("Shader.fx", "#include \"Missing.fxh\"\n");
+	const uint64_t key = CalculateKey(directory);
+	DAE_CHECK(key != 0);
+	directory.WriteFile("Shader.fx", "#include \"Other.fxh\"\n");
+	DAE_CHECK(CalculateKey(directory) != key);
+}
+
+DAE_TEST(IncludeCyclesAreHashedOnce)
+{
+	TestDirectory directory{ "ShaderCacheCycle" };
+	directory.WriteFile("Shader.fx", "#include \"A.fxh\"\n");
+	directory.WriteFile("A.fxh", "#include \"B.fxh\"\n");
+	directory.WriteFile("B.fxh", "#include \"A.fxh\"\n");
+
+	DAE_CHECK(CalculateKey(directory) != 0);
+}
+
+DAE_TEST(StoredEntriesLoadBack)
+{
+	TestDirectory directory{ "ShaderCacheStore" };
+	ShaderCache cache{ directory.GetPath() / "Cache" };
+
+	std::vector<uint8_t> binary{};
+	DAE_CHECK(!cache.Load(42, binary));
+	DAE_CHECK(cache.Store(42, g_Binary.data(), g_Binary.size()));
+	DAE_CHECK(cache.Load(42, binary));
+	DAE_CHECK(binary == g_Binary);
+
+	//The temporary file is renamed over the entry, nothing of it is left
+	fs::path temporaryPath = cache.GetEntryPath(42);
+	temporaryPath += ".tmp";
+	DAE_CHECK(fs::exists(cache.GetEntryPath(42)));
+	DAE_CHECK(!fs::exists(temporaryPath));
+
+	//Storing again replaces the entry
+	const std::vector<uint8_t> otherBinary{ 9, 8, 7 };
+	DAE_CHECK(cache.Store(42, otherBinary.data(), otherBinary.size()));
+	DAE_CHECK(cache.Load(42, binary));
+	DAE_CHECK(binary == otherBinary);
+
+	const ShaderCache::Statistics& statistics = cache.GetStatistics();
+	DAE_CHECK_EQUAL(statistics.numHits, 2u);
+	DAE_CHECK_EQUAL(statistics.numMisses, 1u);
+	DAE_CHECK_EQUAL(statistics.numStores, 2u);
+	DAE_CHECK_EQUAL(statistics.numRejected, 0u);
+
+	cache.Clear();
+	DAE_CHECK(!fs::exists(cache.GetEntryPath(42)));
+}
+
+DAE_TEST(AnInterruptedWriteLeavesNoEntry)
+{
+	TestDirectory directory{ "ShaderCacheInterrupted" };
+	ShaderCache cache{ directory.GetPath() };
+
+	//A crash after writing half the temporary file
+	fs::path temporaryPath = cache.GetEntryPath(7);
+	temporaryPath += ".tmp";
+	WriteBytes(temporaryPath, { 'D', 'S', 'H' });
+
+	std::vector<uint8_t> binary{};
+	DAE_CHECK(!cache.Load(7, binary));
+	DAE_CHECK_EQUAL(cache.GetStatistics().numRejected, 0u);
+
+	DAE_CHECK(cache.Store(7, g_Binary.data(), g_Binary.size()));
+	DAE_CHECK(cache.Load(7, binary));
+	DAE_CHECK(binary == g_Binary);
+	DAE_CHECK(!fs::exists(temporaryPath));
+}
+
+DAE_TEST(DamagedEntriesAreRejected)
+{
+	TestDirectory directory{ "ShaderCacheDamaged" };
+	ShaderCache cache{ directory.GetPath() };
+	DAE_CHECK(cache.Store(1, g_Binary.data(), g_Binary.size()));
+	const std::vector<char> entry = ReadBytes(cache.GetEntryPath(1));
+
+	std::vector<uint8_t> binary{};
+	uint32_t numRejected{ 0 };
+	const auto checkRejected = [&](const std::vector<char>& bytes)
+		{
+			WriteBytes(cache.GetEntryPath(1), bytes);
+			DAE_CHECK(!cache.Load(1, binary));
+			DAE_CHECK(binary.empty());
+			DAE_CHECK_EQUAL(cache.GetStatistics().numRejected, ++numRejected);
+		};
+
+	//Truncated in the binary and in the header
+	checkRejected(std::vector<char>(entry.begin(), entry.end() - 1));
+	checkRejected(std::vector<char>(entry.begin(), entry.begin() + 6));
+
+	//Something appended
+	std::vector<char> appended = entry;
+	appended.push_back(0);
+	checkRejected(appended);
+
+	//A flipped bit in the binary
+	std::vector<char> flipped = entry;
+	flipped[entry.size() - g_Binary.size() / 2] ^= 0x10;
+	checkRejected(flipped);
+
+	//A wrong magic
+	std::vector<char> wrongMagic = entry;
+	wrongMagic[0] ^= 0x01;
+	checkRejected(wrongMagic);
+
+	//An intact entry stored under another key
+	DAE_CHECK(cache.Store(2, g_Binary.data(), g_Binary.size()));
+	checkRejected(ReadBytes(cache.GetEntryPath(2)));
+
+	WriteBytes(cache.GetEntryPath(1), entry);
+	DAE_CHECK(cache.Load(1, binary));
+	DAE_CHECK(binary == g_Binary);
+}
+
+DAE_TEST_MAIN()
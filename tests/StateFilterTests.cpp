@@ -0,0 +1,218 @@
+#include "RecordingStateTarget.h"
+#include "TestFramework.h"
+
+using namespace dae;
+using namespace dae::Test;
+
+namespace
+{
+	Object g_Objects[8]{ { 0 }, { 1 }, { 2 }, { 3 }, { 4 }, { 5 }, { 6 }, { 7 } };
+
+	void SetVertexBuffers(RecordingStateFilter& filter, uint32_t startSlot, std::vector<Object*> buffers, std::vector<uint32_t> offsets)
+	{
+		const std::vector<uint32_t> strides(buffers.size(), 32);
+		filter.IASetVertexBuffers(startSlot, static_cast<uint32_t>(buffers.size()), buffers.data(), strides.data(), offsets.data());
+	}
+
+	void SetShaderResources(RecordingStateFilter& filter, uint32_t startSlot, std::vector<Object*> views)
+	{
+		filter.PSSetShaderResources(startSlot, static_cast<uint32_t>(views.size()), views.data());
+	}
+}
+
+DAE_TEST(RepeatedCallsAreDropped)
+{
+	std::vector<StateCall> calls{};
+	RecordingStateFilter filter{ RecordingStateTarget{ &calls } };
+
+	for (uint32_t i = 0; i < 3; ++i)
+	{
+		filter.IASetPrimitiveTopology(4);
+		filter.IASetInputLayout(&g_Objects[0]);
+		filter.IASetIndexBuffer(&g_Objects[1], 42, 0);
+		filter.RSSetState(&g_Objects[2]);
+	}
+	DAE_CHECK_EQUAL(calls.size(), 4u);
+
+	//A different argument of an otherwise equal call is a change
+	filter.IASetIndexBuffer(&g_Objects[1], 42, 16);
+	DAE_CHECK_EQUAL(calls.size(), 5u);
+
+	filter.BeginFrame();
+	DAE_CHECK_EQUAL(filter.GetStatistics().numSubmitted, 13u);
+	DAE_CHECK_EQUAL(filter.GetStatistics().numFiltered, 8u);
+}
+
+DAE_TEST(VertexBufferCallsAreTrimmedToTheChangedSlots)
+{
+	std::vector<StateCall> calls{};
+	RecordingStateFilter filter{ RecordingStateTarget{ &calls } };
+
+	SetVertexBuffers(filter, 0, { &g_Objects[0], &g_Objects[1], &g_Objects[2], &g_Objects[3] }, { 0, 0, 0, 0 });
+	DAE_CHECK_EQUAL(calls.size(), 1u);
+	DAE_CHECK_EQUAL(calls[0].objects.size(), 4u);
+
+	//Only slot 2 changes
+	calls.clear();
+	SetVertexBuffers(filter, 0, { &g_Objects[0], &g_Objects[1], &g_Objects[4], &g_Objects[3] }, { 0, 0, 0, 0 });
+	DAE_CHECK_EQUAL(calls.size(), 1u);
+	DAE_CHECK_EQUAL(calls[0].startSlot, 2u);
+	DAE_CHECK(calls[0].objects == std::vector<const Object*>{ &g_Objects[4] });
+	DAE_CHECK(calls[0].values == (std::vector<uint32_t>{ 32, 0 }));
+
+	//Slots 1 and 3 change, the unchanged slot between them goes along
+	calls.clear();
+	SetVertexBuffers(filter, 0, { &g_Objects[0], &g_Objects[5], &g_Objects[4], &g_Objects[3] }, { 0, 0, 0, 64 });
+	DAE_CHECK_EQUAL(calls.size(), 1u);
+	DAE_CHECK_EQUAL(calls[0].startSlot, 1u);
+	DAE_CHECK((calls[0].objects == std::vector<const Object*>{ &g_Objects[5], &g_Objects[4], &g_Objects[3] }));
+	DAE_CHECK(calls[0].values == (std::vector<uint32_t>{ 32, 32, 32, 0, 0, 64 }));
+
+	//Nothing changes, nothing is forwarded
+	calls.clear();
+	SetVertexBuffers(filter, 1, { &g_Objects[5], &g_Objects[4] }, { 0, 0 });
+	DAE_CHECK(calls.empty());
+}
+
+DAE_TEST(ShaderResourceCallsAreTrimmedToTheChangedSlots)
+{
+	std::vector<StateCall> calls{};
+	RecordingStateFilter filter{ RecordingStateTarget{ &calls } };
+
+	SetShaderResources(filter, 0, { &g_Objects[0], &g_Objects[1] });
+	calls.clear();
+
+	SetShaderResources(filter, 0, { &g_Objects[0], &g_Objects[2], &g_Objects[3] });
+	DAE_CHECK_EQUAL(calls.size(), 1u);
+	DAE_CHECK_EQUAL(calls[0].startSlot, 1u);
+	DAE_CHECK((calls[0].objects == std::vector<const Object*>{ &g_Objects[2], &g_Objects[3] }));
+
+	//Unbinding is a change like any other
+	calls.clear();
+	SetShaderResources(filter, 2, { nullptr });
+	DAE_CHECK_EQUAL(calls.size(), 1u);
+	DAE_CHECK_EQUAL(calls[0].startSlot, 2u);
+	DAE_CHECK(calls[0].objects == std::vector<const Object*>{ nullptr });
+
+	calls.clear();
+	SetShaderResources(filter, 0, { &g_Objects[0], &g_Objects[2], nullptr });
+	DAE_CHECK(calls.empty());
+}
+
+DAE_TEST(SlotsBeyondTheTrackedOnesAreAlwaysForwarded)
+{
+	std::vector<StateCall> calls{};
+	RecordingStateFilter filter{ RecordingStateTarget{ &calls } };
+
+	constexpr uint32_t lastSlot{ RecordingStateFilter::MaxShaderResources - 1 };
+	for (uint32_t i = 0; i < 2; ++i)
+	{
+		SetShaderResources(filter, lastSlot, { &g_Objects[0], &g_Objects[1] });
+	}
+	DAE_CHECK_EQUAL(calls.size(), 2u);
+	DAE_CHECK_EQUAL(calls[1].startSlot, lastSlot + 1);
+	DAE_CHECK(calls[1].objects == std::vector<const Object*>{ &g_Objects[1] });
+}
+
+DAE_TEST(InvalidateForwardsTheNextCallOfEveryKind)
+{
+	std::vector<StateCall> calls{};
+	RecordingStateFilter filter{ RecordingStateTarget{ &calls } };
+	Object* pRenderTarget = &g_Objects[6];
+
+	const auto bindAll = [&]()
+		{
+			filter.IASetPrimitiveTopology(4);
+			filter.IASetInputLayout(&g_Objects[0]);
+			SetVertexBuffers(filter, 0, { &g_Objects[1], &g_Objects[2] }, { 0, 0 });
+			filter.IASetIndexBuffer(&g_Objects[3], 42, 0);
+			filter.VSSetShader(&g_Objects[4]);
+			filter.PSSetShader(&g_Objects[5]);
+			SetShaderResources(filter, 0, { &g_Objects[1], &g_Objects[2] });
+			filter.OMSetRenderTargets(1, &pRenderTarget, &g_Objects[7]);
+			filter.OMSetDepthStencilState(&g_Objects[3], 0);
+		};
+
+	bindAll();
+	DAE_CHECK_EQUAL(calls.size(), 9u);
+
+	calls.clear();
+	bindAll();
+	DAE_CHECK(calls.empty());
+
+	filter.Invalidate();
+	bindAll();
+	DAE_CHECK_EQUAL(calls.size(), 9u);
+	DAE_CHECK_EQUAL(CountCalls(calls, "IASetVertexBuffers"), 1u);
+	DAE_CHECK_EQUAL(calls[2].objects.size(), 2u);
+}
+
+DAE_TEST(PassesAreAppliedAgainOnlyForNewVariables)
+{
+	std::vector<StateCall> calls{};
+	RecordingStateFilter filter{ RecordingStateTarget{ &calls } };
+
+	filter.ApplyPass(&g_Objects[0], 1);
+	filter.ApplyPass(&g_Objects[0], 1);
+	DAE_CHECK_EQUAL(CountCalls(calls, "ApplyPass"), 1u);
+
+	//Setting a variable bumps the version, the pass has to upload it
+	filter.ApplyPass(&g_Objects[0], 2);
+	DAE_CHECK_EQUAL(CountCalls(calls, "ApplyPass"), 2u);
+
+	filter.ApplyPass(&g_Objects[1], 2);
+	DAE_CHECK_EQUAL(CountCalls(calls, "ApplyPass"), 3u);
+
+	filter.Invalidate();
+	filter.ApplyPass(&g_Objects[1], 2);
+	DAE_CHECK_EQUAL(CountCalls(calls, "ApplyPass"), 4u);
+}
+
+DAE_TEST(PassesForgetWhatTheyBindButNotTheInputAssembler)
+{
+	std::vector<StateCall> calls{};
+	RecordingStateFilter filter{ RecordingStateTarget{ &calls } };
+	Object* pRenderTarget = &g_Objects[6];
+
+	filter.IASetInputLayout(&g_Objects[0]);
+	SetVertexBuffers(filter, 0, { &g_Objects[1] }, { 0 });
+	filter.OMSetRenderTargets(1, &pRenderTarget, nullptr);
+	SetShaderResources(filter, 0, { &g_Objects[2] });
+	filter.PSSetShader(&g_Objects[3]);
+
+	filter.ApplyPass(&g_Objects[4], 1);
+	calls.clear();
+
+	//Input assembler and output survive the pass, shaders and resources may have been replaced by it
+	filter.IASetInputLayout(&g_Objects[0]);
+	SetVertexBuffers(filter, 0, { &g_Objects[1] }, { 0 });
+	filter.OMSetRenderTargets(1, &pRenderTarget, nullptr);
+	DAE_CHECK(calls.empty());
+
+	SetShaderResources(filter, 0, { &g_Objects[2] });
+	filter.PSSetShader(&g_Objects[3]);
+	DAE_CHECK_EQUAL(calls.size(), 2u);
+
+	//Applying the same pass again binds nothing, so nothing is forgotten
+	filter.ApplyPass(&g_Objects[4], 1);
+	calls.clear();
+	SetShaderResources(filter, 0, { &g_Objects[2] });
+	DAE_CHECK(calls.empty());
+}
+
+DAE_TEST(DrawsAreNeverFiltered)
+{
+	std::vector<StateCall> calls{};
+	RecordingStateFilter filter{ RecordingStateTarget{ &calls } };
+
+	filter.DrawIndexed(6, 0, 0);
+	filter.DrawIndexed(6, 0, 0);
+	filter.DrawIndexedInstanced(6, 10, 0, 0, 0);
+	filter.DrawIndexedInstanced(6, 10, 0, 0, 0);
+	DAE_CHECK_EQUAL(calls.size(), 4u);
+
+	filter.BeginFrame();
+	DAE_CHECK_EQUAL(filter.GetStatistics().numSubmitted, 0u);
+}
+
+DAE_TEST_MAIN()
@@ -0,0 +1,72 @@
+#pragma once
+
+#include <cstdio>
+#include <functional>
+#include <iostream>
+#include <vector>
+
+// Just enough to write the Linux tests without a dependency: every DAE_TEST registers itself, DAE_CHECK reports the
+// failing expression and keeps going, RunAll returns the exit code for ctest.
+namespace dae::Test
+{
+	struct Case
+	{
+		const char* name;
+		void(*pFunction)();
+	};
+
+	inline std::vector<Case>& GetCases()
+	{
+		static std::vector<Case> cases{};
+		return cases;
+	}
+
+	inline int& GetNumFailures()
+	{
+		static int numFailures{ 0 };
+		return numFailures;
+	}
+
+	inline bool Register(const char* name, void(*pFunction)())
+	{
+		GetCases().push_back({ name, pFunction });
+		return true;
+	}
+
+	inline void Fail(const char* file, int line, const char* expression)
+	{
+		std::cout << file << "(" << line << "): check failed: " << expression << '\n';
+		++GetNumFailures();
+	}
+
+	inline int RunAll()
+	{
+		int numFailedCases{ 0 };
+		for (const Case& testCase : GetCases())
+		{
+			const int numFailuresBefore = GetNumFailures();
+			testCase.pFunction();
+
+			const bool isPassed = GetNumFailures() == numFailuresBefore;
+			numFailedCases += isPassed ? 0 : 1;
+			std::cout << (isPassed ? "[pass] " : "[FAIL] ") << testCase.name << '\n';
+		}
+
+		std::cout << GetCases().size() - numFailedCases << " of " << GetCases().size() << " tests passed\n";
+		return numFailedCases == 0 ? 0 : 1;
+	}
+}
+
+#define DAE_TEST(name) \
+	static void name(); \
+	static const bool name##IsRegistered = dae::Test::Register(#name, &name); \
+	static void name()
+
+#define DAE_CHECK(expression) \
+	do { if (!(expression)) dae::Test::Fail(__FILE__, __LINE__, #expression); } while (false)
+
+#define DAE_CHECK_EQUAL(actual, expected) \
+	do { if (!((actual) == (expected))) { dae::Test::Fail(__FILE__, __LINE__, #actual " == " #expected); std::cout << "  actual: " << (actual) << ", expected: " << (expected) << '\n'; } } while (false)
+
+#define DAE_TEST_MAIN() \
+	int main() { return dae::Test::RunAll(); }
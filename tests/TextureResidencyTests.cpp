@@ -0,0 +1,244 @@
+#include "TextureResidency.h"
+#include "TestFramework.h"
+
+using namespace dae;
+
+namespace
+{
+	// Sizes like an RGBA8 texture with a full mip chain. An upload that fails leaves it evicted, like Texture.
+	class FakeTexture final
+	{
+	public:
+		static constexpr uint32_t NoMipRequest{ 0xFFFFFFFF };
+
+		explicit FakeTexture(uint32_t size)
+			: m_Size{ size }
+		{
+			while ((m_Size >> m_MipCount) > 0)
+			{
+				++m_MipCount;
+			}
+		}
+
+		bool IsResident() const { return m_IsResident; }
+		uint32_t GetWidth() const { return m_Size; }
+		uint32_t GetHeight() const { return m_Size; }
+		uint32_t GetMipCount() const { return m_MipCount; }
+		uint32_t GetResidentMip() const { return m_ResidentMip; }
+
+		size_t GetResidentSize(uint32_t topMip) const
+		{
+			size_t size{ 0 };
+			for (uint32_t mip = topMip; mip < m_MipCount; ++mip)
+			{
+				const size_t mipSize = std::max(m_Size >> mip, 1u);
+				size += mipSize * mipSize * 4;
+			}
+			return size;
+		}
+
+		size_t GetResidentSize() const { return m_IsResident ? GetResidentSize(m_ResidentMip) : 0; }
+
+		void MarkUsed(uint32_t requestedMip = NoMipRequest)
+		{
+			m_IsUsed = true;
+			m_RequestedMip = requestedMip;
+		}
+
+		bool ConsumeUsed()
+		{
+			const bool isUsed = m_IsUsed;
+			m_IsUsed = false;
+			return isUsed;
+		}
+
+		uint32_t ConsumeRequestedMip()
+		{
+			const uint32_t requestedMip = m_RequestedMip;
+			m_RequestedMip = NoMipRequest;
+			return requestedMip;
+		}
+
+		bool SetResidentMip(uint32_t topMip)
+		{
+			Evict();
+			++m_NumUploads;
+			if (m_IsUploadFailing)
+				return false;
+
+			m_ResidentMip = std::min(topMip, m_MipCount - 1);
+			m_IsResident = true;
+			return true;
+		}
+
+		void Evict() { m_IsResident = false; }
+
+		void SetUploadFailing(bool isUploadFailing) { m_IsUploadFailing = isUploadFailing; }
+		uint32_t GetNumUploads() const { return m_NumUploads; }
+
+	private:
+		uint32_t m_Size;
+		uint32_t m_MipCount{ 0 };
+		uint32_t m_ResidentMip{ 0 };
+		uint32_t m_RequestedMip{ NoMipRequest };
+		uint32_t m_NumUploads{ 0 };
+		bool m_IsResident{ true };
+		bool m_IsUsed{ false };
+		bool m_IsUploadFailing{ false };
+	};
+
+	using FakeResidency = TextureResidency<FakeTexture>;
+
+	size_t GetTotalResidentSize(const std::vector<FakeTexture*>& textures)
+	{
+		size_t size{ 0 };
+		for (const FakeTexture* pTexture : textures)
+		{
+			size += pTexture->GetResidentSize();
+		}
+		return size;
+	}
+}
+
+DAE_TEST(UnusedTexturesLoseMipsBeforeTheyAreEvicted)
+{
+	FakeTexture unused{ 256 };
+	FakeTexture used{ 256 };
+	FakeResidency residency{ 2 * unused.GetResidentSize(0) };
+	residency.SetMinResidentSize(64);
+	residency.Register(&unused);
+	residency.Register(&used);
+
+	//Fits, nothing happens
+	used.MarkUsed();
+	residency.Update();
+	DAE_CHECK_EQUAL(residency.GetStatistics().numOverBudgetFrames, 0u);
+
+	//The unused texture drops to 64x64, the smallest it may get
+	residency.SetBudget(used.GetResidentSize(0) + unused.GetResidentSize(2));
+	used.MarkUsed();
+	residency.Update();
+	DAE_CHECK(unused.IsResident());
+	DAE_CHECK_EQUAL(unused.GetResidentMip(), 2u);
+	DAE_CHECK_EQUAL(used.GetResidentMip(), 0u);
+	DAE_CHECK_EQUAL(residency.GetStatistics().numMipDrops, 2u);
+	DAE_CHECK_EQUAL(residency.GetStatistics().numEvictions, 0u);
+
+	//Not even that fits, it is evicted
+	residency.SetBudget(used.GetResidentSize(0) + unused.GetResidentSize(2) / 2);
+	used.MarkUsed();
+	residency.Update();
+	DAE_CHECK(!unused.IsResident());
+	DAE_CHECK_EQUAL(used.GetResidentMip(), 0u);
+	DAE_CHECK_EQUAL(residency.GetStatistics().numEvictions, 1u);
+	DAE_CHECK_EQUAL(residency.GetStatistics().residentBytes, GetTotalResidentSize({ &unused, &used }));
+}
+
+DAE_TEST(AFailedUploadWhileDroppingMipsIsOneEviction)
+{
+	FakeTexture unused{ 256 };
+	FakeTexture used{ 256 };
+	FakeResidency residency{ unused.GetResidentSize(0) + used.GetResidentSize(0) };
+	residency.SetMinResidentSize(64);
+	residency.Register(&unused);
+	residency.Register(&used);
+
+	used.MarkUsed();
+	residency.Update();
+
+	//Dropping the mips of the unused texture fails and evicts it, that alone is enough to get under budget
+	unused.SetUploadFailing(true);
+	residency.SetBudget(used.GetResidentSize(0) + used.GetResidentSize(1) / 2);
+	used.MarkUsed();
+	residency.Update();
+
+	DAE_CHECK(!unused.IsResident());
+	DAE_CHECK_EQUAL(unused.GetNumUploads(), 1u);
+	DAE_CHECK(used.IsResident());
+	DAE_CHECK_EQUAL(used.GetResidentMip(), 0u);
+
+	const FakeResidency::Statistics& statistics = residency.GetStatistics();
+	DAE_CHECK_EQUAL(statistics.numEvictions, 1u);
+	DAE_CHECK_EQUAL(statistics.numMipDrops, 0u);
+	DAE_CHECK_EQUAL(statistics.residentBytes, GetTotalResidentSize({ &unused, &used }));
+}
+
+DAE_TEST(AFailedUploadWhileDroppingMipsIsNotEvictedTwice)
+{
+	FakeTexture first{ 256 };
+	FakeTexture second{ 256 };
+	FakeTexture used{ 256 };
+	FakeResidency residency{ 3 * used.GetResidentSize(0) };
+	residency.SetMinResidentSize(64);
+	for (FakeTexture* pTexture : { &first, &second, &used })
+	{
+		residency.Register(pTexture);
+	}
+
+	used.MarkUsed();
+	residency.Update();
+
+	//The failed drop of the first still leaves the residency over budget, the second has to give up its mips as well
+	first.SetUploadFailing(true);
+	residency.SetBudget(used.GetResidentSize(0) + second.GetResidentSize(2));
+	used.MarkUsed();
+	residency.Update();
+
+	DAE_CHECK(!first.IsResident());
+	DAE_CHECK_EQUAL(first.GetNumUploads(), 1u);
+	DAE_CHECK(second.IsResident());
+	DAE_CHECK_EQUAL(second.GetResidentMip(), 2u);
+
+	const FakeResidency::Statistics& statistics = residency.GetStatistics();
+	DAE_CHECK_EQUAL(statistics.numEvictions, 1u);
+	DAE_CHECK_EQUAL(statistics.numMipDrops, 2u);
+	DAE_CHECK_EQUAL(statistics.residentBytes, GetTotalResidentSize({ &first, &second, &used }));
+	DAE_CHECK(statistics.residentBytes <= residency.GetBudget());
+}
+
+DAE_TEST(AFailedUploadWhileStreamingIsAnEviction)
+{
+	FakeTexture texture{ 256 };
+	FakeResidency residency{ texture.GetResidentSize(0) };
+	residency.SetMinResidentSize(16);
+	residency.Register(&texture);
+
+	//Far away, only mip 3 is needed and the upload of it fails
+	texture.SetUploadFailing(true);
+	texture.MarkUsed(3);
+	residency.Update();
+
+	DAE_CHECK(!texture.IsResident());
+	DAE_CHECK_EQUAL(residency.GetStatistics().numEvictions, 1u);
+	DAE_CHECK_EQUAL(residency.GetStatistics().numStreamingDrops, 0u);
+	DAE_CHECK_EQUAL(residency.GetStatistics().residentBytes, 0u);
+
+	//Uploads work again, streaming lands on the requested mip
+	texture.SetUploadFailing(false);
+	texture.SetResidentMip(0);
+	texture.MarkUsed(3);
+	residency.Update();
+	DAE_CHECK_EQUAL(texture.GetResidentMip(), 3u);
+	DAE_CHECK_EQUAL(residency.GetStatistics().numStreamingDrops, 3u);
+	DAE_CHECK_EQUAL(residency.GetStatistics().residentBytes, texture.GetResidentSize());
+}
+
+DAE_TEST(AFailedUploadWhileRestoringIsAnEviction)
+{
+	FakeTexture texture{ 256 };
+	FakeResidency residency{ texture.GetResidentSize(0) };
+	residency.Register(&texture);
+	texture.SetResidentMip(2);
+
+	//Close again, the restore of mip 1 fails
+	texture.SetUploadFailing(true);
+	texture.MarkUsed(0);
+	residency.Update();
+
+	DAE_CHECK(!texture.IsResident());
+	DAE_CHECK_EQUAL(residency.GetStatistics().numRestores, 0u);
+	DAE_CHECK_EQUAL(residency.GetStatistics().numEvictions, 1u);
+	DAE_CHECK_EQUAL(residency.GetStatistics().residentBytes, 0u);
+}
+
+DAE_TEST_MAIN()
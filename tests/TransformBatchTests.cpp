@@ -0,0 +1,169 @@
+#include "TransformBatch.h"
+#include "Matrix.h"
+#include "TestFramework.h"
+
+#include <cmath>
+#include <random>
+
+using namespace dae;
+using namespace dae::TransformBatch;
+
+namespace
+{
+	//Past the AVX width twice, so every SoA and AoS tail length shows up
+	constexpr size_t maxCount{ 33 };
+
+	enum class Mode
+	{
+		Point,
+		Vector,
+		Project
+	};
+
+	std::vector<InstructionSet> GetSupportedInstructionSets()
+	{
+		std::vector<InstructionSet> instructionSets;
+		for (InstructionSet instructionSet : { InstructionSet::Scalar, InstructionSet::SSE2, InstructionSet::AVX })
+		{
+			if (MatrixSIMD::IsSupported(instructionSet))
+			{
+				instructionSets.push_back(instructionSet);
+			}
+		}
+		return instructionSets;
+	}
+
+	std::vector<Vector3> CreatePoints(size_t count)
+	{
+		std::mt19937 random{ static_cast<uint32_t>(count) };
+		std::uniform_real_distribution<float> positionDistribution{ -10.0f, 10.0f };
+
+		std::vector<Vector3> points(count);
+		for (Vector3& point : points)
+		{
+			point = { positionDistribution(random), positionDistribution(random), positionDistribution(random) };
+		}
+		return points;
+	}
+
+	//The one point at a time path the batches have to match bit for bit
+	Vector3 TransformOne(Mode mode, const Matrix& matrix, const Viewport& viewport, const Vector3& point)
+	{
+		if (mode == Mode::Point)
+			return matrix.TransformPoint(point);
+
+		if (mode == Mode::Vector)
+			return matrix.TransformVector(point);
+
+		const Vector4 clip = matrix.TransformPoint(Vector4{ point, 1.0f });
+		const float invW = 1.0f / clip.w;
+		return {
+			clip.x * invW * (0.5f * viewport.width) + (viewport.x + 0.5f * viewport.width),
+			clip.y * invW * (-0.5f * viewport.height) + (viewport.y + 0.5f * viewport.height),
+			clip.z * invW * (viewport.maxDepth - viewport.minDepth) + viewport.minDepth
+		};
+	}
+
+	bool IsSame(const Vector3& a, float x, float y, float z)
+	{
+		return a.x == x && a.y == y && a.z == z;
+	}
+
+	//Camera in front of the points so every w is positive
+	const Matrix g_World = Matrix::CreateRotation(0.3f, 0.7f, -0.2f) * Matrix::CreateTranslation(1.0f, 2.0f, 3.0f);
+	const Matrix g_WorldViewProjection = g_World * Matrix::CreateTranslation(0.0f, 0.0f, 40.0f)
+		* Matrix::CreatePerspectiveFovLH(0.5f, 16.0f / 9.0f, 0.1f, 100.0f);
+	const Viewport g_Viewport{ 16.0f, 8.0f, 1280.0f, 720.0f, 0.25f, 1.0f };
+}
+
+DAE_TEST(BatchesMatchTheMatrixPathAtEveryCount)
+{
+	for (InstructionSet instructionSet : GetSupportedInstructionSets())
+	{
+		for (Mode mode : { Mode::Point, Mode::Vector, Mode::Project })
+		{
+			const Matrix& matrix = mode == Mode::Project ? g_WorldViewProjection : g_World;
+
+			bool isSame{ true };
+			for (size_t count = 0; count <= maxCount; ++count)
+			{
+				const std::vector<Vector3> points = CreatePoints(count);
+				std::vector<float> x(count), y(count), z(count);
+				for (size_t i = 0; i < count; ++i)
+				{
+					x[i] = points[i].x;
+					y[i] = points[i].y;
+					z[i] = points[i].z;
+				}
+
+				//One extra element behind every output, a kernel that writes it overruns
+				std::vector<Vector3> resultAoS(count + 1, Vector3{ -1.0f, -1.0f, -1.0f });
+				std::vector<float> resultX(count + 1, -1.0f), resultY(count + 1, -1.0f), resultZ(count + 1, -1.0f);
+
+				const PointsSoA pointsSoA{ x, y, z };
+				const OutputSoA outputSoA{ std::span<float>{ resultX }.first(count), std::span<float>{ resultY }.first(count), std::span<float>{ resultZ }.first(count) };
+				const std::span<Vector3> outputAoS = std::span<Vector3>{ resultAoS }.first(count);
+
+				switch (mode)
+				{
+					case Mode::Point:
+						TransformPoints(matrix, pointsSoA, outputSoA, instructionSet);
+						TransformPoints(matrix, points, outputAoS, instructionSet);
+						break;
+					case Mode::Vector:
+						TransformVectors(matrix, pointsSoA, outputSoA, instructionSet);
+						TransformVectors(matrix, points, outputAoS, instructionSet);
+						break;
+					case Mode::Project:
+						ProjectPoints(matrix, pointsSoA, g_Viewport, outputSoA, instructionSet);
+						ProjectPoints(matrix, points, g_Viewport, outputAoS, instructionSet);
+						break;
+				}
+
+				for (size_t i = 0; i < count; ++i)
+				{
+					const Vector3 expected = TransformOne(mode, matrix, g_Viewport, points[i]);
+					isSame = isSame && IsSame(expected, resultAoS[i].x, resultAoS[i].y, resultAoS[i].z);
+					isSame = isSame && IsSame(expected, resultX[i], resultY[i], resultZ[i]);
+				}
+
+				isSame = isSame && IsSame(resultAoS[count], -1.0f, -1.0f, -1.0f) && IsSame(Vector3{ -1.0f, -1.0f, -1.0f }, resultX[count], resultY[count], resultZ[count]);
+			}
+
+			if (!isSame)
+			{
+				std::cout << "  " << MatrixSIMD::GetName(instructionSet) << " mode " << static_cast<int>(mode) << " differs\n";
+			}
+			DAE_CHECK(isSame);
+		}
+	}
+}
+
+DAE_TEST(ProjectedPointsLandInTheViewport)
+{
+	const Matrix view = Matrix::CreateTranslation(0.0f, 0.0f, 10.0f);
+	const Matrix projection = Matrix::CreatePerspectiveFovLH(1.0f, 16.0f / 9.0f, 1.0f, 100.0f);
+	const Matrix viewProjection = view * projection;
+
+	//The center of the near plane, and the far plane straight ahead
+	const std::vector<Vector3> points{ { 0.0f, 0.0f, -9.0f }, { 0.0f, 0.0f, 90.0f } };
+	std::vector<Vector3> result(points.size());
+
+	for (InstructionSet instructionSet : GetSupportedInstructionSets())
+	{
+		ProjectPoints(viewProjection, points, g_Viewport, result, instructionSet);
+
+		const float centerX = g_Viewport.x + 0.5f * g_Viewport.width;
+		const float centerY = g_Viewport.y + 0.5f * g_Viewport.height;
+		DAE_CHECK(std::abs(result[0].x - centerX) < 1e-3f && std::abs(result[0].y - centerY) < 1e-3f);
+		DAE_CHECK(std::abs(result[0].z - g_Viewport.minDepth) < 1e-5f);
+		DAE_CHECK(std::abs(result[1].z - g_Viewport.maxDepth) < 1e-5f);
+	}
+
+	//Up in the world is up on screen, which is a smaller y in pixels
+	const std::vector<Vector3> abovePoint{ { 0.0f, 1.0f, 0.0f } };
+	ProjectPoints(viewProjection, abovePoint, g_Viewport, result);
+	DAE_CHECK(result[0].y < g_Viewport.y + 0.5f * g_Viewport.height);
+}
+
+DAE_TEST_MAIN()
@@ -0,0 +1,100 @@
+#include "Transform.h"
+#include "Camera.h"
+#include "TestFramework.h"
+
+#include <cmath>
+
+using namespace dae;
+
+namespace
+{
+	bool IsClose(float a, float b, float tolerance = 1e-5f)
+	{
+		return std::abs(a - b) <= tolerance;
+	}
+
+	bool IsClose(const Vector3& a, const Vector3& b, float tolerance = 1e-5f)
+	{
+		return IsClose(a.x, b.x, tolerance) && IsClose(a.y, b.y, tolerance) && IsClose(a.z, b.z, tolerance);
+	}
+
+	bool IsClose(const Matrix& a, const Matrix& b, float tolerance = 1e-5f)
+	{
+		bool isClose{ true };
+		for (int r = 0; r < 4; ++r)
+		{
+			for (int c = 0; c < 4; ++c)
+			{
+				isClose = isClose && IsClose(a[r][c], b[r][c], tolerance);
+			}
+		}
+		return isClose;
+	}
+}
+
+DAE_TEST(WorldMatrixScalesThenRotatesThenTranslates)
+{
+	const Vector3 position{ 3.0f, -1.0f, 7.5f };
+	const Quaternion rotation = Quaternion::CreateRotation(0.3f, 1.1f, -0.4f);
+	const Vector3 scale{ 2.0f, 0.5f, 3.0f };
+	const Transform transform{ position, rotation, scale };
+
+	const Matrix expected = Matrix::CreateScale(scale) * rotation.ToMatrix() * Matrix::CreateTranslation(position);
+	DAE_CHECK(IsClose(transform.GetWorldMatrix(), expected));
+	DAE_CHECK(IsClose(transform.GetWorldMatrix() * transform.GetInverseWorldMatrix(), Matrix{}));
+
+	const Vector3 point{ 1.0f, -2.0f, 0.25f };
+	DAE_CHECK(IsClose(transform.TransformPoint(point), expected.TransformPoint(point)));
+
+	//The axes are the rows of the rotation, which is where Rotate takes the unit axes
+	DAE_CHECK(IsClose(transform.GetForward(), rotation.ToMatrix().GetAxisZ()));
+	DAE_CHECK(IsClose(transform.GetRight(), rotation.ToMatrix().GetAxisX()));
+	DAE_CHECK(IsClose(transform.GetUp(), rotation.ToMatrix().GetAxisY()));
+}
+
+DAE_TEST(CachedMatricesFollowEveryChange)
+{
+	Transform transform{ { 1.0f, 2.0f, 3.0f } };
+	DAE_CHECK(IsClose(transform.GetWorldMatrix(), Matrix::CreateTranslation(1.0f, 2.0f, 3.0f)));
+
+	transform.Rotate(Quaternion::CreateFromAxisAngle(Vector3::UnitY, 0.5f));
+	transform.SetScale(2.0f);
+	transform.Translate({ 0.0f, 1.0f, 0.0f });
+
+	const Matrix expected = Matrix::CreateScale(2.0f, 2.0f, 2.0f) * Matrix::CreateRotationY(0.5f) * Matrix::CreateTranslation(1.0f, 3.0f, 3.0f);
+	DAE_CHECK(IsClose(transform.GetWorldMatrix(), expected));
+	DAE_CHECK(IsClose(transform.GetInverseWorldMatrix(), Matrix::Inverse(expected)));
+}
+
+DAE_TEST(CameraPitchAndYawRoundTrip)
+{
+	Camera camera{ { 4.0f, 2.0f, -10.0f }, 60.0f };
+
+	for (const float pitch : { -1.4f, -0.5f, 0.0f, 0.3f, 1.2f })
+	{
+		for (const float yaw : { -3.0f, -1.0f, 0.0f, 0.7f, 2.5f })
+		{
+			camera.SetRotation(pitch, yaw);
+			camera.CalculateViewMatrix();
+
+			//Pitch lifts the forward vector, yaw turns it around y starting at +z
+			const Vector3 forward = camera.forward;
+			DAE_CHECK(IsClose(forward.SqrMagnitude(), 1.0f));
+			DAE_CHECK(IsClose(std::asin(forward.y), pitch, 1e-4f));
+			DAE_CHECK(IsClose(std::atan2(forward.x, forward.z), yaw, 1e-4f));
+
+			//No roll: right stays horizontal, and the view matrix is the look at matrix of the same direction
+			DAE_CHECK(IsClose(camera.right.y, 0.0f));
+			DAE_CHECK(IsClose(camera.viewMatrix, Matrix::Inverse(Matrix::CreateLookAtLH(camera.origin, forward, Vector3::UnitY)), 1e-4f));
+			DAE_CHECK(IsClose(camera.invViewMatrix * camera.viewMatrix, Matrix{}));
+
+			//Feeding the recovered angles back in gives the same camera
+			const Matrix viewMatrix = camera.viewMatrix;
+			camera.SetRotation(std::asin(forward.y), std::atan2(forward.x, forward.z));
+			camera.CalculateViewMatrix();
+			DAE_CHECK(IsClose(camera.viewMatrix, viewMatrix, 1e-4f));
+		}
+	}
+}
+
+DAE_TEST_MAIN()
@@ -0,0 +1,202 @@
+#include "VectorBatch.h"
+#include "Vector3.h"
+#include "TestFramework.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <random>
+
+using namespace dae;
+using namespace dae::VectorBatch;
+
+namespace
+{
+	//Past the AVX width twice, so every tail length shows up
+	constexpr size_t maxCount{ 33 };
+
+	//The bound documented on Precision::Fast
+	constexpr double fastMaxError{ 2.6e-7 };
+
+	const Vector3 g_Guard{ -7.0f, -7.0f, -7.0f };
+
+	std::vector<InstructionSet> GetSupportedInstructionSets()
+	{
+		std::vector<InstructionSet> instructionSets;
+		for (InstructionSet instructionSet : { InstructionSet::Scalar, InstructionSet::SSE2, InstructionSet::AVX })
+		{
+			if (MatrixSIMD::IsSupported(instructionSet))
+			{
+				instructionSets.push_back(instructionSet);
+			}
+		}
+		return instructionSets;
+	}
+
+	//Lengths from 1e-3 to 1e3 like the benchmark, normals of unit length that are never parallel to the vectors
+	struct Input
+	{
+		std::vector<Vector3> vectors;
+		std::vector<Vector3> normals;
+		std::vector<float> values;
+	};
+
+	Input CreateInput(size_t count, uint32_t seed)
+	{
+		std::mt19937 random{ seed };
+		std::uniform_real_distribution<float> directionDistribution{ -1.0f, 1.0f };
+		std::uniform_real_distribution<float> exponentDistribution{ -3.0f, 3.0f };
+
+		Input input{ std::vector<Vector3>(count), std::vector<Vector3>(count), std::vector<float>(count) };
+		for (size_t i = 0; i < count; ++i)
+		{
+			const float length = std::pow(10.0f, exponentDistribution(random));
+			input.vectors[i] = Vector3{ directionDistribution(random), directionDistribution(random), directionDistribution(random) + 1.5f } * length;
+			input.normals[i] = Vector3{ directionDistribution(random), directionDistribution(random) + 1.5f, directionDistribution(random) }.Normalized();
+			input.values[i] = length;
+		}
+		return input;
+	}
+
+	bool IsSame(const Vector3& a, const Vector3& b)
+	{
+		return memcmp(&a, &b, sizeof(Vector3)) == 0;
+	}
+
+	//Largest component error of a unit result against the double precision direction
+	double GetError(const Vector3& result, const Vector3& vector)
+	{
+		const double x = vector.x, y = vector.y, z = vector.z;
+		const double length = std::sqrt(x * x + y * y + z * z);
+		return std::max({ std::abs(result.x - x / length), std::abs(result.y - y / length), std::abs(result.z - z / length) });
+	}
+
+	//Like the vertices of a mesh: the batch only touches the tangents, everything around them stays
+	struct Vertex
+	{
+		Vector3 position;
+		Vector3 normal;
+		Vector3 tangent;
+		float u;
+		float v;
+	};
+}
+
+DAE_TEST(PreciseMatchesVector3AtEveryCount)
+{
+	for (InstructionSet instructionSet : GetSupportedInstructionSets())
+	{
+		bool isSame{ true };
+		for (size_t count = 0; count <= maxCount; ++count)
+		{
+			const Input input = CreateInput(count, static_cast<uint32_t>(count));
+
+			//One guard element behind every output
+			std::vector<float> values(count + 1, -7.0f);
+			std::vector<Vector3> normalized(count + 1, g_Guard);
+			std::vector<Vector3> rejected(count + 1, g_Guard);
+
+			ReciprocalSqrt(input.values, values, Precision::Precise, instructionSet);
+			Normalize(input.vectors, normalized, Precision::Precise, instructionSet);
+			RejectNormalize(input.vectors, input.normals, rejected, Precision::Precise, instructionSet);
+
+			for (size_t i = 0; i < count; ++i)
+			{
+				const float expectedValue = 1.0f / sqrtf(input.values[i]);
+				isSame = isSame && memcmp(&values[i], &expectedValue, sizeof(float)) == 0;
+				isSame = isSame && IsSame(normalized[i], input.vectors[i].Normalized());
+				isSame = isSame && IsSame(rejected[i], Vector3::Reject(input.vectors[i], input.normals[i]).Normalized());
+			}
+
+			isSame = isSame && values[count] == -7.0f && IsSame(normalized[count], g_Guard) && IsSame(rejected[count], g_Guard);
+
+			//In place gives the same
+			std::vector<Vector3> inPlace = input.vectors;
+			Normalize(inPlace, inPlace, Precision::Precise, instructionSet);
+			isSame = isSame && std::equal(inPlace.begin(), inPlace.end(), normalized.begin(), IsSame);
+		}
+
+		if (!isSame)
+		{
+			std::cout << "  " << MatrixSIMD::GetName(instructionSet) << " differs\n";
+		}
+		DAE_CHECK(isSame);
+	}
+}
+
+DAE_TEST(FastStaysWithinTheDocumentedBound)
+{
+	//Not a multiple of 8, the tails run the precise scalar path and may not hide a bad SIMD lane
+	constexpr size_t count{ 100'003 };
+	const Input input = CreateInput(count, 1337);
+
+	std::vector<float> values(count);
+	std::vector<Vector3> normalized(count);
+	std::vector<Vector3> rejected(count);
+
+	for (InstructionSet instructionSet : GetSupportedInstructionSets())
+	{
+		ReciprocalSqrt(input.values, values, Precision::Fast, instructionSet);
+		Normalize(input.vectors, normalized, Precision::Fast, instructionSet);
+		RejectNormalize(input.vectors, input.normals, rejected, Precision::Fast, instructionSet);
+
+		double valueError{};
+		double normalizeError{};
+		double rejectError{};
+		for (size_t i = 0; i < count; ++i)
+		{
+			const double reference = 1.0 / std::sqrt(static_cast<double>(input.values[i]));
+			valueError = std::max(valueError, std::abs(values[i] - reference) / reference);
+			normalizeError = std::max(normalizeError, GetError(normalized[i], input.vectors[i]));
+
+			//The bound is on the normalization, the cancellation in the float reject is the same on every path
+			rejectError = std::max(rejectError, GetError(rejected[i], Vector3::Reject(input.vectors[i], input.normals[i])));
+		}
+
+		if (std::max({ valueError, normalizeError, rejectError }) > fastMaxError)
+		{
+			std::cout << "  " << MatrixSIMD::GetName(instructionSet) << ": " << valueError << ", " << normalizeError << ", " << rejectError << "\n";
+		}
+		DAE_CHECK(valueError <= fastMaxError);
+		DAE_CHECK(normalizeError <= fastMaxError);
+		DAE_CHECK(rejectError <= fastMaxError);
+	}
+}
+
+DAE_TEST(StridedRejectNormalizeOnlyTouchesTheTangents)
+{
+	for (InstructionSet instructionSet : GetSupportedInstructionSets())
+	{
+		bool isSame{ true };
+		for (size_t count = 0; count <= maxCount; ++count)
+		{
+			const Input input = CreateInput(count, static_cast<uint32_t>(count) + 100);
+
+			std::vector<Vertex> vertices(count + 1, Vertex{ g_Guard, g_Guard, g_Guard, -7.0f, -7.0f });
+			for (size_t i = 0; i < count; ++i)
+			{
+				vertices[i].normal = input.normals[i];
+				vertices[i].tangent = input.vectors[i];
+			}
+
+			RejectNormalize(&vertices.data()->tangent, &vertices.data()->normal, count, sizeof(Vertex), Precision::Precise, instructionSet);
+
+			for (size_t i = 0; i < count; ++i)
+			{
+				isSame = isSame && IsSame(vertices[i].tangent, Vector3::Reject(input.vectors[i], input.normals[i]).Normalized());
+				isSame = isSame && IsSame(vertices[i].position, g_Guard) && IsSame(vertices[i].normal, input.normals[i]);
+				isSame = isSame && vertices[i].u == -7.0f && vertices[i].v == -7.0f;
+			}
+
+			isSame = isSame && IsSame(vertices[count].position, g_Guard) && IsSame(vertices[count].tangent, g_Guard);
+		}
+
+		if (!isSame)
+		{
+			std::cout << "  " << MatrixSIMD::GetName(instructionSet) << " differs\n";
+		}
+		DAE_CHECK(isSame);
+	}
+}
+
+DAE_TEST_MAIN()
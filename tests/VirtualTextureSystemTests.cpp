@@ -0,0 +1,267 @@
+#include "VirtualTextureSystem.h"
+#include "TestFramework.h"
+
+#include <random>
+
+using namespace dae;
+
+namespace
+{
+	//1024x1024 in pages of 128 is 8x8 pages, mips of 8, 4, 2 and 1 pages per axis
+	constexpr uint32_t textureSize{ 1024 };
+	constexpr uint32_t pageSize{ 128 };
+
+	struct LoaderLog
+	{
+		std::vector<PageId> loads{};
+		bool isFailing{ false };
+
+		VirtualTextureSystem::PageLoader GetLoader()
+		{
+			return [this](const PageId& page, uint32_t)
+				{
+					loads.push_back(page);
+					return !isFailing;
+				};
+		}
+	};
+
+	uint32_t Pack(uint32_t textureId, uint32_t mip, uint32_t x, uint32_t y)
+	{
+		return PageId{ textureId, mip, x, y }.Pack();
+	}
+
+	bool IsPage(const PageId& page, uint32_t textureId, uint32_t mip, uint32_t x, uint32_t y)
+	{
+		return page.textureId == textureId && page.mip == mip && page.x == x && page.y == y;
+	}
+
+	bool IsResident(const VirtualTextureSystem& system, uint32_t textureId, uint32_t mip, uint32_t x, uint32_t y)
+	{
+		return system.GetPageTable(textureId).GetSlot(mip, x, y) != InvalidPage;
+	}
+
+	//Every mapped page is the one the cache holds in that slot, and every used slot is mapped
+	bool IsConsistent(const VirtualTextureSystem& system)
+	{
+		uint32_t numMapped{ 0 };
+		for (uint32_t textureId = 0; textureId < system.GetNumTextures(); ++textureId)
+		{
+			const PageTable& pageTable = system.GetPageTable(textureId);
+			for (uint32_t mip = 0; mip < pageTable.GetMipCount(); ++mip)
+			{
+				for (uint32_t y = 0; y < pageTable.GetHeight(mip); ++y)
+				{
+					for (uint32_t x = 0; x < pageTable.GetWidth(mip); ++x)
+					{
+						const uint32_t slot = pageTable.GetSlot(mip, x, y);
+						if (slot == InvalidPage)
+							continue;
+
+						++numMapped;
+						if (system.GetCache().GetPageKey(slot) != Pack(textureId, mip, x, y))
+							return false;
+					}
+				}
+			}
+		}
+		return numMapped == system.GetCache().GetNumUsedSlots();
+	}
+}
+
+DAE_TEST(PageIdsPackLikeTheFeedbackShader)
+{
+	const PageId page{ 200, 14, 1023, 517 };
+	DAE_CHECK_EQUAL(page.Pack(), (200u << 24) | (14u << 20) | (1023u << 10) | 517u);
+
+	const PageId unpacked = PageId::Unpack(page.Pack());
+	DAE_CHECK(IsPage(unpacked, 200, 14, 1023, 517));
+	DAE_CHECK(IsPage(PageId{ 3, 1, 5, 2 }.GetParent(), 3, 2, 2, 1));
+}
+
+DAE_TEST(FeedbackIsReducedToUniquePages)
+{
+	const uint32_t a = Pack(0, 0, 1, 1);
+	const uint32_t b = Pack(0, 1, 0, 0);
+	const uint32_t c = Pack(1, 0, 7, 7);
+	const std::vector<uint32_t> feedback{ a, a, a, InvalidPage, b, c, c, InvalidPage, InvalidPage, a, b, a };
+
+	FeedbackAnalyzer analyzer{};
+	const std::vector<FeedbackAnalyzer::PageRequest>& requests = analyzer.Reduce(feedback.data(), feedback.size());
+
+	//Sorted by key, which is texture, then mip, then position
+	DAE_CHECK_EQUAL(requests.size(), 3u);
+	if (requests.size() == 3)
+	{
+		DAE_CHECK_EQUAL(requests[0].pageKey, a);
+		DAE_CHECK_EQUAL(requests[0].count, 5u);
+		DAE_CHECK(IsPage(requests[0].page, 0, 0, 1, 1));
+		DAE_CHECK_EQUAL(requests[1].pageKey, b);
+		DAE_CHECK_EQUAL(requests[1].count, 2u);
+		DAE_CHECK_EQUAL(requests[2].pageKey, c);
+		DAE_CHECK_EQUAL(requests[2].count, 2u);
+	}
+
+	const std::vector<uint32_t> empty(64, InvalidPage);
+	DAE_CHECK(analyzer.Reduce(empty.data(), empty.size()).empty());
+	DAE_CHECK(analyzer.Reduce(nullptr, 0).empty());
+}
+
+DAE_TEST(TheCoarsestPageIsResidentFromTheStart)
+{
+	LoaderLog log{};
+	VirtualTextureSystem system{ 16, pageSize, log.GetLoader() };
+	const uint32_t textureId = system.AddTexture(textureSize, textureSize);
+
+	DAE_CHECK_EQUAL(textureId, 0u);
+	DAE_CHECK_EQUAL(system.GetPageTable(textureId).GetMipCount(), 4u);
+	DAE_CHECK_EQUAL(log.loads.size(), 1u);
+	DAE_CHECK(!log.loads.empty() && IsPage(log.loads[0], 0, 3, 0, 0));
+	DAE_CHECK(IsResident(system, textureId, 3, 0, 0));
+
+	//Non power of two sizes round up, 300 texels are 3 pages and then 4
+	const uint32_t oddId = system.AddTexture(300, 128);
+	DAE_CHECK_EQUAL(system.GetPageTable(oddId).GetWidth(0), 4u);
+	DAE_CHECK_EQUAL(system.GetPageTable(oddId).GetHeight(0), 1u);
+	DAE_CHECK_EQUAL(system.GetPageTable(oddId).GetMipCount(), 3u);
+}
+
+DAE_TEST(MissingPagesLoadCoarsestFirstWithinTheBudget)
+{
+	LoaderLog log{};
+	VirtualTextureSystem system{ 16, pageSize, log.GetLoader() };
+	system.AddTexture(textureSize, textureSize);
+	log.loads.clear();
+
+	//Mip 0 page (5, 3) needs its ancestors (2, 1) on mip 1 and (1, 0) on mip 2, mip 3 is resident
+	const std::vector<uint32_t> feedback(32, Pack(0, 0, 5, 3));
+	system.Update(feedback.data(), feedback.size(), 2);
+
+	DAE_CHECK_EQUAL(system.GetStatistics().numMissingPages, 3u);
+	DAE_CHECK_EQUAL(system.GetStatistics().numDeferredLoads, 1u);
+	DAE_CHECK_EQUAL(log.loads.size(), 2u);
+	DAE_CHECK(log.loads.size() == 2 && IsPage(log.loads[0], 0, 2, 1, 0) && IsPage(log.loads[1], 0, 1, 2, 1));
+
+	//Until mip 0 is loaded, sampling falls back to the finest resident ancestor
+	uint32_t mip{ 0 };
+	uint32_t x{ 5 };
+	uint32_t y{ 3 };
+	const uint32_t slot = system.GetPageTable(0).Resolve(mip, x, y);
+	DAE_CHECK_EQUAL(mip, 1u);
+	DAE_CHECK_EQUAL(slot, system.GetCache().Find(Pack(0, 1, 2, 1)));
+
+	system.Update(feedback.data(), feedback.size(), 2);
+	DAE_CHECK_EQUAL(log.loads.size(), 3u);
+	DAE_CHECK(IsResident(system, 0, 0, 5, 3));
+	DAE_CHECK_EQUAL(system.GetStatistics().numDeferredLoads, 0u);
+
+	//Everything asked for is resident, nothing more is loaded
+	system.Update(feedback.data(), feedback.size(), 2);
+	DAE_CHECK_EQUAL(log.loads.size(), 3u);
+	DAE_CHECK_EQUAL(system.GetStatistics().numMissingPages, 0u);
+	DAE_CHECK(IsConsistent(system));
+}
+
+DAE_TEST(PagesOutsideAnyTextureAreIgnored)
+{
+	LoaderLog log{};
+	VirtualTextureSystem system{ 16, pageSize, log.GetLoader() };
+	system.AddTexture(textureSize, textureSize);
+	log.loads.clear();
+
+	const std::vector<uint32_t> feedback{ Pack(0, 0, 8, 0), Pack(0, 4, 0, 0), Pack(1, 0, 0, 0), Pack(0, 2, 2, 0) };
+	system.Update(feedback.data(), feedback.size(), 16);
+
+	DAE_CHECK_EQUAL(system.GetStatistics().numUniquePages, 4u);
+	DAE_CHECK_EQUAL(system.GetStatistics().numMissingPages, 0u);
+	DAE_CHECK(log.loads.empty());
+}
+
+DAE_TEST(LeastRecentlyUsedPagesAreEvicted)
+{
+	//The pinned coarsest page and three more
+	LoaderLog log{};
+	VirtualTextureSystem system{ 4, pageSize, log.GetLoader() };
+	system.AddTexture(textureSize, textureSize);
+
+	const std::vector<uint32_t> first{ Pack(0, 2, 0, 0), Pack(0, 2, 1, 0), Pack(0, 2, 0, 1) };
+	system.Update(first.data(), first.size(), 16);
+	DAE_CHECK_EQUAL(system.GetCache().GetNumUsedSlots(), 4u);
+
+	//Keeps (0, 0) alive, (1, 0) and (0, 1) were used a frame earlier and go first
+	const std::vector<uint32_t> second{ Pack(0, 2, 0, 0), Pack(0, 2, 1, 1) };
+	system.Update(second.data(), second.size(), 16);
+	DAE_CHECK_EQUAL(system.GetStatistics().numEvictions, 1u);
+	DAE_CHECK(IsResident(system, 0, 2, 0, 0));
+	DAE_CHECK(IsResident(system, 0, 2, 1, 1));
+	DAE_CHECK(IsResident(system, 0, 3, 0, 0));
+	DAE_CHECK(IsResident(system, 0, 2, 1, 0) != IsResident(system, 0, 2, 0, 1));
+	DAE_CHECK(IsConsistent(system));
+}
+
+DAE_TEST(PagesOfThisFrameAreNeverEvictedForEachOther)
+{
+	LoaderLog log{};
+	VirtualTextureSystem system{ 3, pageSize, log.GetLoader() };
+	system.AddTexture(textureSize, textureSize);
+
+	//Four pages wanted, two free slots: the other two wait for a later frame instead of thrashing
+	const std::vector<uint32_t> feedback{ Pack(0, 2, 0, 0), Pack(0, 2, 1, 0), Pack(0, 2, 0, 1), Pack(0, 2, 1, 1) };
+	system.Update(feedback.data(), feedback.size(), 16);
+
+	DAE_CHECK_EQUAL(system.GetStatistics().numMissingPages, 4u);
+	DAE_CHECK_EQUAL(system.GetStatistics().numDeferredLoads, 2u);
+	DAE_CHECK_EQUAL(system.GetStatistics().numEvictions, 0u);
+	DAE_CHECK(IsResident(system, 0, 3, 0, 0));
+	DAE_CHECK(IsConsistent(system));
+}
+
+DAE_TEST(FailedLoadsLeaveThePageMissing)
+{
+	LoaderLog log{};
+	VirtualTextureSystem system{ 8, pageSize, log.GetLoader() };
+	system.AddTexture(textureSize, textureSize);
+
+	log.isFailing = true;
+	const std::vector<uint32_t> feedback{ Pack(0, 2, 1, 1) };
+	system.Update(feedback.data(), feedback.size(), 16);
+	DAE_CHECK(!IsResident(system, 0, 2, 1, 1));
+	DAE_CHECK_EQUAL(system.GetCache().GetNumUsedSlots(), 1u);
+
+	//Asked for again the next frame
+	log.isFailing = false;
+	system.Update(feedback.data(), feedback.size(), 16);
+	DAE_CHECK(IsResident(system, 0, 2, 1, 1));
+	DAE_CHECK(IsConsistent(system));
+}
+
+DAE_TEST(RandomFeedbackKeepsTablesAndCacheConsistent)
+{
+	VirtualTextureSystem system{ 24, pageSize, [](const PageId&, uint32_t) { return true; } };
+	system.AddTexture(textureSize, textureSize);
+	system.AddTexture(textureSize / 2, textureSize);
+
+	std::mt19937 random{ 42 };
+	std::vector<uint32_t> feedback(256);
+	bool isConsistent{ true };
+	for (uint32_t frame = 0; frame < 200; ++frame)
+	{
+		for (uint32_t& texel : feedback)
+		{
+			const uint32_t textureId = random() % 2;
+			const PageTable& pageTable = system.GetPageTable(textureId);
+			const uint32_t mip = random() % pageTable.GetMipCount();
+			texel = random() % 8 == 0 ? InvalidPage : Pack(textureId, mip, random() % pageTable.GetWidth(mip), random() % pageTable.GetHeight(mip));
+		}
+
+		system.Update(feedback.data(), feedback.size(), 4);
+		isConsistent = isConsistent && IsConsistent(system);
+	}
+	DAE_CHECK(isConsistent);
+
+	//Both coarsest pages are pinned
+	DAE_CHECK(IsResident(system, 0, system.GetPageTable(0).GetMipCount() - 1, 0, 0));
+	DAE_CHECK(IsResident(system, 1, system.GetPageTable(1).GetMipCount() - 1, 0, 0));
+}
+
+DAE_TEST_MAIN()